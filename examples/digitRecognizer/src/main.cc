@@ -160,17 +160,46 @@ auto main() -> cbx::i32 {
 
   net.show_summary();
 
-  std::cout << "Running forward pass..." << std::endl;
+  const auto BATCH_SIZE = 64;
+  const auto EPOCHS = 5;
+
+  // The sparse cross-entropy expects the class indices as floating-point observations.
+  auto train_targets = tensorF32{train_labels.shape(), train_labels.begin()};
+  auto loss = cbx::LossFuncWrapper{cbx::Loss::SparseCrossEntropy};
+  auto optimizer = cbx::Adam{};
+
+  // An untrained copy for comparing the asynchronous mode against the synchronous one.
+  auto async_net = net.clone();
+
+  std::cout << "Training..." << std::endl;
   watch.start();
-  auto out = net.forward_pass(train_images);
+  auto reports = net.fit(train_images, train_targets, loss, optimizer, BATCH_SIZE, EPOCHS);
   watch.stop();
-  std::cout << "Forward pass complete!" << std::endl;
+  for (const auto &report : reports) {
+    fmt::print("Epoch {}/{}: loss = {:.4f}, {:.0f} samples/s on {} threads\n", report.epoch, EPOCHS,
+               report.loss, report.samples_per_second(), report.replicas);
+  }
 
-  std::cout << "Output => " << out.meta_info() << std::endl;
+  const auto ASYNC_LEARNING_RATE = 0.05F;
+
+  std::cout << "Training asynchronously..." << std::endl;
+  for (const auto &report :
+       async_net.fit_async(train_images, train_targets, loss, ASYNC_LEARNING_RATE, BATCH_SIZE, EPOCHS)) {
+    fmt::print("Epoch {}/{}: loss = {:.4f}, {:.0f} samples/s on {} threads, staleness = {:.2f} (max = {})\n",
+               report.epoch, EPOCHS, report.loss, report.samples_per_second(), report.replicas,
+               report.mean_staleness, report.max_staleness);
+  }
+
+  auto [_scores, classes] = net.predict(test_images);
+  auto correct = 0;
+  for (cbx::usize i = {}; i < test_labels.total(); ++i) {
+    correct += classes[i] == test_labels[i];
+  }
+  fmt::print("Test accuracy: {}/{}\n", correct, test_labels.total());
 
   auto n = 5;
   std::cout << "Printing first " << n << " outputs..." << std::endl;
-  print(out, n);
+  print(net.forward_pass(test_images), n);
 
   std::cout << "Time taken: " << watch.get_duration<std::chrono::seconds>() << "s." << std::endl;
   return {};
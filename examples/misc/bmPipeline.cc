@@ -0,0 +1,62 @@
+#include <cbrainx/cbrainx.hh>
+
+#include <algorithm>
+#include <iostream>
+#include <vector>
+
+auto main() -> cbx::i32 {
+  auto stopwatch = cbx::Stopwatch{};
+
+  // A deep network fed with a stream of small batches.
+  auto net = cbx::NeuralNet{{512}};
+  for (auto i = 0; i < 8; ++i) {
+    net.add<cbx::DenseLayer>(512);
+    net.add<cbx::ActivationLayer>(cbx::Activation::ReLU);
+  }
+  net.add<cbx::DenseLayer>(10);
+  net.add<cbx::Softmax>();
+
+  constexpr auto BATCH_SIZE = cbx::usize{4};
+  constexpr auto BATCHES = cbx::usize{4096};
+  auto stream = std::vector<cbx::Tensor<cbx::f32>>{};
+  for (cbx::usize i = {}; i < 16; ++i) {
+    stream.push_back(cbx::Tensor<cbx::f32>::random({BATCH_SIZE, 512}, i, -1, 1));
+  }
+
+  std::cout << "[ WHOLE NETWORK PER BATCH ]" << std::endl;
+  auto plan = net.compile(BATCH_SIZE);
+  auto context = cbx::ExecutionContext{};
+  auto expected = std::vector<cbx::Tensor<cbx::f32>>{};
+  for (const auto &batch : stream) {
+    expected.push_back(plan.run(batch, context));
+  }
+  stopwatch.start();
+  for (cbx::usize i = {}; i < BATCHES; ++i) {
+    (void)plan.run(stream[i % stream.size()], context);
+  }
+  stopwatch.stop();
+  std::cout << "Time taken: " << stopwatch.get_duration() << " milliseconds." << std::endl;
+  std::cout << std::endl;
+
+  std::cout << "[ LAYER-PIPELINED ]" << std::endl;
+  auto pipeline = cbx::Pipeline{net, {.batch_size = BATCH_SIZE}};
+  std::cout << pipeline.to_string();
+  auto mismatches = cbx::usize{};
+  stopwatch.start();
+  // Keeping `depth()` batches in flight lets a single thread both feed and drain the pipeline.
+  for (cbx::usize pushed = {}, popped = {}; popped < BATCHES;) {
+    if (pushed < BATCHES and pushed - popped < pipeline.depth()) {
+      pipeline.push(stream[pushed++ % stream.size()]);
+      continue;
+    }
+    auto output = pipeline.pop();
+    const auto &reference = expected[popped++ % stream.size()];
+    mismatches += not std::equal(output->begin(), output->end(), reference.begin());
+  }
+  stopwatch.stop();
+  std::cout << "Time taken: " << stopwatch.get_duration() << " milliseconds." << std::endl;
+  std::cout << "Mismatches: " << mismatches << std::endl;
+  std::cout << std::endl;
+
+  return {};
+}
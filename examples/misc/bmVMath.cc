@@ -0,0 +1,39 @@
+#include <cbrainx/cbrainx.hh>
+
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+
+auto main() -> cbx::i32 {
+  auto stopwatch = cbx::Stopwatch{};
+
+  // A large vector of random inputs.
+  auto x = cbx::Tensor<cbx::f32>::random({1 << 24}, 1, -10, 10);
+  auto y = x.zeros_like();
+
+  std::cout << "x=" << x.meta_info() << std::endl;
+  std::cout << std::endl;
+
+  std::cout << "[ std::exp ]" << std::endl;
+  stopwatch.start();
+  std::transform(x.begin(), x.end(), y.begin(), [](auto x_i) { return std::exp(x_i); });
+  stopwatch.stop();
+  std::cout << "Time taken: " << stopwatch.get_duration() << " milliseconds." << std::endl;
+  std::cout << std::endl;
+
+  for (auto isa : {cbx::ISA::Generic, cbx::ISA::AVX2, cbx::ISA::AVX512}) {
+    if (not cbx::CpuFeatures::is_supported(isa)) {
+      continue;
+    }
+    cbx::CpuFeatures::set_active_isa(isa);
+
+    std::cout << "[ cbx::vmath::exp (" << cbx::CpuFeatures::to_string(isa) << ") ]" << std::endl;
+    stopwatch.start();
+    cbx::vmath::exp({x.data(), x.total()}, {y.data(), y.total()});
+    stopwatch.stop();
+    std::cout << "Time taken: " << stopwatch.get_duration() << " milliseconds." << std::endl;
+    std::cout << std::endl;
+  }
+
+  return {};
+}
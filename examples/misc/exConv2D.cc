@@ -0,0 +1,55 @@
+// Copyright 2021 CBrainX
+// Project URL: https://github.com/mansoormemon/cbrainx
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Copyright (c) 2021 Mansoor Ahmed Memon <mansoorahmed.one@gmail.com>
+#include <iostream>
+
+#include <cbrainx/cbrainx.hh>
+#include <fmt/format.h>
+
+auto main() -> cbx::i32 {
+  // A batch of one 5x5 single-channel image with a vertical edge in the middle.
+  auto image = cbx::Tensor<cbx::f32>{{1, 5, 5, 1}};
+  for (cbx::usize r = {}; r < 5; ++r) {
+    for (cbx::usize c = 3; c < 5; ++c) {
+      image(0, r, c, 0) = 1;
+    }
+  }
+
+  // Two filters: a horizontal gradient (Sobel) and a box blur.
+  auto sobel = {-1.0F, 0.0F, 1.0F, -2.0F, 0.0F, 2.0F, -1.0F, 0.0F, 1.0F};
+  auto kernel = cbx::Tensor<cbx::f32>{{3, 3, 1, 2}};
+  for (cbx::usize i = {}; auto weight : sobel) {
+    kernel(i / 3, i % 3, 0, 0) = weight;
+    kernel(i / 3, i % 3, 0, 1) = 1.0F / 9;
+    ++i;
+  }
+
+  std::cout << "Convolving with unit stride and same padding..." << std::endl;
+  auto out = cbx::conv2d(image, kernel, 1, 1);
+  std::cout << "out=" << out.meta_info() << std::endl;
+  for (cbx::usize r = {}; r < out.shape()[1]; ++r) {
+    for (cbx::usize c = {}; c < out.shape()[2]; ++c) {
+      fmt::print("({:5.2f}, {:4.2f}) ", out(0, r, c, 0), out(0, r, c, 1));
+    }
+    std::cout << std::endl;
+  }
+
+  std::cout << "Convolving with a stride of two and a dilation of two..." << std::endl;
+  auto strided = cbx::conv2d(image, kernel, {2, 2, 2, 2, 2, 2});
+  std::cout << "strided=" << strided.meta_info() << std::endl;
+
+  return {};
+}
@@ -0,0 +1,44 @@
+#include <cbrainx/cbrainx.hh>
+
+#include <algorithm>
+#include <iostream>
+
+auto main(cbx::i32 argc, char *argv[]) -> cbx::i32 {
+  auto path = argc > 1 ? argv[1] : "res/img/cover.png";
+
+  try {
+    std::cout << "Reading image..." << std::endl;
+    auto img = cbx::ImgProc::resize(cbx::Image::read<cbx::f32>(path), 64, 64);
+    std::cout << "=> " << img.meta_info() << std::endl;
+
+    // Each sample is an image of shape (height, width, channels).
+    auto net = cbx::NeuralNet{img.shape()};
+    net.add<cbx::Conv2DLayer>(8, 3, 2, 1);
+    net.add<cbx::ActivationLayer>(cbx::Activation::ReLU);
+    net.add<cbx::MaxPool2D>(2);
+    net.add<cbx::Conv2DLayer>(16, 3, 1, 1);
+    net.add<cbx::ActivationLayer>(cbx::Activation::ReLU);
+    net.add<cbx::GlobalAvgPool>();
+    net.add<cbx::DenseLayer>(10);
+    net.add<cbx::Softmax>();
+    net.show_summary();
+
+    // A batch of one image.
+    img.reshape(img.rank() + 1, true);
+    auto [scores, classes] = net.predict(img, 3);
+    for (cbx::usize i = {}; i < classes.total(); ++i) {
+      fmt::print("class {} => {:.4f}\n", classes[i], scores[i]);
+    }
+
+    std::cout << "Round-tripping through a model file..." << std::endl;
+    net.save("convNet.cbx");
+    auto loaded = cbx::NeuralNet::load("convNet.cbx");
+    auto [loaded_scores, loaded_classes] = loaded.predict(img, 3);
+    auto is_identical = std::equal(classes.begin(), classes.end(), loaded_classes.begin());
+    std::cout << "Identical predictions: " << std::boolalpha << is_identical << std::endl;
+  } catch (cbx::ImageIOError &e) {
+    std::cout << e.what() << std::endl;
+    std::cout << "Terminating..." << std::endl;
+  }
+  return {};
+}
@@ -0,0 +1,65 @@
+#include <cbrainx/cbrainx.hh>
+
+#include <algorithm>
+#include <iostream>
+#include <vector>
+
+#include <fmt/format.h>
+
+auto main() -> cbx::i32 {
+  auto a = cbx::Tensor<cbx::f32>::arange({2, 3});
+  auto b = cbx::Tensor<cbx::f32>::arange({2, 2}, 10);
+
+  fmt::print("a = {{ {} }}\n", fmt::join(a, ", "));
+  fmt::print("b = {{ {} }}\n", fmt::join(b, ", "));
+
+  std::cout << "Concatenating a and b along axis 1..." << std::endl;
+  auto c = cbx::concat(std::vector{a, b}, 1);
+  std::cout << "c=" << c.meta_info() << std::endl;
+  fmt::print("c = {{ {} }}\n", fmt::join(c, ", "));
+
+  std::cout << "Stacking a thrice..." << std::endl;
+  auto s = cbx::stack(std::vector{a, a, a});
+  std::cout << "s=" << s.meta_info() << std::endl;
+
+  std::cout << "Splitting c along axis 1..." << std::endl;
+  for (const auto &part : cbx::split(c, {3, 2}, 1)) {
+    fmt::print("part = {{ {} }}\n", fmt::join(part, ", "));
+  }
+
+  std::cout << "Splitting a dataset into training and validation views..." << std::endl;
+  auto dataset = cbx::Tensor<cbx::f32>::random({100, 8});
+  auto views = cbx::split_view(dataset, {80, 20});
+  std::cout << "train=" << views[0].meta_info() << std::endl;
+  std::cout << "validation=" << views[1].meta_info() << std::endl;
+
+  std::cout << "Reassembling the dataset into a preallocated tensor..." << std::endl;
+  auto reassembled = dataset.zeros_like();
+  cbx::concat_into(views, reassembled);
+  std::cout << "identical=" << std::boolalpha << std::equal(dataset.begin(), dataset.end(), reassembled.begin())
+            << std::endl;
+
+  std::cout << "Looking up rows 2, 0 and 2 of an embedding table..." << std::endl;
+  auto table = cbx::Tensor<cbx::f32>{{3, 2}, std::initializer_list<cbx::f32>{0, 1, 10, 11, 20, 21}};
+  auto embedded = table.index_select(0, std::vector<cbx::usize>{2, 0, 2});
+  fmt::print("embedded = {{ {} }}\n", fmt::join(embedded, ", "));
+
+  std::cout << "Gathering the scores of the true labels..." << std::endl;
+  auto labels = cbx::Tensor<cbx::i32>{{3, 1}, std::initializer_list<cbx::i32>{1, 0, 1}};
+  auto picked = table.gather(1, labels);
+  fmt::print("picked = {{ {} }}\n", fmt::join(picked, ", "));
+
+  std::cout << "Scattering gradients back into the table..." << std::endl;
+  auto gradients = table.zeros_like();
+  gradients.scatter_add(1, labels, cbx::Tensor<cbx::f32>{{3, 1}, 1});
+  fmt::print("gradients = {{ {} }}\n", fmt::join(gradients, ", "));
+
+  // Top-2 classes per row.
+  auto scores =
+      cbx::Tensor<cbx::f32>{{2, 4}, std::initializer_list<cbx::f32>{0.1, 0.6, 0.2, 0.1, 0.5, 0.05, 0.05, 0.4}};
+  auto [top_scores, top_classes] = scores.topk(2, 1);
+  fmt::print("top_scores = {{ {} }}\n", fmt::join(top_scores, ", "));
+  fmt::print("top_classes = {{ {} }}\n", fmt::join(top_classes, ", "));
+
+  return {};
+}
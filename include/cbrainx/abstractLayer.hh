@@ -18,10 +18,14 @@
 #ifndef CBRAINX__ABSTRACT_LAYER_HH_
 #define CBRAINX__ABSTRACT_LAYER_HH_
 
+#include <memory>
+#include <span>
 #include <string>
+#include <vector>
 
 #include "shape.hh"
 #include "tensor.hh"
+#include "tensorView.hh"
 #include "typeAliases.hh"
 
 namespace cbx {
@@ -31,7 +35,21 @@ namespace cbx {
 // /////////////////////////////////////////////
 
 /// \brief Supported layer types.
-enum class LayerType { Dense, Activation, Softmax };
+enum class LayerType { Dense, Activation, Softmax, Conv2D, MaxPool2D, AvgPool2D, GlobalAvgPool, BatchNorm };
+
+/// \brief A view of a tensor of trainable parameters and the gradient accumulated for it.
+///
+/// \see AbstractLayer::trainable_parameters
+struct TrainableParameter {
+  /// \brief The values of the parameters.
+  std::span<f32> values = {};
+
+  /// \brief The accumulated gradient of the loss w.r.t. the parameters, of the same size as `values`.
+  ///
+  /// \details
+  /// The gradient is writable so that the gradients of several replicas can be reduced into it in place.
+  std::span<f32> gradients = {};
+};
 
 /// \brief The `AbstractLayer` class defines a standard interface for all layers.
 ///
@@ -59,6 +77,23 @@ class AbstractLayer {
   /// \brief The output layer.
   mutable container output_ = {};
 
+  /// \brief The gradient of the loss w.r.t. the input layer.
+  mutable container input_gradient_ = {};
+
+  // /////////////////////////////////////////////
+  // Helpers
+  // /////////////////////////////////////////////
+
+  /// \brief Checks if the gradient received by the backward pass matches the cached output layer.
+  /// \param[in] output_gradient The gradient of the loss w.r.t. the output layer.
+  ///
+  /// \details
+  /// This function throws an exception if the shape of \p output_gradient differs from that of the output
+  /// layer, e.g., because no forward pass preceded the backward pass.
+  ///
+  /// \throws ShapeError
+  auto _m_check_output_gradient(const container &output_gradient) const -> void;
+
  public:
   // /////////////////////////////////////////////
   // Constructors and Destructors
@@ -139,6 +174,15 @@ class AbstractLayer {
   /// \return The number of modifiable parameters in the layer.
   [[nodiscard]] virtual auto parameters() const -> size_type = 0;
 
+  /// \brief Returns the shape of the output layer of one sample.
+  /// \param[in] input_shape The shape of the input layer of one sample.
+  /// \return The shape of the output layer (excluding the samples axis).
+  ///
+  /// \details
+  /// By default, the output is a vector of `neurons()` elements. Element-wise layers preserve the shape of
+  /// their input, and spatial layers report their own, so that a network can track the shape of every layer.
+  [[nodiscard]] virtual auto output_shape(const Shape &input_shape) const -> Shape;
+
   /// \brief Returns the type of the layer.
   /// \return The type of the layer.
   ///
@@ -163,6 +207,17 @@ class AbstractLayer {
   /// \see LayerType
   [[nodiscard]] virtual auto type_name() const -> std::string;
 
+  // /////////////////////////////////////////////
+  // Utility
+  // /////////////////////////////////////////////
+
+  /// \brief Returns a deep copy of the layer.
+  /// \return A new layer with its own parameters, gradients and caches.
+  ///
+  /// \details
+  /// Replicas created this way can run forward and backward passes concurrently with the original.
+  [[nodiscard]] virtual auto clone() const -> std::shared_ptr<AbstractLayer> = 0;
+
   // /////////////////////////////////////////////
   // Core Functionality
   // /////////////////////////////////////////////
@@ -175,13 +230,61 @@ class AbstractLayer {
   /// \return The cached output layer.
   [[nodiscard]] auto output() const -> const container &;
 
-  /// \brief Drops the cached input and output layers.
+  /// \brief Returns the gradient of the loss w.r.t. the input layer computed by the last backward pass.
+  /// \return The cached input gradient.
+  [[nodiscard]] auto input_gradient() const -> const container &;
+
+  /// \brief Drops the cached input and output layers, and the input gradient.
   auto drop_caches() const -> void;
 
+  /// \brief Returns views of the trainable parameters and their gradients.
+  /// \return The trainable parameters of the layer, empty if it has none.
+  ///
+  /// \details
+  /// The views remain valid as long as the layer is alive; optimizers update the parameters through them.
+  [[nodiscard]] virtual auto trainable_parameters() -> std::vector<TrainableParameter>;
+
+  /// \brief Resets the accumulated gradients of the trainable parameters to zero.
+  ///
+  /// \details
+  /// Layers without trainable parameters have nothing to reset.
+  virtual auto zero_gradients() const -> void;
+
   /// \brief Forward pass.
   /// \param[in] input The input layer.
   /// \return A reference to self.
   [[nodiscard]] virtual auto forward_pass(const container &input) const -> const AbstractLayer & = 0;
+
+  /// \brief Forward pass for inference, which writes into caller-provided memory and caches nothing.
+  /// \param[in] input The input layer, of shape (samples, inputs).
+  /// \param[out] output The output layer, of shape (samples, `neurons()`); it must not overlap \p input.
+  ///
+  /// \note Either view may also carry the per-sample shapes of the layers, e.g., (samples, height, width,
+  /// channels), rather than a matrix; layers only rely on the number of samples and on the total.
+  ///
+  /// \details
+  /// The output is identical to that of `forward_pass`, which is implemented in terms of this function, but
+  /// neither the input nor the output is copied into the layer. Implementations must not modify the layer in
+  /// any way, so that several threads can run inference on it at the same time.
+  ///
+  /// \see ExecutionContext
+  virtual auto infer(TensorView<const value_type> input, TensorView<value_type> output) const -> void = 0;
+
+  /// \brief Backward pass.
+  /// \param[in] output_gradient The gradient of the loss w.r.t. the output layer of the last forward pass.
+  /// \return A reference to self.
+  ///
+  /// \details
+  /// The backward pass computes the gradient w.r.t. the input layer, which becomes the output gradient of the
+  /// preceding layer, and accumulates the gradients of the trainable parameters. Gradients of parameters are
+  /// accumulated rather than overwritten so that several batches can contribute to one update; they are reset
+  /// by `zero_gradients`.
+  ///
+  /// This function throws an exception if the shape of \p output_gradient differs from that of the output
+  /// layer.
+  ///
+  /// \throws ShapeError
+  [[nodiscard]] virtual auto backward_pass(const container &output_gradient) const -> const AbstractLayer & = 0;
 };
 
 }
@@ -20,6 +20,7 @@
 
 #include <functional>
 #include <memory>
+#include <span>
 #include <string>
 
 #include "typeAliases.hh"
@@ -73,6 +74,26 @@ struct ActivationFunction {
   /// \param[in] x X coordinate.
   /// \return The derivative of the function at \p x.
   [[nodiscard]] virtual auto derivative(value_type x) const -> value_type = 0;
+
+  /// \brief Evaluates the function element-wise over a span.
+  /// \param[in] x The input span.
+  /// \param[out] y The output span.
+  ///
+  /// \details
+  /// Both spans must be of the same size; they may alias each other exactly. The default implementation invokes
+  /// the function call operator for each element. Functions backed by vectorized kernels override it.
+  ///
+  /// \see vmath
+  virtual auto apply(std::span<const value_type> x, std::span<value_type> y) const -> void;
+
+  /// \brief Evaluates the derivative of the function element-wise over a span.
+  /// \param[in] x The input span.
+  /// \param[out] y The output span.
+  ///
+  /// \details
+  /// Both spans must be of the same size; they may alias each other exactly. The default implementation invokes
+  /// `derivative` for each element.
+  virtual auto apply_derivative(std::span<const value_type> x, std::span<value_type> y) const -> void;
 };
 
 /// \brief The `ActFuncWrapper` class wraps an activation function and allows you to switch between different
@@ -148,6 +169,26 @@ class ActFuncWrapper {
   /// \brief Returns the derivative of the function.
   /// \return Derivative function of the function.
   [[nodiscard]] auto derivative() const -> std::function<value_type(value_type)>;
+
+  /// \brief Evaluates the function element-wise over a span.
+  /// \param[in] x The input span.
+  /// \param[out] y The output span.
+  ///
+  /// \details
+  /// This function throws an exception if \p x and \p y differ in size.
+  ///
+  /// \throws ShapeError
+  auto apply(std::span<const value_type> x, std::span<value_type> y) const -> void;
+
+  /// \brief Evaluates the derivative of the function element-wise over a span.
+  /// \param[in] x The input span.
+  /// \param[out] y The output span.
+  ///
+  /// \details
+  /// This function throws an exception if \p x and \p y differ in size.
+  ///
+  /// \throws ShapeError
+  auto apply_derivative(std::span<const value_type> x, std::span<value_type> y) const -> void;
 };
 
 /// \brief `ArcTan` activation function.
@@ -227,6 +268,11 @@ struct ELU : public ActivationFunction {
   /// \param[in] x X coordinate.
   /// \return The derivative of the function at \p x.
   [[nodiscard]] auto derivative(value_type x) const -> value_type override;
+
+  /// \brief Evaluates the function element-wise over a span.
+  /// \param[in] x The input span.
+  /// \param[out] y The output span.
+  auto apply(std::span<const value_type> x, std::span<value_type> y) const -> void override;
 };
 
 /// \brief `Gaussian` activation function.
@@ -252,6 +298,11 @@ struct Gaussian : public ActivationFunction {
   /// \param[in] x X coordinate.
   /// \return The derivative of the function at \p x.
   [[nodiscard]] auto derivative(value_type x) const -> value_type override;
+
+  /// \brief Evaluates the function element-wise over a span.
+  /// \param[in] x The input span.
+  /// \param[out] y The output span.
+  auto apply(std::span<const value_type> x, std::span<value_type> y) const -> void override;
 };
 
 /// \brief `GELU` activation function.
@@ -282,6 +333,11 @@ struct GELU : public ActivationFunction {
   /// \param[in] x X coordinate.
   /// \return The derivative of the function at \p x.
   [[nodiscard]] auto derivative(value_type x) const -> value_type override;
+
+  /// \brief Evaluates the function element-wise over a span.
+  /// \param[in] x The input span.
+  /// \param[out] y The output span.
+  auto apply(std::span<const value_type> x, std::span<value_type> y) const -> void override;
 };
 
 /// \brief `LeakyReLU` activation function.
@@ -385,6 +441,16 @@ struct Sigmoid : public ActivationFunction {
   /// \param[in] x X coordinate.
   /// \return The derivative of the function at \p x.
   [[nodiscard]] auto derivative(value_type x) const -> value_type override;
+
+  /// \brief Evaluates the function element-wise over a span.
+  /// \param[in] x The input span.
+  /// \param[out] y The output span.
+  auto apply(std::span<const value_type> x, std::span<value_type> y) const -> void override;
+
+  /// \brief Evaluates the derivative of the function element-wise over a span.
+  /// \param[in] x The input span.
+  /// \param[out] y The output span.
+  auto apply_derivative(std::span<const value_type> x, std::span<value_type> y) const -> void override;
 };
 
 /// \brief `Softplus` activation function.
@@ -410,6 +476,11 @@ struct Softplus : public ActivationFunction {
   /// \param[in] x X coordinate.
   /// \return The derivative of the function at \p x.
   [[nodiscard]] auto derivative(value_type x) const -> value_type override;
+
+  /// \brief Evaluates the function element-wise over a span.
+  /// \param[in] x The input span.
+  /// \param[out] y The output span.
+  auto apply(std::span<const value_type> x, std::span<value_type> y) const -> void override;
 };
 
 /// \brief `Swish` activation function.
@@ -435,6 +506,11 @@ struct Swish : public ActivationFunction {
   /// \param[in] x X coordinate.
   /// \return The derivative of the function at \p x.
   [[nodiscard]] auto derivative(value_type x) const -> value_type override;
+
+  /// \brief Evaluates the function element-wise over a span.
+  /// \param[in] x The input span.
+  /// \param[out] y The output span.
+  auto apply(std::span<const value_type> x, std::span<value_type> y) const -> void override;
 };
 
 /// \brief `TanH` activation function.
@@ -460,6 +536,16 @@ struct TanH : public ActivationFunction {
   /// \param[in] x X coordinate.
   /// \return The derivative of the function at \p x.
   [[nodiscard]] auto derivative(value_type x) const -> value_type override;
+
+  /// \brief Evaluates the function element-wise over a span.
+  /// \param[in] x The input span.
+  /// \param[out] y The output span.
+  auto apply(std::span<const value_type> x, std::span<value_type> y) const -> void override;
+
+  /// \brief Evaluates the derivative of the function element-wise over a span.
+  /// \param[in] x The input span.
+  /// \param[out] y The output span.
+  auto apply_derivative(std::span<const value_type> x, std::span<value_type> y) const -> void override;
 };
 
 }
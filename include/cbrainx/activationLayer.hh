@@ -18,6 +18,8 @@
 #ifndef CBRAINX__ACTIVATION_LAYER_HH_
 #define CBRAINX__ACTIVATION_LAYER_HH_
 
+#include <memory>
+
 #include "abstractLayer.hh"
 #include "activationFunctions.hh"
 #include "typeAliases.hh"
@@ -42,6 +44,12 @@ namespace cbx {
 ///  Î - Input (Matrix)  : Shape => (m, n)
 ///  Ô - Output (Matrix) : Shape => (m, n)
 ///
+/// The backward pass propagates the gradient through the derivative of the activation function.
+///
+/// Formula: ∂Î = ∂Ô ∘ ζ'(Î)
+///
+/// where the symbol `∘` denotes element-wise multiplication.
+///
 /// \see Activation
 class ActivationLayer : public AbstractLayer {
  private:
@@ -86,6 +94,14 @@ class ActivationLayer : public AbstractLayer {
   /// \return A reference to self.
   auto operator=(ActivationLayer &&other) noexcept -> ActivationLayer &;
 
+  // /////////////////////////////////////////////
+  // Accessors and Mutators
+  // /////////////////////////////////////////////
+
+  /// \brief Returns the activation function of the layer.
+  /// \return An immutable reference to the activation function.
+  [[nodiscard]] auto function() const -> const ActFuncWrapper &;
+
   // /////////////////////////////////////////////
   // Query Functions
   // /////////////////////////////////////////////
@@ -98,6 +114,11 @@ class ActivationLayer : public AbstractLayer {
   /// \return The number of modifiable parameters in the layer.
   [[nodiscard]] auto parameters() const -> size_type override;
 
+  /// \brief Returns the shape of the output layer of one sample.
+  /// \param[in] input_shape The shape of the input layer of one sample.
+  /// \return \p input_shape, as the layer is applied element by element.
+  [[nodiscard]] auto output_shape(const Shape &input_shape) const -> Shape override;
+
   /// \brief Returns the type of the layer.
   /// \return The type of the layer.
   ///
@@ -112,6 +133,14 @@ class ActivationLayer : public AbstractLayer {
   /// \return Information about the layer's properties as a string.
   [[nodiscard]] auto property() const -> std::string override;
 
+  // /////////////////////////////////////////////
+  // Utility
+  // /////////////////////////////////////////////
+
+  /// \brief Returns a deep copy of the layer.
+  /// \return A new layer with its own parameters, gradients and caches.
+  [[nodiscard]] auto clone() const -> std::shared_ptr<AbstractLayer> override;
+
   // /////////////////////////////////////////////
   // Core Functionality
   // /////////////////////////////////////////////
@@ -120,6 +149,18 @@ class ActivationLayer : public AbstractLayer {
   /// \param[in] input The input layer.
   /// \return A reference to self.
   [[nodiscard]] auto forward_pass(const container &input) const -> const AbstractLayer & override;
+
+  /// \brief Forward pass for inference, which writes into caller-provided memory and caches nothing.
+  /// \param[in] input The input layer.
+  /// \param[out] output The output layer, of the same shape as \p input; it must not overlap \p input.
+  auto infer(TensorView<const value_type> input, TensorView<value_type> output) const -> void override;
+
+  /// \brief Backward pass.
+  /// \param[in] output_gradient The gradient of the loss w.r.t. the output layer of the last forward pass.
+  /// \return A reference to self.
+  ///
+  /// \throws ShapeError
+  [[nodiscard]] auto backward_pass(const container &output_gradient) const -> const AbstractLayer & override;
 };
 
 }
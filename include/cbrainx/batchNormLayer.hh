@@ -0,0 +1,339 @@
+// Copyright 2021 CBrainX
+// Project URL: https://github.com/mansoormemon/cbrainx
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Copyright (c) 2021 Mansoor Ahmed Memon <mansoorahmed.one@gmail.com>
+#ifndef CBRAINX__BATCH_NORM_LAYER_HH_
+#define CBRAINX__BATCH_NORM_LAYER_HH_
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "abstractLayer.hh"
+#include "shape.hh"
+#include "tensor.hh"
+#include "typeAliases.hh"
+
+namespace cbx {
+
+/// \brief The `BatchNormLayer` class represents a batch normalization layer.
+///
+/// \details
+/// Batch normalization standardizes every feature of its input, i.e., every element of the last axis, and then
+/// rescales it with a trainable scale and shift. Each sample may have any shape, e.g., a vector of neurons or
+/// an image, in which case the channels are normalized over all pixels.
+///
+/// The forward pass of this layer performs the subsequent operation, feature by feature.
+///
+/// Formula: Ô = Ɣ ⋅ (Î - μ) / √(σ² + ε) + Ƀ
+///
+/// where:
+///  Î - Input (Tensor)   : Shape => (m, ..., f)
+///  Ɣ - Scale (Vector)   : Shape => (f)
+///  Ƀ - Shift (Vector)   : Shape => (f)
+///  Ô - Output (Tensor)  : Shape => (m, ..., f)
+///
+/// In training mode, the mean μ and the variance σ² are those of the batch. They are computed in a single
+/// parallel pass with Welford's algorithm: fixed-size chunks of rows accumulate their own moments, which are
+/// then merged in chunk order, so the statistics do not depend on the number of threads. The running
+/// statistics track exponential moving averages of the batch statistics (with the unbiased variance).
+///
+/// In inference mode, and always in `infer`, the running statistics are used instead, which turns the layer
+/// into a fixed affine transformation per feature. When a network is compiled, such a layer is folded into the
+/// weights and biases of a dense layer or a convolution right before it (see `fold`), so that it costs nothing
+/// at serving time.
+///
+/// \note During `NeuralNet::fit`, each replica normalizes its own share of the batch, and the running
+/// statistics of the replicas are averaged into the network after every batch, weighted by their shares.
+/// During `NeuralNet::fit_async`, they are averaged after every epoch.
+///
+/// \see LayerType AbstractLayer ExecutionPlan
+class BatchNormLayer : public AbstractLayer {
+ private:
+  /// \brief The shape of the input layer of one sample.
+  Shape input_shape_ = {};
+
+  /// \brief The weight of the running statistics in their moving averages.
+  value_type momentum_ = {};
+
+  /// \brief A small constant added to the variance for numerical stability.
+  value_type epsilon_ = {};
+
+  /// \brief A flag indicating whether the forward pass normalizes with the statistics of the batch.
+  bool training_ = true;
+
+  /// \brief A vector of trainable scales, one per feature.
+  container gamma_ = {};
+
+  /// \brief A vector of trainable shifts, one per feature.
+  container beta_ = {};
+
+  /// \brief The moving average of the mean of every feature, which the forward pass updates in training mode.
+  mutable container running_mean_ = {};
+
+  /// \brief The moving average of the variance of every feature.
+  mutable container running_variance_ = {};
+
+  /// \brief The accumulated gradient of the loss w.r.t. the scales.
+  ///
+  /// \note The gradients of a layer constructed from existing parameters are allocated on first use.
+  mutable container gamma_gradients_ = {};
+
+  /// \brief The accumulated gradient of the loss w.r.t. the shifts.
+  mutable container beta_gradients_ = {};
+
+  /// \brief The standardized input of the last forward pass, i.e., (Î - μ) / √(σ² + ε).
+  mutable container normalized_ = {};
+
+  /// \brief The reciprocal standard deviations used by the last forward pass.
+  mutable container inverse_deviations_ = {};
+
+  /// \brief A flag indicating whether the last forward pass used the statistics of the batch.
+  mutable bool used_batch_statistics_ = {};
+
+  // /////////////////////////////////////////////
+  // Helpers
+  // /////////////////////////////////////////////
+
+  /// \brief Returns the number of rows of features held by an input layer.
+  /// \param[in] shape The shape of the input layer.
+  /// \return The number of rows, i.e., the number of samples times the rows of one sample.
+  ///
+  /// \details
+  /// This function throws an exception if \p shape does not hold a whole number of samples.
+  ///
+  /// \throws ShapeError
+  auto _m_count_rows(const Shape &shape) const -> size_type;
+
+  /// \brief Allocates zeroed gradients unless they are already allocated.
+  auto _m_allocate_gradients() const -> void;
+
+ public:
+  // /////////////////////////////////////////////
+  // Constructors and Destructors
+  // /////////////////////////////////////////////
+
+  /// \brief Parameterized constructor.
+  /// \param[in] input_shape The shape of the input layer of one sample, whose last axis holds the features.
+  /// \param[in] momentum The weight of the running statistics in their moving averages.
+  /// \param[in] epsilon A small constant added to the variance for numerical stability.
+  ///
+  /// \details
+  /// The scales start at one, the shifts at zero, and the running statistics at zero means and unit
+  /// variances. This function throws an exception if the input shape is empty, if the momentum is not in
+  /// [0, 1], or if epsilon is not positive.
+  ///
+  /// \throws ValueError
+  explicit BatchNormLayer(const Shape &input_shape, value_type momentum = 0.99F, value_type epsilon = 1e-3F);
+
+  /// \brief Constructs a layer from existing parameters, e.g., those of a model file.
+  /// \param[in] input_shape The shape of the input layer of one sample, whose last axis holds the features.
+  /// \param[in] gamma The scales of shape (features).
+  /// \param[in] beta The shifts of shape (features).
+  /// \param[in] running_mean The running means of shape (features).
+  /// \param[in] running_variance The running variances of shape (features).
+  /// \param[in] momentum The weight of the running statistics in their moving averages.
+  /// \param[in] epsilon A small constant added to the variance for numerical stability.
+  ///
+  /// \details
+  /// This function throws an exception if the parameters do not match the features of the input shape.
+  ///
+  /// \throws ShapeError
+  /// \throws ValueError
+  BatchNormLayer(const Shape &input_shape, container gamma, container beta, container running_mean,
+                 container running_variance, value_type momentum, value_type epsilon);
+
+  /// \brief Default copy constructor.
+  /// \param[in] other Source layer.
+  BatchNormLayer(const BatchNormLayer &other) = default;
+
+  /// \brief Default move constructor.
+  /// \param[in] other Source layer.
+  BatchNormLayer(BatchNormLayer &&other) noexcept = default;
+
+  /// \brief Default destructor.
+  ~BatchNormLayer() override = default;
+
+  // /////////////////////////////////////////////
+  // Assignment Operators
+  // /////////////////////////////////////////////
+
+  /// \brief Default copy assignment operator.
+  /// \param[in] other Source layer.
+  /// \return A reference to self.
+  auto operator=(const BatchNormLayer &other) -> BatchNormLayer & = default;
+
+  /// \brief Default move assignment operator.
+  /// \param[in] other Source layer.
+  /// \return A reference to self.
+  auto operator=(BatchNormLayer &&other) noexcept -> BatchNormLayer & = default;
+
+  // /////////////////////////////////////////////
+  // Accessors and Mutators
+  // /////////////////////////////////////////////
+
+  /// \brief Returns the scales of the layer.
+  /// \return An immutable reference to the scales.
+  [[nodiscard]] auto gamma() const -> const container &;
+
+  /// \brief Returns the shifts of the layer.
+  /// \return An immutable reference to the shifts.
+  [[nodiscard]] auto beta() const -> const container &;
+
+  /// \brief Returns the running means.
+  /// \return An immutable reference to the running means.
+  [[nodiscard]] auto running_mean() const -> const container &;
+
+  /// \brief Returns the running variances.
+  /// \return An immutable reference to the running variances.
+  [[nodiscard]] auto running_variance() const -> const container &;
+
+  /// \brief Overwrites the running statistics.
+  /// \param[in] mean The running means of shape (features).
+  /// \param[in] variance The running variances of shape (features).
+  /// \return A reference to self.
+  ///
+  /// \details
+  /// This function throws an exception if either tensor does not hold one value per feature.
+  ///
+  /// \throws ShapeError
+  auto set_running_statistics(const container &mean, const container &variance) -> BatchNormLayer &;
+
+  /// \brief Returns the accumulated gradient w.r.t. the scales.
+  /// \return An immutable reference to the gradient of the scales.
+  [[nodiscard]] auto gamma_gradients() const -> const container &;
+
+  /// \brief Returns the accumulated gradient w.r.t. the shifts.
+  /// \return An immutable reference to the gradient of the shifts.
+  [[nodiscard]] auto beta_gradients() const -> const container &;
+
+  /// \brief Returns the weight of the running statistics in their moving averages.
+  /// \return The momentum.
+  [[nodiscard]] auto momentum() const -> value_type;
+
+  /// \brief Returns the constant added to the variance.
+  /// \return The epsilon.
+  [[nodiscard]] auto epsilon() const -> value_type;
+
+  /// \brief Returns whether the forward pass normalizes with the statistics of the batch.
+  /// \return True in training mode.
+  [[nodiscard]] auto is_training() const -> bool;
+
+  /// \brief Switches between training and inference mode.
+  /// \param[in] training If true, the forward pass normalizes with the statistics of the batch and updates the
+  /// running statistics; otherwise, it normalizes with the running statistics.
+  /// \return A reference to self.
+  auto set_training(bool training) -> BatchNormLayer &;
+
+  /// \brief Returns the shape of the input layer of one sample.
+  /// \return The input shape.
+  [[nodiscard]] auto input_shape() const -> const Shape &;
+
+  // /////////////////////////////////////////////
+  // Query Functions
+  // /////////////////////////////////////////////
+
+  /// \brief Returns the number of neurons in the layer.
+  /// \return The number of elements of the output layer of one sample.
+  [[nodiscard]] auto neurons() const -> size_type override;
+
+  /// \brief Returns the number of modifiable parameters in the layer.
+  /// \return The number of scales and shifts; the running statistics are not trained.
+  [[nodiscard]] auto parameters() const -> size_type override;
+
+  /// \brief Returns the shape of the output layer of one sample.
+  /// \param[in] input_shape The shape of the input layer of one sample (unused, as the layer knows its own).
+  /// \return The output shape, which is that of the input.
+  [[nodiscard]] auto output_shape(const Shape &input_shape) const -> Shape override;
+
+  /// \brief Returns the type of the layer.
+  /// \return The type of the layer.
+  ///
+  /// \see LayerType
+  [[nodiscard]] auto type() const -> LayerType override;
+
+  // /////////////////////////////////////////////
+  // Informative
+  // /////////////////////////////////////////////
+
+  /// \brief Returns a string with information about the layer's properties.
+  /// \return Information about the layer's properties as a string.
+  [[nodiscard]] auto property() const -> std::string override;
+
+  // /////////////////////////////////////////////
+  // Utility
+  // /////////////////////////////////////////////
+
+  /// \brief Returns a deep copy of the layer.
+  /// \return A new layer with its own parameters, statistics, gradients and caches.
+  [[nodiscard]] auto clone() const -> std::shared_ptr<AbstractLayer> override;
+
+  /// \brief Folds the normalization, as done in inference mode, into the layer that precedes it.
+  /// \param[in] layer The preceding layer.
+  /// \return A new layer that computes both layers at once, or null if \p layer cannot absorb the
+  /// normalization.
+  ///
+  /// \details
+  /// With the per-feature scale s = Ɣ / √(σ² + ε) of the running statistics, the normalization of a dense layer
+  /// or a convolution whose outputs are the features of this layer is absorbed by scaling the columns of its
+  /// weights (the filters of its kernel) and adjusting its biases.
+  ///
+  /// Formulae:
+  ///  Ŵ' = Ŵ ⋅ diag(s)
+  ///  Ƀ' = (Ƀ - μ) ⋅ s + Ƀₙ
+  ///
+  /// where Ƀₙ denotes the shifts of this layer. The new layer has its own parameters, so later updates of
+  /// either layer are not reflected in it.
+  [[nodiscard]] auto fold(const AbstractLayer &layer) const -> std::shared_ptr<AbstractLayer>;
+
+  // /////////////////////////////////////////////
+  // Core Functionality
+  // /////////////////////////////////////////////
+
+  /// \brief Forward pass.
+  /// \param[in] input The input layer.
+  /// \return A reference to self.
+  ///
+  /// \details
+  /// In training mode, this function also updates the running statistics.
+  ///
+  /// \throws ShapeError
+  [[nodiscard]] auto forward_pass(const container &input) const -> const AbstractLayer & override;
+
+  /// \brief Forward pass for inference, which normalizes with the running statistics and caches nothing.
+  /// \param[in] input The input layer.
+  /// \param[out] output The output layer, holding `neurons()` elements per sample; it may alias \p input.
+  ///
+  /// \throws ShapeError
+  auto infer(TensorView<const value_type> input, TensorView<value_type> output) const -> void override;
+
+  /// \brief Backward pass.
+  /// \param[in] output_gradient The gradient of the loss w.r.t. the output layer of the last forward pass.
+  /// \return A reference to self.
+  ///
+  /// \throws ShapeError
+  [[nodiscard]] auto backward_pass(const container &output_gradient) const -> const AbstractLayer & override;
+
+  /// \brief Returns views of the scales and the shifts, and of their gradients.
+  /// \return The trainable parameters of the layer.
+  [[nodiscard]] auto trainable_parameters() -> std::vector<TrainableParameter> override;
+
+  /// \brief Resets the accumulated gradients of the scales and the shifts to zero.
+  auto zero_gradients() const -> void override;
+};
+
+}
+
+#endif
@@ -21,20 +21,39 @@
 #include "abstractLayer.hh"
 #include "activationFunctions.hh"
 #include "activationLayer.hh"
+#include "batchNormLayer.hh"
+#include "conv2DLayer.hh"
+#include "convolution.hh"
+#include "cpuFeatures.hh"
 #include "customViews.hh"
 #include "denseLayer.hh"
 #include "exceptions.hh"
+#include "executionContext.hh"
+#include "executionPlan.hh"
+#include "gemm.hh"
 #include "image.hh"
 #include "imgProc.hh"
 #include "iterators.hh"
 #include "lossFunctions.hh"
 #include "neuralNet.hh"
+#include "numa.hh"
+#include "optimizers.hh"
+#include "pipeline.hh"
+#include "pooling.hh"
+#include "serve.hh"
 #include "shape.hh"
+#include "smallMatmul.hh"
 #include "softmax.hh"
+#include "spscRing.hh"
 #include "stopwatch.hh"
 #include "tensor.hh"
+#include "tensorOps.hh"
+#include "tensorView.hh"
+#include "threadPool.hh"
+#include "tune.hh"
 #include "typeAliases.hh"
 #include "typeConcepts.hh"
 #include "version.hh"
+#include "vmath.hh"
 
 #endif
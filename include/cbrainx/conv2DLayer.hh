@@ -0,0 +1,283 @@
+// Copyright 2021 CBrainX
+// Project URL: https://github.com/mansoormemon/cbrainx
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Copyright (c) 2021 Mansoor Ahmed Memon <mansoorahmed.one@gmail.com>
+#ifndef CBRAINX__CONV2D_LAYER_HH_
+#define CBRAINX__CONV2D_LAYER_HH_
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "abstractLayer.hh"
+#include "convolution.hh"
+#include "shape.hh"
+#include "tensor.hh"
+#include "typeAliases.hh"
+
+namespace cbx {
+
+/// \brief The `Conv2DLayer` class represents a layer of 2D convolutional filters.
+///
+/// \details
+/// A convolutional layer slides a bank of small filters over the height and width of its input, so that every
+/// neuron only sees a window of the previous layer and all windows share the same weights. Each sample is an
+/// image of shape (height, width, channels), i.e., a batch is laid out as NHWC; an input of shape (height,
+/// width) has a single channel.
+///
+/// The forward pass of this layer performs the subsequent operation.
+///
+/// Formula: Ô = Î ⊛ Ķ + Ƀ
+///
+/// where:
+///  Î - Input (Tensor)   : Shape => (m, h, w, c)
+///  Ķ - Kernel (Tensor)  : Shape => (kh, kw, c, f)
+///  Ƀ - Biases (Vector)  : Shape => (f)
+///  Ô - Output (Tensor)  : Shape => (m, oh, ow, f)
+///
+/// and, the symbol `⊛` denotes a 2D convolution (see `conv2d`), which is lowered to a blocked, multithreaded
+/// matrix multiplication or computed with the Winograd algorithm.
+///
+/// The backward pass propagates the gradient and accumulates the gradients of the parameters.
+///
+/// Formulae:
+///  ∂Î  = fold(∂Ô ⊙ Ķᵀ)
+///  ∂Ķ += unfold(Î)ᵀ ⊙ ∂Ô
+///  ∂Ƀ += ⅀ [pixels] ∂Ô
+///
+/// \see LayerType AbstractLayer conv2d
+class Conv2DLayer : public AbstractLayer {
+ private:
+  /// \brief The shape of the input layer of one sample, i.e., (height, width, channels).
+  Shape input_shape_ = {};
+
+  /// \brief The shape of the output layer of one sample, i.e., (output height, output width, filters).
+  Shape output_shape_ = {};
+
+  /// \brief The geometry of the convolution.
+  Conv2DParams params_ = {};
+
+  /// \brief A tensor of trainable filters of shape (kernel height, kernel width, channels, filters).
+  container kernel_ = {};
+
+  /// \brief A tensor of trainable biases, one per filter.
+  container biases_ = {};
+
+  /// \brief The accumulated gradient of the loss w.r.t. the kernel.
+  ///
+  /// \note The gradients of a layer constructed from existing parameters are allocated on first use.
+  mutable container kernel_gradients_ = {};
+
+  /// \brief The accumulated gradient of the loss w.r.t. the biases.
+  mutable container bias_gradients_ = {};
+
+  // /////////////////////////////////////////////
+  // Helpers
+  // /////////////////////////////////////////////
+
+  /// \brief Normalizes the input shape to (height, width, channels) and derives the output shape.
+  ///
+  /// \details
+  /// This function throws an exception if the input shape is not that of an image, or if the kernel, the
+  /// biases and the geometry do not form a convolution of it.
+  ///
+  /// \throws RankError
+  /// \throws ShapeError
+  /// \throws ValueError
+  auto _m_initialize_shapes() -> void;
+
+  /// \brief Returns the number of samples held by an input layer.
+  /// \param[in] shape The shape of the input layer.
+  /// \return The number of samples.
+  ///
+  /// \details
+  /// This function throws an exception if \p shape does not hold a whole image per sample.
+  ///
+  /// \throws ShapeError
+  auto _m_count_samples(const Shape &shape) const -> size_type;
+
+  /// \brief Allocates zeroed gradients unless they are already allocated.
+  auto _m_allocate_gradients() const -> void;
+
+ public:
+  // /////////////////////////////////////////////
+  // Constructors and Destructors
+  // /////////////////////////////////////////////
+
+  /// \brief Parameterized constructor.
+  /// \param[in] input_shape The shape of the input layer of one sample, i.e., (height, width[, channels]).
+  /// \param[in] filters The number of filters, i.e., the channels of the output.
+  /// \param[in] kernel_size The height and width of the filters.
+  /// \param[in] stride The step between successive windows.
+  /// \param[in] padding The number of zeros added to each side.
+  ///
+  /// \throws RankError
+  /// \throws ValueError
+  Conv2DLayer(const Shape &input_shape, size_type filters, size_type kernel_size, size_type stride = 1,
+              size_type padding = 0);
+
+  /// \brief Parameterized constructor.
+  /// \param[in] input_shape The shape of the input layer of one sample, i.e., (height, width[, channels]).
+  /// \param[in] filters The number of filters, i.e., the channels of the output.
+  /// \param[in] kernel_size The height and width of the filters.
+  /// \param[in] params The geometry of the convolution.
+  ///
+  /// \throws RankError
+  /// \throws ValueError
+  Conv2DLayer(const Shape &input_shape, size_type filters, size_type kernel_size, const Conv2DParams &params);
+
+  /// \brief Constructs a layer from existing parameters, e.g., those of a model file.
+  /// \param[in] input_shape The shape of the input layer of one sample, i.e., (height, width[, channels]).
+  /// \param[in] kernel The filters of shape (kernel height, kernel width, channels, filters).
+  /// \param[in] biases The biases of shape (filters).
+  /// \param[in] params The geometry of the convolution.
+  ///
+  /// \details
+  /// This function throws an exception if the parameters do not form a convolution of the input shape.
+  ///
+  /// \throws RankError
+  /// \throws ShapeError
+  /// \throws ValueError
+  Conv2DLayer(const Shape &input_shape, container kernel, container biases, const Conv2DParams &params);
+
+  /// \brief Default copy constructor.
+  /// \param[in] other Source layer.
+  Conv2DLayer(const Conv2DLayer &other) = default;
+
+  /// \brief Move constructor.
+  /// \param[in] other Source layer.
+  Conv2DLayer(Conv2DLayer &&other) noexcept;
+
+  /// \brief Default destructor.
+  ~Conv2DLayer() override = default;
+
+  // /////////////////////////////////////////////
+  // Assignment Operators
+  // /////////////////////////////////////////////
+
+  /// \brief Default copy assignment operator.
+  /// \param[in] other Source layer.
+  /// \return A reference to self.
+  auto operator=(const Conv2DLayer &other) -> Conv2DLayer & = default;
+
+  /// \brief Move assignment operator.
+  /// \param[in] other Source layer.
+  /// \return A reference to self.
+  auto operator=(Conv2DLayer &&other) noexcept -> Conv2DLayer &;
+
+  // /////////////////////////////////////////////
+  // Accessors and Mutators
+  // /////////////////////////////////////////////
+
+  /// \brief Returns the filters of the layer.
+  /// \return An immutable reference to the kernel of shape (kernel height, kernel width, channels, filters).
+  [[nodiscard]] auto kernel() const -> const container &;
+
+  /// \brief Returns the biases of the layer.
+  /// \return An immutable reference to the biases.
+  [[nodiscard]] auto biases() const -> const container &;
+
+  /// \brief Returns the accumulated gradient w.r.t. the kernel.
+  /// \return An immutable reference to the kernel gradient.
+  [[nodiscard]] auto kernel_gradients() const -> const container &;
+
+  /// \brief Returns the accumulated gradient w.r.t. the biases.
+  /// \return An immutable reference to the bias gradient.
+  [[nodiscard]] auto bias_gradients() const -> const container &;
+
+  /// \brief Returns the geometry of the convolution.
+  /// \return An immutable reference to the parameters of the convolution.
+  [[nodiscard]] auto params() const -> const Conv2DParams &;
+
+  /// \brief Returns the shape of the input layer of one sample.
+  /// \return The input shape, i.e., (height, width, channels).
+  [[nodiscard]] auto input_shape() const -> const Shape &;
+
+  // /////////////////////////////////////////////
+  // Query Functions
+  // /////////////////////////////////////////////
+
+  /// \brief Returns the number of neurons in the layer.
+  /// \return The number of elements of the output layer of one sample.
+  [[nodiscard]] auto neurons() const -> size_type override;
+
+  /// \brief Returns the number of modifiable parameters in the layer.
+  /// \return The number of modifiable parameters in the layer.
+  [[nodiscard]] auto parameters() const -> size_type override;
+
+  /// \brief Returns the shape of the output layer of one sample.
+  /// \param[in] input_shape The shape of the input layer of one sample (unused, as the layer knows its own).
+  /// \return The output shape, i.e., (output height, output width, filters).
+  [[nodiscard]] auto output_shape(const Shape &input_shape) const -> Shape override;
+
+  /// \brief Returns the type of the layer.
+  /// \return The type of the layer.
+  ///
+  /// \see LayerType
+  [[nodiscard]] auto type() const -> LayerType override;
+
+  // /////////////////////////////////////////////
+  // Informative
+  // /////////////////////////////////////////////
+
+  /// \brief Returns a string with information about the layer's properties.
+  /// \return Information about the layer's properties as a string.
+  [[nodiscard]] auto property() const -> std::string override;
+
+  // /////////////////////////////////////////////
+  // Utility
+  // /////////////////////////////////////////////
+
+  /// \brief Returns a deep copy of the layer.
+  /// \return A new layer with its own parameters, gradients and caches.
+  [[nodiscard]] auto clone() const -> std::shared_ptr<AbstractLayer> override;
+
+  // /////////////////////////////////////////////
+  // Core Functionality
+  // /////////////////////////////////////////////
+
+  /// \brief Forward pass.
+  /// \param[in] input The input layer, holding one image of `input_shape()` per sample.
+  /// \return A reference to self.
+  ///
+  /// \throws ShapeError
+  [[nodiscard]] auto forward_pass(const container &input) const -> const AbstractLayer & override;
+
+  /// \brief Forward pass for inference, which writes into caller-provided memory and caches nothing.
+  /// \param[in] input The input layer, holding one image of `input_shape()` per sample.
+  /// \param[out] output The output layer, holding `neurons()` elements per sample; it must not overlap
+  /// \p input.
+  ///
+  /// \throws ShapeError
+  auto infer(TensorView<const value_type> input, TensorView<value_type> output) const -> void override;
+
+  /// \brief Backward pass.
+  /// \param[in] output_gradient The gradient of the loss w.r.t. the output layer of the last forward pass.
+  /// \return A reference to self.
+  ///
+  /// \throws ShapeError
+  [[nodiscard]] auto backward_pass(const container &output_gradient) const -> const AbstractLayer & override;
+
+  /// \brief Returns views of the kernel and the biases, and of their gradients.
+  /// \return The trainable parameters of the layer.
+  [[nodiscard]] auto trainable_parameters() -> std::vector<TrainableParameter> override;
+
+  /// \brief Resets the accumulated gradients of the kernel and the biases to zero.
+  auto zero_gradients() const -> void override;
+};
+
+}
+
+#endif
@@ -0,0 +1,232 @@
+// Copyright 2021 CBrainX
+// Project URL: https://github.com/mansoormemon/cbrainx
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Copyright (c) 2021 Mansoor Ahmed Memon <mansoorahmed.one@gmail.com>
+#ifndef CBRAINX__CONVOLUTION_HH_
+#define CBRAINX__CONVOLUTION_HH_
+
+#include "gemm.hh"
+#include "shape.hh"
+#include "tensor.hh"
+#include "tensorView.hh"
+#include "typeAliases.hh"
+
+namespace cbx {
+
+/// \brief Algorithms for computing a 2D convolution.
+///
+/// \details
+/// | Algorithm     | Applicability                    | Multiplications | Relative error bound |
+/// | ------------- | -------------------------------- | :-------------: | :------------------: |
+/// | `Im2col`      | Any                              | 1               | 1e-6                 |
+/// | `Winograd2x2` | 3x3 kernel, unit stride/dilation | 1 / 2.25        | 1e-6                 |
+/// | `Winograd4x4` | 3x3 kernel, unit stride/dilation | 1 / 4           | 1e-5                 |
+///
+/// The error bounds are relative to the sum of the magnitudes of the terms of an output, i.e., `Σ|x·w|`. They
+/// hold with a margin of about ten for uniformly distributed data; inputs with a wide dynamic range fare
+/// worse with `Winograd4x4`, whose transforms involve larger constants.
+enum class ConvAlgorithm { Auto, Im2col, Winograd2x2, Winograd4x4 };
+
+/// \brief Geometry of a 2D convolution.
+///
+/// \details
+/// Padding is symmetric and filled with zeros. A dilation of `d` spreads the taps of the kernel `d` pixels
+/// apart, i.e., a dilation of one denotes a dense kernel.
+///
+/// With `ConvAlgorithm::Auto`, the fastest algorithm whose error bound does not exceed `tolerance` is chosen
+/// among those applicable to the geometry; Winograd is also skipped when the channels are too few for its
+/// transforms to pay off.
+struct Conv2DParams {
+  /// \brief Step between successive windows along the height.
+  usize stride_h = 1;
+
+  /// \brief Step between successive windows along the width.
+  usize stride_w = 1;
+
+  /// \brief Rows of zeros added above and below the input.
+  usize padding_h = 0;
+
+  /// \brief Columns of zeros added to the left and right of the input.
+  usize padding_w = 0;
+
+  /// \brief Spacing between the taps of the kernel along the height.
+  usize dilation_h = 1;
+
+  /// \brief Spacing between the taps of the kernel along the width.
+  usize dilation_w = 1;
+
+  /// \brief The algorithm to be used.
+  ConvAlgorithm algorithm = ConvAlgorithm::Auto;
+
+  /// \brief The largest acceptable relative error bound when the algorithm is chosen automatically.
+  f32 tolerance = 1e-4F;
+
+  /// \brief Returns parameters that are identical along both spatial axes.
+  /// \param[in] stride The step between successive windows.
+  /// \param[in] padding The number of zeros added to each side.
+  /// \param[in] dilation The spacing between the taps of the kernel.
+  /// \return The parameters.
+  [[nodiscard]] static auto square(usize stride, usize padding = 0, usize dilation = 1) -> Conv2DParams {
+    return {stride, stride, padding, padding, dilation, dilation, ConvAlgorithm::Auto, 1e-4F};
+  }
+};
+
+/// \brief Returns the shape of the result of a 2D convolution.
+/// \param[in] input The shape of the input, i.e., (batch, height, width, channels).
+/// \param[in] kernel The shape of the kernel, i.e., (kernel height, kernel width, channels, filters).
+/// \param[in] params The geometry of the convolution.
+/// \return The shape of the result, i.e., (batch, output height, output width, filters).
+///
+/// \details
+/// This function throws an exception if:
+///     * Either shape is not of rank 4.
+///     * The channels of the input and the kernel differ.
+///     * A stride or dilation is zero, or the dilated kernel does not fit in the padded input.
+///
+/// \throws RankError
+/// \throws ShapeError
+/// \throws ValueError
+[[nodiscard]] auto conv2d_output_shape(const Shape &input, const Shape &kernel, const Conv2DParams &params = {})
+    -> Shape;
+
+/// \brief Returns the algorithm that `conv2d` uses for the given shapes.
+/// \param[in] input The shape of the input, i.e., (batch, height, width, channels).
+/// \param[in] kernel The shape of the kernel, i.e., (kernel height, kernel width, channels, filters).
+/// \param[in] params The geometry of the convolution.
+/// \return The resolved algorithm, never `ConvAlgorithm::Auto`.
+///
+/// \details
+/// This function throws an exception if the shapes are invalid or if the requested algorithm is not
+/// applicable to the geometry.
+///
+/// \throws RankError
+/// \throws ShapeError
+/// \throws ValueError
+[[nodiscard]] auto conv2d_algorithm(const Shape &input, const Shape &kernel, const Conv2DParams &params = {})
+    -> ConvAlgorithm;
+
+/// \brief Computes a 2D convolution (more precisely, a cross-correlation) of a batch of images.
+/// \param[in] input The input of shape (batch, height, width, channels), i.e., NHWC.
+/// \param[in] kernel The filters of shape (kernel height, kernel width, channels, filters), i.e., HWIO.
+/// \param[in] params The geometry of the convolution.
+/// \return The result of shape (batch, output height, output width, filters).
+///
+/// \details
+/// The convolution is lowered to a matrix multiplication. Each output pixel becomes a row of the unfolded
+/// input (im2col) holding the taps of its window in (kernel row, kernel column, channel) order, which is also
+/// the row order of the kernel viewed as a matrix. The unfolded matrix is never materialized as a whole;
+/// instead, it is built in tiles of output pixels that fit in the cache, each of which is multiplied right
+/// away into its rows of the result. Tiles are processed in parallel on the global pool. Pointwise (1x1,
+/// unit stride, unpadded) convolutions skip the unfolding altogether.
+///
+/// 3x3 convolutions with unit stride and dilation may instead use the Winograd algorithm F(2x2, 3x3) or
+/// F(4x4, 3x3), which trades multiplications for cheap linear transforms of the input, the filters and the
+/// products. The transformed filters are cached, keyed by the address and the contents of \p kernel, so that
+/// repeated inference with the same weights transforms them only once. The element-wise stage is batched into
+/// one matrix multiplication per position of the transformed tile.
+///
+/// \throws RankError
+/// \throws ShapeError
+/// \throws ValueError
+///
+/// \see conv2d_output_shape
+[[nodiscard]] auto conv2d(const Tensor<f32> &input, const Tensor<f32> &kernel, const Conv2DParams &params = {})
+    -> Tensor<f32>;
+
+/// \brief Computes a 2D convolution of a batch of images into caller-provided memory.
+/// \param[in] input The input of shape (batch, height, width, channels), i.e., NHWC.
+/// \param[in] kernel The filters of shape (kernel height, kernel width, channels, filters), i.e., HWIO.
+/// \param[out] output The result of shape (batch, output height, output width, filters); it must not overlap
+/// \p input.
+/// \param[in] params The geometry of the convolution.
+/// \param[in] epilogue The callback invoked on each block of \p output right after it is final, if any.
+///
+/// \details
+/// This function computes the same result as the overload that returns a tensor, which is implemented in terms
+/// of it, but allocates nothing beyond the scratch tiles of the unfolded input.
+///
+/// The output is viewed as a matrix of (output pixels, filters), and the arguments of \p epilogue are the first
+/// pixel, the first filter, the number of pixels and the number of filters of a block. Blocks are disjoint and
+/// may be handed to different threads at the same time. Like the epilogue of `gemm`, it saves a separate pass
+/// over the output for element-wise work such as adding biases.
+///
+/// This function throws an exception if the shape of \p output differs from the shape of the result.
+///
+/// \throws RankError
+/// \throws ShapeError
+/// \throws ValueError
+auto conv2d(TensorView<const f32> input, const Tensor<f32> &kernel, TensorView<f32> output,
+            const Conv2DParams &params = {}, const GemmEpilogue &epilogue = {}) -> void;
+
+/// \brief Computes a 2D convolution with identical geometry along both spatial axes.
+/// \param[in] input The input of shape (batch, height, width, channels).
+/// \param[in] kernel The filters of shape (kernel height, kernel width, channels, filters).
+/// \param[in] stride The step between successive windows.
+/// \param[in] padding The number of zeros added to each side.
+/// \param[in] dilation The spacing between the taps of the kernel.
+/// \return The result of shape (batch, output height, output width, filters).
+///
+/// \throws RankError
+/// \throws ShapeError
+/// \throws ValueError
+///
+/// \see conv2d(const Tensor<f32> &, const Tensor<f32> &, const Conv2DParams &)
+[[nodiscard]] auto conv2d(const Tensor<f32> &input, const Tensor<f32> &kernel, usize stride, usize padding = 0,
+                          usize dilation = 1) -> Tensor<f32>;
+
+/// \brief Computes the gradient of the loss w.r.t. the input of a 2D convolution.
+/// \param[in] output_gradient The gradient w.r.t. the result, of shape (batch, output height, output width,
+/// filters).
+/// \param[in] kernel The filters of shape (kernel height, kernel width, channels, filters).
+/// \param[out] input_gradient The gradient w.r.t. the input, of shape (batch, height, width, channels).
+/// \param[in] params The geometry of the convolution.
+///
+/// \details
+/// The gradient of every output pixel is multiplied with the transposed kernel into the gradient of its
+/// unfolded window, which is then folded back, i.e., added to the pixels that the window covers. Since windows
+/// of one image overlap, images rather than tiles are distributed over the threads of the global pool.
+///
+/// This function throws an exception if the shapes do not describe the same convolution.
+///
+/// \throws RankError
+/// \throws ShapeError
+/// \throws ValueError
+auto conv2d_input_gradient(TensorView<const f32> output_gradient, const Tensor<f32> &kernel,
+                           TensorView<f32> input_gradient, const Conv2DParams &params = {}) -> void;
+
+/// \brief Accumulates the gradient of the loss w.r.t. the kernel of a 2D convolution.
+/// \param[in] input The input of shape (batch, height, width, channels).
+/// \param[in] output_gradient The gradient w.r.t. the result, of shape (batch, output height, output width,
+/// filters).
+/// \param[in, out] kernel_gradient The accumulator of shape (kernel height, kernel width, channels, filters).
+/// \param[in] params The geometry of the convolution.
+///
+/// \details
+/// The gradient is the product of the transposed unfolded input and the gradient of the result, built tile by
+/// tile like the forward pass. Each thread sums its tiles into a partial gradient of its own, and the partials
+/// are added to \p kernel_gradient in a fixed order, so the result does not depend on the timing of the
+/// threads.
+///
+/// This function throws an exception if the shapes do not describe the same convolution.
+///
+/// \throws RankError
+/// \throws ShapeError
+/// \throws ValueError
+auto conv2d_kernel_gradient(TensorView<const f32> input, TensorView<const f32> output_gradient,
+                            TensorView<f32> kernel_gradient, const Conv2DParams &params = {}) -> void;
+
+}
+
+#endif
@@ -0,0 +1,87 @@
+// Copyright 2021 CBrainX
+// Project URL: https://github.com/mansoormemon/cbrainx
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Copyright (c) 2021 Mansoor Ahmed Memon <mansoorahmed.one@gmail.com>
+
+#ifndef CBRAINX__CPU_FEATURES_HH_
+#define CBRAINX__CPU_FEATURES_HH_
+
+#include <string>
+
+#include "typeAliases.hh"
+
+namespace cbx {
+
+/// \brief Instruction sets for which the library ships vectorized kernels.
+///
+/// \details
+/// The enumerators are ordered by capability, i.e., a CPU that supports `AVX512` also supports `AVX2`.
+enum class ISA { Generic, AVX2, AVX512 };
+
+/// \brief The `CpuFeatures` class detects the instruction sets available at runtime and selects the one used
+/// by the vectorized kernels.
+///
+/// \details
+/// The kernels are compiled for every instruction set listed in `ISA` (provided that the build enables SIMD)
+/// and dispatched at runtime. By default, the most capable instruction set supported by both the CPU and the
+/// build is selected. The selection can be overridden with the environment variable `CBRAINX_ISA` (accepted
+/// values are `generic`, `avx2` and `avx512`) or programmatically using `CpuFeatures::set_active_isa`.
+///
+/// \see ISA
+class CpuFeatures {
+ public:
+  // /////////////////////////////////////////////
+  // Query Functions
+  // /////////////////////////////////////////////
+
+  /// \brief Returns the most capable instruction set supported by both the CPU and the build.
+  /// \return The most capable supported instruction set.
+  [[nodiscard]] static auto supported_isa() -> ISA;
+
+  /// \brief Returns the instruction set currently used by the vectorized kernels.
+  /// \return The active instruction set.
+  [[nodiscard]] static auto active_isa() -> ISA;
+
+  /// \brief Returns whether the given instruction set is supported or not.
+  /// \param[in] isa The instruction set to be checked.
+  /// \return True if \p isa is supported by both the CPU and the build.
+  [[nodiscard]] static auto is_supported(ISA isa) -> bool;
+
+  // /////////////////////////////////////////////
+  // Modifiers
+  // /////////////////////////////////////////////
+
+  /// \brief Selects the instruction set to be used by the vectorized kernels.
+  /// \param[in] isa The instruction set to be used.
+  ///
+  /// \details
+  /// This function throws an exception if \p isa is not supported.
+  ///
+  /// \throws ValueError
+  static auto set_active_isa(ISA isa) -> void;
+
+  // /////////////////////////////////////////////
+  // Informative
+  // /////////////////////////////////////////////
+
+  /// \brief Returns the name of the given instruction set as a string.
+  /// \param[in] isa The instruction set.
+  /// \return The name of the instruction set.
+  [[nodiscard]] static auto to_string(ISA isa) -> std::string;
+};
+
+}
+
+#endif
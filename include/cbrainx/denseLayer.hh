@@ -18,12 +18,24 @@
 #ifndef CBRAINX__DENSE_LAYER_HH_
 #define CBRAINX__DENSE_LAYER_HH_
 
+#include <memory>
+#include <utility>
+
 #include "abstractLayer.hh"
 #include "tensor.hh"
 #include "typeAliases.hh"
 
 namespace cbx {
 
+/// \brief The number of parameters from which `NeuralNet` shards a dense layer by default (16 MiB of weights).
+inline constexpr usize DENSE_SHARD_MIN_PARAMETERS = usize{1} << 22;
+
+/// \brief The minimum number of neurons per shard of a dense layer picked by default.
+inline constexpr usize DENSE_SHARD_MIN_NEURONS = 1024;
+
+/// \brief The granularity of the blocks of columns of a sharded dense layer, i.e., a cache line of weights.
+inline constexpr usize DENSE_SHARD_ALIGNMENT = 16;
+
 /// \brief The `DenseLayer` class represents a fully connected dense layer.
 ///
 /// \details
@@ -42,6 +54,19 @@ namespace cbx {
 ///
 /// and, the symbol `⊙` denotes dot product (typically matrix multiplication).
 ///
+/// The backward pass propagates the gradient and accumulates the gradients of the parameters.
+///
+/// Formulae:
+///  ∂Î  = ∂Ô ⊙ Ŵᵀ
+///  ∂Ŵ += Îᵀ ⊙ ∂Ô
+///  ∂Ƀ += ⅀ [rows] ∂Ô
+///
+/// A layer that is too wide for any cache may be sharded, i.e., its weight matrix is cut into blocks of
+/// columns, one per worker of the global thread pool. The forward pass then runs each block on its own worker,
+/// which multiplies the input with its columns directly into the matching columns of the shared output. The
+/// weights are placed by the same partition, i.e., each block is first touched by the worker that later reads
+/// it, so that with pinned workers (see `ThreadPool`) every NUMA node streams weights from its own memory.
+///
 /// \see LayerType AbstractLayer
 class DenseLayer : public AbstractLayer {
  private:
@@ -51,6 +76,40 @@ class DenseLayer : public AbstractLayer {
   /// \brief A tensor of trainable biases.
   container biases_ = {};
 
+  /// \brief The accumulated gradient of the loss w.r.t. the weights.
+  ///
+  /// \note The gradients of a layer constructed from existing parameters are allocated on first use.
+  mutable container weight_gradients_ = {};
+
+  /// \brief The accumulated gradient of the loss w.r.t. the biases.
+  mutable container bias_gradients_ = {};
+
+  /// \brief The number of blocks of columns that the forward pass is split into.
+  size_type shards_ = 1;
+
+  // /////////////////////////////////////////////
+  // Helpers
+  // /////////////////////////////////////////////
+
+  /// \brief Checks if an input layer can be multiplied with the weights.
+  /// \param[in] shape The shape of the input layer.
+  ///
+  /// \details
+  /// An input of a higher rank, e.g., the feature maps of a convolution, is flattened into one row per sample.
+  /// This function throws an exception if \p shape does not hold as many elements per sample as the weights
+  /// have rows.
+  ///
+  /// \throws ShapeError
+  auto _m_check_input_shape(const Shape &shape) const -> void;
+
+  /// \brief Allocates zeroed gradients unless they are already allocated.
+  auto _m_allocate_gradients() const -> void;
+
+  /// \brief Returns the block of columns of a shard.
+  /// \param[in] shard The index of the shard.
+  /// \return The first column and the number of columns of the shard.
+  [[nodiscard]] auto _m_shard_columns(size_type shard) const -> std::pair<size_type, size_type>;
+
  public:
   // /////////////////////////////////////////////
   // Constructors and Destructors
@@ -61,6 +120,18 @@ class DenseLayer : public AbstractLayer {
   /// \param[in] neurons The number of neurons in this layer.
   DenseLayer(size_type input_size, size_type neurons);
 
+  /// \brief Constructs a layer from existing parameters.
+  /// \param[in] input_size The number of neurons in the input layer.
+  /// \param[in] weights The weights, of shape (\p input_size, neurons).
+  /// \param[in] biases The biases, of shape (neurons).
+  ///
+  /// \details
+  /// The parameters are moved into the layer, so memory adopted by them, e.g., a mapped file, stays in place.
+  /// This function throws an exception if the shapes of the parameters do not match.
+  ///
+  /// \throws ShapeError
+  DenseLayer(size_type input_size, container weights, container biases);
+
   /// \brief Default copy constructor.
   /// \param[in] other Source layer.
   DenseLayer(const DenseLayer &other) = default;
@@ -86,6 +157,45 @@ class DenseLayer : public AbstractLayer {
   /// \return A reference to self.
   auto operator=(DenseLayer &&other) noexcept -> DenseLayer &;
 
+  // /////////////////////////////////////////////
+  // Accessors and Mutators
+  // /////////////////////////////////////////////
+
+  /// \brief Returns the weights of the layer.
+  /// \return An immutable reference to the weights, of shape (inputs, neurons).
+  [[nodiscard]] auto weights() const -> const container &;
+
+  /// \brief Returns the biases of the layer.
+  /// \return An immutable reference to the biases, of shape (neurons).
+  [[nodiscard]] auto biases() const -> const container &;
+
+  /// \brief Returns the accumulated gradient w.r.t. the weights.
+  /// \return An immutable reference to the weight gradients.
+  [[nodiscard]] auto weight_gradients() const -> const container &;
+
+  /// \brief Returns the accumulated gradient w.r.t. the biases.
+  /// \return An immutable reference to the bias gradients.
+  [[nodiscard]] auto bias_gradients() const -> const container &;
+
+  /// \brief Returns the number of shards of the forward pass.
+  /// \return The number of shards, one if the layer is not sharded.
+  [[nodiscard]] auto shards() const -> size_type;
+
+  /// \brief Shards the forward pass across the workers of the global thread pool.
+  /// \param[in] shards The number of shards; one turns sharding off.
+  /// \return A reference to self.
+  ///
+  /// \details
+  /// The number of shards is capped so that every shard covers at least `DENSE_SHARD_ALIGNMENT` columns. Unless
+  /// the layer ends up unsharded, the weights are moved into new memory placed by the partition of the shards,
+  /// which invalidates plans compiled from the layer and views of its weights taken before. This function
+  /// throws an exception if \p shards is zero.
+  ///
+  /// \throws ValueError
+  ///
+  /// \see ExecutionPlan
+  auto set_shards(size_type shards) -> DenseLayer &;
+
   // /////////////////////////////////////////////
   // Query Functions
   // /////////////////////////////////////////////
@@ -112,6 +222,14 @@ class DenseLayer : public AbstractLayer {
   /// \return Information about the layer's properties as a string.
   [[nodiscard]] auto property() const -> std::string override;
 
+  // /////////////////////////////////////////////
+  // Utility
+  // /////////////////////////////////////////////
+
+  /// \brief Returns a deep copy of the layer.
+  /// \return A new layer with its own parameters, gradients and caches.
+  [[nodiscard]] auto clone() const -> std::shared_ptr<AbstractLayer> override;
+
   // /////////////////////////////////////////////
   // Core Functionality
   // /////////////////////////////////////////////
@@ -119,7 +237,39 @@ class DenseLayer : public AbstractLayer {
   /// \brief Forward pass.
   /// \param[in] input The input layer.
   /// \return A reference to self.
+  ///
+  /// \details
+  /// A single sample, i.e., an input of shape (1, n), is multiplied with `gemv` rather than `matmul`. A sharded
+  /// layer multiplies each block of columns on its own worker, splitting the rows as well if there are fewer
+  /// shards than workers.
+  ///
+  /// \throws ShapeError
   [[nodiscard]] auto forward_pass(const container &input) const -> const AbstractLayer & override;
+
+  /// \brief Forward pass for inference, which writes into caller-provided memory and caches nothing.
+  /// \param[in] input The input layer, of shape (samples, inputs).
+  /// \param[out] output The output layer, of shape (samples, `neurons()`); it must not overlap \p input.
+  ///
+  /// \throws ShapeError
+  auto infer(TensorView<const value_type> input, TensorView<value_type> output) const -> void override;
+
+  /// \brief Backward pass.
+  /// \param[in] output_gradient The gradient of the loss w.r.t. the output layer of the last forward pass.
+  /// \return A reference to self.
+  ///
+  /// \details
+  /// The products with transposed matrices are computed by `gemm` without materializing the transposes, and the
+  /// bias gradient, i.e., the sum of the rows of \p output_gradient, by `gemv`.
+  ///
+  /// \throws ShapeError
+  [[nodiscard]] auto backward_pass(const container &output_gradient) const -> const AbstractLayer & override;
+
+  /// \brief Returns views of the weights and biases, and their gradients.
+  /// \return The trainable parameters of the layer.
+  [[nodiscard]] auto trainable_parameters() -> std::vector<TrainableParameter> override;
+
+  /// \brief Resets the accumulated gradients of the weights and biases to zero.
+  auto zero_gradients() const -> void override;
 };
 
 }
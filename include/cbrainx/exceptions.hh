@@ -91,6 +91,27 @@ class IndexOutOfBoundsError : public std::exception {
   [[nodiscard]] auto what() const noexcept -> str override;
 };
 
+/// \brief An object of `ModelIOError` class will be thrown as an exception to report errors during reading or
+/// writing a model to/from a disk.
+class ModelIOError : public std::exception {
+ private:
+  /// \brief Error message.
+  std::string msg_ = {};
+
+ public:
+  /// \brief Parameterized Constructor.
+  /// \tparam Args Data type of the arguments.
+  /// \param[in] fmt_str Format string.
+  /// \param[in] args Any optional arguments for \p fmt_str.
+  template <typename... Args>
+  explicit ModelIOError(std::string_view fmt_str, Args... args)
+      : msg_{fmt::vformat(fmt_str, fmt::make_format_args(args...))} {}
+
+  /// \brief Returns error description.
+  /// \return Error message.
+  [[nodiscard]] auto what() const noexcept -> str override;
+};
+
 /// \brief An object of the `RankError` class will be thrown as an exception to report errors due to an
 /// invalid interpretation of the tensor's rank.
 class RankError : public std::exception {
@@ -133,6 +154,27 @@ class ShapeError : public std::exception {
   [[nodiscard]] auto what() const noexcept -> str override;
 };
 
+/// \brief An object of the `SocketError` class will be thrown as an exception to report errors during
+/// communication over a socket.
+class SocketError : public std::exception {
+ private:
+  /// \brief Error message.
+  std::string msg_ = {};
+
+ public:
+  /// \brief Parameterized Constructor.
+  /// \tparam Args Data type of the arguments.
+  /// \param[in] fmt_str Format string.
+  /// \param[in] args Any optional arguments for \p fmt_str.
+  template <typename... Args>
+  explicit SocketError(std::string_view fmt_str, Args... args)
+      : msg_{fmt::vformat(fmt_str, fmt::make_format_args(args...))} {}
+
+  /// \brief Returns error description.
+  /// \return Error message.
+  [[nodiscard]] auto what() const noexcept -> str override;
+};
+
 /// \brief An object of `UnrecognizedColorModelError` class will be thrown as an exception to report errors when
 /// attempting to decode an unsupported color model.
 class UnrecognizedColorModelError : public std::exception {
@@ -0,0 +1,108 @@
+// Copyright 2021 CBrainX
+// Project URL: https://github.com/mansoormemon/cbrainx
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Copyright (c) 2021 Mansoor Ahmed Memon <mansoorahmed.one@gmail.com>
+#ifndef CBRAINX__EXECUTION_CONTEXT_HH_
+#define CBRAINX__EXECUTION_CONTEXT_HH_
+
+#include <span>
+#include <vector>
+
+#include "typeAliases.hh"
+
+namespace cbx {
+
+/// \brief The `ExecutionContext` class holds the mutable state of an inference call.
+///
+/// \details
+/// The layers of a network are never modified by inference; everything a call writes besides its result lives
+/// in a context. Several threads may therefore run inference on the same network concurrently, sharing one copy
+/// of the weights, as long as each of them passes its own context. A context is typically created once per
+/// thread and reused, so that its workspace, once grown to the largest batch, is never reallocated.
+///
+/// A context must not be used by two calls at the same time.
+///
+/// \see NeuralNet::infer
+class ExecutionContext {
+ public:
+  using value_type = f32;
+
+  using size_type = usize;
+
+ private:
+  /// \brief Scratch memory for intermediate layers.
+  std::vector<value_type> workspace_ = {};
+
+ public:
+  // /////////////////////////////////////////////
+  // Constructors and Destructors
+  // /////////////////////////////////////////////
+
+  /// \brief Default constructor.
+  ExecutionContext() = default;
+
+  /// \brief Default copy constructor.
+  /// \param[in] other Source context.
+  ExecutionContext(const ExecutionContext &other) = default;
+
+  /// \brief Default move constructor.
+  /// \param[in] other Source context.
+  ExecutionContext(ExecutionContext &&other) noexcept = default;
+
+  /// \brief Default destructor.
+  ~ExecutionContext() = default;
+
+  // /////////////////////////////////////////////
+  // Assignment Operators
+  // /////////////////////////////////////////////
+
+  /// \brief Default copy assignment operator.
+  /// \param[in] other Source context.
+  /// \return A reference to self.
+  auto operator=(const ExecutionContext &other) -> ExecutionContext & = default;
+
+  /// \brief Default move assignment operator.
+  /// \param[in] other Source context.
+  /// \return A reference to self.
+  auto operator=(ExecutionContext &&other) noexcept -> ExecutionContext & = default;
+
+  // /////////////////////////////////////////////
+  // Query Functions
+  // /////////////////////////////////////////////
+
+  /// \brief Returns the number of elements the workspace can hold without growing.
+  /// \return The capacity of the workspace.
+  [[nodiscard]] auto capacity() const noexcept -> size_type;
+
+  // /////////////////////////////////////////////
+  // Core Functionality
+  // /////////////////////////////////////////////
+
+  /// \brief Returns a workspace of the specified size.
+  /// \param[in] size The number of elements required.
+  /// \return A view of the first \p size elements of the workspace.
+  ///
+  /// \details
+  /// The workspace only grows; its contents are unspecified, and the view is invalidated by the next call that
+  /// requires a larger workspace.
+  [[nodiscard]] auto workspace(size_type size) -> std::span<value_type>;
+
+  /// \brief Releases the memory of the workspace.
+  auto release() -> void;
+};
+
+}
+
+#endif
@@ -0,0 +1,285 @@
+// Copyright 2021 CBrainX
+// Project URL: https://github.com/mansoormemon/cbrainx
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Copyright (c) 2021 Mansoor Ahmed Memon <mansoorahmed.one@gmail.com>
+#ifndef CBRAINX__EXECUTION_PLAN_HH_
+#define CBRAINX__EXECUTION_PLAN_HH_
+
+#include <list>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "abstractLayer.hh"
+#include "activationFunctions.hh"
+#include "executionContext.hh"
+#include "gemm.hh"
+#include "shape.hh"
+#include "tensor.hh"
+#include "typeAliases.hh"
+
+namespace cbx {
+
+/// \brief The `ExecutionPlan` class represents a network compiled for inference at a fixed batch size.
+///
+/// \details
+/// Compilation flattens the layers into a contiguous sequence of steps. Each step names the kernel that it
+/// runs, e.g., a dense layer of one sample runs `gemv` while a larger batch runs `gemm` with a blocking looked
+/// up once, and carries everything that kernel needs: the widths of its operands, raw pointers to the
+/// parameters, and the offsets of its input and output within the workspace of an `ExecutionContext`. Running
+/// the plan is a single switch per step over those fields, without any virtual call, list traversal or shape
+/// validation between layers.
+///
+/// Layers of types that have no dedicated kernel, e.g., convolutions and pooling, fall back to their virtual
+/// `infer`, and so do sharded dense layers, which distribute their columns over the workers themselves. Such
+/// steps are listed by `to_string` with the type of their layer.
+///
+/// Unless disabled, compilation also fuses the layers. An activation layer or a softmax that follows a step
+/// is folded into that step as an epilogue, which is applied in place to each block of the output while the
+/// block is still in cache: a dense layer followed by an activation becomes a single `gemm` whose epilogue adds
+/// the biases and applies the function, a final dense layer followed by a softmax normalizes its rows as they
+/// are produced, and consecutive activations collapse into one step. `Activation::Linear` is dropped
+/// altogether. Each folded layer saves a write and a read of an intermediate tensor, and the fused plan
+/// produces exactly the same outputs as the unfused one.
+///
+/// A batch normalization that directly follows a dense layer or a convolution is folded algebraically into
+/// the weights and biases of that layer (see `BatchNormLayer::fold`), so it adds no step at all. The fused
+/// plan then matches the unfused one up to rounding, and it owns the folded copy of the parameters, which does
+/// not follow later updates of the network.
+///
+/// A plan shares the parameters of the network it was compiled from and keeps its layers alive. In-place
+/// updates of the parameters, e.g., by an optimizer, are therefore seen by the plan, but layers added to or
+/// removed from the network afterwards are not. Like `NeuralNet::infer`, a plan may be run by several threads
+/// at once, each with its own context.
+///
+/// \see NeuralNet::compile
+class ExecutionPlan {
+ public:
+  using value_type = f32;
+
+  using size_type = usize;
+
+  using tensor_type = Tensor<value_type>;
+
+  using layers_type = std::list<std::shared_ptr<AbstractLayer>>;
+
+  /// \brief The kernels that a step can run.
+  enum class Kernel { DenseGemv, DenseSmall, DenseGemm, Activation, Softmax, Layer };
+
+  /// \brief The memory that an operand of a step refers to.
+  enum class Buffer { Input, Workspace, Output };
+
+ private:
+  /// \brief A location within one of the buffers of a run.
+  struct Operand {
+    /// \brief The buffer.
+    Buffer buffer = {};
+
+    /// \brief The offset of the first element within the buffer.
+    size_type offset = {};
+  };
+
+  /// \brief A resolved layer.
+  struct Step {
+    /// \brief The kernel to be run.
+    Kernel kernel = {};
+
+    /// \brief The number of values per sample read by the step.
+    size_type inputs = {};
+
+    /// \brief The number of values per sample written by the step.
+    size_type outputs = {};
+
+    /// \brief The input of the step.
+    Operand source = {};
+
+    /// \brief The output of the step.
+    Operand target = {};
+
+    /// \brief The weights of a dense step, of shape (inputs, outputs).
+    const value_type *weights = {};
+
+    /// \brief The biases of a dense step, of length `outputs`.
+    const value_type *biases = {};
+
+    /// \brief The blocking of a `DenseGemm` step.
+    GemmConfig config = {};
+
+    /// \brief The function of an `Activation` step.
+    ActFuncWrapper activation = {};
+
+    /// \brief The functions applied in place to the output of the step, in order.
+    std::vector<ActFuncWrapper> epilogue = {};
+
+    /// \brief A flag indicating whether a row-wise softmax is applied in place after the epilogue.
+    bool softmax = {};
+
+    /// \brief The layer of a `Layer` step.
+    const AbstractLayer *layer = {};
+  };
+
+  /// \brief The layers whose parameters the steps refer to.
+  std::vector<std::shared_ptr<AbstractLayer>> layers_ = {};
+
+  /// \brief The steps, in order of execution.
+  std::vector<Step> steps_ = {};
+
+  /// \brief The number of samples per run.
+  size_type batch_size_ = {};
+
+  /// \brief The number of input values per sample.
+  size_type input_size_ = {};
+
+  /// \brief The number of output values per sample.
+  size_type output_size_ = {};
+
+  /// \brief The number of elements of workspace required by a run.
+  size_type workspace_size_ = {};
+
+  /// \brief The number of passes over intermediate tensors saved by fusion.
+  size_type memory_passes_saved_ = {};
+
+  // /////////////////////////////////////////////
+  // Helpers
+  // /////////////////////////////////////////////
+
+  /// \brief Applies the biases and the epilogue of a step to a block of its output.
+  /// \param[in] step The step.
+  /// \param[in, out] y Pointer to the first row of the block within the output of the step.
+  /// \param[in] rows The number of rows of the block.
+  /// \param[in] col, cols The first column and the number of columns of the block.
+  ///
+  /// \details
+  /// The softmax of the step is only applied if the block spans whole rows.
+  static auto _s_finish(const Step &step, value_type *y, size_type rows, size_type col, size_type cols) -> void;
+
+ public:
+  // /////////////////////////////////////////////
+  // Constructors and Destructors
+  // /////////////////////////////////////////////
+
+  /// \brief Default constructor.
+  ///
+  /// \details
+  /// An empty plan has no steps; it must be assigned a compiled plan before being run.
+  ExecutionPlan() = default;
+
+  /// \brief Compiles a sequence of layers.
+  /// \param[in] input_shape The shape of the input layer (excluding the samples axis).
+  /// \param[in] layers The layers, in order.
+  /// \param[in] batch_size The number of samples per run.
+  /// \param[in] fuse If true, activations, softmaxes and batch normalizations are fused into the steps
+  /// preceding them.
+  ///
+  /// \details
+  /// This function throws an exception if \p batch_size is zero or if \p layers is empty.
+  ///
+  /// \throws ValueError
+  ExecutionPlan(const Shape &input_shape, const layers_type &layers, size_type batch_size, bool fuse = true);
+
+  /// \brief Default copy constructor.
+  /// \param[in] other Source plan.
+  ExecutionPlan(const ExecutionPlan &other) = default;
+
+  /// \brief Default move constructor.
+  /// \param[in] other Source plan.
+  ExecutionPlan(ExecutionPlan &&other) noexcept = default;
+
+  /// \brief Default destructor.
+  ~ExecutionPlan() = default;
+
+  // /////////////////////////////////////////////
+  // Assignment Operators
+  // /////////////////////////////////////////////
+
+  /// \brief Default copy assignment operator.
+  /// \param[in] other Source plan.
+  /// \return A reference to self.
+  auto operator=(const ExecutionPlan &other) -> ExecutionPlan & = default;
+
+  /// \brief Default move assignment operator.
+  /// \param[in] other Source plan.
+  /// \return A reference to self.
+  auto operator=(ExecutionPlan &&other) noexcept -> ExecutionPlan & = default;
+
+  // /////////////////////////////////////////////
+  // Query Functions
+  // /////////////////////////////////////////////
+
+  /// \brief Returns the number of samples per run.
+  /// \return The batch size.
+  [[nodiscard]] auto batch_size() const noexcept -> size_type;
+
+  /// \brief Returns the number of input values per sample.
+  /// \return The input size.
+  [[nodiscard]] auto input_size() const noexcept -> size_type;
+
+  /// \brief Returns the number of output values per sample.
+  /// \return The output size.
+  [[nodiscard]] auto output_size() const noexcept -> size_type;
+
+  /// \brief Returns the number of elements of workspace required by a run.
+  /// \return The workspace size.
+  [[nodiscard]] auto workspace_size() const noexcept -> size_type;
+
+  /// \brief Returns the number of passes over intermediate tensors saved by fusion.
+  /// \return The number of memory passes saved.
+  ///
+  /// \details
+  /// Every layer folded into the step before it, or dropped, would otherwise have read its input and written
+  /// its output in full, i.e., it saves two passes over a tensor of shape (`batch_size()`, width).
+  [[nodiscard]] auto memory_passes_saved() const noexcept -> size_type;
+
+  /// \brief Returns the kernels of the steps, in order of execution.
+  /// \return The kernels of the plan.
+  [[nodiscard]] auto kernels() const -> std::vector<Kernel>;
+
+  // /////////////////////////////////////////////
+  // Informative
+  // /////////////////////////////////////////////
+
+  /// \brief Returns a description of the steps, one per line.
+  /// \return The steps of the plan as a string.
+  [[nodiscard]] auto to_string() const -> std::string;
+
+  // /////////////////////////////////////////////
+  // Core Functionality
+  // /////////////////////////////////////////////
+
+  /// \brief Runs the plan on raw memory.
+  /// \param[in] input The input, of `batch_size() * input_size()` elements.
+  /// \param[out] output The output, of `batch_size() * output_size()` elements; it must not overlap \p input.
+  /// \param[in, out] context The context whose workspace holds the intermediate layers.
+  ///
+  /// \note This function performs no validation at all.
+  auto run(const value_type *input, value_type *output, ExecutionContext &context) const -> void;
+
+  /// \brief Runs the plan.
+  /// \param[in] input The input, of shape (`batch_size()`, ...input shape).
+  /// \param[in, out] context The context whose workspace holds the intermediate layers.
+  /// \return The output, of shape (`batch_size()`, `output_size()`).
+  ///
+  /// \details
+  /// The number of elements of \p input is checked once; the steps themselves perform no checks. This function
+  /// throws an exception if the plan is empty or if \p input does not hold `batch_size() * input_size()`
+  /// elements.
+  ///
+  /// \throws ShapeError
+  [[nodiscard]] auto run(const tensor_type &input, ExecutionContext &context) const -> tensor_type;
+};
+
+}
+
+#endif
@@ -0,0 +1,159 @@
+// Copyright 2021 CBrainX
+// Project URL: https://github.com/mansoormemon/cbrainx
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Copyright (c) 2021 Mansoor Ahmed Memon <mansoorahmed.one@gmail.com>
+#ifndef CBRAINX__GEMM_HH_
+#define CBRAINX__GEMM_HH_
+
+#include <functional>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "typeAliases.hh"
+
+namespace cbx {
+
+/// \brief Blocking parameters of the single-precision matrix multiplication.
+///
+/// \details
+/// The product is computed in the classic Goto fashion: a `kc × nc` panel of the right operand and an
+/// `mc × kc` block of the left operand are packed into contiguous buffers sized for the caches, and a
+/// register-blocked microkernel of shape `mr × nr` sweeps over them. The best parameters depend on the cache
+/// hierarchy and the vector width of the machine, hence they are chosen by `cbx::tune`.
+///
+/// \see cbx::tune
+struct GemmConfig {
+  /// \brief Rows of the left operand packed per block (sized for the L2 cache).
+  usize mc = 96;
+
+  /// \brief Depth of the packed blocks (sized for the L1 cache).
+  usize kc = 256;
+
+  /// \brief Columns of the right operand packed per panel (sized for the L3 cache).
+  usize nc = 2048;
+
+  /// \brief Rows of the register tile, zero along with `nr` meaning the tile preferred by the active
+  /// instruction set, i.e., the largest one whose accumulators fit in its vector registers.
+  usize mr = 0;
+
+  /// \brief Columns of the register tile, zero along with `mr` meaning the preferred tile.
+  usize nr = 0;
+
+  /// \brief Maximum number of threads, zero meaning all threads of the global pool.
+  usize threads = 0;
+
+  /// \brief Returns the parameters as a string.
+  /// \return A string of the form `mc=.. kc=.. nc=.. mr=.. nr=.. threads=..`.
+  [[nodiscard]] auto to_string() const -> std::string;
+
+  /// \brief Default equality operator.
+  auto operator==(const GemmConfig &other) const -> bool = default;
+};
+
+/// \brief Operations applied to the operands of `gemm` before multiplication.
+enum class MatrixOp { None, Transpose };
+
+/// \brief A callback invoked by `gemm` on each block of the accumulator once the block is final.
+///
+/// \details
+/// The arguments are the first row, the first column, the number of rows and the number of columns of the
+/// block, in that order. Blocks are disjoint and may be handed to different threads at the same time.
+using GemmEpilogue = std::function<void(usize, usize, usize, usize)>;
+
+/// \brief Returns the register tile shapes for which a microkernel is available.
+/// \return The supported (`mr`, `nr`) pairs.
+[[nodiscard]] auto gemm_microkernels() -> std::vector<std::pair<usize, usize>>;
+
+/// \brief Accumulates the product of two row-major matrices, i.e., `C += op(A) × op(B)`.
+/// \param[in] a The left operand; `op(A)` is of shape (\p m, \p k).
+/// \param[in] b The right operand; `op(B)` is of shape (\p k, \p n).
+/// \param[in, out] c The accumulator of shape (\p m, \p n).
+/// \param[in] m, n, k The dimensions of the product.
+/// \param[in] config The blocking parameters.
+/// \param[in] op_a, op_b The operations applied to \p a and \p b.
+///
+/// \details
+/// Every element of \p c accumulates its terms in ascending order of `k` with the multiply-add of the active
+/// instruction set, so the result does not depend on \p config. Blocks of rows are computed in parallel on the
+/// global pool, and so are parts of the columns of each block when there are fewer blocks than threads.
+///
+/// Transposed operands are never materialized; they are read transposed while being packed, e.g., a row-major
+/// matrix `X` of shape (\p k, \p m) is passed as \p a with `op_a = MatrixOp::Transpose` to compute `Xᵀ × B`.
+///
+/// This function throws an exception if any block size is zero or if no microkernel of the requested shape is
+/// available.
+///
+/// \throws ValueError
+auto gemm(const f32 *a, const f32 *b, f32 *c, usize m, usize n, usize k, const GemmConfig &config,
+          MatrixOp op_a = MatrixOp::None, MatrixOp op_b = MatrixOp::None) -> void;
+
+/// \brief Accumulates the product of two row-major matrices and post-processes each finished block of \p c.
+/// \param[in] a The left operand; `op(A)` is of shape (\p m, \p k).
+/// \param[in] b The right operand; `op(B)` is of shape (\p k, \p n).
+/// \param[in, out] c The accumulator of shape (\p m, \p n).
+/// \param[in] m, n, k The dimensions of the product.
+/// \param[in] config The blocking parameters.
+/// \param[in] epilogue The callback invoked on each block of \p c right after its last update.
+/// \param[in] op_a, op_b The operations applied to \p a and \p b.
+///
+/// \details
+/// The epilogue runs on the thread that computed the block while the block is still in cache, which saves a
+/// separate pass over \p c for element-wise work such as adding biases or applying an activation. If \p k is
+/// zero, it is invoked once on the whole of \p c, and if \p m or \p n is zero, it is not invoked at all.
+///
+/// \throws ValueError
+auto gemm(const f32 *a, const f32 *b, f32 *c, usize m, usize n, usize k, const GemmConfig &config,
+          const GemmEpilogue &epilogue, MatrixOp op_a = MatrixOp::None, MatrixOp op_b = MatrixOp::None) -> void;
+
+/// \brief Accumulates the product of two row-major submatrices with explicit leading dimensions.
+/// \param[in] a, lda The left operand and the number of elements per stored row of it.
+/// \param[in] b, ldb The right operand and the number of elements per stored row of it.
+/// \param[in, out] c, ldc The accumulator and the number of elements per stored row of it.
+/// \param[in] m, n, k The dimensions of the product.
+/// \param[in] config The blocking parameters.
+/// \param[in] epilogue The callback invoked on each block of \p c right after its last update, if any.
+/// \param[in] op_a, op_b The operations applied to \p a and \p b.
+///
+/// \details
+/// The operands may be parts of larger matrices, e.g., a block of columns of a weight matrix multiplied into
+/// the matching block of columns of an output, which lets several threads share one output without copies.
+/// The other overloads assume densely stored operands.
+///
+/// \throws ValueError
+auto gemm(const f32 *a, usize lda, const f32 *b, usize ldb, f32 *c, usize ldc, usize m, usize n, usize k,
+          const GemmConfig &config, const GemmEpilogue &epilogue = {}, MatrixOp op_a = MatrixOp::None,
+          MatrixOp op_b = MatrixOp::None) -> void;
+
+/// \brief The number of matrix elements from which `gemv` runs in parallel (1 MiB of weights).
+inline constexpr usize GEMV_PARALLEL_VOLUME = usize{1} << 18;
+
+/// \brief Accumulates the product of a row vector and a row-major matrix, i.e., `y += x × W`.
+/// \param[in] x The row vector of length \p k.
+/// \param[in] w The matrix of shape (\p k, \p n).
+/// \param[in, out] y The accumulator of length \p n.
+/// \param[in] k, n The dimensions of the product.
+/// \param[in] threads Maximum number of threads, zero meaning all threads of the global pool.
+///
+/// \details
+/// A matrix-vector product performs one multiply-add per element of \p w, so it is bound by memory bandwidth
+/// rather than arithmetic. Instead of packing, the matrix is streamed once with `vmath::gemv`. Large matrices
+/// are split into blocks of columns that are processed on separate cores, each streaming its own part of every
+/// row; products of less than `GEMV_PARALLEL_VOLUME` elements run on the calling thread.
+auto gemv(const f32 *x, const f32 *w, f32 *y, usize k, usize n, usize threads = 0) -> void;
+
+}
+
+#endif
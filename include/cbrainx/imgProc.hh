@@ -138,14 +138,14 @@ class ImgProc {
   /// \param[in] img The image to be inverted.
   /// \return A reference to \p img.
   template <BitDepth B>
-  static auto invert(Tensor<B> &img) noexcept -> Tensor<B> &;
+  static auto invert(Tensor<B> &img) -> Tensor<B> &;
 
   /// \brief Binarizes the given image.
   /// \tparam B Bit depth of the image.
   /// \param[in] img The image to be binarized.
   /// \return A reference to \p img.
   template <BitDepth B>
-  static auto binarize(Tensor<B> &img) noexcept -> Tensor<B> &;
+  static auto binarize(Tensor<B> &img) -> Tensor<B> &;
 
   /// \brief Resizes the given image.
   /// \tparam B Bit depth of the image.
@@ -98,6 +98,16 @@ struct LossFunction {
   /// \return The derivative of the function w.r.t. \p y_pred.
   [[nodiscard]] virtual auto derivative(const tensor_type &y_true, const tensor_type &y_pred) const
       -> value_type = 0;
+
+  /// \brief Returns the gradient of the mean loss w.r.t. each element of \p y_pred.
+  /// \param[in] y_true The observed values.
+  /// \param[in] y_pred The predicted values.
+  /// \return A tensor of the same shape as \p y_pred.
+  ///
+  /// \details
+  /// Unlike `derivative`, which condenses the slope into a single number, this is the seed of a backward pass.
+  [[nodiscard]] virtual auto gradient(const tensor_type &y_true, const tensor_type &y_pred) const
+      -> tensor_type = 0;
 };
 
 /// \brief The `LossFuncWrapper` class wraps a loss function and allows you to switch between different types at
@@ -178,6 +188,12 @@ class LossFuncWrapper {
   /// \param[in] y_pred The predicted values.
   /// \return The derivative of the function w.r.t. \p y_pred.
   [[nodiscard]] auto derivative(const tensor_type &y_true, const tensor_type &y_pred) const -> value_type;
+
+  /// \brief Returns the gradient of the mean loss w.r.t. each element of \p y_pred.
+  /// \param[in] y_true The observed values.
+  /// \param[in] y_pred The predicted values.
+  /// \return A tensor of the same shape as \p y_pred.
+  [[nodiscard]] auto gradient(const tensor_type &y_true, const tensor_type &y_pred) const -> tensor_type;
 };
 
 /// \brief The `MeanSquaredError` loss function.
@@ -236,6 +252,16 @@ struct MeanSquaredError : public LossFunction {
   /// \throws ShapeError
   [[nodiscard]] auto derivative(const tensor_type &y_true, const tensor_type &y_pred) const
       -> value_type override;
+
+  /// \brief Returns the gradient of the mean loss w.r.t. each element of \p y_pred.
+  /// \param[in] y_true The observed values.
+  /// \param[in] y_pred The predicted values.
+  /// \return A tensor of the same shape as \p y_pred.
+  ///
+  /// \throws RankError
+  /// \throws ShapeError
+  [[nodiscard]] auto gradient(const tensor_type &y_true, const tensor_type &y_pred) const
+      -> tensor_type override;
 };
 
 /// \brief The `BinaryCrossEntropy` loss function.
@@ -294,6 +320,16 @@ struct BinaryCrossEntropy : public LossFunction {
   /// \throws ShapeError
   [[nodiscard]] auto derivative(const tensor_type &y_true, const tensor_type &y_pred) const
       -> value_type override;
+
+  /// \brief Returns the gradient of the mean loss w.r.t. each element of \p y_pred.
+  /// \param[in] y_true The observed values.
+  /// \param[in] y_pred The predicted values.
+  /// \return A tensor of the same shape as \p y_pred.
+  ///
+  /// \throws RankError
+  /// \throws ShapeError
+  [[nodiscard]] auto gradient(const tensor_type &y_true, const tensor_type &y_pred) const
+      -> tensor_type override;
 };
 
 /// \brief The `CategoricalCrossEntropy` loss function.
@@ -352,6 +388,16 @@ struct CategoricalCrossEntropy : public LossFunction {
   /// \throws ShapeError
   [[nodiscard]] auto derivative(const tensor_type &y_true, const tensor_type &y_pred) const
       -> value_type override;
+
+  /// \brief Returns the gradient of the mean loss w.r.t. each element of \p y_pred.
+  /// \param[in] y_true The observed values.
+  /// \param[in] y_pred The predicted values.
+  /// \return A tensor of the same shape as \p y_pred.
+  ///
+  /// \throws RankError
+  /// \throws ShapeError
+  [[nodiscard]] auto gradient(const tensor_type &y_true, const tensor_type &y_pred) const
+      -> tensor_type override;
 };
 
 /// \brief The `SparseCrossEntropy` loss function.
@@ -382,6 +428,16 @@ struct CategoricalCrossEntropy : public LossFunction {
 ///
 /// \see Loss LossFunction
 struct SparseCrossEntropy : public LossFunction {
+ private:
+  /// \brief Gathers the clamped predicted probabilities of the positive classes.
+  /// \param[in] y_true The observed class indices.
+  /// \param[in] y_pred The predicted probabilities.
+  /// \return The probability of the positive class of each sample.
+  ///
+  /// \throws IndexOutOfBoundsError
+  static auto _s_positive_probabilities(const tensor_type &y_true, const tensor_type &y_pred) -> tensor_type;
+
+ public:
   /// \brief Returns the type of the loss function.
   /// \return The type of the loss function.
   [[nodiscard]] auto type() const -> Loss override;
@@ -413,6 +469,16 @@ struct SparseCrossEntropy : public LossFunction {
   /// \throws ShapeError
   [[nodiscard]] auto derivative(const tensor_type &y_true, const tensor_type &y_pred) const
       -> value_type override;
+
+  /// \brief Returns the gradient of the mean loss w.r.t. each element of \p y_pred.
+  /// \param[in] y_true The observed values.
+  /// \param[in] y_pred The predicted values.
+  /// \return A tensor of the same shape as \p y_pred.
+  ///
+  /// \throws RankError
+  /// \throws ShapeError
+  [[nodiscard]] auto gradient(const tensor_type &y_true, const tensor_type &y_pred) const
+      -> tensor_type override;
 };
 
 }
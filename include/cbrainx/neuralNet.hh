@@ -20,12 +20,24 @@
 
 #include <list>
 #include <memory>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
 
 #include "abstractLayer.hh"
+#include "denseLayer.hh"
+#include "executionContext.hh"
+#include "executionPlan.hh"
+#include "lossFunctions.hh"
+#include "optimizers.hh"
 #include "typeAliases.hh"
 
 namespace cbx {
 
+/// \brief The alignment in bytes of the parameters within a model file.
+inline constexpr usize MODEL_ALIGNMENT = 64;
+
 /// \brief A constraint to filter semantic data types representing a layer.
 /// \tparam T The data type to which the constraint is to be applied.
 ///
@@ -34,6 +46,40 @@ namespace cbx {
 template <typename T>
 concept ConcreteLayer = std::is_base_of_v<AbstractLayer, T> and not std::is_abstract_v<T>;
 
+/// \brief Statistics of one training epoch.
+///
+/// \see NeuralNet::fit
+struct EpochReport {
+  /// \brief The index of the epoch, starting from one.
+  usize epoch = {};
+
+  /// \brief The mean loss over all samples of the epoch, as measured before each update.
+  f32 loss = {};
+
+  /// \brief The number of samples processed.
+  usize samples = {};
+
+  /// \brief The number of replicas that processed a batch in parallel.
+  usize replicas = {};
+
+  /// \brief The wall-clock duration of the epoch in seconds.
+  f64 seconds = {};
+
+  /// \brief The number of parameter updates applied.
+  usize updates = {};
+
+  /// \brief The mean number of updates that other threads applied between reading the parameters and updating
+  /// them, i.e., zero for synchronous training.
+  f64 mean_staleness = {};
+
+  /// \brief The largest staleness of any update.
+  usize max_staleness = {};
+
+  /// \brief Returns the training throughput.
+  /// \return The number of samples processed per second.
+  [[nodiscard]] auto samples_per_second() const -> f64 { return seconds > 0 ? f64(samples) / seconds : 0; }
+};
+
 /// \brief The `NeuralNet` class represents a network of simulated neurons called an artificial neural network.
 ///
 /// \details
@@ -79,6 +125,12 @@ class NeuralNet {
   /// \brief A doubly-linked list of layers.
   container layers_ = {};
 
+  /// \brief The context of inference calls that do not supply their own.
+  ExecutionContext context_ = {};
+
+  /// \brief The number of parameters from which dense layers are sharded, zero meaning never.
+  size_type shard_threshold_ = DENSE_SHARD_MIN_PARAMETERS;
+
   // /////////////////////////////////////////////
   // Helpers
   // /////////////////////////////////////////////
@@ -100,7 +152,37 @@ class NeuralNet {
   /// network.
   ///
   /// \throws ShapeError
-  auto _m_match_input_shape(const Shape &shape) -> void;
+  auto _m_match_input_shape(const Shape &shape) const -> void;
+
+  /// \brief Validates a training set.
+  /// \param[in] x The input samples.
+  /// \param[in] y The observations.
+  /// \param[in] batch_size The number of samples per update.
+  ///
+  /// \details
+  /// This function throws an exception if the shape of \p x does not match the input shape of the network, if
+  /// \p x holds no samples, if \p y does not hold as many samples as \p x, or if \p batch_size is zero.
+  ///
+  /// \throws ShapeError
+  /// \throws ValueError
+  auto _m_check_training_set(const tensor_type &x, const tensor_type &y, size_type batch_size) -> void;
+
+  /// \brief Shards a dense layer according to the sharding policy of the network.
+  /// \param[in] layer The layer; layers of other types are left as they are.
+  ///
+  /// \details
+  /// A dense layer of at least `shard_threshold()` parameters is split into one shard per worker of the global
+  /// thread pool, but into no shard of less than `DENSE_SHARD_MIN_NEURONS` neurons; any other dense layer is
+  /// left unsharded.
+  auto _m_apply_shard_policy(AbstractLayer &layer) const -> void;
+
+  /// \brief Averages the running statistics of the batch normalizations of replicas of the network into the
+  /// network and copies the averages back into every replica.
+  /// \param[in, out] replicas The replicas, which must have the same layers as the network; the network itself
+  /// may be one of them.
+  /// \param[in] weights The weight of each replica in the averages, summing to one.
+  auto _m_merge_running_statistics(const std::vector<NeuralNet *> &replicas, const std::vector<f32> &weights)
+      -> void;
 
  public:
   // /////////////////////////////////////////////
@@ -225,6 +307,25 @@ class NeuralNet {
   /// \return A mutable reverse iterator pointing to the reverse ending of the container.
   auto rend() noexcept -> reverse_iterator;
 
+  // /////////////////////////////////////////////
+  // Accessors and Mutators
+  // /////////////////////////////////////////////
+
+  /// \brief Returns the number of parameters from which dense layers are sharded.
+  /// \return The sharding threshold, zero if sharding is disabled.
+  [[nodiscard]] auto shard_threshold() const -> size_type;
+
+  /// \brief Sets the number of parameters from which dense layers are sharded.
+  /// \param[in] parameters The sharding threshold; zero disables sharding.
+  /// \return A reference to self.
+  ///
+  /// \details
+  /// The policy is applied to every dense layer when it is added. Changing the threshold re-applies it to the
+  /// dense layers already in the network, overriding any shards set on them by hand.
+  ///
+  /// \see DenseLayer::set_shards
+  auto set_shard_threshold(size_type parameters) -> NeuralNet &;
+
   // /////////////////////////////////////////////
   // Query Functions
   // /////////////////////////////////////////////
@@ -237,6 +338,16 @@ class NeuralNet {
   /// \return The total number of trainable parameters.
   [[nodiscard]] auto total_parameters() const -> size_type;
 
+  /// \brief Returns the shape of the input layer.
+  /// \return The input shape (excluding the samples axis).
+  [[nodiscard]] auto input_shape() const -> const Shape &;
+
+  /// \brief Returns the shape of the output layer, i.e., that of the last layer or else of the input layer.
+  /// \return The output shape (excluding the samples axis).
+  ///
+  /// \see AbstractLayer::output_shape
+  [[nodiscard]] auto output_shape() const -> Shape;
+
   // /////////////////////////////////////////////
   // Informative
   // /////////////////////////////////////////////
@@ -244,6 +355,45 @@ class NeuralNet {
   /// \brief Prints a summary of the network.
   auto show_summary() const -> void;
 
+  // /////////////////////////////////////////////
+  // Utility
+  // /////////////////////////////////////////////
+
+  /// \brief Returns a deep copy of the network.
+  /// \return A network with clones of all layers.
+  ///
+  /// \see AbstractLayer::clone
+  [[nodiscard]] auto clone() const -> NeuralNet;
+
+  /// \brief Returns a network in which batch normalizations are folded into the layers preceding them.
+  /// \return A network that shares all other layers with this one.
+  ///
+  /// \details
+  /// The folded layers are computed once, with the running statistics at the time of the call, and are not
+  /// affected by later training. Plans compiled from the returned network share them, whereas every plan
+  /// compiled from this network folds its own copies.
+  ///
+  /// \see BatchNormLayer::fold compile
+  [[nodiscard]] auto fold() const -> NeuralNet;
+
+  /// \brief Writes the network to a model file.
+  /// \param[in] path The path of the file.
+  ///
+  /// \details
+  /// The file starts with a text header that describes the input shape and each layer, i.e., its type, its
+  /// shape, the geometry of a convolution or a pooling and its activation function, followed by a binary blob
+  /// of parameters in the native byte order. The blob and every tensor within it are aligned to
+  /// `MODEL_ALIGNMENT` bytes, so that `load` can map them without copying.
+  ///
+  /// This function throws an exception if the network contains a type of layer that cannot be saved, or if the
+  /// file cannot be written.
+  ///
+  /// \throws ValueError
+  /// \throws ModelIOError
+  ///
+  /// \see load
+  auto save(const std::string &path) const -> void;
+
   // /////////////////////////////////////////////
   // Modifiers
   // /////////////////////////////////////////////
@@ -253,12 +403,21 @@ class NeuralNet {
   /// \tparam Args The data type of arguments.
   /// \param[in] args Parameter list for the constructor of \p L.
   /// \return An immutable reference to the newly created layer, i.e., the last layer.
+  ///
+  /// \details
+  /// A layer that can be constructed from a shape, e.g., `Conv2DLayer`, receives the output shape of the
+  /// previous layer; any other layer receives its number of elements, i.e., a multi-dimensional output is
+  /// flattened.
   template <ConcreteLayer L, typename... Args>
   auto add(Args... args) -> const_reference {
-    auto [input_neurons] = input_shape_.unwrap<1>();
-    auto previous_layer_size = layers_.empty() ? input_neurons : layers_.back()->neurons();
-    layers_.emplace_back(std::make_shared<L>(previous_layer_size, args...));
+    auto previous_shape = output_shape();
+    if constexpr (std::is_constructible_v<L, const Shape &, Args...>) {
+      layers_.emplace_back(std::make_shared<L>(previous_shape, args...));
+    } else {
+      layers_.emplace_back(std::make_shared<L>(previous_shape.total(), args...));
+    }
     layers_.back()->set_id(i32(layers_.size()));
+    _m_apply_shard_policy(*layers_.back());
     return layers_.back();
   }
 
@@ -279,6 +438,187 @@ class NeuralNet {
   ///
   /// \throws ShapeError
   [[nodiscard]] auto forward_pass(tensor_type input) -> tensor_type;
+
+  /// \brief Forward pass for inference.
+  /// \param[in] input The input layer.
+  /// \return The output layer.
+  ///
+  /// \details
+  /// This function runs `infer` with the network's own context, so it must not be called concurrently; threads
+  /// that share a network pass their own contexts instead.
+  ///
+  /// \throws ShapeError
+  [[nodiscard]] auto infer(const tensor_type &input) -> tensor_type;
+
+  /// \brief Forward pass for inference with caller-owned state.
+  /// \param[in] input The input layer.
+  /// \param[in, out] context The context that holds the intermediate layers of this call.
+  /// \return The output layer.
+  ///
+  /// \details
+  /// Unlike `forward_pass`, this function leaves the layers untouched, so it cannot be followed by a backward
+  /// pass. The hidden layers are written alternately to two halves of a workspace of \p context sized to the
+  /// widest hidden layer, and the last layer writes straight into the result, so a call allocates nothing but
+  /// its output once the workspace has grown to the batch size.
+  ///
+  /// Any number of threads may call this function on the same network at the same time, provided that each
+  /// passes a different context and that the network is not trained or modified meanwhile.
+  ///
+  /// This function throws an exception if the input tensor's shape does not match the input shape of the
+  /// network.
+  ///
+  /// \throws ShapeError
+  ///
+  /// \see ExecutionContext
+  [[nodiscard]] auto infer(const tensor_type &input, ExecutionContext &context) const -> tensor_type;
+
+  /// \brief Compiles the network into a flat plan for inference at a fixed batch size.
+  /// \param[in] batch_size The number of samples per run.
+  /// \param[in] fuse If true, activations, softmaxes and batch normalizations are fused into the layers
+  /// preceding them.
+  /// \return The compiled plan.
+  ///
+  /// \details
+  /// Batch normalizations are folded into copies of the layers preceding them for each plan; compile plans for
+  /// several batch sizes from `fold()` instead to share one set of folded layers.
+  ///
+  /// This function throws an exception if \p batch_size is zero or if the network has no layers.
+  ///
+  /// \throws ValueError
+  ///
+  /// \see ExecutionPlan fold
+  [[nodiscard]] auto compile(size_type batch_size, bool fuse = true) const -> ExecutionPlan;
+
+  /// \brief Predicts the most likely classes for each sample.
+  /// \param[in] input The input layer.
+  /// \param[in] k The number of classes to be reported per sample.
+  /// \return A pair of tensors holding the scores of the top \p k classes and their indices, best first.
+  ///
+  /// \details
+  /// This function runs an inference pass and selects the top \p k entries along the last axis of the output.
+  /// It throws an exception if the input tensor's shape does not match the input shape of the network, or if
+  /// \p k is zero or exceeds the number of outputs.
+  ///
+  /// \throws ShapeError
+  /// \throws ValueError
+  ///
+  /// \see infer Tensor::topk
+  [[nodiscard]] auto predict(tensor_type input, size_type k = 1) -> std::pair<tensor_type, Tensor<size_type>>;
+
+  /// \brief Backward pass.
+  /// \param[in] output_gradient The gradient of the loss w.r.t. the output of the last forward pass.
+  /// \return The gradient of the loss w.r.t. the input of the last forward pass.
+  ///
+  /// \details
+  /// The gradient is propagated through the layers in reverse order, and each layer accumulates the gradients
+  /// of its trainable parameters.
+  ///
+  /// This function throws an exception if the shape of \p output_gradient does not match the output of the last
+  /// forward pass.
+  ///
+  /// \throws ShapeError
+  [[nodiscard]] auto backward_pass(tensor_type output_gradient) -> tensor_type;
+
+  /// \brief Resets the accumulated gradients of all layers to zero.
+  auto zero_gradients() -> void;
+
+  /// \brief Returns views of the trainable parameters of all layers, in order.
+  /// \return The trainable parameters of the network.
+  ///
+  /// \see Optimizer
+  [[nodiscard]] auto trainable_parameters() -> std::vector<TrainableParameter>;
+
+  /// \brief Trains the network with mini-batch gradient descent.
+  /// \param[in] x The input samples, of shape (samples, ...input shape).
+  /// \param[in] y The observations, with as many entries along the first axis as \p x.
+  /// \param[in] loss The loss function to be minimized.
+  /// \param[in] optimizer The optimizer that updates the parameters after each batch.
+  /// \param[in] batch_size The number of samples per update.
+  /// \param[in] epochs The number of passes over the samples.
+  /// \return The statistics of each epoch.
+  ///
+  /// \details
+  /// Batches are taken in order. Each batch is split into contiguous micro-batches, one per thread of the
+  /// global pool, and every thread runs the forward and backward passes of its micro-batch on its own replica
+  /// of the network, so the activations and gradient buffers of different threads never alias. The network
+  /// itself serves as the first replica. The gradients of all replicas are then summed with a tree reduction,
+  /// performed in parallel over slices of the parameters, the optimizer updates the parameters of the network,
+  /// and the new values are broadcast to the other replicas.
+  ///
+  /// Each micro-batch gradient is weighted by its share of the batch, so the update is the same as that of a
+  /// single pass over the whole batch, up to rounding. Batch normalizations are the exception: each replica
+  /// normalizes with the statistics of its own micro-batch, so the gradients, and thus the trained parameters,
+  /// depend on the number of threads. After every batch, the running statistics of the replicas are averaged,
+  /// weighted by their shares of the batch, into the network and copied back into every replica.
+  ///
+  /// This function throws an exception if the shape of \p x does not match the input shape of the network, if
+  /// \p y does not hold as many samples as \p x, or if \p batch_size is zero.
+  ///
+  /// \throws ShapeError
+  /// \throws ValueError
+  auto fit(const tensor_type &x, const tensor_type &y, const LossFuncWrapper &loss, Optimizer &optimizer,
+           size_type batch_size, size_type epochs) -> std::vector<EpochReport>;
+
+  /// \brief Trains the network with asynchronous, lock-free stochastic gradient descent (Hogwild).
+  /// \param[in] x The input samples, of shape (samples, ...input shape).
+  /// \param[in] y The observations, with as many entries along the first axis as \p x.
+  /// \param[in] loss The loss function to be minimized.
+  /// \param[in] learning_rate The step size of the updates.
+  /// \param[in] batch_size The number of samples per update.
+  /// \param[in] epochs The number of passes over the samples.
+  /// \return The statistics of each epoch, including the staleness of the updates.
+  ///
+  /// \details
+  /// Every thread of the global pool owns a replica of the network and repeatedly claims the next batch of the
+  /// epoch. It copies the current parameters of the network into its replica, computes the gradient of its
+  /// batch, and subtracts the scaled gradient from the parameters of the network without any synchronization
+  /// with the other threads. Parameters are read and written with relaxed atomic loads and stores, so a thread
+  /// may see a mix of old and new values and concurrent updates of the same parameter may overwrite each
+  /// other. Elements with a zero gradient are not written at all, which keeps the threads off each other's
+  /// cache lines when the gradients are sparse.
+  ///
+  /// The staleness of an update is the number of updates that other threads applied between the snapshot and
+  /// the update. Unlike `fit`, the result depends on the scheduling of the threads.
+  ///
+  /// The running statistics of batch normalizations are not parameters, so each replica updates its own from
+  /// the batches it claims; they are averaged into the network at the end of every epoch.
+  ///
+  /// This function throws an exception if the shape of \p x does not match the input shape of the network, if
+  /// \p y does not hold as many samples as \p x, if \p batch_size is zero, or if \p learning_rate is not
+  /// positive.
+  ///
+  /// \throws ShapeError
+  /// \throws ValueError
+  ///
+  /// \see fit
+  auto fit_async(const tensor_type &x, const tensor_type &y, const LossFuncWrapper &loss, f32 learning_rate,
+                 size_type batch_size, size_type epochs) -> std::vector<EpochReport>;
+
+  // /////////////////////////////////////////////////////////////
+  // Static Functions
+  // /////////////////////////////////////////////////////////////
+
+  /// \brief Reads a network from a model file.
+  /// \param[in] path The path of the file.
+  /// \return The network.
+  ///
+  /// \details
+  /// On POSIX systems, the file is mapped into memory privately and the parameters of the layers point into
+  /// the mapping, i.e., nothing is copied and pages are only read from disk when first touched. Training the
+  /// network afterwards modifies private copies of the touched pages and never the file. Elsewhere, the blob is
+  /// read into memory in one go.
+  ///
+  /// Sharding is disabled on the loaded network, i.e., its `shard_threshold()` is zero, because sharding a
+  /// dense layer copies its weights into memory placed by the shards. That trades the zero-copy load and the
+  /// sharing of the page cache between processes for locality on multi-socket machines; `set_shard_threshold`
+  /// opts into it.
+  ///
+  /// This function throws an exception if the file cannot be read or is not a valid model file.
+  ///
+  /// \throws ModelIOError
+  ///
+  /// \see save
+  [[nodiscard]] static auto load(const std::string &path) -> NeuralNet;
 };
 
 }
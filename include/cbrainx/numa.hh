@@ -0,0 +1,276 @@
+// Copyright 2021 CBrainX
+// Project URL: https://github.com/mansoormemon/cbrainx
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Copyright (c) 2021 Mansoor Ahmed Memon <mansoorahmed.one@gmail.com>
+#ifndef CBRAINX__NUMA_HH_
+#define CBRAINX__NUMA_HH_
+
+#include <memory>
+#include <new>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "typeAliases.hh"
+
+namespace cbx {
+
+/// \brief The `NumaTopology` class describes how the logical CPUs of the machine are grouped into NUMA nodes.
+///
+/// \details
+/// On Linux, the topology is read from `/sys/devices/system/node`. Elsewhere, or if that directory cannot be
+/// read, the machine is described as a single node spanning all hardware threads.
+///
+/// Besides the description, this class provides the two primitives the library needs in order to keep memory
+/// traffic local to a socket, i.e., pinning a thread to a CPU and interleaving the pages of a buffer across
+/// all nodes. Both are best-effort and report failure instead of throwing, since a missing capability merely
+/// costs performance.
+class NumaTopology {
+ public:
+  using size_type = usize;
+
+  /// \brief A NUMA node and the logical CPUs that belong to it.
+  struct Node {
+    /// \brief Identifier assigned to the node by the operating system.
+    size_type id = {};
+
+    /// \brief Logical CPUs of the node in ascending order.
+    std::vector<size_type> cpus = {};
+  };
+
+ private:
+  /// \brief Nodes in ascending order of their identifiers.
+  std::vector<Node> nodes_ = {};
+
+ public:
+  // /////////////////////////////////////////////
+  // Constructors and Destructors
+  // /////////////////////////////////////////////
+
+  /// \brief Parameterized constructor.
+  /// \param[in] nodes The nodes of the topology.
+  ///
+  /// \details
+  /// This constructor throws an exception if \p nodes is empty or if any node has no CPU.
+  ///
+  /// \throws ValueError
+  explicit NumaTopology(std::vector<Node> nodes);
+
+  // /////////////////////////////////////////////
+  // Accessors and Mutators
+  // /////////////////////////////////////////////
+
+  /// \brief Returns the nodes of the topology.
+  /// \return An immutable reference to the nodes.
+  [[nodiscard]] auto nodes() const noexcept -> const std::vector<Node> &;
+
+  // /////////////////////////////////////////////
+  // Query Functions
+  // /////////////////////////////////////////////
+
+  /// \brief Returns the number of nodes.
+  /// \return The number of nodes.
+  [[nodiscard]] auto node_count() const noexcept -> size_type;
+
+  /// \brief Returns the total number of logical CPUs.
+  /// \return The number of logical CPUs.
+  [[nodiscard]] auto cpu_count() const noexcept -> size_type;
+
+  /// \brief Returns all logical CPUs grouped by node.
+  /// \return The CPUs of the first node, followed by those of the second one, and so on.
+  ///
+  /// \details
+  /// Handing out CPUs in this order to the workers of a statically partitioned loop makes every node process a
+  /// contiguous share of the iteration space.
+  [[nodiscard]] auto cpus() const -> std::vector<size_type>;
+
+  /// \brief Returns the node that the given CPU belongs to.
+  /// \param[in] cpu The logical CPU.
+  /// \return The identifier of the node.
+  ///
+  /// \details
+  /// This function throws an exception if \p cpu does not belong to any node.
+  ///
+  /// \throws ValueError
+  [[nodiscard]] auto node_of_cpu(size_type cpu) const -> size_type;
+
+  // /////////////////////////////////////////////
+  // Informative
+  // /////////////////////////////////////////////
+
+  /// \brief Returns a summary of the topology as a string.
+  /// \return A string listing each node and its CPUs.
+  [[nodiscard]] auto to_string() const -> std::string;
+
+  // /////////////////////////////////////////////////////////////
+  // Static Functions
+  // /////////////////////////////////////////////////////////////
+
+  /// \brief Reads the topology from a sysfs-like directory.
+  /// \param[in] root The directory containing the `node<N>/cpulist` entries.
+  /// \return The discovered topology, or a single node spanning all hardware threads if nothing can be read.
+  [[nodiscard]] static auto discover(const std::string &root = "/sys/devices/system/node") -> NumaTopology;
+
+  /// \brief Returns the topology of the machine.
+  /// \return A reference to the topology discovered on first use.
+  [[nodiscard]] static auto system() -> const NumaTopology &;
+
+  /// \brief Pins the calling thread to a logical CPU.
+  /// \param[in] cpu The logical CPU.
+  /// \return True if the affinity of the thread was changed.
+  static auto pin_current_thread(size_type cpu) noexcept -> bool;
+
+  /// \brief Spreads the pages of a buffer round-robin across all nodes.
+  /// \param[in] address The beginning of the buffer.
+  /// \param[in] bytes The size of the buffer in bytes.
+  /// \return True if the memory policy of the buffer was changed.
+  ///
+  /// \details
+  /// Only the pages that lie entirely within the buffer are affected. Pages that are already resident are
+  /// migrated. Interleaving suits data that every thread reads in full, such as the weights of a layer,
+  /// whereas data that is partitioned among threads is better placed by first touch.
+  ///
+  /// \note This function has no effect on a machine with a single node.
+  static auto interleave(void *address, size_type bytes) noexcept -> bool;
+};
+
+/// \brief An allocator that leaves trivially constructible elements uninitialized on value-initialization.
+/// \tparam T Data type of the elements.
+///
+/// \details
+/// On Linux, a physical page is placed on the node of the thread that first writes to it. A `std::vector`
+/// zero-fills its elements on the allocating thread, so all pages of a large buffer end up on one node. With
+/// this allocator, the elements are left untouched instead, which lets the owner of the buffer initialize them
+/// in parallel, e.g., using the same partition as the loops that will consume them.
+///
+/// Construction from explicit arguments is unaffected.
+///
+/// An allocator may also be bound to existing memory, such as a region of a mapped file. Its first allocation
+/// of exactly the bound number of elements then returns that memory, which a container adopts as is since
+/// value-initialization does not touch it. The memory is kept alive by a shared owner for as long as any copy
+/// of the allocator exists. Every other allocation, and every allocation by a copy of the container, comes
+/// from the heap as usual.
+template <typename T>
+class FirstTouchAllocator : public std::allocator<T> {
+ public:
+  using value_type = T;
+
+  using propagate_on_container_copy_assignment = std::false_type;
+  using propagate_on_container_move_assignment = std::true_type;
+  using propagate_on_container_swap = std::true_type;
+  using is_always_equal = std::false_type;
+
+  /// \brief Rebinds the allocator to another type.
+  template <typename U>
+  struct rebind {
+    using other = FirstTouchAllocator<U>;
+  };
+
+ private:
+  /// \brief Keeps the bound memory alive.
+  std::shared_ptr<const void> owner_ = {};
+
+  /// \brief The bound memory.
+  T *address_ = {};
+
+  /// \brief The number of elements of the bound memory.
+  usize count_ = {};
+
+  /// \brief A flag indicating whether the bound memory has been handed out.
+  bool claimed_ = {};
+
+ public:
+  /// \brief Default constructor.
+  FirstTouchAllocator() = default;
+
+  /// \brief Constructs an allocator bound to existing memory.
+  /// \param[in] owner The owner of the memory, released once no copy of the allocator remains.
+  /// \param[in] address The first element of the memory.
+  /// \param[in] count The number of elements of the memory.
+  FirstTouchAllocator(std::shared_ptr<const void> owner, T *address, usize count) noexcept
+      : owner_{std::move(owner)}, address_{address}, count_{count} {}
+
+  /// \brief Default copy constructor.
+  ///
+  /// \details
+  /// Allocators are only ever copied, never moved from, so that a bound allocator never loses its owner.
+  FirstTouchAllocator(const FirstTouchAllocator &other) = default;
+
+  /// \brief Converting constructor.
+  ///
+  /// \details
+  /// The binding to existing memory is not carried over to other types.
+  template <typename U>
+  FirstTouchAllocator(const FirstTouchAllocator<U> &) noexcept {}
+
+  /// \brief Default copy assignment operator.
+  /// \param[in] other Source allocator.
+  /// \return A reference to self.
+  auto operator=(const FirstTouchAllocator &other) -> FirstTouchAllocator & = default;
+
+  /// \brief Allocates uninitialized storage.
+  /// \param[in] n The number of elements.
+  /// \return Pointer to the first element.
+  [[nodiscard]] auto allocate(usize n) -> T * {
+    if (address_ != nullptr and not claimed_ and n == count_) {
+      claimed_ = true;
+      return address_;
+    }
+    return std::allocator<T>::allocate(n);
+  }
+
+  /// \brief Deallocates storage; the bound memory is left to its owner.
+  /// \param[in] pointer Pointer to the first element.
+  /// \param[in] n The number of elements.
+  auto deallocate(T *pointer, usize n) -> void {
+    if (pointer != nullptr and pointer == address_) {
+      return;
+    }
+    std::allocator<T>::deallocate(pointer, n);
+  }
+
+  /// \brief Returns the allocator of a copy of a container, which always allocates from the heap.
+  /// \return An unbound allocator.
+  [[nodiscard]] auto select_on_container_copy_construction() const noexcept -> FirstTouchAllocator {
+    return {};
+  }
+
+  /// \brief Default-initializes an element.
+  /// \param[in] pointer The location of the element.
+  template <typename U>
+  auto construct(U *pointer) noexcept(std::is_nothrow_default_constructible_v<U>) -> void {
+    ::new (static_cast<void *>(pointer)) U;
+  }
+
+  /// \brief Constructs an element from the given arguments.
+  /// \param[in] pointer The location of the element.
+  /// \param[in] args The constructor arguments.
+  template <typename U, typename... Args>
+  auto construct(U *pointer, Args &&...args) -> void {
+    ::new (static_cast<void *>(pointer)) U(std::forward<Args>(args)...);
+  }
+
+  /// \brief Compares two allocators; they are equal if either can release the storage of the other.
+  /// \param[in] other The other allocator.
+  /// \return True if both are bound to the same memory, or neither is bound.
+  auto operator==(const FirstTouchAllocator &other) const noexcept -> bool {
+    return address_ == other.address_;
+  }
+};
+
+}
+
+#endif
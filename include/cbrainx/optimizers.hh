@@ -0,0 +1,377 @@
+// Copyright 2021 CBrainX
+// Project URL: https://github.com/mansoormemon/cbrainx
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Copyright (c) 2021 Mansoor Ahmed Memon <mansoorahmed.one@gmail.com>
+
+#ifndef CBRAINX__OPTIMIZERS_HH_
+#define CBRAINX__OPTIMIZERS_HH_
+
+#include <span>
+#include <string>
+#include <vector>
+
+#include "abstractLayer.hh"
+#include "numa.hh"
+#include "typeAliases.hh"
+
+namespace cbx {
+
+/// \brief The `Optimizer` class defines a standard interface for all optimizers.
+///
+/// \details
+/// An optimizer updates trainable parameters from their accumulated gradients. Such an update performs only a
+/// handful of operations per parameter, so it is bound by memory bandwidth. Hence, every optimizer is a fused
+/// kernel that reads each parameter, its gradient and its state once, and writes the parameter and the state
+/// back in the same sweep, using AVX-512 or AVX2 whenever available.
+///
+/// The state of an optimizer, e.g., the moments of `Adam`, is held in one flat buffer per kind of state that
+/// spans the parameters of all layers, in the order in which they are passed to `step`. A step is therefore a
+/// single streaming pass over the concatenated parameters, which is cut into chunks that are updated in
+/// parallel on the global pool.
+///
+/// The state is allocated on the first step, and reallocated (i.e., reset) if the sizes of the parameters
+/// change between steps.
+///
+/// \see TrainableParameter NeuralNet::trainable_parameters
+class Optimizer {
+ public:
+  using value_type = f32;
+
+  using size_type = usize;
+
+  using container = std::vector<value_type, FirstTouchAllocator<value_type>>;
+
+ private:
+  /// \brief The learning rate.
+  value_type learning_rate_ = {};
+
+  /// \brief The number of steps taken since the state was allocated.
+  size_type steps_ = {};
+
+  /// \brief The offsets of the parameters within the flat state buffers, followed by their total size.
+  std::vector<size_type> offsets_ = {};
+
+  /// \brief The state buffers, stored one after the other.
+  container state_ = {};
+
+  /// \brief Checks the parameters and (re)allocates the state if their layout has changed.
+  /// \param[in] parameters The parameters to be updated.
+  ///
+  /// \details
+  /// This function throws an exception if the size of any parameter differs from that of its gradient.
+  ///
+  /// \throws ShapeError
+  auto _m_prepare(std::span<const TrainableParameter> parameters) -> void;
+
+ protected:
+  /// \brief The number of elements per chunk of a parallel step.
+  static constexpr size_type CHUNK_SIZE = size_type{1} << 14;
+
+  // /////////////////////////////////////////////
+  // Helpers
+  // /////////////////////////////////////////////
+
+  /// \brief Checks if a hyperparameter lies in the range [0, 1).
+  /// \param[in] caller The name of the calling function.
+  /// \param[in] name The name of the hyperparameter.
+  /// \param[in] value The value of the hyperparameter.
+  ///
+  /// \details
+  /// This function throws an exception if \p value is out of range.
+  ///
+  /// \throws ValueError
+  static auto _s_check_decay(str caller, str name, value_type value) -> void;
+
+  /// \brief Checks if a hyperparameter is not negative.
+  /// \param[in] caller The name of the calling function.
+  /// \param[in] name The name of the hyperparameter.
+  /// \param[in] value The value of the hyperparameter.
+  ///
+  /// \details
+  /// This function throws an exception if \p value is negative.
+  ///
+  /// \throws ValueError
+  static auto _s_check_non_negative(str caller, str name, value_type value) -> void;
+
+  // /////////////////////////////////////////////
+  // Interface
+  // /////////////////////////////////////////////
+
+  /// \brief Returns the number of state buffers, i.e., the number of state values per parameter.
+  /// \return The number of state buffers.
+  [[nodiscard]] virtual auto _m_slots() const -> size_type = 0;
+
+  /// \brief Updates a contiguous run of parameters in place.
+  /// \param[in, out] values The parameters.
+  /// \param[in] gradients The gradients of the parameters.
+  /// \param[in, out] first, second The state buffers of the run, null if there are fewer slots.
+  /// \param[in] n The number of parameters in the run.
+  /// \param[in] step The number of the step being taken, starting at one.
+  virtual auto _m_update(value_type *values, const value_type *gradients, value_type *first, value_type *second,
+                         size_type n, size_type step) const -> void = 0;
+
+ public:
+  // /////////////////////////////////////////////
+  // Constructors and Destructors
+  // /////////////////////////////////////////////
+
+  /// \brief Parameterized constructor.
+  /// \param[in] learning_rate The learning rate.
+  ///
+  /// \details
+  /// This constructor throws an exception if \p learning_rate is not positive.
+  ///
+  /// \throws ValueError
+  explicit Optimizer(value_type learning_rate);
+
+  /// \brief Default copy constructor.
+  /// \param[in] other Source optimizer.
+  Optimizer(const Optimizer &other) = default;
+
+  /// \brief Default destructor.
+  virtual ~Optimizer() = default;
+
+  // /////////////////////////////////////////////
+  // Assignment Operators
+  // /////////////////////////////////////////////
+
+  /// \brief Default copy assignment operator.
+  /// \param[in] other Source optimizer.
+  /// \return A reference to self.
+  auto operator=(const Optimizer &other) -> Optimizer & = default;
+
+  // /////////////////////////////////////////////
+  // Accessors and Mutators
+  // /////////////////////////////////////////////
+
+  /// \brief Returns the learning rate.
+  /// \return The learning rate.
+  [[nodiscard]] auto learning_rate() const -> value_type;
+
+  /// \brief Sets the learning rate, e.g., to follow a schedule.
+  /// \param[in] learning_rate The new learning rate.
+  /// \return A reference to self.
+  ///
+  /// \details
+  /// This function throws an exception if \p learning_rate is not positive.
+  ///
+  /// \throws ValueError
+  auto set_learning_rate(value_type learning_rate) -> Optimizer &;
+
+  /// \brief Returns the number of steps taken since the state was allocated.
+  /// \return The number of steps.
+  [[nodiscard]] auto steps() const -> size_type;
+
+  /// \brief Returns the number of state values held by the optimizer.
+  /// \return The size of the state.
+  [[nodiscard]] auto state_size() const -> size_type;
+
+  // /////////////////////////////////////////////
+  // Informative
+  // /////////////////////////////////////////////
+
+  /// \brief Returns the name and the hyperparameters of the optimizer as a string.
+  /// \return A description of the optimizer.
+  [[nodiscard]] virtual auto to_string() const -> std::string = 0;
+
+  // /////////////////////////////////////////////
+  // Core Functionality
+  // /////////////////////////////////////////////
+
+  /// \brief Updates the parameters from their accumulated gradients.
+  /// \param[in] parameters The parameters to be updated.
+  ///
+  /// \details
+  /// The gradients are used as they are, i.e., averaging over a batch is up to the caller.
+  ///
+  /// This function throws an exception if the size of any parameter differs from that of its gradient.
+  ///
+  /// \throws ShapeError
+  auto step(std::span<const TrainableParameter> parameters) -> void;
+
+  /// \brief Drops the state, so that the next step starts afresh.
+  auto reset() -> void;
+};
+
+/// \brief Stochastic gradient descent, optionally with momentum.
+///
+/// Formulae:
+///  v = μv + (g + λθ)
+///  θ = θ - ηv
+///
+/// where η is the learning rate, μ the momentum and λ the weight decay. Without momentum, no state is kept.
+class SGD : public Optimizer {
+ private:
+  /// \brief The momentum.
+  value_type momentum_ = {};
+
+  /// \brief The coefficient of the L2 penalty.
+  value_type weight_decay_ = {};
+
+ protected:
+  /// \brief Returns the number of state buffers.
+  /// \return The number of state buffers.
+  [[nodiscard]] auto _m_slots() const -> size_type override;
+
+  /// \brief Updates a contiguous run of parameters in place.
+  auto _m_update(value_type *values, const value_type *gradients, value_type *first, value_type *second,
+                 size_type n, size_type step) const -> void override;
+
+ public:
+  /// \brief Parameterized constructor.
+  /// \param[in] learning_rate The learning rate.
+  /// \param[in] momentum The momentum, in the range [0, 1).
+  /// \param[in] weight_decay The coefficient of the L2 penalty.
+  ///
+  /// \throws ValueError
+  explicit SGD(value_type learning_rate = 0.01F, value_type momentum = {}, value_type weight_decay = {});
+
+  /// \brief Returns the name and the hyperparameters of the optimizer as a string.
+  /// \return A description of the optimizer.
+  [[nodiscard]] auto to_string() const -> std::string override;
+};
+
+/// \brief Adaptive moment estimation.
+///
+/// Formulae:
+///  m = β₁m + (1 - β₁)g
+///  v = β₂v + (1 - β₂)g²
+///  θ = θ - η ⋅ m̂ / (√v̂ + ε)
+///
+/// where m̂ = m / (1 - β₁ᵗ) and v̂ = v / (1 - β₂ᵗ) are corrected for their initialization at zero. The weight
+/// decay is added to the gradient as an L2 penalty.
+class Adam : public Optimizer {
+ private:
+  /// \brief The decay rate of the first moment.
+  value_type beta1_ = {};
+
+  /// \brief The decay rate of the second moment.
+  value_type beta2_ = {};
+
+  /// \brief A term added to the denominator for numerical stability.
+  value_type epsilon_ = {};
+
+  /// \brief The weight decay.
+  value_type weight_decay_ = {};
+
+  /// \brief A flag for decoupling the weight decay from the gradient.
+  bool decoupled_ = {};
+
+ protected:
+  /// \brief Parameterized constructor.
+  /// \param[in] learning_rate The learning rate.
+  /// \param[in] beta1, beta2 The decay rates of the moments, in the range [0, 1).
+  /// \param[in] epsilon A term added to the denominator for numerical stability.
+  /// \param[in] weight_decay The weight decay.
+  /// \param[in] decoupled If true, the weights decay directly rather than through the gradient.
+  ///
+  /// \throws ValueError
+  Adam(value_type learning_rate, value_type beta1, value_type beta2, value_type epsilon,
+       value_type weight_decay, bool decoupled);
+
+  /// \brief Returns the number of state buffers.
+  /// \return The number of state buffers.
+  [[nodiscard]] auto _m_slots() const -> size_type override;
+
+  /// \brief Updates a contiguous run of parameters in place.
+  auto _m_update(value_type *values, const value_type *gradients, value_type *first, value_type *second,
+                 size_type n, size_type step) const -> void override;
+
+  /// \brief Returns the hyperparameters as a string.
+  /// \return The hyperparameters.
+  [[nodiscard]] auto _m_hyperparameters() const -> std::string;
+
+ public:
+  /// \brief Parameterized constructor.
+  /// \param[in] learning_rate The learning rate.
+  /// \param[in] beta1, beta2 The decay rates of the moments, in the range [0, 1).
+  /// \param[in] epsilon A term added to the denominator for numerical stability.
+  /// \param[in] weight_decay The coefficient of the L2 penalty.
+  ///
+  /// \throws ValueError
+  explicit Adam(value_type learning_rate = 1e-3F, value_type beta1 = 0.9F, value_type beta2 = 0.999F,
+                value_type epsilon = 1e-8F, value_type weight_decay = {});
+
+  /// \brief Returns the name and the hyperparameters of the optimizer as a string.
+  /// \return A description of the optimizer.
+  [[nodiscard]] auto to_string() const -> std::string override;
+};
+
+/// \brief Adam with decoupled weight decay.
+///
+/// Formula: θ = (1 - ηλ)θ - η ⋅ m̂ / (√v̂ + ε)
+///
+/// Unlike the L2 penalty of `Adam`, the decay is not scaled by the adaptive learning rate.
+class AdamW : public Adam {
+ public:
+  /// \brief Parameterized constructor.
+  /// \param[in] learning_rate The learning rate.
+  /// \param[in] beta1, beta2 The decay rates of the moments, in the range [0, 1).
+  /// \param[in] epsilon A term added to the denominator for numerical stability.
+  /// \param[in] weight_decay The decoupled weight decay.
+  ///
+  /// \throws ValueError
+  explicit AdamW(value_type learning_rate = 1e-3F, value_type beta1 = 0.9F, value_type beta2 = 0.999F,
+                 value_type epsilon = 1e-8F, value_type weight_decay = 1e-2F);
+
+  /// \brief Returns the name and the hyperparameters of the optimizer as a string.
+  /// \return A description of the optimizer.
+  [[nodiscard]] auto to_string() const -> std::string override;
+};
+
+/// \brief Root mean square propagation.
+///
+/// Formulae:
+///  v = ρv + (1 - ρ)g²
+///  θ = θ - η ⋅ g / (√v + ε)
+class RMSProp : public Optimizer {
+ private:
+  /// \brief The decay rate of the second moment.
+  value_type rho_ = {};
+
+  /// \brief A term added to the denominator for numerical stability.
+  value_type epsilon_ = {};
+
+  /// \brief The coefficient of the L2 penalty.
+  value_type weight_decay_ = {};
+
+ protected:
+  /// \brief Returns the number of state buffers.
+  /// \return The number of state buffers.
+  [[nodiscard]] auto _m_slots() const -> size_type override;
+
+  /// \brief Updates a contiguous run of parameters in place.
+  auto _m_update(value_type *values, const value_type *gradients, value_type *first, value_type *second,
+                 size_type n, size_type step) const -> void override;
+
+ public:
+  /// \brief Parameterized constructor.
+  /// \param[in] learning_rate The learning rate.
+  /// \param[in] rho The decay rate of the second moment, in the range [0, 1).
+  /// \param[in] epsilon A term added to the denominator for numerical stability.
+  /// \param[in] weight_decay The coefficient of the L2 penalty.
+  ///
+  /// \throws ValueError
+  explicit RMSProp(value_type learning_rate = 1e-3F, value_type rho = 0.9F, value_type epsilon = 1e-8F,
+                   value_type weight_decay = {});
+
+  /// \brief Returns the name and the hyperparameters of the optimizer as a string.
+  /// \return A description of the optimizer.
+  [[nodiscard]] auto to_string() const -> std::string override;
+};
+
+}
+
+#endif
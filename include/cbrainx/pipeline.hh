@@ -0,0 +1,240 @@
+// Copyright 2021 CBrainX
+// Project URL: https://github.com/mansoormemon/cbrainx
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Copyright (c) 2021 Mansoor Ahmed Memon <mansoorahmed.one@gmail.com>
+#ifndef CBRAINX__PIPELINE_HH_
+#define CBRAINX__PIPELINE_HH_
+
+#include <memory>
+#include <optional>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "executionPlan.hh"
+#include "neuralNet.hh"
+#include "spscRing.hh"
+#include "tensor.hh"
+#include "typeAliases.hh"
+
+namespace cbx {
+
+/// \brief The settings of a `Pipeline`.
+struct PipelineConfig {
+  /// \brief The number of samples per batch.
+  usize batch_size = 8;
+
+  /// \brief The maximum number of stages; zero picks one stage per CPU but the first, up to one per layer.
+  usize stages = {};
+
+  /// \brief The number of batches that each ring buffer between two stages can hold.
+  usize depth = 4;
+
+  /// \brief A flag indicating whether each stage is pinned to a CPU of its own.
+  bool pinned = true;
+
+  /// \brief The number of timed runs per layer when balancing the stages.
+  usize calibration_runs = 16;
+};
+
+/// \brief The `Pipeline` class streams batches through a network whose layers are spread over several cores.
+///
+/// \details
+/// The layers are cut into contiguous stages, each compiled into an `ExecutionPlan` and run by a thread of its
+/// own. Neighbouring stages are connected by lock-free single-producer single-consumer ring buffers, so that
+/// while the second stage works on batch `i`, the first one already works on batch `i + 1`. For a stream of
+/// small batches, which are too small to be split within a matrix product, this keeps every core busy and
+/// raises the sustained throughput to that of the slowest stage instead of that of the whole network.
+///
+/// The stages are balanced by cost. Every dense layer, together with the activations and the softmax following
+/// it, is a unit that is never split, so that fusion within a stage is preserved. Each unit is compiled on its
+/// own and timed at the batch size of the pipeline, and the units are then partitioned into stages such that
+/// the cost of the most expensive stage is minimal.
+///
+/// Batches leave the pipeline in the order they enter it. A batch may hold fewer samples than `batch_size()`,
+/// e.g., the tail of a stream; it still costs as much as a full one. Exactly one thread may push and exactly
+/// one thread may pop at any given time; the two may be the same thread as long as it never has more than
+/// `depth()` batches pushed but not popped, since `push` blocks while the first ring buffer is full.
+///
+/// The pipeline shares the parameters of the network and keeps its layers alive.
+///
+/// \see ExecutionPlan SpscRing
+class Pipeline {
+ public:
+  using value_type = f32;
+
+  using size_type = usize;
+
+  using tensor_type = Tensor<value_type>;
+
+ private:
+  /// \brief A batch in flight, held by a slot of a ring buffer.
+  struct Batch {
+    /// \brief The values of the samples, of `batch_size()` rows.
+    std::vector<value_type> data = {};
+
+    /// \brief The number of valid samples; zero marks the end of the stream.
+    size_type samples = {};
+  };
+
+  /// \brief A contiguous group of layers run by one thread.
+  struct Stage {
+    /// \brief The compiled layers of the stage.
+    ExecutionPlan plan = {};
+
+    /// \brief The ids of the first and the last layer of the stage.
+    i32 first_layer = {}, last_layer = {};
+
+    /// \brief The measured time of one batch, in seconds.
+    f64 cost = {};
+  };
+
+  /// \brief The settings.
+  PipelineConfig config_ = {};
+
+  /// \brief The stages, in order.
+  std::vector<Stage> stages_ = {};
+
+  /// \brief The ring buffers; ring `i` feeds stage `i`, and the last one holds the outputs.
+  std::vector<std::unique_ptr<SpscRing<Batch>>> rings_ = {};
+
+  /// \brief The threads of the stages.
+  std::vector<std::thread> threads_ = {};
+
+  /// \brief The number of input values per sample.
+  size_type input_size_ = {};
+
+  /// \brief The number of output values per sample.
+  size_type output_size_ = {};
+
+  /// \brief A flag indicating whether the end of the stream has been pushed.
+  bool closed_ = {};
+
+  /// \brief A flag indicating whether the end of the stream has been popped.
+  bool drained_ = {};
+
+  // /////////////////////////////////////////////
+  // Helpers
+  // /////////////////////////////////////////////
+
+  /// \brief The routine executed by the thread of each stage.
+  /// \param[in] index The index of the stage.
+  auto _m_run_stage(size_type index) -> void;
+
+ public:
+  // /////////////////////////////////////////////
+  // Constructors and Destructors
+  // /////////////////////////////////////////////
+
+  /// \brief Builds the stages of a network and starts their threads.
+  /// \param[in] net The network.
+  /// \param[in] config The settings.
+  ///
+  /// \details
+  /// This function throws an exception if the network has no layers, or if the batch size or the depth is
+  /// zero.
+  ///
+  /// \throws ValueError
+  Pipeline(const NeuralNet &net, const PipelineConfig &config = {});
+
+  /// \brief Deleted copy constructor.
+  Pipeline(const Pipeline &other) = delete;
+
+  /// \brief Destructor.
+  ///
+  /// \details
+  /// The destructor closes the stream if needed, discards the batches that have not been popped, and waits for
+  /// the stages to finish.
+  ~Pipeline();
+
+  // /////////////////////////////////////////////
+  // Assignment Operators
+  // /////////////////////////////////////////////
+
+  /// \brief Deleted copy assignment operator.
+  auto operator=(const Pipeline &other) -> Pipeline & = delete;
+
+  // /////////////////////////////////////////////
+  // Query Functions
+  // /////////////////////////////////////////////
+
+  /// \brief Returns the number of samples per batch.
+  /// \return The batch size.
+  [[nodiscard]] auto batch_size() const noexcept -> size_type;
+
+  /// \brief Returns the number of batches that each ring buffer can hold.
+  /// \return The depth of the ring buffers.
+  [[nodiscard]] auto depth() const noexcept -> size_type;
+
+  /// \brief Returns the number of input values per sample.
+  /// \return The input size.
+  [[nodiscard]] auto input_size() const noexcept -> size_type;
+
+  /// \brief Returns the number of output values per sample.
+  /// \return The output size.
+  [[nodiscard]] auto output_size() const noexcept -> size_type;
+
+  /// \brief Returns the number of stages.
+  /// \return The number of stages.
+  [[nodiscard]] auto stages() const noexcept -> size_type;
+
+  /// \brief Returns the measured time of one batch in each stage, in seconds.
+  /// \return The costs of the stages, in order.
+  ///
+  /// \details
+  /// The throughput of the pipeline is bounded by the most expensive stage.
+  [[nodiscard]] auto stage_costs() const -> std::vector<f64>;
+
+  // /////////////////////////////////////////////
+  // Informative
+  // /////////////////////////////////////////////
+
+  /// \brief Returns a description of the stages, one per line.
+  /// \return The stages of the pipeline as a string.
+  [[nodiscard]] auto to_string() const -> std::string;
+
+  // /////////////////////////////////////////////
+  // Core Functionality
+  // /////////////////////////////////////////////
+
+  /// \brief Feeds a batch into the pipeline.
+  /// \param[in] input The batch, of shape (samples, ...input shape) with 0 < samples <= `batch_size()`.
+  ///
+  /// \details
+  /// This function blocks while the first ring buffer is full. It throws an exception if the stream has been
+  /// closed or if the shape of \p input does not fit.
+  ///
+  /// \throws ValueError
+  /// \throws ShapeError
+  auto push(const tensor_type &input) -> void;
+
+  /// \brief Takes the output of the oldest batch still in the pipeline.
+  /// \return The output, of shape (samples, `output_size()`), or nothing once the stream has been closed and
+  /// all of its batches have been popped.
+  ///
+  /// \details
+  /// This function blocks until the output is available.
+  [[nodiscard]] auto pop() -> std::optional<tensor_type>;
+
+  /// \brief Marks the end of the stream.
+  ///
+  /// \details
+  /// The batches pushed so far are still processed and can be popped. Closing a closed stream has no effect.
+  auto close() -> void;
+};
+
+}
+
+#endif
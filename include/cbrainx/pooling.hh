@@ -0,0 +1,434 @@
+// Copyright 2021 CBrainX
+// Project URL: https://github.com/mansoormemon/cbrainx
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Copyright (c) 2021 Mansoor Ahmed Memon <mansoorahmed.one@gmail.com>
+#ifndef CBRAINX__POOLING_HH_
+#define CBRAINX__POOLING_HH_
+
+#include <memory>
+#include <string>
+#include <string_view>
+
+#include "abstractLayer.hh"
+#include "shape.hh"
+#include "tensor.hh"
+#include "tensorView.hh"
+#include "typeAliases.hh"
+
+namespace cbx {
+
+/// \brief The geometry of a 2D pooling.
+struct Pool2DParams {
+  /// \brief Height of the window.
+  usize window_h = 2;
+
+  /// \brief Width of the window.
+  usize window_w = 2;
+
+  /// \brief Step between successive windows along the height.
+  usize stride_h = 2;
+
+  /// \brief Step between successive windows along the width.
+  usize stride_w = 2;
+
+  /// \brief Rows added above and below the input, which never contribute to a window.
+  usize padding_h = 0;
+
+  /// \brief Columns added to the left and right of the input, which never contribute to a window.
+  usize padding_w = 0;
+
+  /// \brief Returns parameters that are identical along both spatial axes.
+  /// \param[in] window The height and width of the window.
+  /// \param[in] stride The step between successive windows.
+  /// \param[in] padding The number of rows and columns added to each side.
+  /// \return The parameters.
+  [[nodiscard]] static auto square(usize window, usize stride, usize padding = 0) -> Pool2DParams {
+    return {window, window, stride, stride, padding, padding};
+  }
+};
+
+/// \brief Returns the shape of the result of a 2D pooling.
+/// \param[in] input The shape of the input, i.e., (batch, height, width, channels).
+/// \param[in] params The geometry of the pooling.
+/// \return The shape of the result, i.e., (batch, output height, output width, channels).
+///
+/// \details
+/// This function throws an exception if:
+///     * The input is not of rank 4.
+///     * A window extent or stride is zero, or the padding is not smaller than the window.
+///     * The window does not fit in the padded input.
+///
+/// \throws RankError
+/// \throws ValueError
+[[nodiscard]] auto pool2d_output_shape(const Shape &input, const Pool2DParams &params) -> Shape;
+
+/// \brief The `Pool2DLayer` class is the base of the layers that summarize windows of an image.
+///
+/// \details
+/// A pooling layer slides a window over the height and width of its input and reduces every window to one
+/// value per channel. Like `Conv2DLayer`, each sample is an image of shape (height, width, channels), i.e., a
+/// batch is laid out as NHWC. Since the channels of a pixel are contiguous, a window is reduced pixel by pixel
+/// with the SIMD kernels of `vmath`, and the output rows of a batch are spread over the threads of the global
+/// pool. Padded positions are skipped rather than treated as values.
+///
+/// A pooling layer has no trainable parameters.
+///
+/// \see MaxPool2D AvgPool2D GlobalAvgPool
+class Pool2DLayer : public AbstractLayer {
+ protected:
+  /// \brief The shape of the input layer of one sample, i.e., (height, width, channels).
+  Shape input_shape_ = {};
+
+  /// \brief The shape of the output layer of one sample.
+  Shape output_shape_ = {};
+
+  /// \brief The geometry of the pooling.
+  Pool2DParams params_ = {};
+
+  // /////////////////////////////////////////////
+  // Helpers
+  // /////////////////////////////////////////////
+
+  /// \brief Returns the number of samples held by an input layer.
+  /// \param[in] shape The shape of the input layer.
+  /// \return The number of samples.
+  ///
+  /// \details
+  /// This function throws an exception if \p shape does not hold a whole image per sample.
+  ///
+  /// \throws ShapeError
+  auto _m_count_samples(const Shape &shape) const -> size_type;
+
+  /// \brief Returns the shape of a batch of input images.
+  /// \param[in] samples The number of samples.
+  /// \return The shape (samples, height, width, channels).
+  [[nodiscard]] auto _m_images(size_type samples) const -> Shape;
+
+  /// \brief Returns the shape of a batch of pooled images.
+  /// \param[in] samples The number of samples.
+  /// \return The shape (samples, output height, output width, channels).
+  [[nodiscard]] auto _m_maps(size_type samples) const -> Shape;
+
+  /// \brief Returns the shape of the output layer of a batch.
+  /// \param[in] samples The number of samples.
+  /// \return The output shape of one sample, preceded by \p samples.
+  [[nodiscard]] auto _m_outputs(size_type samples) const -> Shape;
+
+  // /////////////////////////////////////////////
+  // Constructors and Destructors
+  // /////////////////////////////////////////////
+
+  /// \brief Parameterized constructor.
+  /// \param[in] name The name of the layer.
+  /// \param[in] input_shape The shape of the input layer of one sample, i.e., (height, width[, channels]).
+  /// \param[in] params The geometry of the pooling.
+  ///
+  /// \throws RankError
+  /// \throws ValueError
+  Pool2DLayer(std::string_view name, const Shape &input_shape, const Pool2DParams &params);
+
+ public:
+  // /////////////////////////////////////////////
+  // Accessors and Mutators
+  // /////////////////////////////////////////////
+
+  /// \brief Returns the geometry of the pooling.
+  /// \return An immutable reference to the parameters of the pooling.
+  [[nodiscard]] auto params() const -> const Pool2DParams &;
+
+  /// \brief Returns the shape of the input layer of one sample.
+  /// \return The input shape, i.e., (height, width, channels).
+  [[nodiscard]] auto input_shape() const -> const Shape &;
+
+  // /////////////////////////////////////////////
+  // Query Functions
+  // /////////////////////////////////////////////
+
+  /// \brief Returns the number of neurons in the layer.
+  /// \return The number of elements of the output layer of one sample.
+  [[nodiscard]] auto neurons() const -> size_type override;
+
+  /// \brief Returns the number of modifiable parameters in the layer.
+  /// \return Zero, since pooling has no parameters.
+  [[nodiscard]] auto parameters() const -> size_type override;
+
+  /// \brief Returns the shape of the output layer of one sample.
+  /// \param[in] input_shape The shape of the input layer of one sample (unused, as the layer knows its own).
+  /// \return The output shape.
+  [[nodiscard]] auto output_shape(const Shape &input_shape) const -> Shape override;
+
+  // /////////////////////////////////////////////
+  // Informative
+  // /////////////////////////////////////////////
+
+  /// \brief Returns a string with information about the layer's properties.
+  /// \return Information about the layer's properties as a string.
+  [[nodiscard]] auto property() const -> std::string override;
+
+  // /////////////////////////////////////////////
+  // Core Functionality
+  // /////////////////////////////////////////////
+
+  /// \brief Forward pass.
+  /// \param[in] input The input layer, holding one image of `input_shape()` per sample.
+  /// \return A reference to self.
+  ///
+  /// \throws ShapeError
+  [[nodiscard]] auto forward_pass(const container &input) const -> const AbstractLayer & override;
+};
+
+/// \brief The `MaxPool2D` class represents a layer that keeps the largest value of every window.
+///
+/// \details
+/// The forward pass of this layer performs the subsequent operation, channel by channel.
+///
+/// Formula: Ô[y, x] = max [(i, j) ∈ window(y, x)] Î[i, j]
+///
+/// The gradient only flows to the position at which each maximum was attained; ties are resolved in favor of
+/// the first position of the window in row-major order. By default, the forward pass records these positions
+/// so that the backward pass merely scatters the gradient. Recording can be disabled to save memory during
+/// training, in which case the backward pass searches the windows again. Inference never records.
+///
+/// \see LayerType Pool2DLayer
+class MaxPool2D : public Pool2DLayer {
+ private:
+  /// \brief A flag indicating whether the forward pass records the positions of the maxima.
+  bool records_indices_ = true;
+
+  /// \brief The position of the maximum within its window, in row-major order, for every element of the output
+  /// of the last forward pass.
+  ///
+  /// \note The positions are stored as floats, which represent integers up to 2²⁴ exactly.
+  mutable container indices_ = {};
+
+ public:
+  // /////////////////////////////////////////////
+  // Constructors and Destructors
+  // /////////////////////////////////////////////
+
+  /// \brief Parameterized constructor.
+  /// \param[in] input_shape The shape of the input layer of one sample, i.e., (height, width[, channels]).
+  /// \param[in] window The height and width of the window.
+  /// \param[in] stride The step between successive windows (0 means non-overlapping windows).
+  /// \param[in] padding The number of rows and columns added to each side.
+  ///
+  /// \throws RankError
+  /// \throws ValueError
+  MaxPool2D(const Shape &input_shape, size_type window = 2, size_type stride = 0, size_type padding = 0);
+
+  /// \brief Parameterized constructor.
+  /// \param[in] input_shape The shape of the input layer of one sample, i.e., (height, width[, channels]).
+  /// \param[in] params The geometry of the pooling.
+  ///
+  /// \throws RankError
+  /// \throws ValueError
+  MaxPool2D(const Shape &input_shape, const Pool2DParams &params);
+
+  // /////////////////////////////////////////////
+  // Accessors and Mutators
+  // /////////////////////////////////////////////
+
+  /// \brief Returns whether the forward pass records the positions of the maxima.
+  /// \return True if the positions are recorded.
+  [[nodiscard]] auto records_indices() const -> bool;
+
+  /// \brief Sets whether the forward pass records the positions of the maxima.
+  /// \param[in] records_indices If true, the positions are recorded.
+  /// \return A reference to self.
+  auto set_records_indices(bool records_indices) -> MaxPool2D &;
+
+  /// \brief Returns the positions of the maxima recorded by the last forward pass.
+  /// \return An immutable reference to the positions, which is empty if none were recorded.
+  [[nodiscard]] auto indices() const -> const container &;
+
+  // /////////////////////////////////////////////
+  // Query Functions
+  // /////////////////////////////////////////////
+
+  /// \brief Returns the type of the layer.
+  /// \return The type of the layer.
+  ///
+  /// \see LayerType
+  [[nodiscard]] auto type() const -> LayerType override;
+
+  // /////////////////////////////////////////////
+  // Utility
+  // /////////////////////////////////////////////
+
+  /// \brief Returns a deep copy of the layer.
+  /// \return A new layer with its own caches.
+  [[nodiscard]] auto clone() const -> std::shared_ptr<AbstractLayer> override;
+
+  // /////////////////////////////////////////////
+  // Core Functionality
+  // /////////////////////////////////////////////
+
+  /// \brief Forward pass, which also records the positions of the maxima unless disabled.
+  /// \param[in] input The input layer, holding one image of `input_shape()` per sample.
+  /// \return A reference to self.
+  ///
+  /// \throws ShapeError
+  [[nodiscard]] auto forward_pass(const container &input) const -> const AbstractLayer & override;
+
+  /// \brief Forward pass for inference, which writes into caller-provided memory and caches nothing.
+  /// \param[in] input The input layer, holding one image of `input_shape()` per sample.
+  /// \param[out] output The output layer, holding `neurons()` elements per sample; it must not overlap
+  /// \p input.
+  ///
+  /// \throws ShapeError
+  auto infer(TensorView<const value_type> input, TensorView<value_type> output) const -> void override;
+
+  /// \brief Backward pass.
+  /// \param[in] output_gradient The gradient of the loss w.r.t. the output layer of the last forward pass.
+  /// \return A reference to self.
+  ///
+  /// \throws ShapeError
+  [[nodiscard]] auto backward_pass(const container &output_gradient) const -> const AbstractLayer & override;
+};
+
+/// \brief The `AvgPool2D` class represents a layer that averages every window.
+///
+/// \details
+/// The forward pass of this layer performs the subsequent operation, channel by channel.
+///
+/// Formula: Ô[y, x] = ⅀ [(i, j) ∈ window(y, x)] Î[i, j] / |window(y, x)|
+///
+/// where the window only counts positions inside the input, i.e., padding does not dilute the average. The
+/// backward pass distributes the gradient of every output evenly over its window.
+///
+/// \see LayerType Pool2DLayer
+class AvgPool2D : public Pool2DLayer {
+ protected:
+  /// \brief Parameterized constructor for layers that specialize the averaging.
+  /// \param[in] name The name of the layer.
+  /// \param[in] input_shape The shape of the input layer of one sample, i.e., (height, width[, channels]).
+  /// \param[in] params The geometry of the pooling.
+  ///
+  /// \throws RankError
+  /// \throws ValueError
+  AvgPool2D(std::string_view name, const Shape &input_shape, const Pool2DParams &params);
+
+ public:
+  // /////////////////////////////////////////////
+  // Constructors and Destructors
+  // /////////////////////////////////////////////
+
+  /// \brief Parameterized constructor.
+  /// \param[in] input_shape The shape of the input layer of one sample, i.e., (height, width[, channels]).
+  /// \param[in] window The height and width of the window.
+  /// \param[in] stride The step between successive windows (0 means non-overlapping windows).
+  /// \param[in] padding The number of rows and columns added to each side.
+  ///
+  /// \throws RankError
+  /// \throws ValueError
+  AvgPool2D(const Shape &input_shape, size_type window = 2, size_type stride = 0, size_type padding = 0);
+
+  /// \brief Parameterized constructor.
+  /// \param[in] input_shape The shape of the input layer of one sample, i.e., (height, width[, channels]).
+  /// \param[in] params The geometry of the pooling.
+  ///
+  /// \throws RankError
+  /// \throws ValueError
+  AvgPool2D(const Shape &input_shape, const Pool2DParams &params);
+
+  // /////////////////////////////////////////////
+  // Query Functions
+  // /////////////////////////////////////////////
+
+  /// \brief Returns the type of the layer.
+  /// \return The type of the layer.
+  ///
+  /// \see LayerType
+  [[nodiscard]] auto type() const -> LayerType override;
+
+  // /////////////////////////////////////////////
+  // Utility
+  // /////////////////////////////////////////////
+
+  /// \brief Returns a deep copy of the layer.
+  /// \return A new layer with its own caches.
+  [[nodiscard]] auto clone() const -> std::shared_ptr<AbstractLayer> override;
+
+  // /////////////////////////////////////////////
+  // Core Functionality
+  // /////////////////////////////////////////////
+
+  /// \brief Forward pass for inference, which writes into caller-provided memory and caches nothing.
+  /// \param[in] input The input layer, holding one image of `input_shape()` per sample.
+  /// \param[out] output The output layer, holding `neurons()` elements per sample; it must not overlap
+  /// \p input.
+  ///
+  /// \throws ShapeError
+  auto infer(TensorView<const value_type> input, TensorView<value_type> output) const -> void override;
+
+  /// \brief Backward pass.
+  /// \param[in] output_gradient The gradient of the loss w.r.t. the output layer of the last forward pass.
+  /// \return A reference to self.
+  ///
+  /// \throws ShapeError
+  [[nodiscard]] auto backward_pass(const container &output_gradient) const -> const AbstractLayer & override;
+};
+
+/// \brief The `GlobalAvgPool` class represents a layer that averages every channel over the whole image.
+///
+/// \details
+/// Global average pooling is an average pooling whose window spans the entire image, which reduces each sample
+/// of shape (height, width, channels) to a vector of shape (channels). It is commonly placed between the
+/// convolutions and the classifier of a network, in place of a much larger dense layer over all pixels.
+///
+/// \see LayerType AvgPool2D
+class GlobalAvgPool : public AvgPool2D {
+ public:
+  // /////////////////////////////////////////////
+  // Constructors and Destructors
+  // /////////////////////////////////////////////
+
+  /// \brief Parameterized constructor.
+  /// \param[in] input_shape The shape of the input layer of one sample, i.e., (height, width[, channels]).
+  ///
+  /// \throws RankError
+  /// \throws ValueError
+  explicit GlobalAvgPool(const Shape &input_shape);
+
+  // /////////////////////////////////////////////
+  // Query Functions
+  // /////////////////////////////////////////////
+
+  /// \brief Returns the type of the layer.
+  /// \return The type of the layer.
+  ///
+  /// \see LayerType
+  [[nodiscard]] auto type() const -> LayerType override;
+
+  // /////////////////////////////////////////////
+  // Informative
+  // /////////////////////////////////////////////
+
+  /// \brief Returns a string with information about the layer's properties.
+  /// \return Information about the layer's properties as a string.
+  [[nodiscard]] auto property() const -> std::string override;
+
+  // /////////////////////////////////////////////
+  // Utility
+  // /////////////////////////////////////////////
+
+  /// \brief Returns a deep copy of the layer.
+  /// \return A new layer with its own caches.
+  [[nodiscard]] auto clone() const -> std::shared_ptr<AbstractLayer> override;
+};
+
+}
+
+#endif
@@ -0,0 +1,427 @@
+// Copyright 2021 CBrainX
+// Project URL: https://github.com/mansoormemon/cbrainx
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Copyright (c) 2021 Mansoor Ahmed Memon <mansoorahmed.one@gmail.com>
+#ifndef CBRAINX__SERVE_HH_
+#define CBRAINX__SERVE_HH_
+
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <future>
+#include <list>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include "executionContext.hh"
+#include "executionPlan.hh"
+#include "neuralNet.hh"
+#include "tensor.hh"
+#include "typeAliases.hh"
+
+/// \brief Local inference serving with dynamic batching.
+///
+/// \details
+/// A `Server` accepts connections on a Unix domain socket and answers inference requests. Requests that arrive
+/// close together are coalesced into one batch, so that many single-sample calls share one matrix-matrix
+/// product instead of each running a matrix-vector product of their own. A batch is closed as soon as it holds
+/// `max_batch_size` samples or its oldest request has waited for `max_wait`, whichever comes first.
+///
+/// The protocol is binary and uses the native byte order, since both ends live on the same machine:
+///   - upon connection, the server sends two `u32`, the number of input and output values per sample;
+///   - a request is a `u32` number of samples followed by as many samples of `f32` input values;
+///   - a response is a `u32` number of samples followed by as many samples of `f32` output values. A response
+///     of zero samples reports a failed request.
+///
+/// A connection carries one request at a time; concurrent callers use one connection each.
+///
+/// \see Client
+namespace cbx::serve {
+
+/// \brief The settings of a `Server`.
+struct ServerConfig {
+  /// \brief The path of the Unix domain socket; an existing file at this path is replaced.
+  std::string socket_path = {};
+
+  /// \brief The maximum number of samples per batch.
+  usize max_batch_size = 32;
+
+  /// \brief The maximum time that a request waits for others to join its batch.
+  std::chrono::microseconds max_wait = std::chrono::microseconds{1000};
+};
+
+/// \brief A snapshot of the activity of a `Server`.
+struct Statistics {
+  /// \brief The number of requests answered.
+  usize requests = {};
+
+  /// \brief The number of samples answered.
+  usize samples = {};
+
+  /// \brief The number of batches run.
+  usize batches = {};
+
+  /// \brief The time elapsed since the server was started, in seconds.
+  f64 seconds = {};
+
+  /// \brief The median latency of the recent requests, in microseconds.
+  f64 latency_p50 = {};
+
+  /// \brief The 90th percentile of the latency of the recent requests, in microseconds.
+  f64 latency_p90 = {};
+
+  /// \brief The 99th percentile of the latency of the recent requests, in microseconds.
+  f64 latency_p99 = {};
+
+  /// \brief The maximum latency of the recent requests, in microseconds.
+  f64 latency_max = {};
+
+  /// \brief The number of batches of each size, i.e., `batch_sizes[b]` batches held `b` samples.
+  std::vector<usize> batch_sizes = {};
+
+  /// \brief Returns the number of samples answered per second.
+  /// \return The throughput.
+  [[nodiscard]] auto throughput() const noexcept -> f64;
+
+  /// \brief Returns the average number of samples per batch.
+  /// \return The mean batch size.
+  [[nodiscard]] auto mean_batch_size() const noexcept -> f64;
+
+  /// \brief Returns the statistics as a string, including the non-empty bins of the batch-size histogram.
+  /// \return A multi-line description of the statistics.
+  [[nodiscard]] auto to_string() const -> std::string;
+};
+
+/// \brief The `Server` class serves a network over a Unix domain socket with dynamic batching.
+///
+/// \details
+/// Each connection is handled by a thread of its own, which reads a request, queues it and waits for its
+/// result. A single batching thread collects the queued requests, copies them into one input matrix, runs a
+/// plan compiled for that batch size, and scatters the rows of the output back to the waiting requests. Plans
+/// are compiled on first use of each batch size and kept for the lifetime of the server.
+///
+/// The latency of a request is measured from the moment it has been read until its result is available, i.e.,
+/// it covers queueing, batching and inference, but not the transfer over the socket. Percentiles are computed
+/// over the most recent `LATENCY_WINDOW` requests.
+class Server {
+ public:
+  using value_type = f32;
+
+  using size_type = usize;
+
+  using clock = std::chrono::steady_clock;
+
+  using time_point = clock::time_point;
+
+  /// \brief The number of recent requests over which latency percentiles are computed.
+  static constexpr size_type LATENCY_WINDOW = size_type{1} << 16;
+
+  /// \brief The maximum number of samples per request.
+  static constexpr size_type MAX_REQUEST_SAMPLES = size_type{1} << 16;
+
+ private:
+  /// \brief A queued request.
+  struct Request {
+    /// \brief The number of samples.
+    size_type samples = {};
+
+    /// \brief The input values of the samples.
+    std::vector<value_type> input = {};
+
+    /// \brief The output values of the samples.
+    std::vector<value_type> output = {};
+
+    /// \brief The moment the request was read.
+    time_point arrival = {};
+
+    /// \brief Fulfilled once the output is available.
+    std::promise<void> done = {};
+  };
+
+  /// \brief An accepted connection.
+  struct Connection {
+    /// \brief The socket of the connection.
+    int fd = -1;
+
+    /// \brief The thread serving the connection.
+    std::thread thread = {};
+
+    /// \brief A flag indicating whether the thread has returned.
+    bool finished = {};
+  };
+
+  /// \brief The network being served.
+  NeuralNet net_;
+
+  /// \brief The settings.
+  ServerConfig config_ = {};
+
+  /// \brief The number of input values per sample.
+  size_type input_size_ = {};
+
+  /// \brief The number of output values per sample.
+  size_type output_size_ = {};
+
+  /// \brief The listening socket.
+  int listen_fd_ = -1;
+
+  /// \brief The thread accepting connections.
+  std::thread acceptor_ = {};
+
+  /// \brief The thread forming and running batches.
+  std::thread batcher_ = {};
+
+  /// \brief The accepted connections.
+  std::list<Connection> connections_ = {};
+
+  /// \brief Guards the connections.
+  std::mutex connections_mutex_ = {};
+
+  /// \brief The requests waiting to be batched, oldest first.
+  std::deque<Request *> queue_ = {};
+
+  /// \brief The total number of samples in the queue.
+  size_type queued_samples_ = {};
+
+  /// \brief Guards the queue and the stop flag.
+  std::mutex mutex_ = {};
+
+  /// \brief Signals the batching thread upon the arrival of a request or a stop.
+  std::condition_variable cv_ = {};
+
+  /// \brief A flag for stopping the server.
+  bool stop_ = {};
+
+  /// \brief The plans compiled so far, by batch size; only touched by the batching thread.
+  std::unordered_map<size_type, ExecutionPlan> plans_ = {};
+
+  /// \brief The context of the batching thread.
+  ExecutionContext context_ = {};
+
+  /// \brief The moment the server was started.
+  time_point started_ = {};
+
+  /// \brief The counters of the statistics.
+  Statistics statistics_ = {};
+
+  /// \brief The latencies of the most recent requests, in microseconds, used as a ring buffer.
+  std::vector<f64> latencies_ = {};
+
+  /// \brief The number of latencies recorded so far.
+  size_type latencies_recorded_ = {};
+
+  /// \brief Guards the statistics.
+  mutable std::mutex statistics_mutex_ = {};
+
+  // /////////////////////////////////////////////
+  // Helpers
+  // /////////////////////////////////////////////
+
+  /// \brief The routine of the thread accepting connections.
+  auto _m_accept() -> void;
+
+  /// \brief The routine of a thread serving a connection.
+  /// \param[in] connection The connection.
+  auto _m_serve(Connection &connection) -> void;
+
+  /// \brief The routine of the batching thread.
+  auto _m_batch() -> void;
+
+  /// \brief Runs a batch of requests and fulfills them.
+  /// \param[in] batch The requests.
+  /// \param[in] samples The total number of samples of the requests.
+  /// \param[in, out] input, output Buffers for the input and output matrices of the batch.
+  auto _m_run(const std::vector<Request *> &batch, size_type samples, std::vector<value_type> &input,
+              std::vector<value_type> &output) -> void;
+
+ public:
+  // /////////////////////////////////////////////
+  // Constructors and Destructors
+  // /////////////////////////////////////////////
+
+  /// \brief Parameterized constructor.
+  /// \param[in] net The network to be served.
+  /// \param[in] config The settings.
+  ///
+  /// \details
+  /// The server shares the layers of `net.fold()`, i.e., those of \p net except for batch normalizations and
+  /// the layers they are folded into; they must not be modified while it is running. This function throws an
+  /// exception if the network has no layers, if the socket path is empty or too long, or if the maximum batch
+  /// size is zero.
+  ///
+  /// \throws ValueError
+  Server(NeuralNet net, ServerConfig config);
+
+  /// \brief Deleted copy constructor.
+  Server(const Server &other) = delete;
+
+  /// \brief Destructor.
+  ///
+  /// \details
+  /// The destructor stops the server.
+  ~Server();
+
+  // /////////////////////////////////////////////
+  // Assignment Operators
+  // /////////////////////////////////////////////
+
+  /// \brief Deleted copy assignment operator.
+  auto operator=(const Server &other) -> Server & = delete;
+
+  // /////////////////////////////////////////////
+  // Accessors and Mutators
+  // /////////////////////////////////////////////
+
+  /// \brief Returns the settings.
+  /// \return An immutable reference to the settings.
+  [[nodiscard]] auto config() const noexcept -> const ServerConfig &;
+
+  // /////////////////////////////////////////////
+  // Query Functions
+  // /////////////////////////////////////////////
+
+  /// \brief Returns the number of input values per sample.
+  /// \return The input size.
+  [[nodiscard]] auto input_size() const noexcept -> size_type;
+
+  /// \brief Returns the number of output values per sample.
+  /// \return The output size.
+  [[nodiscard]] auto output_size() const noexcept -> size_type;
+
+  /// \brief Returns whether the server is accepting connections.
+  /// \return True if the server has been started and not stopped.
+  [[nodiscard]] auto is_running() const noexcept -> bool;
+
+  /// \brief Returns a snapshot of the activity of the server.
+  /// \return The statistics.
+  [[nodiscard]] auto statistics() const -> Statistics;
+
+  // /////////////////////////////////////////////
+  // Core Functionality
+  // /////////////////////////////////////////////
+
+  /// \brief Binds the socket and starts serving in the background.
+  ///
+  /// \details
+  /// This function throws an exception if the server is already running or if the socket cannot be bound.
+  ///
+  /// \throws SocketError
+  auto start() -> void;
+
+  /// \brief Stops serving.
+  ///
+  /// \details
+  /// Requests that have already been queued are answered; connections are then closed and the socket file is
+  /// removed. Stopping a server that is not running has no effect.
+  auto stop() -> void;
+};
+
+/// \brief The `Client` class sends inference requests to a `Server`.
+///
+/// \details
+/// A client holds one connection, over which it sends one request at a time; it is therefore not meant to be
+/// shared by threads.
+class Client {
+ public:
+  using value_type = f32;
+
+  using size_type = usize;
+
+  using tensor_type = Tensor<value_type>;
+
+ private:
+  /// \brief The socket of the connection.
+  int fd_ = -1;
+
+  /// \brief The number of input values per sample.
+  size_type input_size_ = {};
+
+  /// \brief The number of output values per sample.
+  size_type output_size_ = {};
+
+ public:
+  // /////////////////////////////////////////////
+  // Constructors and Destructors
+  // /////////////////////////////////////////////
+
+  /// \brief Connects to a server.
+  /// \param[in] socket_path The path of the socket of the server.
+  ///
+  /// \details
+  /// This function throws an exception if the connection cannot be established.
+  ///
+  /// \throws SocketError
+  explicit Client(const std::string &socket_path);
+
+  /// \brief Deleted copy constructor.
+  Client(const Client &other) = delete;
+
+  /// \brief Move constructor.
+  /// \param[in] other Source client.
+  Client(Client &&other) noexcept;
+
+  /// \brief Destructor.
+  ///
+  /// \details
+  /// The destructor closes the connection.
+  ~Client();
+
+  // /////////////////////////////////////////////
+  // Assignment Operators
+  // /////////////////////////////////////////////
+
+  /// \brief Deleted copy assignment operator.
+  auto operator=(const Client &other) -> Client & = delete;
+
+  /// \brief Move assignment operator.
+  /// \param[in] other Source client.
+  /// \return A reference to self.
+  auto operator=(Client &&other) noexcept -> Client &;
+
+  // /////////////////////////////////////////////
+  // Query Functions
+  // /////////////////////////////////////////////
+
+  /// \brief Returns the number of input values per sample expected by the server.
+  /// \return The input size.
+  [[nodiscard]] auto input_size() const noexcept -> size_type;
+
+  /// \brief Returns the number of output values per sample returned by the server.
+  /// \return The output size.
+  [[nodiscard]] auto output_size() const noexcept -> size_type;
+
+  // /////////////////////////////////////////////
+  // Core Functionality
+  // /////////////////////////////////////////////
+
+  /// \brief Runs inference on the server.
+  /// \param[in] input The input, whose first axis holds the samples.
+  /// \return The output, of shape (samples, `output_size()`).
+  ///
+  /// \details
+  /// This function throws an exception if \p input does not hold a whole number of samples, or if the server
+  /// fails the request or the connection breaks.
+  ///
+  /// \throws ShapeError
+  /// \throws SocketError
+  [[nodiscard]] auto infer(const tensor_type &input) -> tensor_type;
+};
+
+}
+
+#endif
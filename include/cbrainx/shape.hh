@@ -376,6 +376,41 @@ class Shape {
   [[nodiscard]] auto slice(size_type start_pos) const -> Shape;
 };
 
+/// \brief The `FixedShape` class template represents a shape that is known at compile time.
+/// \tparam Dims The dimensions of each axis.
+///
+/// \details
+/// A fixed shape carries its dimensions in its type, which allows functions to select kernels specialized for
+/// these dimensions at compile time. It is stateless and converts to a `Shape` when needed.
+///
+/// \see Shape
+template <usize... Dims>
+struct FixedShape {
+  static_assert(sizeof...(Dims) > 0, "cbx::FixedShape: rank must be non-zero");
+  static_assert(((Dims > 0) and ...), "cbx::FixedShape: dimensions must be non-zero");
+
+  /// \brief The rank of the shape.
+  static constexpr usize RANK = sizeof...(Dims);
+
+  /// \brief The total number of elements.
+  static constexpr usize TOTAL = (Dims * ...);
+
+  /// \brief Returns the equivalent dynamic shape.
+  /// \return A `Shape` with the same dimensions.
+  [[nodiscard]] static auto to_shape() -> Shape { return Shape{Dims...}; }
+
+  /// \brief Checks whether a dynamic shape is identical to this one.
+  /// \param[in] shape The shape to be checked.
+  /// \return True if \p shape has the same rank and dimensions.
+  [[nodiscard]] static auto matches(const Shape &shape) noexcept -> bool {
+    if (shape.rank() != RANK) {
+      return false;
+    }
+    auto axis = usize{};
+    return ((shape[axis++] == Dims) and ...);
+  }
+};
+
 // /////////////////////////////////////////////////////////////
 // External Functions
 // /////////////////////////////////////////////////////////////
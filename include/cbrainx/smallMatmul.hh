@@ -0,0 +1,158 @@
+// Copyright 2021 CBrainX
+// Project URL: https://github.com/mansoormemon/cbrainx
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Copyright (c) 2021 Mansoor Ahmed Memon <mansoorahmed.one@gmail.com>
+
+#ifndef CBRAINX__SMALL_MATMUL_HH_
+#define CBRAINX__SMALL_MATMUL_HH_
+
+#include <algorithm>
+#include <array>
+#include <utility>
+
+#include "typeAliases.hh"
+
+namespace cbx {
+
+/// \brief The largest order of square products that `small_matmul` dispatches to a fully unrolled kernel.
+inline constexpr usize SMALL_MATMUL_MAX_ORDER = 16;
+
+/// \brief The largest number of multiply-adds (`m * n * k`) that `small_matmul` handles.
+inline constexpr usize SMALL_MATMUL_MAX_VOLUME =
+    SMALL_MATMUL_MAX_ORDER * SMALL_MATMUL_MAX_ORDER * SMALL_MATMUL_MAX_ORDER;
+
+/// \brief Returns whether `small_matmul` computes a product of the specified dimensions.
+/// \param[in] m, n, k The dimensions of the product.
+/// \return True if the product is small enough.
+constexpr auto is_small_matmul(usize m, usize n, usize k) -> bool {
+  return m * n * k <= SMALL_MATMUL_MAX_VOLUME;
+}
+
+// /////////////////////////////////////////////
+// Implementation Detail
+// /////////////////////////////////////////////
+
+namespace _detail {
+
+/// \brief Accumulates `x * b[j]` into `acc[j]` for every column, unrolled.
+template <typename R, typename T, typename U, usize... Js>
+constexpr auto small_axpy(R *acc, const T &x, const U *b, std::index_sequence<Js...>) -> void {
+  ((acc[Js] += x * b[Js]), ...);
+}
+
+/// \brief Computes one row of an `M × N × K` product, unrolled over the depth and the columns.
+template <usize N, typename T, typename U, typename R, usize... Ks>
+constexpr auto small_row(const T *a, const U *b, R *c, std::index_sequence<Ks...>) -> void {
+  R acc[N] = {};
+  (small_axpy(acc, a[Ks], b + Ks * N, std::make_index_sequence<N>{}), ...);
+  std::copy(acc, acc + N, c);
+}
+
+}
+
+// /////////////////////////////////////////////
+// Fixed-size Kernels
+// /////////////////////////////////////////////
+
+/// \brief Multiplies an `M × K` matrix with a `K × N` matrix, with all dimensions known at compile time.
+/// \tparam M, N, K The dimensions of the product.
+/// \param[in] a The row-major `M × K` matrix.
+/// \param[in] b The row-major `K × N` matrix.
+/// \param[out] c The row-major `M × N` product, which is overwritten.
+///
+/// \details
+/// The depth and column loops are fully unrolled, and each row is accumulated in registers. Every element of
+/// the product is summed in the same order as the schoolbook loop, so the result is identical to it. It may
+/// differ from `gemm` in the last bits, since the microkernels of `gemm` fuse each multiply-add.
+template <usize M, usize N, usize K, typename T, typename U, typename R>
+constexpr auto fixed_matmul(const T *a, const U *b, R *c) -> void {
+  static_assert(M > 0 and N > 0 and K > 0, "cbx::fixed_matmul: dimensions must be non-zero");
+  for (usize i = {}; i < M; ++i) {
+    _detail::small_row<N>(a + i * K, b, c + i * N, std::make_index_sequence<K>{});
+  }
+}
+
+/// \brief Multiplies two matrices stored in `std::array`s, with all dimensions known at compile time.
+/// \tparam M, N, K The dimensions of the product.
+/// \param[in] a The row-major `M × K` matrix.
+/// \param[in] b The row-major `K × N` matrix.
+/// \return The row-major `M × N` product.
+///
+/// \see fixed_matmul
+template <usize M, usize N, usize K, typename T, typename U, typename R = decltype(T{} * U{})>
+constexpr auto matmul(const std::array<T, M * K> &a, const std::array<U, K * N> &b) -> std::array<R, M * N> {
+  auto c = std::array<R, M * N>{};
+  fixed_matmul<M, N, K>(a.data(), b.data(), c.data());
+  return c;
+}
+
+// /////////////////////////////////////////////
+// Runtime Dispatch
+// /////////////////////////////////////////////
+
+namespace _detail {
+
+template <typename T, typename U, typename R>
+using small_kernel_type = void (*)(const T *, const U *, R *);
+
+/// \brief Builds a table of the square kernels, where entry `i` multiplies matrices of order `i + 1`.
+template <typename T, typename U, typename R, usize... Is>
+constexpr auto square_kernels(std::index_sequence<Is...>)
+    -> std::array<small_kernel_type<T, U, R>, sizeof...(Is)> {
+  return {&fixed_matmul<Is + 1, Is + 1, Is + 1, T, U, R>...};
+}
+
+}
+
+/// \brief Multiplies small matrices without any blocking, tuning or threading.
+/// \param[in] a The row-major `m × k` matrix.
+/// \param[in] b The row-major `k × n` matrix.
+/// \param[out] c The row-major `m × n` product, which is overwritten.
+/// \param[in] m, n, k The dimensions of the product.
+/// \return True if the product was small enough to be computed, otherwise false and \p c is left untouched.
+///
+/// \details
+/// For products this small, the setup of the general path costs more than the arithmetic. Square products up
+/// to `SMALL_MATMUL_MAX_ORDER` are switched to their fully unrolled `fixed_matmul` kernel; other products of at
+/// most `SMALL_MATMUL_MAX_VOLUME` multiply-adds run a plain loop over raw pointers. Either way, the result is
+/// identical to the schoolbook loop, and may therefore differ from `gemm` by rounding.
+template <typename T, typename U, typename R>
+auto small_matmul(const T *a, const U *b, R *c, usize m, usize n, usize k) -> bool {
+  if (not is_small_matmul(m, n, k)) {
+    return false;
+  }
+  if (m == n and n == k and n != 0) {
+    static constexpr auto KERNELS =
+        _detail::square_kernels<T, U, R>(std::make_index_sequence<SMALL_MATMUL_MAX_ORDER>{});
+    KERNELS[n - 1](a, b, c);
+    return true;
+  }
+  for (usize i = {}; i < m; ++i) {
+    auto c_row = c + i * n;
+    std::fill(c_row, c_row + n, R{});
+    for (usize p = {}; p < k; ++p) {
+      auto x = a[i * k + p];
+      auto b_row = b + p * n;
+      for (usize j = {}; j < n; ++j) {
+        c_row[j] += x * b_row[j];
+      }
+    }
+  }
+  return true;
+}
+
+}
+
+#endif
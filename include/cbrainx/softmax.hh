@@ -18,6 +18,9 @@
 #ifndef CBRAINX__SOFT_MAX_HH_
 #define CBRAINX__SOFT_MAX_HH_
 
+#include <memory>
+#include <span>
+
 #include "abstractLayer.hh"
 #include "tensor.hh"
 #include "typeAliases.hh"
@@ -102,6 +105,11 @@ class Softmax : public AbstractLayer {
   /// \return The number of modifiable parameters in the layer.
   [[nodiscard]] auto parameters() const -> size_type override;
 
+  /// \brief Returns the shape of the output layer of one sample.
+  /// \param[in] input_shape The shape of the input layer of one sample.
+  /// \return \p input_shape, as normalizing the scores leaves their layout unchanged.
+  [[nodiscard]] auto output_shape(const Shape &input_shape) const -> Shape override;
+
   /// \brief Returns the type of the layer.
   /// \return The type of the layer.
   ///
@@ -116,6 +124,14 @@ class Softmax : public AbstractLayer {
   /// \return Information about the layer's properties as a string.
   [[nodiscard]] auto property() const -> std::string override;
 
+  // /////////////////////////////////////////////
+  // Utility
+  // /////////////////////////////////////////////
+
+  /// \brief Returns a deep copy of the layer.
+  /// \return A new layer with its own parameters, gradients and caches.
+  [[nodiscard]] auto clone() const -> std::shared_ptr<AbstractLayer> override;
+
   // /////////////////////////////////////////////
   // Core Functionality
   // /////////////////////////////////////////////
@@ -124,6 +140,24 @@ class Softmax : public AbstractLayer {
   /// \param[in] input The input layer.
   /// \return A reference to self.
   [[nodiscard]] auto forward_pass(const container &input) const -> const AbstractLayer & override;
+
+  /// \brief Applies the softmax function to each row of a row-major matrix.
+  /// \param[in] x The input rows.
+  /// \param[out] y The output rows, of the same size as \p x; it must not overlap \p x.
+  /// \param[in] classes The number of columns.
+  static auto apply(std::span<const value_type> x, std::span<value_type> y, size_type classes) -> void;
+
+  /// \brief Forward pass for inference, which writes into caller-provided memory and caches nothing.
+  /// \param[in] input The input layer.
+  /// \param[out] output The output layer, of the same shape as \p input; it must not overlap \p input.
+  auto infer(TensorView<const value_type> input, TensorView<value_type> output) const -> void override;
+
+  /// \brief Backward pass.
+  /// \param[in] output_gradient The gradient of the loss w.r.t. the output layer of the last forward pass.
+  /// \return A reference to self.
+  ///
+  /// \throws ShapeError
+  [[nodiscard]] auto backward_pass(const container &output_gradient) const -> const AbstractLayer & override;
 };
 
 }
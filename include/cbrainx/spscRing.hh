@@ -0,0 +1,150 @@
+// Copyright 2021 CBrainX
+// Project URL: https://github.com/mansoormemon/cbrainx
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Copyright (c) 2021 Mansoor Ahmed Memon <mansoorahmed.one@gmail.com>
+#ifndef CBRAINX__SPSC_RING_HH_
+#define CBRAINX__SPSC_RING_HH_
+
+#include <atomic>
+#include <vector>
+
+#include "exceptions.hh"
+#include "typeAliases.hh"
+
+namespace cbx {
+
+/// \brief The `SpscRing` class represents a bounded, lock-free queue between one producer and one consumer.
+/// \tparam T Data type of the slots.
+///
+/// \details
+/// The slots are allocated once and used in place: the producer acquires the next free slot, fills it and
+/// publishes it, while the consumer takes the oldest published slot, reads it and releases it for reuse. No
+/// element is ever copied or allocated by the ring itself, so that slots may hold large buffers.
+///
+/// Each side owns one counter, which only it writes. The producer publishes a slot by a release store of its
+/// counter that the consumer observes with an acquire load, and vice versa, so the contents of a slot are
+/// always visible to the side that is handed it. Both counters live on cache lines of their own.
+///
+/// Exactly one thread may act as the producer and exactly one as the consumer at any given time.
+template <typename T>
+class SpscRing {
+ public:
+  using value_type = T;
+
+  using size_type = usize;
+
+  /// \brief The assumed size of a cache line in bytes.
+  static constexpr size_type CACHE_LINE = 64;
+
+ private:
+  /// \brief The slots.
+  std::vector<value_type> slots_ = {};
+
+  /// \brief The number of slots released by the consumer, written only by the consumer.
+  alignas(CACHE_LINE) std::atomic<size_type> head_ = {};
+
+  /// \brief The number of slots published by the producer, written only by the producer.
+  alignas(CACHE_LINE) std::atomic<size_type> tail_ = {};
+
+ public:
+  // /////////////////////////////////////////////
+  // Constructors and Destructors
+  // /////////////////////////////////////////////
+
+  /// \brief Parameterized constructor.
+  /// \param[in] capacity The number of slots.
+  /// \param[in] prototype The initial value of every slot.
+  ///
+  /// \details
+  /// This function throws an exception if \p capacity is zero.
+  ///
+  /// \throws ValueError
+  explicit SpscRing(size_type capacity, const value_type &prototype = {}) : slots_(capacity, prototype) {
+    if (capacity == 0) {
+      throw ValueError{"cbx::SpscRing::SpscRing: capacity must be positive"};
+    }
+  }
+
+  /// \brief Deleted copy constructor.
+  SpscRing(const SpscRing &other) = delete;
+
+  /// \brief Default destructor.
+  ~SpscRing() = default;
+
+  // /////////////////////////////////////////////
+  // Assignment Operators
+  // /////////////////////////////////////////////
+
+  /// \brief Deleted copy assignment operator.
+  auto operator=(const SpscRing &other) -> SpscRing & = delete;
+
+  // /////////////////////////////////////////////
+  // Query Functions
+  // /////////////////////////////////////////////
+
+  /// \brief Returns the number of slots.
+  /// \return The capacity of the ring.
+  [[nodiscard]] auto capacity() const noexcept -> size_type { return slots_.size(); }
+
+  /// \brief Returns the number of published slots that have not been released yet.
+  /// \return The number of occupied slots.
+  ///
+  /// \note The result is only a snapshot while either side is active.
+  [[nodiscard]] auto size() const noexcept -> size_type {
+    return tail_.load(std::memory_order_acquire) - head_.load(std::memory_order_acquire);
+  }
+
+  // /////////////////////////////////////////////
+  // Producer
+  // /////////////////////////////////////////////
+
+  /// \brief Returns the next free slot without publishing it.
+  /// \return Pointer to the slot, or `nullptr` if the ring is full.
+  [[nodiscard]] auto acquire() noexcept -> value_type * {
+    auto tail = tail_.load(std::memory_order_relaxed);
+    if (tail - head_.load(std::memory_order_acquire) == slots_.size()) {
+      return nullptr;
+    }
+    return &slots_[tail % slots_.size()];
+  }
+
+  /// \brief Hands the slot returned by the last `acquire` over to the consumer.
+  auto publish() noexcept -> void {
+    tail_.store(tail_.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+  }
+
+  // /////////////////////////////////////////////
+  // Consumer
+  // /////////////////////////////////////////////
+
+  /// \brief Returns the oldest published slot without releasing it.
+  /// \return Pointer to the slot, or `nullptr` if the ring is empty.
+  [[nodiscard]] auto front() noexcept -> value_type * {
+    auto head = head_.load(std::memory_order_relaxed);
+    if (tail_.load(std::memory_order_acquire) == head) {
+      return nullptr;
+    }
+    return &slots_[head % slots_.size()];
+  }
+
+  /// \brief Hands the slot returned by the last `front` back to the producer.
+  auto release() noexcept -> void {
+    head_.store(head_.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+  }
+};
+
+}
+
+#endif
@@ -19,19 +19,28 @@
 #define CBRAINX__TENSOR_HH_
 
 #include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <functional>
 #include <iterator>
 #include <numeric>
 #include <random>
 #include <ranges>
 #include <string>
 #include <thread>
+#include <tuple>
 #include <utility>
+#include <vector>
 
 #include <fmt/format.h>
 
 #include "exceptions.hh"
 #include "iterators.hh"
+#include "numa.hh"
 #include "shape.hh"
+#include "smallMatmul.hh"
+#include "threadPool.hh"
+#include "tune.hh"
 #include "typeAliases.hh"
 #include "typeConcepts.hh"
 
@@ -57,7 +66,7 @@ class Tensor {
  public:
   using value_type = T;
 
-  using container = std::vector<value_type>;
+  using container = std::vector<value_type, FirstTouchAllocator<value_type>>;
 
   using reference = typename container::reference;
   using const_reference = typename container::const_reference;
@@ -88,6 +97,15 @@ class Tensor {
   static constexpr size_type MATRIX_RANK = 2;
 
  private:
+  /// \brief Minimum number of elements handed to a thread by the parallel indexing operations.
+  static constexpr size_type PARALLEL_GRAIN = 1 << 15;
+
+  /// \brief Number of slices to look ahead when prefetching random-access sources.
+  static constexpr size_type PREFETCH_DISTANCE = 8;
+
+  /// \brief `topk` uses a bounded heap if the extent is at least this many times larger than `k`.
+  static constexpr size_type SELECTION_HEAP_RATIO = 8;
+
   /// \brief A flag for enabling or disabling bounds checking.
   ///
   /// \note This attribute is mutable and does not account for the constness of the tensor.
@@ -97,7 +115,7 @@ class Tensor {
   Shape shape_ = {};
 
   /// \brief Actual data.
-  container data_ = container(shape_.total());
+  container data_ = container(shape_.total(), value_type{});
 
   // /////////////////////////////////////////////
   // Helpers
@@ -299,6 +317,108 @@ class Tensor {
     }
   }
 
+  /// \brief Checks if the given axis exists.
+  /// \param[in] axis The axis to be checked.
+  ///
+  /// \details
+  /// This function throws an exception if \p axis is not less than the rank.
+  ///
+  /// \throws ValueError
+  auto _m_check_axis(size_type axis) const -> void {
+    if (axis >= rank()) {
+      throw ValueError{"cbx::Tensor::_m_check_axis: axis = {} must be less than this->rank() = {}", axis,
+                       rank()};
+    }
+  }
+
+  /// \brief Converts a range of indices to offsets along an axis.
+  /// \tparam R Type of the range.
+  /// \param[in] indices The indices to be converted.
+  /// \param[in] axis The axis that the indices refer to.
+  /// \return The indices as offsets along \p axis.
+  ///
+  /// \details
+  /// The indices are validated up front so that no worker thread ever touches memory out of bounds and a
+  /// failing in-place operation leaves the tensor untouched.
+  ///
+  /// This function throws an exception if any index is out of range w.r.t. \p axis.
+  ///
+  /// \throws IndexOutOfBoundsError
+  template <std::ranges::range R>
+  [[nodiscard]] auto _m_axis_offsets(const R &indices, size_type axis) const -> std::vector<size_type> {
+    auto extent = shape_[axis];
+    auto offsets = std::vector<size_type>{};
+    if constexpr (std::ranges::sized_range<R>) {
+      offsets.reserve(std::ranges::size(indices));
+    }
+    for (auto index : indices) {
+      auto is_negative = false;
+      if constexpr (std::is_signed_v<decltype(index)>) {
+        is_negative = index < 0;
+      }
+      auto offset = size_type(index);
+      if (is_negative or offset >= extent) {
+        throw IndexOutOfBoundsError{
+            "cbx::Tensor::_m_axis_offsets: index = {} is out of range for this->shape() [axis = {}] = {}",
+            index, axis, extent};
+      }
+      offsets.push_back(offset);
+    }
+    return offsets;
+  }
+
+  /// \brief Checks if an index tensor conforms with this tensor for a gather or scatter along an axis.
+  /// \param[in] other The shape of the index tensor.
+  /// \param[in] axis The axis along which the indices are applied.
+  ///
+  /// \details
+  /// This function throws an exception if \p other differs from `this->shape()` along any axis but \p axis.
+  ///
+  /// \throws RankError
+  /// \throws ShapeError
+  auto _m_check_index_shape(const Shape &other, size_type axis) const -> void {
+    if (other.rank() != rank()) {
+      throw RankError{
+          "cbx::Tensor::_m_check_index_shape: rank of other = {} must be equal to this->rank() = {}",
+          other.rank(), rank()};
+    }
+    for (size_type i = {}; i < rank(); ++i) {
+      if (i != axis and other[i] != shape_[i]) {
+        throw ShapeError{"cbx::Tensor::_m_check_index_shape: other = {} must match this->shape() = {} along "
+                         "all axes except axis = {}",
+                         other.to_string(), shape_.to_string(), axis};
+      }
+    }
+  }
+
+  /// \brief Splits the shape around an axis.
+  /// \param[in] axis The pivot axis.
+  /// \return The number of elements before, along and after \p axis.
+  [[nodiscard]] auto _m_split_around(size_type axis) const -> std::tuple<size_type, size_type, size_type> {
+    auto outer = std::accumulate(shape_.begin(), shape_.begin() + axis, size_type{1}, std::multiplies{});
+    auto inner = std::accumulate(shape_.begin() + axis + 1, shape_.end(), size_type{1}, std::multiplies{});
+    return {outer, shape_[axis], inner};
+  }
+
+  /// \brief Runs an element-wise loop over all the elements in parallel.
+  /// \param[in] body The loop body, invoked with the half-open range of elements it is responsible for.
+  ///
+  /// \details
+  /// Every element-wise loop is partitioned the same way, so a thread always touches the same share of a
+  /// buffer. Together with `FirstTouchAllocator`, this keeps the pages that a thread works on local to its
+  /// NUMA node.
+  auto _m_parallel_elementwise(const ThreadPool::body_type &body) const -> void {
+    ThreadPool::global().parallel_for(0, total(), PARALLEL_GRAIN, body);
+  }
+
+  /// \brief Hints the processor to fetch the cache line holding \p address for reading.
+  /// \param[in] address The address to be prefetched.
+  static auto _s_prefetch([[maybe_unused]] const void *address) noexcept -> void {
+#if defined(__GNUC__) || defined(__clang__)
+    __builtin_prefetch(address, 0, 1);
+#endif
+  }
+
  public:
   // /////////////////////////////////////////////
   // Constructors and Destructors
@@ -322,7 +442,27 @@ class Tensor {
   /// \brief Constructs a tensor of the specified shape with the initial value \p value for all its elements.
   /// \param[in] shape The shape of the tensor.
   /// \param[in] value The initializing value for all the elements.
-  explicit Tensor(const Shape &shape, value_type value = {}) : shape_{shape}, data_(shape.total(), value) {}
+  ///
+  /// \details
+  /// The elements are initialized in parallel so that the pages of a large tensor are distributed among the
+  /// NUMA nodes the same way as later element-wise work.
+  explicit Tensor(const Shape &shape, value_type value = {}) : shape_{shape}, data_(shape.total()) {
+    _m_parallel_elementwise([this, value](size_type first, size_type last) {
+      std::fill(data_.begin() + first, data_.begin() + last, value);
+    });
+  }
+
+  /// \brief Constructs a tensor of the specified shape whose elements are allocated by \p allocator.
+  /// \param[in] shape The shape of the tensor.
+  /// \param[in] allocator The allocator of the elements.
+  ///
+  /// \details
+  /// The elements are left as they are found in the allocated memory, which lets a tensor adopt existing data,
+  /// e.g., a region of a mapped file bound to the allocator.
+  ///
+  /// \see FirstTouchAllocator
+  Tensor(const Shape &shape, const typename container::allocator_type &allocator)
+      : shape_{shape}, data_(shape.total(), allocator) {}
 
   /// \brief Constructs a tensor of the specified shape with the contents of the range [\p first, `last`).
   /// \param[in] shape The shape of the tensor.
@@ -628,8 +768,12 @@ class Tensor {
   /// \brief Applies the given transformation to all the elements of the tensor.
   /// \param[in] func The transformation function.
   /// \return A reference to self.
-  constexpr auto transform(UnaryOperation auto func) noexcept -> Tensor & {
-    std::transform(begin(), end(), begin(), func);
+  ///
+  /// \note The transformation is applied in parallel and must therefore be free of side effects.
+  constexpr auto transform(UnaryOperation auto func) -> Tensor & {
+    _m_parallel_elementwise([this, &func](size_type first, size_type last) {
+      std::transform(begin() + first, begin() + last, begin() + first, func);
+    });
     return *this;
   }
 
@@ -637,9 +781,18 @@ class Tensor {
   /// \param[in] first An iterator pointing to the beginning of the secondary range.
   /// \param[in] func The transformation function.
   /// \return A reference to self.
+  ///
+  /// \note If \p first is a contiguous iterator, the transformation is applied in parallel and must therefore
+  /// be free of side effects.
   template <std::input_iterator I_It>
-  constexpr auto transform(I_It first, BinaryOperation auto func) noexcept -> Tensor & {
-    std::transform(begin(), end(), first, begin(), func);
+  constexpr auto transform(I_It first, BinaryOperation auto func) -> Tensor & {
+    if constexpr (std::contiguous_iterator<I_It>) {
+      _m_parallel_elementwise([this, first, &func](size_type lo, size_type hi) {
+        std::transform(begin() + lo, begin() + hi, first + lo, begin() + lo, func);
+      });
+    } else {
+      std::transform(begin(), end(), first, begin(), func);
+    }
     return *this;
   }
 
@@ -658,16 +811,20 @@ class Tensor {
   /// \return A reference to self.
   ///
   /// \see Tensor::transform(UnaryOperation auto func)
-  constexpr auto operator|=(UnaryOperation auto func) noexcept -> Tensor & { return transform(func); }
+  constexpr auto operator|=(UnaryOperation auto func) -> Tensor & { return transform(func); }
 
   /// \brief Applies the given transformation to all the elements and returns it as a transformed tensor.
   /// \tparam U The type of new tensor.
   /// \param[in] func The transformation function.
   /// \return The transformed tensor.
+  ///
+  /// \note The transformation is applied in parallel and must therefore be free of side effects.
   template <typename U = value_type>
   [[nodiscard]] constexpr auto transformed(UnaryOperation auto func) const -> Tensor<U> {
     auto result = zeros_like<U>();
-    std::transform(begin(), end(), result.begin(), func);
+    _m_parallel_elementwise([this, &result, &func](size_type first, size_type last) {
+      std::transform(begin() + first, begin() + last, result.begin() + first, func);
+    });
     return result;
   }
 
@@ -676,10 +833,19 @@ class Tensor {
   /// \param[in] first An iterator pointing to the beginning of the secondary range.
   /// \param[in] func The transformation function.
   /// \return The transformed tensor.
+  ///
+  /// \note If \p first is a contiguous iterator, the transformation is applied in parallel and must therefore
+  /// be free of side effects.
   template <typename U = value_type, std::input_iterator I_It>
   [[nodiscard]] constexpr auto transformed(I_It first, BinaryOperation auto func) const -> Tensor<U> {
     auto result = zeros_like<U>();
-    std::transform(begin(), end(), first, result.begin(), func);
+    if constexpr (std::contiguous_iterator<I_It>) {
+      _m_parallel_elementwise([this, &result, first, &func](size_type lo, size_type hi) {
+        std::transform(begin() + lo, begin() + hi, first + lo, result.begin() + lo, func);
+      });
+    } else {
+      std::transform(begin(), end(), first, result.begin(), func);
+    }
     return result;
   }
 
@@ -705,7 +871,7 @@ class Tensor {
   /// \brief Clamps values outside the interval [\p lower_bound, \p upper_bound] to its edges.
   /// \param[in] lower_bound, upper_bound The interval boundaries.
   /// \return A reference to self.
-  constexpr auto clamp(value_type lower_bound, value_type upper_bound) noexcept -> Tensor & {
+  constexpr auto clamp(value_type lower_bound, value_type upper_bound) -> Tensor & {
     return transform([lower_bound, upper_bound](auto x) {
       return std::clamp(x, lower_bound, upper_bound);
     });
@@ -715,7 +881,7 @@ class Tensor {
   /// a clamped tensor.
   /// \param[in] lower_bound, upper_bound The interval boundaries.
   /// \return The clamped tensor.
-  [[nodiscard]] constexpr auto clamped(value_type lower_bound, value_type upper_bound) noexcept -> Tensor {
+  [[nodiscard]] constexpr auto clamped(value_type lower_bound, value_type upper_bound) -> Tensor {
     return transformed([lower_bound, upper_bound](auto x) {
       return std::clamp(x, lower_bound, upper_bound);
     });
@@ -728,7 +894,7 @@ class Tensor {
   /// \brief Add and assign operator.
   /// \param[in] num A scalar operand.
   /// \return A reference to self.
-  constexpr auto operator+=(Number auto num) noexcept -> Tensor & {
+  constexpr auto operator+=(Number auto num) -> Tensor & {
     return transform([num](auto x) {
       return x + num;
     });
@@ -737,7 +903,7 @@ class Tensor {
   /// \brief Subtract and assign operator.
   /// \param[in] num A scalar operand.
   /// \return A reference to self.
-  constexpr auto operator-=(Number auto num) noexcept -> Tensor & {
+  constexpr auto operator-=(Number auto num) -> Tensor & {
     return transform([num](auto x) {
       return x - num;
     });
@@ -746,7 +912,7 @@ class Tensor {
   /// \brief Multiply and assign operator.
   /// \param[in] num A scalar operand.
   /// \return A reference to self.
-  constexpr auto operator*=(Number auto num) noexcept -> Tensor & {
+  constexpr auto operator*=(Number auto num) -> Tensor & {
     return transform([num](auto x) {
       return x * num;
     });
@@ -755,7 +921,7 @@ class Tensor {
   /// \brief Divide and assign operator.
   /// \param[in] num A scalar operand.
   /// \return A reference to self.
-  constexpr auto operator/=(Number auto num) noexcept -> Tensor & {
+  constexpr auto operator/=(Number auto num) -> Tensor & {
     return transform([num](auto x) {
       return x / num;
     });
@@ -764,7 +930,7 @@ class Tensor {
   /// \brief Modulus and assign operator.
   /// \param[in] num A scalar operand.
   /// \return A reference to self.
-  constexpr auto operator%=(Number auto num) noexcept -> Tensor & {
+  constexpr auto operator%=(Number auto num) -> Tensor & {
     return transform([num](auto x) {
       return fmod(x, num);
     });
@@ -875,6 +1041,10 @@ class Tensor {
   /// \return The resultant tensor.
   ///
   /// \details
+  /// Products of at most `SMALL_MATMUL_MAX_VOLUME` multiply-adds are computed directly by `small_matmul`.
+  /// Larger single-precision matrices are multiplied by the cache-blocked kernel `gemm`, using the
+  /// configuration that `cbx::tune` holds for the class of the product.
+  ///
   /// This function throws an exception if:
   ///     * Either of the tensors does not represent a matrix.
   ///     * The matrices are not compatible for multiplication.
@@ -894,6 +1064,22 @@ class Tensor {
     auto rows = r1, cols = c2, common_axis = c1;
     auto product = Tensor<resultant_value_t>::matrix(rows, cols);
 
+    // Small products are dominated by the setup of the paths below; they go straight to unrolled kernels.
+    if (small_matmul(data(), tensor.data(), product.data(), rows, cols, common_axis)) {
+      return product;
+    }
+
+    // Single-precision products use the blocked kernel with the configuration tuned for this machine.
+    if constexpr (std::is_same_v<value_type, f32> and std::is_same_v<U, f32> and
+                  std::is_same_v<resultant_value_t, f32>) {
+      auto config = tune::lookup(rows, cols, common_axis);
+      if (not multithreading) {
+        config.threads = 1;
+      }
+      gemm(data(), tensor.data(), product.data(), rows, cols, common_axis, config);
+      return product;
+    }
+
     // Based on the number of rows in the product matrix, estimate how many rows will be assigned to each
     // thread.
     auto calculate_rows_per_thread = [](auto rows) -> size_type {
@@ -904,12 +1090,6 @@ class Tensor {
       return std::floor(factor) * (ARBITRARY_CONSTANT_B - ARBITRARY_CONSTANT_A);
     };
 
-    // Calculate how many threads will be required based on the number of total rows and rows assigned to each
-    // thread.
-    auto calculate_threads_required = [](f32 rows, auto rows_per_thread) -> size_type {
-      return std::ceil(rows / rows_per_thread);
-    };
-
     // Disable bounds checking as the loop is counter controlled, so there is no need for bounds checking.
     auto this_bounds_checking_enabled = this->is_bounds_checking_enabled();
     auto tensor_bounds_checking_enabled = tensor.is_bounds_checking_enabled();
@@ -937,24 +1117,11 @@ class Tensor {
       return product;
     }
 
-    auto rows_per_thread = calculate_rows_per_thread(rows);
-    auto threads_required = calculate_threads_required(rows, rows_per_thread);
-
-    // Bookkeeping threads to call later for joining into the main thread.
-    auto threads = std::vector<std::thread>{};
-    threads.reserve(threads_required);
-
-    // Construct each thread with implementation lambda and its parameters.
-    for (size_type current_row = {}; current_row < rows; current_row += rows_per_thread) {
-      auto distance = rows - current_row;
-      auto num_of_rows = std::min(rows_per_thread, distance);
-      threads.emplace_back(impl, current_row, num_of_rows);
-    }
-
-    // Call all threads to join into the main thread.
-    for (auto &thread : threads) {
-      thread.join();
-    }
+    // Rows are handed out in contiguous blocks on the global pool. The product was zeroed with the same
+    // proportional partition, so each socket mostly writes to pages that it has touched first.
+    ThreadPool::global().parallel_for(0, rows, calculate_rows_per_thread(rows), [&impl](auto first, auto last) {
+      impl(first, last - first);
+    });
 
     // Return bounds checking to previous state.
     if (this_bounds_checking_enabled) {
@@ -968,6 +1135,296 @@ class Tensor {
     return product;
   }
 
+  /// \brief Matrix multiplication with dimensions known at compile time.
+  /// \tparam M, K, N The dimensions of the operands, i.e., `M × K` and `K × N`.
+  /// \tparam U Data type of \p tensor.
+  /// \tparam resultant_value_t Data type of the resultant tensor.
+  /// \param[in] tensor A tensor operand.
+  /// \return The resultant tensor.
+  ///
+  /// \details
+  /// The product is computed by the fully unrolled kernel `fixed_matmul<M, N, K>`, which is selected at compile
+  /// time, e.g., `a.matmul(b, FixedShape<4, 4>{}, FixedShape<4, 4>{})`.
+  ///
+  /// This function throws an exception if the shapes of the operands are not `M × K` and `K × N`.
+  ///
+  /// \throws ShapeError
+  template <usize M, usize K, usize N, typename U, typename resultant_value_t = decltype(value_type{} * U{})>
+  auto matmul(const Tensor<U> &tensor, FixedShape<M, K>, FixedShape<K, N>) const -> Tensor<resultant_value_t> {
+    if (not FixedShape<M, K>::matches(shape_) or not FixedShape<K, N>::matches(tensor.shape())) {
+      throw ShapeError{"cbx::Tensor::matmul: shapes {} and {} do not match the fixed shapes {} and {}",
+                       shape_.to_string(), tensor.shape().to_string(), FixedShape<M, K>::to_shape().to_string(),
+                       FixedShape<K, N>::to_shape().to_string()};
+    }
+    auto product = Tensor<resultant_value_t>::matrix(M, N);
+    fixed_matmul<M, N, K>(data(), tensor.data(), product.data());
+    return product;
+  }
+
+  // /////////////////////////////////////////////
+  // Indexing
+  // /////////////////////////////////////////////
+
+  /// \brief Selects slices along an axis.
+  /// \tparam R Type of the range of indices.
+  /// \param[in] axis The axis along which the slices are selected.
+  /// \param[in] indices The indices of the slices to be selected, in order, possibly repeated.
+  /// \return A tensor whose extent along \p axis equals the number of indices.
+  ///
+  /// \details
+  /// Slice `k` of the result along \p axis is a copy of slice `indices[k]` of this tensor. This covers
+  /// embedding lookups (select rows of a table by token) as well as mini-batch assembly from shuffled sample
+  /// indices.
+  ///
+  /// The copy is parallelized over the selected slices and the source of upcoming slices is prefetched, since
+  /// the access pattern is random.
+  ///
+  /// This function throws an exception if:
+  ///     * \p axis is not less than the rank.
+  ///     * \p indices is empty.
+  ///     * Any index is out of range w.r.t. \p axis.
+  ///
+  /// \throws ValueError
+  /// \throws IndexOutOfBoundsError
+  template <std::ranges::range R>
+  [[nodiscard]] auto index_select(size_type axis, const R &indices) const -> Tensor {
+    _m_check_axis(axis);
+    auto offsets = _m_axis_offsets(indices, axis);
+    auto count = offsets.size();
+    if (count == 0) {
+      throw ValueError{"cbx::Tensor::index_select: indices must not be empty"};
+    }
+
+    auto [outer, extent, inner] = _m_split_around(axis);
+    auto result_shape = shape_;
+    result_shape.set_axis(axis, count);
+    auto result = Tensor{result_shape};
+
+    auto source = data();
+    auto destination = result.data();
+    auto slice_bytes = inner * sizeof(value_type);
+    auto grain = std::max(PARALLEL_GRAIN / inner, size_type{1});
+    ThreadPool::global().parallel_for(
+        0, outer * count, grain,
+        [=, &offsets, extent = extent, inner = inner](size_type begin, size_type end) {
+          for (auto slice = begin; slice < end; ++slice) {
+            if (auto ahead = slice + PREFETCH_DISTANCE; ahead < end) {
+              _s_prefetch(source + ((ahead / count) * extent + offsets[ahead % count]) * inner);
+            }
+            auto offset = ((slice / count) * extent + offsets[slice % count]) * inner;
+            std::memcpy(destination + slice * inner, source + offset, slice_bytes);
+          }
+        });
+    return result;
+  }
+
+  /// \brief Gathers elements along an axis.
+  /// \tparam I Data type of the indices.
+  /// \param[in] axis The axis along which the elements are gathered.
+  /// \param[in] indices A tensor of indices along \p axis.
+  /// \return A tensor of the same shape as \p indices.
+  ///
+  /// \details
+  /// For a tensor of rank 3 and `axis = 1`, the result is `result(i, j, k) = this(i, indices(i, j, k), k)`. The
+  /// index tensor must match this tensor along every axis except \p axis, along which it may have any extent.
+  ///
+  /// A typical use is picking the predicted probability of the true class of every sample, i.e., gathering
+  /// along the last axis of a `(samples, classes)` matrix with a `(samples, 1)` tensor of labels.
+  ///
+  /// This function throws an exception if:
+  ///     * \p axis is not less than the rank.
+  ///     * The shape of \p indices does not conform with this tensor.
+  ///     * Any index is out of range w.r.t. \p axis.
+  ///
+  /// \throws ValueError
+  /// \throws RankError
+  /// \throws ShapeError
+  /// \throws IndexOutOfBoundsError
+  template <Number I>
+  [[nodiscard]] auto gather(size_type axis, const Tensor<I> &indices) const -> Tensor {
+    _m_check_axis(axis);
+    _m_check_index_shape(indices.shape(), axis);
+    auto offsets = _m_axis_offsets(indices, axis);
+
+    auto [outer, extent, inner] = _m_split_around(axis);
+    auto count = indices.shape()[axis];
+    auto result = Tensor{indices.shape()};
+
+    auto source = data();
+    auto destination = result.data();
+    auto grain = std::max(PARALLEL_GRAIN / (count * inner), size_type{1});
+    ThreadPool::global().parallel_for(
+        0, outer, grain, [=, &offsets, extent = extent, inner = inner](size_type begin, size_type end) {
+          for (auto o = begin; o < end; ++o) {
+            auto base = source + o * extent * inner;
+            for (size_type k = {}; k < count; ++k) {
+              auto row = (o * count + k) * inner;
+              if (auto ahead = row + PREFETCH_DISTANCE * inner; ahead < end * count * inner) {
+                auto ahead_base = (ahead / (count * inner)) * extent + offsets[ahead];
+                _s_prefetch(source + ahead_base * inner + ahead % inner);
+              }
+              for (size_type i = {}; i < inner; ++i) {
+                destination[row + i] = base[offsets[row + i] * inner + i];
+              }
+            }
+          }
+        });
+    return result;
+  }
+
+  /// \brief Adds elements into positions along an axis in place.
+  /// \tparam I Data type of the indices.
+  /// \tparam U Data type of \p source.
+  /// \param[in] axis The axis along which the elements are scattered.
+  /// \param[in] indices A tensor of indices along \p axis.
+  /// \param[in] source A tensor of the same shape as \p indices holding the values to be added.
+  /// \return A reference to self.
+  ///
+  /// \details
+  /// This function is the adjoint of `gather`. For a tensor of rank 3 and `axis = 1`, it performs
+  /// `this(i, indices(i, j, k), k) += source(i, j, k)`. Duplicate indices accumulate, which makes it suitable
+  /// for propagating gradients back into an embedding table.
+  ///
+  /// The work is parallelized over the positions before and after \p axis; each of them owns a disjoint set of
+  /// destination elements, so no synchronization is required.
+  ///
+  /// This function throws an exception if:
+  ///     * \p axis is not less than the rank.
+  ///     * The shapes of \p indices and \p source are unequal.
+  ///     * The shape of \p indices does not conform with this tensor.
+  ///     * Any index is out of range w.r.t. \p axis.
+  ///
+  /// \throws ValueError
+  /// \throws RankError
+  /// \throws ShapeError
+  /// \throws IndexOutOfBoundsError
+  template <Number I, Number U>
+  auto scatter_add(size_type axis, const Tensor<I> &indices, const Tensor<U> &source) -> Tensor & {
+    _m_check_axis(axis);
+    _s_check_shape_equality(indices.shape(), source.shape());
+    _m_check_index_shape(indices.shape(), axis);
+    auto offsets = _m_axis_offsets(indices, axis);
+
+    auto [outer, extent, inner] = _m_split_around(axis);
+    auto count = indices.shape()[axis];
+
+    auto values = source.data();
+    auto destination = data();
+    auto grain = std::max(PARALLEL_GRAIN / count, size_type{1});
+    ThreadPool::global().parallel_for(
+        0, outer * inner, grain, [=, &offsets, extent = extent, inner = inner](size_type begin, size_type end) {
+          // A block covers the columns [begin, end) of the (outer, inner) plane, which may straddle several
+          // outer positions.
+          for (auto column = begin; column < end;) {
+            auto o = column / inner;
+            auto first = column % inner;
+            auto last = std::min(inner, first + (end - column));
+            auto base = destination + o * extent * inner;
+            for (size_type k = {}; k < count; ++k) {
+              auto row = (o * count + k) * inner;
+              for (auto i = first; i < last; ++i) {
+                base[offsets[row + i] * inner + i] += static_cast<value_type>(values[row + i]);
+              }
+            }
+            column += last - first;
+          }
+        });
+    return *this;
+  }
+
+  /// \brief Selects the \p k largest (or smallest) elements along an axis.
+  /// \param[in] k The number of elements to be selected from each line along \p axis.
+  /// \param[in] axis The axis along which the elements are selected.
+  /// \param[in] largest If true, the largest elements are selected, otherwise the smallest ones.
+  /// \return A pair of tensors holding the selected values and their indices along \p axis. Both have the shape
+  /// of this tensor, except for an extent of \p k along \p axis.
+  ///
+  /// \details
+  /// The selected elements of each line are ordered from the best to the worst, and ties are broken in favor of
+  /// the lower index, which makes the result deterministic. NaNs compare greater than any number.
+  ///
+  /// Small selections are made in a single pass with a bounded heap, where most elements are rejected by one
+  /// comparison with the current threshold; larger ones fall back to `std::nth_element` followed by sorting the
+  /// selected part. Lines are processed in parallel.
+  ///
+  /// This function throws an exception if:
+  ///     * \p axis is not less than the rank.
+  ///     * \p k is zero or greater than the extent of \p axis.
+  ///
+  /// \throws ValueError
+  [[nodiscard]] auto topk(size_type k, size_type axis, bool largest = true) const
+      -> std::pair<Tensor, Tensor<size_type>> {
+    _m_check_axis(axis);
+    auto [outer, extent, inner] = _m_split_around(axis);
+    if (k == 0 or k > extent) {
+      throw ValueError{"cbx::Tensor::topk: k = {} must be in the range [1, {}]", k, extent};
+    }
+
+    auto result_shape = shape_;
+    result_shape.set_axis(axis, k);
+    auto values = Tensor{result_shape};
+    auto indices = Tensor<size_type>{result_shape};
+
+    using candidate_type = std::pair<value_type, size_type>;
+    auto is_before = [largest](const candidate_type &a, const candidate_type &b) -> bool {
+      if constexpr (std::is_floating_point_v<value_type>) {
+        auto a_nan = std::isnan(a.first), b_nan = std::isnan(b.first);
+        if (a_nan != b_nan) {
+          return largest ? a_nan : b_nan;
+        }
+        if (a_nan) {
+          return a.second < b.second;
+        }
+      }
+      if (a.first != b.first) {
+        return largest ? a.first > b.first : a.first < b.first;
+      }
+      return a.second < b.second;
+    };
+
+    auto source = data();
+    auto grain = std::max(PARALLEL_GRAIN / extent, size_type{1});
+    ThreadPool::global().parallel_for(
+        0, outer * inner, grain,
+        [&, extent = extent, inner = inner](size_type begin, size_type end) {
+          auto candidates = std::vector<candidate_type>{};
+          candidates.reserve(extent);
+          for (auto line = begin; line < end; ++line) {
+            auto o = line / inner, i = line % inner;
+            auto base = source + o * extent * inner + i;
+            candidates.clear();
+            if (k * SELECTION_HEAP_RATIO <= extent) {
+              // The heap keeps the worst selected element on top, which serves as the admission threshold.
+              for (size_type j = {}; j < k; ++j) {
+                candidates.emplace_back(base[j * inner], j);
+              }
+              std::ranges::make_heap(candidates, is_before);
+              for (auto j = k; j < extent; ++j) {
+                auto candidate = candidate_type{base[j * inner], j};
+                if (is_before(candidate, candidates.front())) {
+                  std::ranges::pop_heap(candidates, is_before);
+                  candidates.back() = candidate;
+                  std::ranges::push_heap(candidates, is_before);
+                }
+              }
+              std::ranges::sort_heap(candidates, is_before);
+            } else {
+              for (size_type j = {}; j < extent; ++j) {
+                candidates.emplace_back(base[j * inner], j);
+              }
+              std::ranges::nth_element(candidates, candidates.begin() + (k - 1), is_before);
+              std::sort(candidates.begin(), candidates.begin() + k, is_before);
+            }
+            for (size_type j = {}; j < k; ++j) {
+              auto offset = (o * k + j) * inner + i;
+              values[offset] = candidates[j].first;
+              indices[offset] = candidates[j].second;
+            }
+          }
+        });
+    return {std::move(values), std::move(indices)};
+  }
+
   // /////////////////////////////////////////////
   // Utility
   // /////////////////////////////////////////////
@@ -982,6 +1439,18 @@ class Tensor {
     return *this;
   }
 
+  /// \brief Spreads the pages of the tensor across all NUMA nodes.
+  /// \return True if the memory policy of the pages was changed.
+  ///
+  /// \details
+  /// Interleaving suits tensors that every thread reads in full, such as the weights of a layer, whose pages
+  /// would otherwise all reside on the socket of the initializing thread.
+  ///
+  /// \note The policy sticks to the current allocation, i.e., it is lost once the tensor reallocates.
+  ///
+  /// \see NumaTopology::interleave
+  auto interleave() noexcept -> bool { return NumaTopology::interleave(data(), total() * sizeof(value_type)); }
+
   /// \brief Clones the original tensor.
   /// \return A clone of the original tensor.
   [[nodiscard]] constexpr auto clone() const -> Tensor { return *this; }
@@ -1244,7 +1713,7 @@ constexpr auto operator+(const Tensor<T> &tensor) noexcept -> Tensor<T> {
 /// \param[in] tensor A tensor operand.
 /// \return The resultant tensor.
 template <typename T>
-constexpr auto operator-(const Tensor<T> &tensor) noexcept -> Tensor<T> {
+constexpr auto operator-(const Tensor<T> &tensor) -> Tensor<T> {
   return tensor | std::negate{};
 }
 
@@ -0,0 +1,381 @@
+// Copyright 2021 CBrainX
+// Project URL: https://github.com/mansoormemon/cbrainx
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Copyright (c) 2021 Mansoor Ahmed Memon <mansoorahmed.one@gmail.com>
+
+#ifndef CBRAINX__TENSOR_OPS_HH_
+#define CBRAINX__TENSOR_OPS_HH_
+
+#include <algorithm>
+#include <cstring>
+#include <functional>
+#include <numeric>
+#include <ranges>
+#include <type_traits>
+#include <vector>
+
+#include "exceptions.hh"
+#include "shape.hh"
+#include "tensor.hh"
+#include "tensorView.hh"
+#include "threadPool.hh"
+#include "typeAliases.hh"
+
+namespace cbx {
+
+// /////////////////////////////////////////////
+// Implementation Detail
+// /////////////////////////////////////////////
+
+namespace _detail {
+
+/// \brief The minimum number of elements copied by a thread.
+constexpr usize COPY_GRAIN = usize{1} << 15;
+
+/// \brief Value type of the tensors (or views) in a range.
+template <std::ranges::range R>
+using range_value_t = std::remove_const_t<typename std::ranges::range_value_t<R>::value_type>;
+
+/// \brief Returns the product of the dimensions in [\p first, \p last).
+inline auto product(Shape::const_iterator first, Shape::const_iterator last) -> usize {
+  return std::accumulate(first, last, Shape::SCALAR_SIZE, std::multiplies{});
+}
+
+/// \brief Checks if \p axis is a valid axis for the given rank.
+///
+/// \throws ValueError
+inline auto check_axis(str caller, usize axis, usize rank) -> void {
+  if (axis >= rank) {
+    throw ValueError{"cbx::{}: axis = {} must be less than rank = {}", caller, axis, rank};
+  }
+}
+
+/// \brief Returns the shape resulting from joining \p tensors along \p axis.
+///
+/// \details
+/// If \p stacking is true, a new axis is inserted at \p axis and all shapes must be equal. Otherwise, all
+/// shapes must agree on every axis except \p axis.
+///
+/// \throws ValueError
+/// \throws RankError
+/// \throws ShapeError
+template <std::ranges::range R>
+auto joined_shape(str caller, const R &tensors, usize axis, bool stacking) -> Shape {
+  if (std::ranges::empty(tensors)) {
+    throw ValueError{"cbx::{}: tensors must not be empty", caller};
+  }
+  const auto &first = std::ranges::begin(tensors)->shape();
+  check_axis(caller, axis, first.rank() + (stacking ? 1 : 0));
+
+  auto dims = std::vector<usize>{first.begin(), first.end()};
+  usize count = {};
+  usize joined = {};
+  for (const auto &tensor : tensors) {
+    const auto &shape = tensor.shape();
+    if (shape.rank() != first.rank()) {
+      throw RankError{"cbx::{}: tensor [index = {}] of rank = {} is in contradiction with rank = {}", caller,
+                      count, shape.rank(), first.rank()};
+    }
+    for (usize a = {}; a < shape.rank(); ++a) {
+      if (shape[a] != first[a] and (stacking or a != axis)) {
+        throw ShapeError{"cbx::{}: tensor [index = {}] of shape = {} does not match shape = {} [axis = {}]",
+                         caller, count, shape.to_string(), first.to_string(), a};
+      }
+    }
+    joined += stacking ? 1 : shape[axis];
+    ++count;
+  }
+
+  if (stacking) {
+    dims.insert(dims.begin() + isize(axis), joined);
+  } else {
+    dims[axis] = joined;
+  }
+  return Shape{dims.begin(), dims.end()};
+}
+
+/// \brief Interleaves contiguous runs from several sources into \p dst.
+///
+/// \details
+/// The destination consists of \p outer rows. Each row is made up of `runs[i]` elements from every source `i`,
+/// taken from row `o` of that source. The destination is split among the threads of the global pool by element
+/// count, and each thread copies its part with `std::memcpy`.
+template <typename T>
+auto interleave(const std::vector<const T *> &sources, const std::vector<usize> &runs, usize outer, T *dst)
+    -> void {
+  auto offsets = std::vector<usize>(runs.size() + 1);
+  std::partial_sum(runs.begin(), runs.end(), offsets.begin() + 1);
+  auto row = offsets.back();
+
+  ThreadPool::global().parallel_for(0, outer * row, COPY_GRAIN, [&](usize begin, usize end) {
+    auto position = begin;
+    while (position < end) {
+      auto o = position / row;
+      auto offset = position % row;
+      // Locate the source whose run covers the current offset.
+      auto i = usize(std::upper_bound(offsets.begin(), offsets.end(), offset) - offsets.begin()) - 1;
+      auto skip = offset - offsets[i];
+      auto count = std::min(runs[i] - skip, end - position);
+      std::memcpy(dst + position, sources[i] + o * runs[i] + skip, count * sizeof(T));
+      position += count;
+    }
+  });
+}
+
+/// \brief Joins \p tensors along \p axis into \p out, whose shape must already be the joined shape.
+template <std::ranges::range R, typename T>
+auto join_into(const R &tensors, T *out, usize axis) -> void {
+  auto sources = std::vector<const T *>{};
+  auto runs = std::vector<usize>{};
+  usize outer = {};
+  for (const auto &tensor : tensors) {
+    const auto &shape = tensor.shape();
+    // Each source contributes the elements of its axes [axis, rank) to every row of the destination. This also
+    // holds for stacking, where the new axis is inserted in front of `axis`.
+    outer = product(shape.begin(), shape.begin() + isize(axis));
+    sources.push_back(tensor.data());
+    runs.push_back(product(shape.begin() + isize(axis), shape.end()));
+  }
+  interleave(sources, runs, outer, out);
+}
+
+/// \brief Returns the sizes of the parts when an axis of dimension \p dim is split into \p sections.
+///
+/// \throws ValueError
+inline auto section_sizes(str caller, usize dim, usize sections) -> std::vector<usize> {
+  if (sections == 0 or dim % sections != 0) {
+    throw ValueError{"cbx::{}: dimension = {} cannot be split into sections = {} equal parts", caller, dim,
+                     sections};
+  }
+  return std::vector<usize>(sections, dim / sections);
+}
+
+/// \brief Checks if \p sizes add up to \p dim.
+///
+/// \throws ValueError
+inline auto check_sizes(str caller, usize dim, const std::vector<usize> &sizes) -> void {
+  auto sum = std::accumulate(sizes.begin(), sizes.end(), usize{});
+  if (sizes.empty() or sum != dim or std::ranges::count(sizes, 0) != 0) {
+    throw ValueError{"cbx::{}: sizes [count = {}, sum = {}] must be non-zero and add up to dimension = {}",
+                     caller, sizes.size(), sum, dim};
+  }
+}
+
+}
+
+// /////////////////////////////////////////////
+// Joining
+// /////////////////////////////////////////////
+
+/// \brief Concatenates tensors along an existing axis into a preallocated tensor.
+/// \tparam R Type of the range holding the tensors (or views).
+/// \param[in] tensors The tensors to be concatenated.
+/// \param[out] out The destination, whose shape must be equal to the concatenated shape.
+/// \param[in] axis The axis along which the tensors will be concatenated.
+///
+/// \details
+/// The tensors must agree on every axis except \p axis. The copy runs in parallel on the global thread pool and
+/// moves contiguous runs with `std::memcpy`. Reusing \p out across calls, e.g., for assembling mini-batches,
+/// avoids any allocation.
+///
+/// This function throws an exception if:
+///     * \p tensors is empty or \p axis is out of range.
+///     * The ranks of the tensors differ.
+///     * The shapes of the tensors (or \p out) are incompatible.
+///
+/// \throws ValueError
+/// \throws RankError
+/// \throws ShapeError
+template <std::ranges::range R, typename T = _detail::range_value_t<R>>
+auto concat_into(const R &tensors, Tensor<T> &out, usize axis = 0) -> void {
+  auto shape = _detail::joined_shape("concat_into", tensors, axis, false);
+  if (out.shape() != shape) {
+    throw ShapeError{"cbx::concat_into: out = {} must be of the concatenated shape = {}", out.shape().to_string(),
+                     shape.to_string()};
+  }
+  _detail::join_into(tensors, out.data(), axis);
+}
+
+/// \brief Concatenates tensors along an existing axis.
+/// \tparam R Type of the range holding the tensors (or views).
+/// \param[in] tensors The tensors to be concatenated.
+/// \param[in] axis The axis along which the tensors will be concatenated.
+/// \return The concatenated tensor.
+///
+/// \details
+/// Here is a code snippet to better exhibit the use of this function.
+///
+/// ```cpp
+/// auto a = cbx::Tensor{{2, 3}};
+/// auto b = cbx::Tensor{{4, 3}};
+/// // The shape of `c` will be (6, 3).
+/// auto c = cbx::concat(std::vector{a, b});
+/// ```
+///
+/// \throws ValueError
+/// \throws RankError
+/// \throws ShapeError
+///
+/// \see concat_into
+template <std::ranges::range R, typename T = _detail::range_value_t<R>>
+[[nodiscard]] auto concat(const R &tensors, usize axis = 0) -> Tensor<T> {
+  auto out = Tensor<T>{_detail::joined_shape("concat", tensors, axis, false)};
+  _detail::join_into(tensors, out.data(), axis);
+  return out;
+}
+
+/// \brief Stacks tensors of identical shapes along a new axis.
+/// \tparam R Type of the range holding the tensors (or views).
+/// \param[in] tensors The tensors to be stacked.
+/// \param[in] axis The position of the new axis in the resultant shape.
+/// \return The stacked tensor.
+///
+/// \details
+/// For example, stacking eight tensors of shape (28, 28) along axis 0 yields a tensor of shape (8, 28, 28).
+///
+/// \throws ValueError
+/// \throws RankError
+/// \throws ShapeError
+template <std::ranges::range R, typename T = _detail::range_value_t<R>>
+[[nodiscard]] auto stack(const R &tensors, usize axis = 0) -> Tensor<T> {
+  auto out = Tensor<T>{_detail::joined_shape("stack", tensors, axis, true)};
+  _detail::join_into(tensors, out.data(), axis);
+  return out;
+}
+
+// /////////////////////////////////////////////
+// Splitting
+// /////////////////////////////////////////////
+
+/// \brief Splits a tensor along an axis into parts of the specified sizes.
+/// \param[in] tensor The tensor to be split.
+/// \param[in] sizes The dimensions of the parts along \p axis.
+/// \param[in] axis The axis along which the tensor will be split.
+/// \return The parts, each holding a copy of its elements.
+///
+/// \details
+/// The parts always own their data. Use `split_view` to split along the leading axis without copying.
+///
+/// This function throws an exception if \p axis is out of range, or if \p sizes contains a zero or does not add
+/// up to the dimension of \p axis.
+///
+/// \throws ValueError
+///
+/// \see split_view
+template <typename T>
+[[nodiscard]] auto split(const Tensor<T> &tensor, const std::vector<usize> &sizes, usize axis = 0)
+    -> std::vector<Tensor<T>> {
+  const auto &shape = tensor.shape();
+  _detail::check_axis("split", axis, shape.rank());
+  _detail::check_sizes("split", shape[axis], sizes);
+
+  auto outer = _detail::product(shape.begin(), shape.begin() + isize(axis));
+  auto inner = _detail::product(shape.begin() + isize(axis) + 1, shape.end());
+  auto row = shape[axis] * inner;
+
+  auto parts = std::vector<Tensor<T>>{};
+  parts.reserve(sizes.size());
+  usize offset = {};
+  for (auto size : sizes) {
+    auto dims = std::vector<usize>{shape.begin(), shape.end()};
+    dims[axis] = size;
+    auto &part = parts.emplace_back(Shape{dims.begin(), dims.end()});
+
+    auto run = size * inner;
+    auto source = tensor.data() + offset;
+    auto destination = part.data();
+    ThreadPool::global().parallel_for(0, outer, std::max(_detail::COPY_GRAIN / run, usize{1}),
+                                      [=](usize begin, usize end) {
+                                        for (auto o = begin; o < end; ++o) {
+                                          std::memcpy(destination + o * run, source + o * row, run * sizeof(T));
+                                        }
+                                      });
+    offset += run;
+  }
+  return parts;
+}
+
+/// \brief Splits a tensor along an axis into equal parts.
+/// \param[in] tensor The tensor to be split.
+/// \param[in] sections The number of parts.
+/// \param[in] axis The axis along which the tensor will be split.
+/// \return The parts, each holding a copy of its elements.
+///
+/// \details
+/// This function throws an exception if \p axis is out of range, or if the dimension of \p axis is not
+/// divisible by \p sections.
+///
+/// \throws ValueError
+template <typename T>
+[[nodiscard]] auto split(const Tensor<T> &tensor, usize sections, usize axis = 0) -> std::vector<Tensor<T>> {
+  _detail::check_axis("split", axis, tensor.rank());
+  return split(tensor, _detail::section_sizes("split", tensor.shape()[axis], sections), axis);
+}
+
+/// \brief Splits a tensor or a view along the leading axis into views of the specified sizes.
+/// \tparam V Type of the tensor or view.
+/// \param[in] tensor The tensor to be split.
+/// \param[in] sizes The dimensions of the parts along the leading axis.
+/// \return Views of the parts.
+///
+/// \details
+/// Since the elements of consecutive slices along the leading axis are contiguous, the parts can refer to the
+/// original memory and no elements are copied. The views are invalidated along with \p tensor.
+///
+/// This function throws an exception if \p tensor is a scalar, or if \p sizes contains a zero or does not add
+/// up to the leading dimension.
+///
+/// \throws ValueError
+template <typename V>
+[[nodiscard]] auto split_view(V &tensor, const std::vector<usize> &sizes) {
+  using element_type = std::remove_pointer_t<decltype(tensor.data())>;
+
+  const auto &shape = tensor.shape();
+  _detail::check_axis("split_view", 0, shape.rank());
+  _detail::check_sizes("split_view", shape[0], sizes);
+
+  auto inner = _detail::product(shape.begin() + 1, shape.end());
+  auto views = std::vector<TensorView<element_type>>{};
+  views.reserve(sizes.size());
+  auto data = tensor.data();
+  for (auto size : sizes) {
+    auto dims = std::vector<usize>{shape.begin(), shape.end()};
+    dims[0] = size;
+    views.emplace_back(data, Shape{dims.begin(), dims.end()});
+    data += size * inner;
+  }
+  return views;
+}
+
+/// \brief Splits a tensor or a view along the leading axis into equal views.
+/// \tparam V Type of the tensor or view.
+/// \param[in] tensor The tensor to be split.
+/// \param[in] sections The number of parts.
+/// \return Views of the parts.
+///
+/// \details
+/// This function throws an exception if \p tensor is a scalar, or if the leading dimension is not divisible by
+/// \p sections.
+///
+/// \throws ValueError
+template <typename V>
+[[nodiscard]] auto split_view(V &tensor, usize sections) {
+  _detail::check_axis("split_view", 0, tensor.rank());
+  return split_view(tensor, _detail::section_sizes("split_view", tensor.shape()[0], sections));
+}
+
+}
+
+#endif
@@ -0,0 +1,226 @@
+// Copyright 2021 CBrainX
+// Project URL: https://github.com/mansoormemon/cbrainx
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Copyright (c) 2021 Mansoor Ahmed Memon <mansoorahmed.one@gmail.com>
+
+#ifndef CBRAINX__TENSOR_VIEW_HH_
+#define CBRAINX__TENSOR_VIEW_HH_
+
+#include <string>
+#include <type_traits>
+
+#include <fmt/format.h>
+
+#include "exceptions.hh"
+#include "shape.hh"
+#include "tensor.hh"
+#include "typeAliases.hh"
+
+namespace cbx {
+
+/// \brief The `TensorView` class represents a non-owning view of contiguous tensor data.
+/// \tparam T Data type of the elements (may be const-qualified for read-only views).
+///
+/// \details
+/// A view pairs a pointer with a shape and never allocates. It is only valid as long as the memory that it
+/// refers to is alive; in particular, any operation that reallocates the viewed tensor invalidates the view.
+///
+/// \see Tensor
+template <typename T>
+class TensorView {
+ public:
+  using value_type = std::remove_const_t<T>;
+  using element_type = T;
+
+  using reference = element_type &;
+  using const_reference = const value_type &;
+
+  using pointer = element_type *;
+  using const_pointer = const value_type *;
+
+  using size_type = usize;
+  using difference_type = isize;
+
+  using iterator = pointer;
+  using const_iterator = const_pointer;
+
+ private:
+  /// \brief Pointer to the first element.
+  pointer data_ = {};
+
+  /// \brief Shape of data.
+  Shape shape_ = {};
+
+  /// \brief Performs bounds checking w.r.t. the total number of elements.
+  /// \param[in] index The index of the element.
+  ///
+  /// \details
+  /// This function throws an exception if \p index is out of bounds.
+  ///
+  /// \throws IndexOutOfBoundsError
+  auto _m_check_linear_bounds(size_type index) const -> void {
+    if (index >= total()) {
+      throw IndexOutOfBoundsError{"cbx::TensorView::_m_check_linear_bounds: index = {} >= this->total() = {}",
+                                  index, total()};
+    }
+  }
+
+ public:
+  // /////////////////////////////////////////////
+  // Constructors and Destructors
+  // /////////////////////////////////////////////
+
+  /// \brief Default constructor.
+  TensorView() = default;
+
+  /// \brief Constructs a view of the specified shape over the memory starting at \p data.
+  /// \param[in] data Pointer to the first element.
+  /// \param[in] shape The shape of the view.
+  TensorView(pointer data, const Shape &shape) : data_{data}, shape_{shape} {}
+
+  /// \brief Constructs a view of a whole tensor.
+  /// \param[in] tensor The tensor to be viewed.
+  TensorView(Tensor<value_type> &tensor) : data_{tensor.data()}, shape_{tensor.shape()} {}
+
+  /// \brief Constructs a read-only view of a whole tensor.
+  /// \param[in] tensor The tensor to be viewed.
+  TensorView(const Tensor<value_type> &tensor) requires std::is_const_v<element_type>
+      : data_{tensor.data()}, shape_{tensor.shape()} {}
+
+  /// \brief Constructs a read-only view from a mutable one.
+  /// \param[in] other The source view.
+  TensorView(const TensorView<value_type> &other) requires std::is_const_v<element_type>
+      : data_{other.data()}, shape_{other.shape()} {}
+
+  /// \brief Default copy constructor.
+  /// \param[in] other Source view.
+  TensorView(const TensorView &other) = default;
+
+  /// \brief Default destructor.
+  ~TensorView() = default;
+
+  // /////////////////////////////////////////////
+  // Assignment Operators
+  // /////////////////////////////////////////////
+
+  /// \brief Default copy assignment operator.
+  /// \param[in] other Source view.
+  /// \return A reference to self.
+  auto operator=(const TensorView &other) -> TensorView & = default;
+
+  // /////////////////////////////////////////////
+  // Element Access
+  // /////////////////////////////////////////////
+
+  /// \brief Accesses the element at the specified index linearly.
+  /// \param[in] index The index of the element.
+  /// \return A reference to the element at the specified index.
+  ///
+  /// \note This function neither respects dimensionality nor performs bounds checking.
+  [[nodiscard]] auto operator[](size_type index) const noexcept -> reference { return data_[index]; }
+
+  /// \brief Accesses the element at the specified index linearly.
+  /// \param[in] index The index of the element.
+  /// \return A reference to the element at the specified index.
+  ///
+  /// \note This function does not respect dimensionality but performs bounds checking w.r.t. the total number
+  /// of elements.
+  ///
+  /// \throws IndexOutOfBoundsError
+  [[nodiscard]] auto at(size_type index) const -> reference {
+    _m_check_linear_bounds(index);
+    return data_[index];
+  }
+
+  // /////////////////////////////////////////////
+  // Accessors and Mutators
+  // /////////////////////////////////////////////
+
+  /// \brief Returns the shape of the view.
+  /// \return An immutable reference to the shape of the view.
+  [[nodiscard]] auto shape() const noexcept -> const Shape & { return shape_; }
+
+  /// \brief Returns the pointer to the first element.
+  /// \return Pointer to the first element.
+  [[nodiscard]] auto data() const noexcept -> pointer { return data_; }
+
+  /// \brief Returns the total number of elements in the view.
+  /// \return The total number of elements.
+  [[nodiscard]] auto total() const noexcept -> size_type { return shape_.total(); }
+
+  /// \brief Returns the rank of the view.
+  /// \return The rank of the view.
+  [[nodiscard]] auto rank() const noexcept -> size_type { return shape_.rank(); }
+
+  // /////////////////////////////////////////////
+  // Iterators
+  // /////////////////////////////////////////////
+
+  /// \brief Returns an iterator pointing to the first element.
+  /// \return An iterator pointing to the first element.
+  [[nodiscard]] auto begin() const noexcept -> iterator { return data_; }
+
+  /// \brief Returns an iterator pointing past the last element.
+  /// \return An iterator pointing past the last element.
+  [[nodiscard]] auto end() const noexcept -> iterator { return data_ + total(); }
+
+  // /////////////////////////////////////////////
+  // Informative
+  // /////////////////////////////////////////////
+
+  /// \brief Returns meta-information about the view as a string.
+  /// \return A string containing meta-information about the view.
+  [[nodiscard]] auto meta_info() const -> std::string {
+    return fmt::format("{{ total={}, shape={}, type={} }}", total(), shape_.to_string(),
+                       typeid(value_type).name());
+  }
+
+  // /////////////////////////////////////////////
+  // Utility
+  // /////////////////////////////////////////////
+
+  /// \brief Returns a view of the same data with a different shape.
+  /// \param[in] new_shape The new shape of the view.
+  /// \return The reshaped view.
+  ///
+  /// \details
+  /// This function throws an exception if the new shape is not equivalent to `this->shape()`.
+  ///
+  /// \throws ShapeError
+  [[nodiscard]] auto reshaped(const Shape &new_shape) const -> TensorView {
+    if (not shape_.is_equivalent(new_shape)) {
+      throw ShapeError{"cbx::TensorView::reshaped: new_shape = {} [total = {}] is not equivalent to this->shape() "
+                       "= {} [total = {}]",
+                       new_shape.to_string(), new_shape.total(), shape_.to_string(), total()};
+    }
+    return {data_, new_shape};
+  }
+
+  /// \brief Copies the viewed elements into a new tensor.
+  /// \return A tensor holding a copy of the viewed elements.
+  [[nodiscard]] auto to_tensor() const -> Tensor<value_type> { return Tensor<value_type>{shape_, data_}; }
+};
+
+/// \brief Deduction guide for views of mutable tensors.
+template <typename T>
+TensorView(Tensor<T> &) -> TensorView<T>;
+
+/// \brief Deduction guide for views of immutable tensors.
+template <typename T>
+TensorView(const Tensor<T> &) -> TensorView<const T>;
+
+}
+
+#endif
@@ -0,0 +1,173 @@
+// Copyright 2021 CBrainX
+// Project URL: https://github.com/mansoormemon/cbrainx
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Copyright (c) 2021 Mansoor Ahmed Memon <mansoorahmed.one@gmail.com>
+
+#ifndef CBRAINX__THREAD_POOL_HH_
+#define CBRAINX__THREAD_POOL_HH_
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "typeAliases.hh"
+
+namespace cbx {
+
+/// \brief The `ThreadPool` class represents a fixed set of worker threads for data-parallel loops.
+///
+/// \details
+/// Work is distributed with static block partitioning, i.e., a loop is cut into contiguous blocks and block `i`
+/// is always handed to worker `i`, while the calling thread processes the first block itself. Since the same
+/// worker always touches the same part of a buffer, this scheme plays well with caches.
+///
+/// Parallel loops issued from within a block, whether it runs on a worker or on the calling thread, are
+/// executed serially by that thread, so nesting never deadlocks.
+///
+/// A pool may pin its workers to CPUs in the order given by `NumaTopology::cpus()`, i.e., node by node, with
+/// the first CPU reserved for the calling thread. Blocks are proportional to the iteration space, so a loop
+/// that initializes a buffer and a later loop that consumes it (both partitioned this way) touch the same
+/// share of the buffer from the same socket. Combined with first-touch placement, each socket then works on
+/// pages local to it.
+///
+/// \see NumaTopology
+class ThreadPool {
+ public:
+  using size_type = usize;
+
+  using task_type = std::function<void()>;
+
+  /// \brief A loop body invoked with the half-open range [begin, end) of the block it is responsible for.
+  using body_type = std::function<void(size_type, size_type)>;
+
+ private:
+  /// \brief Worker threads.
+  std::vector<std::thread> workers_ = {};
+
+  /// \brief Pending tasks of each worker.
+  std::vector<std::deque<task_type>> queues_ = {};
+
+  /// \brief Guards the queues and the stop flag.
+  std::mutex mutex_ = {};
+
+  /// \brief Signals the workers upon the arrival of a new task.
+  std::condition_variable cv_ = {};
+
+  /// \brief A flag for stopping the workers.
+  bool stop_ = {};
+
+  /// \brief A flag indicating whether the workers are pinned to CPUs.
+  bool pinned_ = {};
+
+  // /////////////////////////////////////////////
+  // Helpers
+  // /////////////////////////////////////////////
+
+  /// \brief The routine executed by each worker.
+  /// \param[in] index The index of the worker.
+  auto _m_work(size_type index) -> void;
+
+  /// \brief Appends a task to the queue of a worker.
+  /// \param[in] index The index of the worker.
+  /// \param[in] task The task to be executed.
+  auto _m_submit(size_type index, task_type task) -> void;
+
+ public:
+  // /////////////////////////////////////////////
+  // Constructors and Destructors
+  // /////////////////////////////////////////////
+
+  /// \brief Parameterized constructor.
+  /// \param[in] workers The number of worker threads, excluding the calling thread.
+  /// \param[in] pinned If true, each worker is pinned to a CPU, node by node.
+  ///
+  /// \details
+  /// Pinning is best-effort; a worker whose affinity cannot be changed runs unpinned.
+  explicit ThreadPool(size_type workers, bool pinned = false);
+
+  /// \brief Deleted copy constructor.
+  ThreadPool(const ThreadPool &other) = delete;
+
+  /// \brief Destructor.
+  ///
+  /// \details
+  /// The destructor waits for all pending tasks to finish.
+  ~ThreadPool();
+
+  // /////////////////////////////////////////////
+  // Assignment Operators
+  // /////////////////////////////////////////////
+
+  /// \brief Deleted copy assignment operator.
+  auto operator=(const ThreadPool &other) -> ThreadPool & = delete;
+
+  // /////////////////////////////////////////////
+  // Query Functions
+  // /////////////////////////////////////////////
+
+  /// \brief Returns the number of threads that participate in a parallel loop, including the calling thread.
+  /// \return The degree of parallelism.
+  [[nodiscard]] auto concurrency() const noexcept -> size_type;
+
+  /// \brief Returns whether the calling thread is a worker of any pool, or is processing a block of a loop.
+  /// \return True if the calling thread is a worker or is inside a block.
+  [[nodiscard]] static auto is_worker() noexcept -> bool;
+
+  /// \brief Makes all parallel loops subsequently issued by the calling thread run serially in place.
+  ///
+  /// \details
+  /// This suits threads that are themselves one of several busy threads, e.g., the stages of a `Pipeline`,
+  /// whose loops would otherwise queue behind each other on the workers of the pool.
+  static auto serialize_current_thread() noexcept -> void;
+
+  /// \brief Returns whether the workers are pinned to CPUs.
+  /// \return True if the workers are pinned.
+  [[nodiscard]] auto is_pinned() const noexcept -> bool;
+
+  // /////////////////////////////////////////////
+  // Core Functionality
+  // /////////////////////////////////////////////
+
+  /// \brief Executes a loop over the range [\p begin, \p end) in parallel.
+  /// \param[in] begin, end The range of the loop.
+  /// \param[in] grain The minimum number of iterations per block.
+  /// \param[in] body The loop body.
+  ///
+  /// \details
+  /// The range is cut into at most `concurrency()` blocks of at least \p grain iterations each. This function
+  /// returns once every block has been processed. If the body throws, the first exception is rethrown in the
+  /// calling thread after all blocks have finished.
+  auto parallel_for(size_type begin, size_type end, size_type grain, const body_type &body) -> void;
+
+  // /////////////////////////////////////////////////////////////
+  // Static Functions
+  // /////////////////////////////////////////////////////////////
+
+  /// \brief Returns the process-wide pool.
+  /// \return A reference to the global pool.
+  ///
+  /// \details
+  /// The global pool is created on first use with one worker less than the number of hardware threads. The
+  /// count can be overridden with the environment variable `CBRAINX_NUM_THREADS`, which includes the calling
+  /// thread. Setting `CBRAINX_PIN_THREADS=1` pins the workers.
+  static auto global() -> ThreadPool &;
+};
+
+}
+
+#endif
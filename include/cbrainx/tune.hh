@@ -0,0 +1,102 @@
+// Copyright 2021 CBrainX
+// Project URL: https://github.com/mansoormemon/cbrainx
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Copyright (c) 2021 Mansoor Ahmed Memon <mansoorahmed.one@gmail.com>
+#ifndef CBRAINX__TUNE_HH_
+#define CBRAINX__TUNE_HH_
+
+#include <functional>
+#include <string>
+
+#include "gemm.hh"
+#include "typeAliases.hh"
+
+/// \brief Autotuning of the matrix multiplication kernel.
+///
+/// \details
+/// Matrix multiplications are grouped into classes by the order of magnitude of each dimension (`xs` up to 16,
+/// `s` up to 128, `m` up to 1024 and `l` beyond). Tuning a class benchmarks candidate block sizes, microkernel
+/// shapes and thread counts on a representative problem and keeps the fastest configuration.
+///
+/// Results are kept per machine in a plain text cache file, so that a fleet spanning several CPU generations
+/// can share one home directory. The file is located at `CBRAINX_TUNE_CACHE` if set, otherwise at
+/// `$XDG_CACHE_HOME/cbrainx/gemm.tune` or `$HOME/.cache/cbrainx/gemm.tune`. It is read on first lookup.
+///
+/// A class without a cached entry uses the defaults of `GemmConfig`, unless tuning at first use is enabled
+/// (with `set_auto_tuning` or `CBRAINX_AUTOTUNE=1`), in which case the class is tuned on the spot and the cache
+/// file is updated. Since tuning a class of large matrices takes a few seconds, the whole table is better
+/// prepared ahead of time with the `cbxTune` tool.
+///
+/// \see GemmConfig
+namespace cbx::tune {
+
+/// \brief Returns the key that identifies this machine in the cache file.
+/// \return A string made of the CPU model, the active instruction set and the number of threads.
+[[nodiscard]] auto machine_key() -> std::string;
+
+/// \brief Returns the class of a matrix multiplication.
+/// \param[in] m, n, k The dimensions of the product.
+/// \return The class as a string, e.g., `s-m-l`.
+[[nodiscard]] auto shape_class(usize m, usize n, usize k) -> std::string;
+
+/// \brief Returns the path of the cache file.
+/// \return The path of the cache file, or an empty string if no suitable location exists.
+[[nodiscard]] auto cache_path() -> std::string;
+
+/// \brief Returns the configuration to be used for a matrix multiplication.
+/// \param[in] m, n, k The dimensions of the product.
+/// \return The tuned configuration of the class if known, otherwise the default one.
+///
+/// \details
+/// Only the first lookup reads the cache file. Afterwards, the lookup of a known class takes no lock, so it is
+/// cheap enough to be repeated on every product.
+[[nodiscard]] auto lookup(usize m, usize n, usize k) -> GemmConfig;
+
+/// \brief Benchmarks the candidates for the class of a matrix multiplication and records the fastest one.
+/// \param[in] m, n, k The dimensions of the product.
+/// \param[in] log If set, invoked with a line of progress per candidate.
+/// \return The fastest configuration.
+///
+/// \note The result is recorded in memory only; call `save` to persist it.
+auto tune(usize m, usize n, usize k, const std::function<void(const std::string &)> &log = {}) -> GemmConfig;
+
+/// \brief Tunes every class.
+/// \param[in] log If set, invoked with a line of progress per candidate.
+auto tune_all(const std::function<void(const std::string &)> &log = {}) -> void;
+
+/// \brief Reads the entries of this machine from a cache file, replacing those in memory.
+/// \param[in] path The path of the file.
+/// \return The number of entries read.
+auto load(const std::string &path) -> usize;
+
+/// \brief Writes the entries of this machine to a cache file, preserving those of other machines.
+/// \param[in] path The path of the file.
+/// \return True if the file was written.
+auto save(const std::string &path) -> bool;
+
+/// \brief Discards all entries in memory.
+auto clear() -> void;
+
+/// \brief Enables or disables tuning at first use.
+/// \param[in] enabled If true, unknown classes are tuned when first looked up.
+auto set_auto_tuning(bool enabled) -> void;
+
+/// \brief Returns whether tuning at first use is enabled or not.
+/// \return True if tuning at first use is enabled.
+[[nodiscard]] auto is_auto_tuning() -> bool;
+
+}
+
+#endif
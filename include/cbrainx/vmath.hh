@@ -0,0 +1,179 @@
+// Copyright 2021 CBrainX
+// Project URL: https://github.com/mansoormemon/cbrainx
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Copyright (c) 2021 Mansoor Ahmed Memon <mansoorahmed.one@gmail.com>
+
+#ifndef CBRAINX__VMATH_HH_
+#define CBRAINX__VMATH_HH_
+
+#include <span>
+
+#include "typeAliases.hh"
+
+/// \brief Vectorized transcendental functions for single-precision data.
+///
+/// \details
+/// Every routine evaluates a function element-wise over a span and stores the results in an output span of the
+/// same size. The input and output spans may alias each other exactly, in which case the operation is performed
+/// in place. Partially overlapping spans result in undefined behavior.
+///
+/// The routines are implemented with polynomial approximations that are evaluated with AVX-512 or AVX2 (with
+/// FMA) instructions whenever available, and with identical scalar code otherwise. The instruction set is
+/// selected at runtime by `CpuFeatures`. The error bounds below were measured against a double-precision
+/// reference over a sweep of every seventh single-precision value, and hold for all instruction sets.
+///
+/// | Function  | Domain                       | Maximum error |
+/// | --------- | ---------------------------- | ------------- |
+/// | `exp`     | [-87.33, 88.72]              | 1.5 ULP       |
+/// | `log`     | (0, +∞)                      | 1 ULP         |
+/// | `tanh`    | (-∞, +∞)                     | 1.5 ULP       |
+/// | `sigmoid` | [-87.33, +∞)                 | 2.5 ULP       |
+/// | `erf`     | (-∞, +∞)                     | 1.5 ULP       |
+///
+/// Special values follow the C library where it matters for neural networks, i.e., NaNs are propagated,
+/// `exp(+∞) = +∞`, `exp(-∞) = 0`, `log(0) = -∞` and `log(x < 0) = NaN`. Results that would be subnormal are
+/// flushed to zero.
+///
+/// The namespace also hosts `gemv`, a streaming matrix-vector kernel, and the element-wise accumulations `axpy`
+/// and `maximum` behind pooling, all of which are dispatched in the same way.
+///
+/// \see CpuFeatures
+namespace cbx::vmath {
+
+/// \brief Computes the base-e exponential function element-wise.
+/// \param[in] x The input span.
+/// \param[out] y The output span.
+///
+/// \details
+/// This function throws an exception if \p x and \p y differ in size.
+///
+/// \throws ShapeError
+auto exp(std::span<const f32> x, std::span<f32> y) -> void;
+
+/// \brief Computes the natural logarithm element-wise.
+/// \param[in] x The input span.
+/// \param[out] y The output span.
+///
+/// \details
+/// This function throws an exception if \p x and \p y differ in size.
+///
+/// \throws ShapeError
+auto log(std::span<const f32> x, std::span<f32> y) -> void;
+
+/// \brief Computes the hyperbolic tangent element-wise.
+/// \param[in] x The input span.
+/// \param[out] y The output span.
+///
+/// \details
+/// This function throws an exception if \p x and \p y differ in size.
+///
+/// \throws ShapeError
+auto tanh(std::span<const f32> x, std::span<f32> y) -> void;
+
+/// \brief Computes the logistic sigmoid, i.e., 1 / (1 + e⁻ˣ), element-wise.
+/// \param[in] x The input span.
+/// \param[out] y The output span.
+///
+/// \details
+/// This function throws an exception if \p x and \p y differ in size.
+///
+/// \throws ShapeError
+auto sigmoid(std::span<const f32> x, std::span<f32> y) -> void;
+
+/// \brief Computes the Gauss error function element-wise.
+/// \param[in] x The input span.
+/// \param[out] y The output span.
+///
+/// \details
+/// This function throws an exception if \p x and \p y differ in size.
+///
+/// \throws ShapeError
+auto erf(std::span<const f32> x, std::span<f32> y) -> void;
+
+/// \brief Computes the base-e exponential function element-wise in place.
+/// \param[in,out] x The span to be transformed.
+auto exp(std::span<f32> x) -> void;
+
+/// \brief Computes the natural logarithm element-wise in place.
+/// \param[in,out] x The span to be transformed.
+auto log(std::span<f32> x) -> void;
+
+/// \brief Computes the hyperbolic tangent element-wise in place.
+/// \param[in,out] x The span to be transformed.
+auto tanh(std::span<f32> x) -> void;
+
+/// \brief Computes the logistic sigmoid element-wise in place.
+/// \param[in,out] x The span to be transformed.
+auto sigmoid(std::span<f32> x) -> void;
+
+/// \brief Computes the Gauss error function element-wise in place.
+/// \param[in,out] x The span to be transformed.
+auto erf(std::span<f32> x) -> void;
+
+/// \brief Accumulates the product of a row vector and a row-major matrix, i.e., `y += xᵀ × W`.
+/// \param[in] x The vector of length `k`.
+/// \param[in] w The matrix of shape (`k`, `n`).
+/// \param[in] ldw The distance between consecutive rows of \p w, in elements.
+/// \param[in, out] y The accumulator of length `n`.
+///
+/// \details
+/// The matrix is read exactly once, in row order, which makes this the bandwidth-optimal kernel for
+/// matrix-vector products. Only the first `y.size()` columns of each row are read, so column blocks of a wider
+/// matrix can be processed independently.
+///
+/// This function throws an exception if \p ldw is less than the size of \p y.
+///
+/// \throws ValueError
+auto gemv(std::span<const f32> x, const f32 *w, usize ldw, std::span<f32> y) -> void;
+
+/// \brief Accumulates a scaled vector element-wise, i.e., `y += a ⋅ x`.
+/// \param[in] a The scalar multiplier.
+/// \param[in] x The source span.
+/// \param[in, out] y The accumulator.
+///
+/// \details
+/// This function throws an exception if the sizes of \p x and \p y do not match.
+///
+/// \throws ShapeError
+auto axpy(f32 a, std::span<const f32> x, std::span<f32> y) -> void;
+
+/// \brief Updates a running maximum element-wise, i.e., `y = max(y, x)`.
+/// \param[in] x The source span.
+/// \param[in, out] y The running maximum.
+///
+/// \details
+/// This function throws an exception if the sizes of \p x and \p y do not match.
+///
+/// \throws ShapeError
+auto maximum(std::span<const f32> x, std::span<f32> y) -> void;
+
+/// \brief Updates a running maximum element-wise and records where it was attained.
+/// \param[in] x The source span.
+/// \param[in, out] y The running maximum.
+/// \param[in, out] index The positions at which the maxima were attained.
+/// \param[in] position The position of \p x, stored in \p index wherever `x > y`.
+///
+/// \details
+/// Ties keep the position that was recorded first. Positions are stored as floats, which represent integers
+/// up to 2²⁴ exactly.
+///
+/// This function throws an exception if the sizes of \p x, \p y and \p index do not match.
+///
+/// \throws ShapeError
+auto maximum(std::span<const f32> x, std::span<f32> y, std::span<f32> index, f32 position) -> void;
+
+}
+
+#endif
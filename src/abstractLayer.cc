@@ -21,8 +21,22 @@
 
 #include <fmt/core.h>
 
+#include "cbrainx/exceptions.hh"
+
 namespace cbx {
 
+// /////////////////////////////////////////////
+// Helpers
+// /////////////////////////////////////////////
+
+auto AbstractLayer::_m_check_output_gradient(const container &output_gradient) const -> void {
+  if (output_gradient.shape() != output_.shape()) {
+    throw ShapeError{"cbx::AbstractLayer::_m_check_output_gradient: output_gradient = {} does not match the "
+                     "output = {} of the last forward pass",
+                     output_gradient.shape().to_string(), output_.shape().to_string()};
+  }
+}
+
 // /////////////////////////////////////////////
 // Constructors (and Destructors)
 // /////////////////////////////////////////////
@@ -64,6 +78,14 @@ auto AbstractLayer::set_name(std::string_view name) -> AbstractLayer & {
   return *this;
 }
 
+// /////////////////////////////////////////////
+// Query Functions
+// /////////////////////////////////////////////
+
+auto AbstractLayer::output_shape([[maybe_unused]] const Shape &input_shape) const -> Shape {
+  return Shape{neurons()};
+}
+
 // /////////////////////////////////////////////
 // Informative
 // /////////////////////////////////////////////
@@ -82,6 +104,21 @@ auto AbstractLayer::to_string() const -> std::string { return fmt::format("{}{}"
     case LayerType::Softmax: {
       return "Softmax";
     }
+    case LayerType::Conv2D: {
+      return "Conv2D";
+    }
+    case LayerType::MaxPool2D: {
+      return "MaxPool2D";
+    }
+    case LayerType::AvgPool2D: {
+      return "AvgPool2D";
+    }
+    case LayerType::GlobalAvgPool: {
+      return "GlobalAvgPool";
+    }
+    case LayerType::BatchNorm: {
+      return "BatchNorm";
+    }
     default: {
       return {};
     }
@@ -96,6 +133,12 @@ auto AbstractLayer::input() const -> const container & { return input_; }
 
 auto AbstractLayer::output() const -> const container & { return output_; }
 
-auto AbstractLayer::drop_caches() const -> void { input_ = {}, output_ = {}; }
+auto AbstractLayer::input_gradient() const -> const container & { return input_gradient_; }
+
+auto AbstractLayer::drop_caches() const -> void { input_ = {}, output_ = {}, input_gradient_ = {}; }
+
+auto AbstractLayer::trainable_parameters() -> std::vector<TrainableParameter> { return {}; }
+
+auto AbstractLayer::zero_gradients() const -> void {}
 
 }
@@ -17,10 +17,32 @@
 
 #include "cbrainx/activationFunctions.hh"
 
+#include <algorithm>
+#include <array>
 #include <cmath>
 
+#include "cbrainx/exceptions.hh"
+#include "cbrainx/vmath.hh"
+
 namespace cbx {
 
+// /////////////////////////////////////////////
+// Implementation Detail
+// /////////////////////////////////////////////
+
+namespace {
+
+/// \brief Number of elements processed per block by the composite functions.
+///
+/// \details
+/// Functions composed of several vectorized primitives evaluate their operands block by block in stack buffers
+/// so that they neither allocate nor clobber the input when evaluated in place.
+constexpr usize BLOCK_SIZE = 256;
+
+using block_type = std::array<f32, BLOCK_SIZE>;
+
+}
+
 // /////////////////////////////////////////////
 // Constructors (and Destructors)
 // /////////////////////////////////////////////
@@ -107,6 +129,36 @@ auto ActFuncWrapper::derivative() const -> std::function<value_type(value_type)>
   };
 }
 
+auto ActFuncWrapper::apply(std::span<const value_type> x, std::span<value_type> y) const -> void {
+  if (x.size() != y.size()) {
+    throw ShapeError{"cbx::ActFuncWrapper::apply: x [size = {}] and y [size = {}] must be of the same size",
+                     x.size(), y.size()};
+  }
+  func_->apply(x, y);
+}
+
+auto ActFuncWrapper::apply_derivative(std::span<const value_type> x, std::span<value_type> y) const -> void {
+  if (x.size() != y.size()) {
+    throw ShapeError{"cbx::ActFuncWrapper::apply_derivative: x [size = {}] and y [size = {}] must be of the "
+                     "same size",
+                     x.size(), y.size()};
+  }
+  func_->apply_derivative(x, y);
+}
+
+// /////////////////////////////////////////////
+// Batch Evaluation
+// /////////////////////////////////////////////
+
+auto ActivationFunction::apply(std::span<const value_type> x, std::span<value_type> y) const -> void {
+  std::transform(x.begin(), x.end(), y.begin(), [this](auto x_i) { return this->operator()(x_i); });
+}
+
+auto ActivationFunction::apply_derivative(std::span<const value_type> x, std::span<value_type> y) const
+    -> void {
+  std::transform(x.begin(), x.end(), y.begin(), [this](auto x_i) { return this->derivative(x_i); });
+}
+
 // /////////////////////////////////////////////
 // Interface
 // /////////////////////////////////////////////
@@ -148,6 +200,33 @@ auto ELU::operator()(value_type x) const -> value_type { return x >= 0 ? x : ALP
 
 auto ELU::derivative(value_type x) const -> value_type { return x >= 0 ? 1 : ALPHA * std::exp(x); }
 
+auto ELU::apply(std::span<const value_type> x, std::span<value_type> y) const -> void {
+  // The negative branch computes eˣ - 1 as (u - 1) · x / ln(u) where u = eˣ, which recovers the precision that
+  // plain subtraction loses near zero.
+  auto u = block_type{};
+  auto ln_u = block_type{};
+  for (usize offset = {}; offset < x.size(); offset += BLOCK_SIZE) {
+    auto n = std::min(BLOCK_SIZE, x.size() - offset);
+    for (usize i = {}; i < n; ++i) {
+      u[i] = std::min(x[offset + i], 0.0F);
+    }
+    vmath::exp(std::span{u.data(), n});
+    vmath::log(std::span<const f32>{u.data(), n}, std::span{ln_u.data(), n});
+    for (usize i = {}; i < n; ++i) {
+      auto x_i = x[offset + i];
+      if (x_i >= 0) {
+        y[offset + i] = x_i;
+      } else if (u[i] == 0) {
+        y[offset + i] = -ALPHA;
+      } else if (u[i] == 1) {
+        y[offset + i] = ALPHA * x_i;
+      } else {
+        y[offset + i] = ALPHA * ((u[i] - 1) * x_i / ln_u[i]);
+      }
+    }
+  }
+}
+
 // /////////////////////////////////////////////
 
 auto Gaussian::type() const -> Activation { return Activation::Gaussian; }
@@ -160,6 +239,11 @@ auto Gaussian::operator()(value_type x) const -> value_type { return std::exp(-x
 
 auto Gaussian::derivative(value_type x) const -> value_type { return -2 * x * this->operator()(x); }
 
+auto Gaussian::apply(std::span<const value_type> x, std::span<value_type> y) const -> void {
+  std::transform(x.begin(), x.end(), y.begin(), [](auto x_i) { return -x_i * x_i; });
+  vmath::exp(y);
+}
+
 // /////////////////////////////////////////////
 
 auto GELU::type() const -> Activation { return Activation::GELU; }
@@ -179,6 +263,20 @@ auto GELU::derivative(value_type x) const -> value_type {
   return sigmoid(C * x) + swish(C * x) * (1 - sigmoid(C * x));
 }
 
+auto GELU::apply(std::span<const value_type> x, std::span<value_type> y) const -> void {
+  auto s = block_type{};
+  for (usize offset = {}; offset < x.size(); offset += BLOCK_SIZE) {
+    auto n = std::min(BLOCK_SIZE, x.size() - offset);
+    for (usize i = {}; i < n; ++i) {
+      s[i] = C * x[offset + i];
+    }
+    vmath::sigmoid(std::span{s.data(), n});
+    for (usize i = {}; i < n; ++i) {
+      y[offset + i] = x[offset + i] * s[i];
+    }
+  }
+}
+
 // /////////////////////////////////////////////
 
 auto LeakyReLU::type() const -> Activation { return Activation::LeakyReLU; }
@@ -232,6 +330,16 @@ auto Sigmoid::derivative(value_type x) const -> value_type {
   return this->operator()(x) * (1 - this->operator()(x));
 }
 
+auto Sigmoid::apply(std::span<const value_type> x, std::span<value_type> y) const -> void {
+  vmath::sigmoid(x, y);
+}
+
+auto Sigmoid::apply_derivative(std::span<const value_type> x, std::span<value_type> y) const -> void {
+  // Formula: σ'(x) = σ(x) · (1 - σ(x))
+  vmath::sigmoid(x, y);
+  std::transform(y.begin(), y.end(), y.begin(), [](auto s) { return s * (1 - s); });
+}
+
 // /////////////////////////////////////////////
 
 auto Softplus::type() const -> Activation { return Activation::Softplus; }
@@ -247,6 +355,30 @@ auto Softplus::derivative(value_type x) const -> value_type {
   return sigmoid(x);
 }
 
+auto Softplus::apply(std::span<const value_type> x, std::span<value_type> y) const -> void {
+  // Formula: ln(1 + exp(x)) = max(x, 0) + ln(1 + exp(-|x|))
+  //
+  // The logarithm is corrected as ln(u) · e / (u - 1) where u = 1 + e, which keeps it accurate when e is small.
+  auto e = block_type{};
+  auto ln_u = block_type{};
+  for (usize offset = {}; offset < x.size(); offset += BLOCK_SIZE) {
+    auto n = std::min(BLOCK_SIZE, x.size() - offset);
+    for (usize i = {}; i < n; ++i) {
+      e[i] = -std::fabs(x[offset + i]);
+    }
+    vmath::exp(std::span{e.data(), n});
+    for (usize i = {}; i < n; ++i) {
+      ln_u[i] = 1 + e[i];
+    }
+    vmath::log(std::span{ln_u.data(), n});
+    for (usize i = {}; i < n; ++i) {
+      auto u = 1 + e[i];
+      auto log1p = u == 1 ? e[i] : ln_u[i] * e[i] / (u - 1);
+      y[offset + i] = std::max(x[offset + i], 0.0F) + log1p;
+    }
+  }
+}
+
 // /////////////////////////////////////////////
 
 auto Swish::type() const -> Activation { return Activation::Swish; }
@@ -265,6 +397,17 @@ auto Swish::derivative(value_type x) const -> value_type {
   return this->operator()(x) + (sigmoid(x) * (1 - this->operator()(x)));
 }
 
+auto Swish::apply(std::span<const value_type> x, std::span<value_type> y) const -> void {
+  auto s = block_type{};
+  for (usize offset = {}; offset < x.size(); offset += BLOCK_SIZE) {
+    auto n = std::min(BLOCK_SIZE, x.size() - offset);
+    vmath::sigmoid(x.subspan(offset, n), std::span{s.data(), n});
+    for (usize i = {}; i < n; ++i) {
+      y[offset + i] = x[offset + i] * s[i];
+    }
+  }
+}
+
 // /////////////////////////////////////////////
 
 auto TanH::type() const -> Activation { return Activation::TanH; }
@@ -279,4 +422,12 @@ auto TanH::derivative(value_type x) const -> value_type {
   return 1 - (this->operator()(x) * this->operator()(x));
 }
 
+auto TanH::apply(std::span<const value_type> x, std::span<value_type> y) const -> void { vmath::tanh(x, y); }
+
+auto TanH::apply_derivative(std::span<const value_type> x, std::span<value_type> y) const -> void {
+  // Formula: tanh'(x) = 1 - tanh²(x)
+  vmath::tanh(x, y);
+  std::transform(y.begin(), y.end(), y.begin(), [](auto t) { return 1 - t * t; });
+}
+
 }
@@ -41,6 +41,12 @@ auto ActivationLayer::operator=(ActivationLayer &&other) noexcept -> ActivationL
   return *this;
 }
 
+// /////////////////////////////////////////////
+// Accessors and Mutators
+// /////////////////////////////////////////////
+
+auto ActivationLayer::function() const -> const ActFuncWrapper & { return act_func_; }
+
 // /////////////////////////////////////////////
 // Query Functions
 // /////////////////////////////////////////////
@@ -49,6 +55,8 @@ auto ActivationLayer::neurons() const -> size_type { return neurons_; }
 
 auto ActivationLayer::parameters() const -> size_type { return {}; }
 
+auto ActivationLayer::output_shape(const Shape &input_shape) const -> Shape { return input_shape; }
+
 auto ActivationLayer::type() const -> LayerType { return LayerType::Activation; }
 
 // /////////////////////////////////////////////
@@ -59,6 +67,14 @@ auto ActivationLayer::property() const -> std::string {
   return fmt::format("Function: {}", act_func_.to_string());
 }
 
+// /////////////////////////////////////////////
+// Utility
+// /////////////////////////////////////////////
+
+auto ActivationLayer::clone() const -> std::shared_ptr<AbstractLayer> {
+  return std::make_shared<ActivationLayer>(*this);
+}
+
 // /////////////////////////////////////////////
 // Core Functionality
 // /////////////////////////////////////////////
@@ -73,7 +89,29 @@ auto ActivationLayer::forward_pass(const container &input) const -> const Abstra
 
   // Applying forward pass and caching the input and output layers.
   input_ = input;
-  output_ = input | act_func_;
+  output_ = container{input.shape()};
+  infer(input_, output_);
+  return *this;
+}
+
+auto ActivationLayer::infer(TensorView<const value_type> input, TensorView<value_type> output) const -> void {
+  act_func_.apply({input.data(), input.total()}, {output.data(), output.total()});
+}
+
+auto ActivationLayer::backward_pass(const container &output_gradient) const -> const AbstractLayer & {
+  // Formula: ∂Î = ∂Ô ∘ ζ'(Î)
+  //
+  // where:
+  //  ζ' - Derivative of the activation function
+  //  ∂Ô - Gradient w.r.t. the output (Matrix) : Shape => (m, n)
+  //  ∂Î - Gradient w.r.t. the input (Matrix)  : Shape => (m, n)
+  //
+  // and, the symbol `∘` denotes element-wise multiplication.
+  _m_check_output_gradient(output_gradient);
+  input_gradient_ = container{input_.shape()};
+  act_func_.apply_derivative({input_.data(), input_.total()},
+                             {input_gradient_.data(), input_gradient_.total()});
+  input_gradient_ *= output_gradient;
   return *this;
 }
 
@@ -0,0 +1,459 @@
+// Copyright 2021 CBrainX
+// Project URL: https://github.com/mansoormemon/cbrainx
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Copyright (c) 2021 Mansoor Ahmed Memon <mansoorahmed.one@gmail.com>
+#include "cbrainx/batchNormLayer.hh"
+
+#include <algorithm>
+#include <cmath>
+#include <utility>
+
+#include <fmt/format.h>
+
+#include "cbrainx/conv2DLayer.hh"
+#include "cbrainx/denseLayer.hh"
+#include "cbrainx/exceptions.hh"
+#include "cbrainx/threadPool.hh"
+
+namespace cbx {
+
+// /////////////////////////////////////////////
+// Implementation Detail
+// /////////////////////////////////////////////
+
+namespace {
+
+/// \brief The number of elements per chunk of the reductions over rows.
+///
+/// \details
+/// The chunks do not depend on the number of threads, so that partial results are always merged alike.
+constexpr usize BATCH_NORM_CHUNK_SIZE = 16384;
+
+/// \brief Returns the number of features of samples of the given shape, i.e., the extent of the last axis.
+auto count_features(const Shape &shape) -> usize { return shape.rank() == 0 ? 1 : shape.back(); }
+
+/// \brief Returns the number of rows per chunk.
+auto chunk_rows(usize features) -> usize { return std::max(BATCH_NORM_CHUNK_SIZE / features, usize{1}); }
+
+/// \brief The mean and the sum of squared deviations of every feature over a number of rows.
+struct Moments {
+  usize count = {};
+  std::vector<f32> mean = {};
+  std::vector<f32> m2 = {};
+};
+
+/// \brief Computes the moments of the rows [first, last) with Welford's algorithm.
+auto welford(const f32 *x, usize features, usize first, usize last) -> Moments {
+  auto moments = Moments{0, std::vector<f32>(features), std::vector<f32>(features)};
+  for (auto r = first; r < last; ++r) {
+    auto row = x + r * features;
+    auto reciprocal = 1.0F / f32(++moments.count);
+    for (usize j = {}; j < features; ++j) {
+      auto delta = row[j] - moments.mean[j];
+      moments.mean[j] += delta * reciprocal;
+      moments.m2[j] += delta * (row[j] - moments.mean[j]);
+    }
+  }
+  return moments;
+}
+
+/// \brief Merges the moments of disjoint sets of rows (Chan et al.).
+auto merge(Moments &a, const Moments &b) -> void {
+  if (b.count == 0) {
+    return;
+  }
+  auto count = a.count + b.count;
+  auto weight = f32(b.count) / f32(count);
+  auto cross = f32(a.count) * weight;
+  for (usize j = {}; j < a.mean.size(); ++j) {
+    auto delta = b.mean[j] - a.mean[j];
+    a.mean[j] += delta * weight;
+    a.m2[j] += b.m2[j] + delta * delta * cross;
+  }
+  a.count = count;
+}
+
+/// \brief Computes the moments of all rows, chunk by chunk in parallel.
+auto batch_moments(const f32 *x, usize rows, usize features) -> Moments {
+  auto step = chunk_rows(features);
+  auto chunks = (rows + step - 1) / step;
+  auto partials = std::vector<Moments>(chunks);
+  ThreadPool::global().parallel_for(0, chunks, 1, [&](usize first, usize last) {
+    for (auto c = first; c < last; ++c) {
+      partials[c] = welford(x, features, c * step, std::min((c + 1) * step, rows));
+    }
+  });
+  auto moments = std::move(partials.front());
+  for (usize c = 1; c < chunks; ++c) {
+    merge(moments, partials[c]);
+  }
+  return moments;
+}
+
+/// \brief Computes ⅀ ∂Ô and ⅀ ∂Ô ⋅ x̂ of every feature over all rows, chunk by chunk in parallel.
+auto gradient_sums(const f32 *output_gradient, const f32 *normalized, usize rows, usize features)
+    -> std::pair<std::vector<f32>, std::vector<f32>> {
+  auto step = chunk_rows(features);
+  auto chunks = (rows + step - 1) / step;
+  auto partials = std::vector<std::vector<f32>>(chunks, std::vector<f32>(2 * features));
+  ThreadPool::global().parallel_for(0, chunks, 1, [&](usize first, usize last) {
+    for (auto c = first; c < last; ++c) {
+      auto *sums = partials[c].data();
+      for (auto r = c * step; r < std::min((c + 1) * step, rows); ++r) {
+        auto dy = output_gradient + r * features;
+        auto x_hat = normalized + r * features;
+        for (usize j = {}; j < features; ++j) {
+          sums[j] += dy[j];
+          sums[features + j] += dy[j] * x_hat[j];
+        }
+      }
+    }
+  });
+  auto sums = std::pair{std::vector<f32>(features), std::vector<f32>(features)};
+  for (const auto &partial : partials) {
+    for (usize j = {}; j < features; ++j) {
+      sums.first[j] += partial[j];
+      sums.second[j] += partial[features + j];
+    }
+  }
+  return sums;
+}
+
+/// \brief Returns a copy of a row-major matrix whose columns are scaled, and biases adjusted, as in
+/// `BatchNormLayer::fold`.
+auto fold_columns(const Tensor<f32> &weights, const Tensor<f32> &biases, const std::vector<f32> &scale,
+                  const Tensor<f32> &mean, const Tensor<f32> &beta) -> std::pair<Tensor<f32>, Tensor<f32>> {
+  auto features = scale.size();
+  auto folded_weights = Tensor<f32>{weights.shape(), weights.data()};
+  auto folded_biases = Tensor<f32>{biases.shape(), biases.data()};
+  for (usize i = {}; i < folded_weights.total(); i += features) {
+    for (usize j = {}; j < features; ++j) {
+      folded_weights[i + j] *= scale[j];
+    }
+  }
+  for (usize j = {}; j < features; ++j) {
+    folded_biases[j] = (folded_biases[j] - mean[j]) * scale[j] + beta[j];
+  }
+  return {std::move(folded_weights), std::move(folded_biases)};
+}
+
+}
+
+// /////////////////////////////////////////////
+// Helpers
+// /////////////////////////////////////////////
+
+auto BatchNormLayer::_m_count_rows(const Shape &shape) const -> size_type {
+  if (shape.rank() < container::MATRIX_RANK or shape.total() != shape.front() * input_shape_.total()) {
+    throw ShapeError{"cbx::BatchNormLayer::_m_count_rows: input = {} does not hold samples of shape {}",
+                     shape.to_string(), input_shape_.to_string()};
+  }
+  return shape.total() / input_shape_.back();
+}
+
+auto BatchNormLayer::_m_allocate_gradients() const -> void {
+  if (gamma_gradients_.total() != gamma_.total()) {
+    gamma_gradients_ = gamma_.zeros_like();
+  }
+  if (beta_gradients_.total() != beta_.total()) {
+    beta_gradients_ = beta_.zeros_like();
+  }
+}
+
+// /////////////////////////////////////////////
+// Constructors (and Destructors)
+// /////////////////////////////////////////////
+
+BatchNormLayer::BatchNormLayer(const Shape &input_shape, value_type momentum, value_type epsilon)
+    : BatchNormLayer{input_shape,
+                     container{{count_features(input_shape)}, 1},
+                     container{{count_features(input_shape)}},
+                     container{{count_features(input_shape)}},
+                     container{{count_features(input_shape)}, 1},
+                     momentum,
+                     epsilon} {
+  gamma_gradients_ = gamma_.zeros_like();
+  beta_gradients_ = beta_.zeros_like();
+}
+
+BatchNormLayer::BatchNormLayer(const Shape &input_shape, container gamma, container beta,
+                               container running_mean, container running_variance, value_type momentum,
+                               value_type epsilon)
+    : AbstractLayer{"BTNL"},
+      input_shape_{input_shape},
+      momentum_{momentum},
+      epsilon_{epsilon},
+      gamma_{std::move(gamma)},
+      beta_{std::move(beta)},
+      running_mean_{std::move(running_mean)},
+      running_variance_{std::move(running_variance)} {
+  if (input_shape_.rank() == 0) {
+    throw ValueError{"cbx::BatchNormLayer::BatchNormLayer: input_shape must not be empty"};
+  }
+  if (not(momentum_ >= 0 and momentum_ <= 1) or not(epsilon_ > 0)) {
+    throw ValueError{"cbx::BatchNormLayer::BatchNormLayer: momentum = {} must be in [0, 1] and epsilon = {} "
+                     "must be positive",
+                     momentum_, epsilon_};
+  }
+  auto features = input_shape_.back();
+  for (const auto *parameter : {&gamma_, &beta_, &running_mean_, &running_variance_}) {
+    if (parameter->rank() != container::VECTOR_RANK or parameter->total() != features) {
+      throw ShapeError{"cbx::BatchNormLayer::BatchNormLayer: parameter = {} does not match the {} features of "
+                       "input_shape = {}",
+                       parameter->shape().to_string(), features, input_shape_.to_string()};
+    }
+  }
+}
+
+// /////////////////////////////////////////////
+// Accessors and Mutators
+// /////////////////////////////////////////////
+
+auto BatchNormLayer::gamma() const -> const container & { return gamma_; }
+
+auto BatchNormLayer::beta() const -> const container & { return beta_; }
+
+auto BatchNormLayer::running_mean() const -> const container & { return running_mean_; }
+
+auto BatchNormLayer::running_variance() const -> const container & { return running_variance_; }
+
+auto BatchNormLayer::set_running_statistics(const container &mean, const container &variance)
+    -> BatchNormLayer & {
+  auto features = input_shape_.back();
+  for (const auto *statistic : {&mean, &variance}) {
+    if (statistic->total() != features) {
+      throw ShapeError{"cbx::BatchNormLayer::set_running_statistics: statistic = {} does not match the {} "
+                       "features of the layer",
+                       statistic->shape().to_string(), features};
+    }
+  }
+  std::copy(mean.begin(), mean.end(), running_mean_.begin());
+  std::copy(variance.begin(), variance.end(), running_variance_.begin());
+  return *this;
+}
+
+auto BatchNormLayer::gamma_gradients() const -> const container & {
+  _m_allocate_gradients();
+  return gamma_gradients_;
+}
+
+auto BatchNormLayer::beta_gradients() const -> const container & {
+  _m_allocate_gradients();
+  return beta_gradients_;
+}
+
+auto BatchNormLayer::momentum() const -> value_type { return momentum_; }
+
+auto BatchNormLayer::epsilon() const -> value_type { return epsilon_; }
+
+auto BatchNormLayer::is_training() const -> bool { return training_; }
+
+auto BatchNormLayer::set_training(bool training) -> BatchNormLayer & {
+  training_ = training;
+  return *this;
+}
+
+auto BatchNormLayer::input_shape() const -> const Shape & { return input_shape_; }
+
+// /////////////////////////////////////////////
+// Query Functions
+// /////////////////////////////////////////////
+
+auto BatchNormLayer::neurons() const -> size_type { return input_shape_.total(); }
+
+auto BatchNormLayer::parameters() const -> size_type { return gamma_.total() + beta_.total(); }
+
+auto BatchNormLayer::output_shape([[maybe_unused]] const Shape &input_shape) const -> Shape {
+  return input_shape_;
+}
+
+auto BatchNormLayer::type() const -> LayerType { return LayerType::BatchNorm; }
+
+// /////////////////////////////////////////////
+// Informative
+// /////////////////////////////////////////////
+
+auto BatchNormLayer::property() const -> std::string {
+  return fmt::format("Shape: G={}, B={}", gamma_.shape().to_string(), beta_.shape().to_string());
+}
+
+// /////////////////////////////////////////////
+// Utility
+// /////////////////////////////////////////////
+
+auto BatchNormLayer::clone() const -> std::shared_ptr<AbstractLayer> {
+  return std::make_shared<BatchNormLayer>(*this);
+}
+
+auto BatchNormLayer::fold(const AbstractLayer &layer) const -> std::shared_ptr<AbstractLayer> {
+  // Formulae:
+  //  Ŵ' = Ŵ ⋅ diag(s)
+  //  Ƀ' = (Ƀ - μ) ⋅ s + Ƀₙ
+  //
+  // where s = Ɣ / √(σ² + ε), and the columns of Ŵ are the features of this layer.
+  auto features = gamma_.total();
+  auto scale = std::vector<value_type>(features);
+  for (size_type j = {}; j < features; ++j) {
+    scale[j] = gamma_[j] / std::sqrt(running_variance_[j] + epsilon_);
+  }
+
+  auto folded = std::shared_ptr<AbstractLayer>{};
+  switch (layer.type()) {
+    case LayerType::Dense: {
+      const auto &dense = static_cast<const DenseLayer &>(layer);
+      if (dense.neurons() != features or input_shape_.total() != features) {
+        return {};
+      }
+      auto [weights, biases] = fold_columns(dense.weights(), dense.biases(), scale, running_mean_, beta_);
+      auto inputs = dense.weights().shape().front();
+      auto dense_folded = std::make_shared<DenseLayer>(inputs, std::move(weights), std::move(biases));
+      dense_folded->set_shards(dense.shards());
+      folded = dense_folded;
+      break;
+    }
+    case LayerType::Conv2D: {
+      const auto &conv = static_cast<const Conv2DLayer &>(layer);
+      if (conv.kernel().shape().back() != features or conv.neurons() != input_shape_.total()) {
+        return {};
+      }
+      auto [kernel, biases] = fold_columns(conv.kernel(), conv.biases(), scale, running_mean_, beta_);
+      folded = std::make_shared<Conv2DLayer>(conv.input_shape(), std::move(kernel), std::move(biases),
+                                             conv.params());
+      break;
+    }
+    default: {
+      return {};
+    }
+  }
+  folded->set_id(layer.id());
+  return folded;
+}
+
+// /////////////////////////////////////////////
+// Core Functionality
+// /////////////////////////////////////////////
+
+auto BatchNormLayer::forward_pass(const container &input) const -> const AbstractLayer & {
+  // Formula: Ô = Ɣ ⋅ x̂ + Ƀ, where x̂ = (Î - μ) / √(σ² + ε)
+  auto rows = _m_count_rows(input.shape());
+  auto features = gamma_.total();
+  auto mean = std::vector<value_type>(running_mean_.begin(), running_mean_.end());
+  inverse_deviations_ = container{{features}};
+  used_batch_statistics_ = training_;
+  if (training_) {
+    // The running statistics track the unbiased variance, while the batch is normalized with the biased one.
+    auto moments = batch_moments(input.data(), rows, features);
+    auto correction = rows > 1 ? f32(rows) / f32(rows - 1) : 1.0F;
+    for (size_type j = {}; j < features; ++j) {
+      auto variance = moments.m2[j] / f32(rows);
+      mean[j] = moments.mean[j];
+      inverse_deviations_[j] = 1.0F / std::sqrt(variance + epsilon_);
+      running_mean_[j] = momentum_ * running_mean_[j] + (1 - momentum_) * mean[j];
+      running_variance_[j] = momentum_ * running_variance_[j] + (1 - momentum_) * variance * correction;
+    }
+  } else {
+    for (size_type j = {}; j < features; ++j) {
+      inverse_deviations_[j] = 1.0F / std::sqrt(running_variance_[j] + epsilon_);
+    }
+  }
+
+  // Applying forward pass and caching the input, the standardized input and the output.
+  input_ = input;
+  normalized_ = container{input.shape()};
+  output_ = container{input.shape()};
+  ThreadPool::global().parallel_for(0, rows, chunk_rows(features), [&](size_type first, size_type last) {
+    for (auto r = first; r < last; ++r) {
+      auto offset = r * features;
+      for (size_type j = {}; j < features; ++j) {
+        auto x_hat = (input_[offset + j] - mean[j]) * inverse_deviations_[j];
+        normalized_[offset + j] = x_hat;
+        output_[offset + j] = gamma_[j] * x_hat + beta_[j];
+      }
+    }
+  });
+  return *this;
+}
+
+auto BatchNormLayer::infer(TensorView<const value_type> input, TensorView<value_type> output) const -> void {
+  // Formula: Ô = Î ⋅ s + (Ƀ - μ ⋅ s), where s = Ɣ / √(σ² + ε)
+  auto rows = _m_count_rows(input.shape());
+  auto target = output.reshaped(input.shape());
+  auto features = gamma_.total();
+  auto scale = std::vector<value_type>(features), shift = std::vector<value_type>(features);
+  for (size_type j = {}; j < features; ++j) {
+    scale[j] = gamma_[j] / std::sqrt(running_variance_[j] + epsilon_);
+    shift[j] = beta_[j] - running_mean_[j] * scale[j];
+  }
+  ThreadPool::global().parallel_for(0, rows, chunk_rows(features), [&](size_type first, size_type last) {
+    for (auto r = first; r < last; ++r) {
+      auto x = input.data() + r * features;
+      auto y = target.data() + r * features;
+      for (size_type j = {}; j < features; ++j) {
+        y[j] = x[j] * scale[j] + shift[j];
+      }
+    }
+  });
+}
+
+auto BatchNormLayer::backward_pass(const container &output_gradient) const -> const AbstractLayer & {
+  // Formulae:
+  //  ∂Ɣ += ⅀ ∂Ô ⋅ x̂
+  //  ∂Ƀ += ⅀ ∂Ô
+  //  ∂Î  = Ɣ / √(σ² + ε) ⋅ (∂Ô - ⅀ ∂Ô / n - x̂ ⋅ ⅀ (∂Ô ⋅ x̂) / n)
+  //
+  // where the sums run over the n rows of the batch. With the running statistics, μ and σ² do not depend on the
+  // input, and the mean terms of ∂Î vanish.
+  _m_check_output_gradient(output_gradient);
+  auto features = gamma_.total();
+  auto rows = output_gradient.total() / features;
+  _m_allocate_gradients();
+
+  auto [sum, weighted_sum] = gradient_sums(output_gradient.data(), normalized_.data(), rows, features);
+  auto coefficient = std::vector<value_type>(features);
+  for (size_type j = {}; j < features; ++j) {
+    beta_gradients_[j] += sum[j];
+    gamma_gradients_[j] += weighted_sum[j];
+    coefficient[j] = gamma_[j] * inverse_deviations_[j];
+    sum[j] = used_batch_statistics_ ? sum[j] / f32(rows) : 0;
+    weighted_sum[j] = used_batch_statistics_ ? weighted_sum[j] / f32(rows) : 0;
+  }
+
+  input_gradient_ = container{input_.shape()};
+  ThreadPool::global().parallel_for(0, rows, chunk_rows(features), [&](size_type first, size_type last) {
+    for (auto r = first; r < last; ++r) {
+      auto offset = r * features;
+      for (size_type j = {}; j < features; ++j) {
+        auto dy = output_gradient[offset + j];
+        auto x_hat = normalized_[offset + j];
+        input_gradient_[offset + j] = coefficient[j] * (dy - sum[j] - x_hat * weighted_sum[j]);
+      }
+    }
+  });
+  return *this;
+}
+
+auto BatchNormLayer::trainable_parameters() -> std::vector<TrainableParameter> {
+  _m_allocate_gradients();
+  return {{{gamma_.data(), gamma_.total()}, {gamma_gradients_.data(), gamma_gradients_.total()}},
+          {{beta_.data(), beta_.total()}, {beta_gradients_.data(), beta_gradients_.total()}}};
+}
+
+auto BatchNormLayer::zero_gradients() const -> void {
+  _m_allocate_gradients();
+  std::fill(gamma_gradients_.begin(), gamma_gradients_.end(), value_type{});
+  std::fill(beta_gradients_.begin(), beta_gradients_.end(), value_type{});
+}
+
+}
@@ -0,0 +1,263 @@
+// Copyright 2021 CBrainX
+// Project URL: https://github.com/mansoormemon/cbrainx
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Copyright (c) 2021 Mansoor Ahmed Memon <mansoorahmed.one@gmail.com>
+#include "cbrainx/conv2DLayer.hh"
+
+#include <algorithm>
+#include <limits>
+#include <utility>
+
+#include <fmt/format.h>
+
+#include "cbrainx/exceptions.hh"
+#include "cbrainx/gemm.hh"
+
+namespace cbx {
+
+// /////////////////////////////////////////////
+// Helpers
+// /////////////////////////////////////////////
+
+auto Conv2DLayer::_m_initialize_shapes() -> void {
+  if (input_shape_.rank() == container::MATRIX_RANK) {
+    input_shape_ = Shape{input_shape_[0], input_shape_[1], 1};
+  }
+  if (input_shape_.rank() != 3) {
+    throw RankError{"cbx::Conv2DLayer::_m_initialize_shapes: input_shape = {} is not the shape of an image",
+                    input_shape_.to_string()};
+  }
+  auto is_bank = kernel_.rank() > 0 and biases_.rank() == container::VECTOR_RANK and
+                 biases_.total() == kernel_.shape().back();
+  if (not is_bank) {
+    throw ShapeError{"cbx::Conv2DLayer::_m_initialize_shapes: kernel = {} and biases = {} do not form a layer",
+                     kernel_.shape().to_string(), biases_.shape().to_string()};
+  }
+  auto [height, width, channels] = input_shape_.unwrap<3>();
+  output_shape_ = conv2d_output_shape({1, height, width, channels}, kernel_.shape(), params_).slice(1);
+}
+
+auto Conv2DLayer::_m_count_samples(const Shape &shape) const -> size_type {
+  if (shape.rank() < container::MATRIX_RANK or shape.total() != shape.front() * input_shape_.total()) {
+    throw ShapeError{"cbx::Conv2DLayer::_m_count_samples: input = {} does not hold images of shape {}",
+                     shape.to_string(), input_shape_.to_string()};
+  }
+  return shape.front();
+}
+
+auto Conv2DLayer::_m_allocate_gradients() const -> void {
+  if (kernel_gradients_.total() != kernel_.total()) {
+    kernel_gradients_ = kernel_.zeros_like();
+  }
+  if (bias_gradients_.total() != biases_.total()) {
+    bias_gradients_ = biases_.zeros_like();
+  }
+}
+
+// /////////////////////////////////////////////
+// Constructors (and Destructors)
+// /////////////////////////////////////////////
+
+Conv2DLayer::Conv2DLayer(const Shape &input_shape, size_type filters, size_type kernel_size, size_type stride,
+                         size_type padding)
+    : Conv2DLayer{input_shape, filters, kernel_size, Conv2DParams::square(stride, padding)} {}
+
+Conv2DLayer::Conv2DLayer(const Shape &input_shape, size_type filters, size_type kernel_size,
+                         const Conv2DParams &params)
+    : AbstractLayer{"CNVL"}, input_shape_{input_shape}, params_{params} {
+  auto channels = input_shape.rank() > container::MATRIX_RANK ? input_shape.back() : 1;
+  kernel_ = container::random({kernel_size, kernel_size, channels, filters}, {}, -1, 1);
+  biases_ = container{{filters}, std::numeric_limits<value_type>::epsilon()};
+  _m_initialize_shapes();
+  kernel_gradients_ = kernel_.zeros_like();
+  bias_gradients_ = biases_.zeros_like();
+}
+
+Conv2DLayer::Conv2DLayer(const Shape &input_shape, container kernel, container biases,
+                         const Conv2DParams &params)
+    : AbstractLayer{"CNVL"},
+      input_shape_{input_shape},
+      params_{params},
+      kernel_{std::move(kernel)},
+      biases_{std::move(biases)} {
+  _m_initialize_shapes();
+}
+
+Conv2DLayer::Conv2DLayer(Conv2DLayer &&other) noexcept
+    : AbstractLayer{std::move(other)},
+      input_shape_{std::move(other.input_shape_)},
+      output_shape_{std::move(other.output_shape_)},
+      params_{other.params_},
+      kernel_{std::move(other.kernel_)},
+      biases_{std::move(other.biases_)},
+      kernel_gradients_{std::move(other.kernel_gradients_)},
+      bias_gradients_{std::move(other.bias_gradients_)} {}
+
+// /////////////////////////////////////////////
+// Assignment Operators
+// /////////////////////////////////////////////
+
+auto Conv2DLayer::operator=(Conv2DLayer &&other) noexcept -> Conv2DLayer & {
+  AbstractLayer::operator=(std::move(other));
+  input_shape_ = std::move(other.input_shape_);
+  output_shape_ = std::move(other.output_shape_);
+  params_ = other.params_;
+  kernel_ = std::move(other.kernel_);
+  biases_ = std::move(other.biases_);
+  kernel_gradients_ = std::move(other.kernel_gradients_);
+  bias_gradients_ = std::move(other.bias_gradients_);
+  return *this;
+}
+
+// /////////////////////////////////////////////
+// Accessors and Mutators
+// /////////////////////////////////////////////
+
+auto Conv2DLayer::kernel() const -> const container & { return kernel_; }
+
+auto Conv2DLayer::biases() const -> const container & { return biases_; }
+
+auto Conv2DLayer::kernel_gradients() const -> const container & {
+  _m_allocate_gradients();
+  return kernel_gradients_;
+}
+
+auto Conv2DLayer::bias_gradients() const -> const container & {
+  _m_allocate_gradients();
+  return bias_gradients_;
+}
+
+auto Conv2DLayer::params() const -> const Conv2DParams & { return params_; }
+
+auto Conv2DLayer::input_shape() const -> const Shape & { return input_shape_; }
+
+// /////////////////////////////////////////////
+// Query Functions
+// /////////////////////////////////////////////
+
+auto Conv2DLayer::neurons() const -> size_type { return output_shape_.total(); }
+
+auto Conv2DLayer::parameters() const -> size_type { return kernel_.total() + biases_.total(); }
+
+auto Conv2DLayer::output_shape([[maybe_unused]] const Shape &input_shape) const -> Shape {
+  return output_shape_;
+}
+
+auto Conv2DLayer::type() const -> LayerType { return LayerType::Conv2D; }
+
+// /////////////////////////////////////////////
+// Informative
+// /////////////////////////////////////////////
+
+auto Conv2DLayer::property() const -> std::string {
+  return fmt::format("Shape: K={}, B={}, S=[{}, {}], P=[{}, {}]", kernel_.shape().to_string(),
+                     biases_.shape().to_string(), params_.stride_h, params_.stride_w, params_.padding_h,
+                     params_.padding_w);
+}
+
+// /////////////////////////////////////////////
+// Utility
+// /////////////////////////////////////////////
+
+auto Conv2DLayer::clone() const -> std::shared_ptr<AbstractLayer> {
+  return std::make_shared<Conv2DLayer>(*this);
+}
+
+// /////////////////////////////////////////////
+// Core Functionality
+// /////////////////////////////////////////////
+
+auto Conv2DLayer::forward_pass(const container &input) const -> const AbstractLayer & {
+  // Formula: Ô = Î ⊛ Ķ + Ƀ
+  //
+  // where:
+  //  Î - Input (Tensor)  : Shape => (m, h, w, c)
+  //  Ķ - Kernel (Tensor) : Shape => (kh, kw, c, f)
+  //  Ƀ - Biases (Vector) : Shape => (f)
+  //  Ô - Output (Tensor) : Shape => (m, oh, ow, f)
+
+  // Applying forward pass and caching the input and output layers.
+  auto samples = _m_count_samples(input.shape());
+  auto [out_height, out_width, filters] = output_shape_.unwrap<3>();
+  input_ = input;
+  output_ = container{{samples, out_height, out_width, filters}};
+  infer(input_, output_);
+  return *this;
+}
+
+auto Conv2DLayer::infer(TensorView<const value_type> input, TensorView<value_type> output) const -> void {
+  auto samples = _m_count_samples(input.shape());
+  auto [height, width, channels] = input_shape_.unwrap<3>();
+  auto [out_height, out_width, filters] = output_shape_.unwrap<3>();
+  auto images = input.reshaped({samples, height, width, channels});
+  auto maps = output.reshaped({samples, out_height, out_width, filters});
+  // The biases are added by the convolution to each block of the maps while it is still in cache.
+  auto add_biases = [&](size_type pixel, size_type filter, size_type pixels, size_type count) {
+    for (auto i = pixel; i < pixel + pixels; ++i) {
+      auto row = maps.data() + i * filters + filter;
+      std::transform(row, row + count, biases_.begin() + filter, row,
+                     [](auto value, auto bias) { return value + bias; });
+    }
+  };
+  conv2d(images, kernel_, maps, params_, add_biases);
+}
+
+auto Conv2DLayer::backward_pass(const container &output_gradient) const -> const AbstractLayer & {
+  // Formulae:
+  //  ∂Î  = fold(∂Ô ⊙ Ķᵀ)
+  //  ∂Ķ += unfold(Î)ᵀ ⊙ ∂Ô
+  //  ∂Ƀ += ⅀ [pixels] ∂Ô
+  //
+  // where:
+  //  ∂Ô - Gradient w.r.t. the output (Tensor) : Shape => (m, oh, ow, f)
+  //  ∂Î - Gradient w.r.t. the input (Tensor)  : Shape => (m, h, w, c)
+  //  ∂Ķ - Gradient w.r.t. the kernel (Tensor) : Shape => (kh, kw, c, f)
+  //  ∂Ƀ - Gradient w.r.t. the biases (Vector) : Shape => (f)
+  //
+  // and, unfold (im2col) lays out the window of every output pixel as a row, which fold adds back.
+  _m_check_output_gradient(output_gradient);
+  auto samples = input_.shape().front();
+  auto [height, width, channels] = input_shape_.unwrap<3>();
+  auto images = Shape{samples, height, width, channels};
+  auto filters = output_shape_.back();
+  auto pixels = output_gradient.total() / filters;
+  _m_allocate_gradients();
+
+  conv2d_kernel_gradient(TensorView<const value_type>{input_}.reshaped(images), output_gradient,
+                         kernel_gradients_, params_);
+
+  // Summing the pixels is a product with a row vector of ones, which `gemv` streams in a single pass.
+  auto ones = std::vector<value_type>(pixels, 1);
+  gemv(ones.data(), output_gradient.data(), bias_gradients_.data(), pixels, filters);
+
+  input_gradient_ = input_.zeros_like();
+  conv2d_input_gradient(output_gradient, kernel_, TensorView<value_type>{input_gradient_}.reshaped(images),
+                        params_);
+  return *this;
+}
+
+auto Conv2DLayer::trainable_parameters() -> std::vector<TrainableParameter> {
+  _m_allocate_gradients();
+  return {{{kernel_.data(), kernel_.total()}, {kernel_gradients_.data(), kernel_gradients_.total()}},
+          {{biases_.data(), biases_.total()}, {bias_gradients_.data(), bias_gradients_.total()}}};
+}
+
+auto Conv2DLayer::zero_gradients() const -> void {
+  _m_allocate_gradients();
+  std::fill(kernel_gradients_.begin(), kernel_gradients_.end(), value_type{});
+  std::fill(bias_gradients_.begin(), bias_gradients_.end(), value_type{});
+}
+
+}
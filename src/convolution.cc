@@ -0,0 +1,352 @@
+// Copyright 2021 CBrainX
+// Project URL: https://github.com/mansoormemon/cbrainx
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Copyright (c) 2021 Mansoor Ahmed Memon <mansoorahmed.one@gmail.com>
+#include "cbrainx/convolution.hh"
+
+#include <algorithm>
+#include <cstring>
+#include <functional>
+#include <tuple>
+#include <vector>
+
+#include "cbrainx/exceptions.hh"
+#include "cbrainx/gemm.hh"
+#include "cbrainx/threadPool.hh"
+#include "cbrainx/tune.hh"
+#include "winograd.hh"
+
+namespace cbx {
+
+// /////////////////////////////////////////////
+// Implementation Detail
+// /////////////////////////////////////////////
+
+namespace {
+
+/// \brief Number of elements of a tile of the unfolded input, sized to stay within the L2 cache.
+constexpr usize TILE_ELEMENTS = 1 << 16;
+
+/// \brief Relative error bounds of the Winograd algorithms, see `ConvAlgorithm`.
+constexpr f32 WINOGRAD_2X2_ERROR = 1e-6F;
+constexpr f32 WINOGRAD_4X4_ERROR = 1e-5F;
+
+/// \brief Minimum number of channels times filters for the Winograd transforms to pay off.
+constexpr usize WINOGRAD_MIN_WORK = 64;
+
+/// \brief Returns the output extent along one spatial axis, or zero if the window does not fit.
+auto output_extent(usize extent, usize kernel, usize stride, usize padding, usize dilation) -> usize {
+  auto padded = extent + 2 * padding;
+  auto span = dilation * (kernel - 1) + 1;
+  return padded < span ? 0 : (padded - span) / stride + 1;
+}
+
+/// \brief Unfolds the windows of output pixels [first, last) into consecutive rows of \p rows.
+auto unfold(const f32 *input, const Shape &in, const Shape &out, const Shape &kernel,
+            const Conv2DParams &params, usize first, usize last, f32 *rows) -> void {
+  auto [height, width, channels] = std::tuple{in[1], in[2], in[3]};
+  auto [out_height, out_width] = std::tuple{out[1], out[2]};
+  auto [kernel_height, kernel_width] = std::tuple{kernel[0], kernel[1]};
+  auto channel_bytes = channels * sizeof(f32);
+
+  for (auto pixel = first; pixel < last; ++pixel) {
+    auto n = pixel / (out_height * out_width);
+    auto oh = pixel / out_width % out_height;
+    auto ow = pixel % out_width;
+    auto image = input + n * height * width * channels;
+    for (usize kh = {}; kh < kernel_height; ++kh) {
+      // Coordinates are shifted by the padding so that they stay unsigned.
+      auto ih = oh * params.stride_h + kh * params.dilation_h;
+      auto row_inside = ih >= params.padding_h and ih - params.padding_h < height;
+      for (usize kw = {}; kw < kernel_width; ++kw) {
+        auto iw = ow * params.stride_w + kw * params.dilation_w;
+        if (row_inside and iw >= params.padding_w and iw - params.padding_w < width) {
+          std::memcpy(rows, image + ((ih - params.padding_h) * width + (iw - params.padding_w)) * channels,
+                      channel_bytes);
+        } else {
+          std::fill_n(rows, channels, f32{});
+        }
+        rows += channels;
+      }
+    }
+  }
+}
+
+/// \brief Adds consecutive rows of \p rows to the windows of output pixels [first, last), undoing `unfold`.
+auto fold(const f32 *rows, const Shape &in, const Shape &out, const Shape &kernel, const Conv2DParams &params,
+          usize first, usize last, f32 *input) -> void {
+  auto [height, width, channels] = std::tuple{in[1], in[2], in[3]};
+  auto [out_height, out_width] = std::tuple{out[1], out[2]};
+  auto [kernel_height, kernel_width] = std::tuple{kernel[0], kernel[1]};
+
+  for (auto pixel = first; pixel < last; ++pixel) {
+    auto n = pixel / (out_height * out_width);
+    auto oh = pixel / out_width % out_height;
+    auto ow = pixel % out_width;
+    auto image = input + n * height * width * channels;
+    for (usize kh = {}; kh < kernel_height; ++kh) {
+      auto ih = oh * params.stride_h + kh * params.dilation_h;
+      auto row_inside = ih >= params.padding_h and ih - params.padding_h < height;
+      for (usize kw = {}; kw < kernel_width; ++kw) {
+        auto iw = ow * params.stride_w + kw * params.dilation_w;
+        if (row_inside and iw >= params.padding_w and iw - params.padding_w < width) {
+          auto target = image + ((ih - params.padding_h) * width + (iw - params.padding_w)) * channels;
+          std::transform(rows, rows + channels, target, target, std::plus{});
+        }
+        rows += channels;
+      }
+    }
+  }
+}
+
+/// \brief Returns whether a convolution reads its input as the unfolded matrix as is.
+auto is_pointwise(const Shape &kernel, const Conv2DParams &params) -> bool {
+  return kernel[0] == 1 and kernel[1] == 1 and params.stride_h == 1 and params.stride_w == 1 and
+         params.padding_h == 0 and params.padding_w == 0;
+}
+
+/// \brief Checks that a gradient w.r.t. the result of a convolution has the shape of the result.
+auto check_output_gradient(str caller, const Shape &output_gradient, const Shape &expected) -> void {
+  if (output_gradient != expected) {
+    throw ShapeError{"cbx::{}: output_gradient = {} does not match the result = {} of the convolution", caller,
+                     output_gradient.to_string(), expected.to_string()};
+  }
+}
+
+}
+
+// /////////////////////////////////////////////
+// Query Functions
+// /////////////////////////////////////////////
+
+auto conv2d_output_shape(const Shape &input, const Shape &kernel, const Conv2DParams &params) -> Shape {
+  constexpr usize CONV2D_RANK = 4;
+  if (input.rank() != CONV2D_RANK or kernel.rank() != CONV2D_RANK) {
+    throw RankError{"cbx::conv2d_output_shape: input = {} and kernel = {} must be of rank {}",
+                    input.to_string(), kernel.to_string(), CONV2D_RANK};
+  }
+  if (input[3] != kernel[2]) {
+    throw ShapeError{"cbx::conv2d_output_shape: channels of input = {} must be equal to those of kernel = {}",
+                     input.to_string(), kernel.to_string()};
+  }
+  if (params.stride_h == 0 or params.stride_w == 0 or params.dilation_h == 0 or params.dilation_w == 0) {
+    throw ValueError{"cbx::conv2d_output_shape: strides [{}, {}] and dilations [{}, {}] must be positive",
+                     params.stride_h, params.stride_w, params.dilation_h, params.dilation_w};
+  }
+  auto out_height = output_extent(input[1], kernel[0], params.stride_h, params.padding_h, params.dilation_h);
+  auto out_width = output_extent(input[2], kernel[1], params.stride_w, params.padding_w, params.dilation_w);
+  if (out_height == 0 or out_width == 0) {
+    throw ValueError{"cbx::conv2d_output_shape: kernel = {} does not fit in input = {} with padding [{}, {}] "
+                     "and dilation [{}, {}]",
+                     kernel.to_string(), input.to_string(), params.padding_h, params.padding_w,
+                     params.dilation_h, params.dilation_w};
+  }
+  return {input[0], out_height, out_width, kernel[3]};
+}
+
+auto conv2d_algorithm(const Shape &input, const Shape &kernel, const Conv2DParams &params) -> ConvAlgorithm {
+  auto out_shape = conv2d_output_shape(input, kernel, params);
+  auto is_winograd_geometry = kernel[0] == 3 and kernel[1] == 3 and params.stride_h == 1 and
+                              params.stride_w == 1 and params.dilation_h == 1 and params.dilation_w == 1;
+
+  switch (params.algorithm) {
+    case ConvAlgorithm::Auto: {
+      // Tiles larger than the output waste most of their transforms.
+      auto out_extent = std::min(out_shape[1], out_shape[2]);
+      if (not is_winograd_geometry or kernel[2] * kernel[3] < WINOGRAD_MIN_WORK) {
+        return ConvAlgorithm::Im2col;
+      }
+      if (params.tolerance >= WINOGRAD_4X4_ERROR and out_extent >= 4) {
+        return ConvAlgorithm::Winograd4x4;
+      }
+      if (params.tolerance >= WINOGRAD_2X2_ERROR and out_extent >= 2) {
+        return ConvAlgorithm::Winograd2x2;
+      }
+      return ConvAlgorithm::Im2col;
+    }
+    case ConvAlgorithm::Winograd2x2:
+    case ConvAlgorithm::Winograd4x4: {
+      if (not is_winograd_geometry) {
+        throw ValueError{"cbx::conv2d_algorithm: Winograd requires a 3x3 kernel with unit stride and dilation, "
+                         "got kernel = {}, strides [{}, {}] and dilations [{}, {}]",
+                         kernel.to_string(), params.stride_h, params.stride_w, params.dilation_h,
+                         params.dilation_w};
+      }
+      return params.algorithm;
+    }
+    default: {
+      return ConvAlgorithm::Im2col;
+    }
+  }
+}
+
+// /////////////////////////////////////////////
+// Core Functionality
+// /////////////////////////////////////////////
+
+auto conv2d(const Tensor<f32> &input, const Tensor<f32> &kernel, const Conv2DParams &params) -> Tensor<f32> {
+  auto result = Tensor<f32>{conv2d_output_shape(input.shape(), kernel.shape(), params)};
+  conv2d(input, kernel, result, params);
+  return result;
+}
+
+auto conv2d(TensorView<const f32> input, const Tensor<f32> &kernel, TensorView<f32> output,
+            const Conv2DParams &params, const GemmEpilogue &epilogue) -> void {
+  auto out_shape = conv2d_output_shape(input.shape(), kernel.shape(), params);
+  if (output.shape() != out_shape) {
+    throw ShapeError{"cbx::conv2d: output = {} does not match the result = {} of the convolution",
+                     output.shape().to_string(), out_shape.to_string()};
+  }
+
+  switch (conv2d_algorithm(input.shape(), kernel.shape(), params)) {
+    case ConvAlgorithm::Winograd2x2: {
+      _detail::winograd_conv2d(input, kernel, params, 2, output, epilogue);
+      return;
+    }
+    case ConvAlgorithm::Winograd4x4: {
+      _detail::winograd_conv2d(input, kernel, params, 4, output, epilogue);
+      return;
+    }
+    default: {
+      break;
+    }
+  }
+
+  auto pixels = out_shape[0] * out_shape[1] * out_shape[2];
+  auto filters = out_shape[3];
+  auto depth = kernel.shape()[0] * kernel.shape()[1] * kernel.shape()[2];
+  std::fill(output.begin(), output.end(), f32{});
+
+  // The input of a pointwise convolution already is the unfolded matrix.
+  if (is_pointwise(kernel.shape(), params)) {
+    auto config = tune::lookup(pixels, filters, depth);
+    gemm(input.data(), kernel.data(), output.data(), pixels, filters, depth, config, epilogue);
+    return;
+  }
+
+  auto tile = std::max(TILE_ELEMENTS / depth, usize{1});
+  auto tiles = (pixels + tile - 1) / tile;
+  auto config = tune::lookup(tile, filters, depth);
+  // A single tile leaves the parallelism to the multiplication; otherwise, each tile is multiplied serially by
+  // the thread that unfolded it, while the rows are still in its cache.
+  if (tiles > 1) {
+    config.threads = 1;
+  }
+  ThreadPool::global().parallel_for(0, tiles, 1, [&](usize first_tile, usize last_tile) {
+    auto rows = std::vector<f32>(std::min(tile, pixels) * depth);
+    for (auto t = first_tile; t < last_tile; ++t) {
+      auto first = t * tile;
+      auto last = std::min(first + tile, pixels);
+      unfold(input.data(), input.shape(), out_shape, kernel.shape(), params, first, last, rows.data());
+      // The blocks of a tile are numbered from its first pixel.
+      auto shifted = GemmEpilogue{};
+      if (epilogue) {
+        shifted = [&epilogue, first](usize row, usize col, usize rows, usize cols) {
+          epilogue(first + row, col, rows, cols);
+        };
+      }
+      gemm(rows.data(), kernel.data(), output.data() + first * filters, last - first, filters, depth, config,
+           shifted);
+    }
+  });
+}
+
+auto conv2d(const Tensor<f32> &input, const Tensor<f32> &kernel, usize stride, usize padding, usize dilation)
+    -> Tensor<f32> {
+  return conv2d(input, kernel, Conv2DParams::square(stride, padding, dilation));
+}
+
+auto conv2d_input_gradient(TensorView<const f32> output_gradient, const Tensor<f32> &kernel,
+                           TensorView<f32> input_gradient, const Conv2DParams &params) -> void {
+  auto out_shape = conv2d_output_shape(input_gradient.shape(), kernel.shape(), params);
+  check_output_gradient("conv2d_input_gradient", output_gradient.shape(), out_shape);
+
+  auto [batch, out_height, out_width, filters] = out_shape.unwrap<4>();
+  auto image_pixels = out_height * out_width;
+  auto depth = kernel.shape()[0] * kernel.shape()[1] * kernel.shape()[2];
+  std::fill(input_gradient.begin(), input_gradient.end(), f32{});
+
+  // The gradient of the unfolded input of a pointwise convolution is that of the input itself.
+  if (is_pointwise(kernel.shape(), params)) {
+    auto pixels = batch * image_pixels;
+    gemm(output_gradient.data(), kernel.data(), input_gradient.data(), pixels, depth, filters,
+         tune::lookup(pixels, depth, filters), MatrixOp::None, MatrixOp::Transpose);
+    return;
+  }
+
+  auto tile = std::min(std::max(TILE_ELEMENTS / depth, usize{1}), image_pixels);
+  auto config = tune::lookup(tile, depth, filters);
+  if (batch > 1) {
+    config.threads = 1;
+  }
+  ThreadPool::global().parallel_for(0, batch, 1, [&](usize first_image, usize last_image) {
+    auto rows = std::vector<f32>(tile * depth);
+    for (auto first = first_image * image_pixels; first < last_image * image_pixels; first += tile) {
+      auto last = std::min(first + tile, (first / image_pixels + 1) * image_pixels);
+      std::fill_n(rows.begin(), (last - first) * depth, f32{});
+      gemm(output_gradient.data() + first * filters, kernel.data(), rows.data(), last - first, depth, filters,
+           config, MatrixOp::None, MatrixOp::Transpose);
+      fold(rows.data(), input_gradient.shape(), out_shape, kernel.shape(), params, first, last,
+           input_gradient.data());
+    }
+  });
+}
+
+auto conv2d_kernel_gradient(TensorView<const f32> input, TensorView<const f32> output_gradient,
+                            TensorView<f32> kernel_gradient, const Conv2DParams &params) -> void {
+  auto out_shape = conv2d_output_shape(input.shape(), kernel_gradient.shape(), params);
+  check_output_gradient("conv2d_kernel_gradient", output_gradient.shape(), out_shape);
+
+  auto pixels = out_shape[0] * out_shape[1] * out_shape[2];
+  auto filters = out_shape[3];
+  auto depth = kernel_gradient.total() / filters;
+
+  if (is_pointwise(kernel_gradient.shape(), params)) {
+    gemm(input.data(), output_gradient.data(), kernel_gradient.data(), depth, filters, pixels,
+         tune::lookup(depth, filters, pixels), MatrixOp::Transpose, MatrixOp::None);
+    return;
+  }
+
+  auto tile = std::max(TILE_ELEMENTS / depth, usize{1});
+  auto tiles = (pixels + tile - 1) / tile;
+  auto blocks = std::min(ThreadPool::global().concurrency(), tiles);
+  auto config = tune::lookup(depth, filters, std::min(tile, pixels));
+  if (blocks > 1) {
+    config.threads = 1;
+  }
+  auto partials = std::vector<std::vector<f32>>(blocks);
+  ThreadPool::global().parallel_for(0, blocks, 1, [&](usize first_block, usize last_block) {
+    auto rows = std::vector<f32>(std::min(tile, pixels) * depth);
+    for (auto block = first_block; block < last_block; ++block) {
+      auto &partial = partials[block];
+      partial.resize(depth * filters);
+      for (auto t = block * tiles / blocks; t < (block + 1) * tiles / blocks; ++t) {
+        auto first = t * tile;
+        auto last = std::min(first + tile, pixels);
+        auto count = last - first;
+        unfold(input.data(), input.shape(), out_shape, kernel_gradient.shape(), params, first, last,
+               rows.data());
+        gemm(rows.data(), output_gradient.data() + first * filters, partial.data(), depth, filters, count,
+             config, MatrixOp::Transpose, MatrixOp::None);
+      }
+    }
+  });
+  for (const auto &partial : partials) {
+    std::transform(partial.begin(), partial.end(), kernel_gradient.begin(), kernel_gradient.begin(),
+                   std::plus{});
+  }
+}
+
+}
@@ -0,0 +1,116 @@
+// Copyright 2021 CBrainX
+// Project URL: https://github.com/mansoormemon/cbrainx
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Copyright (c) 2021 Mansoor Ahmed Memon <mansoorahmed.one@gmail.com>
+
+#include "cbrainx/cpuFeatures.hh"
+
+#include <atomic>
+#include <cstdlib>
+#include <string_view>
+
+#include "cbrainx/exceptions.hh"
+
+namespace cbx {
+
+// /////////////////////////////////////////////
+// Implementation Detail
+// /////////////////////////////////////////////
+
+namespace {
+
+auto detect_isa() -> ISA {
+#if defined(CBRAINX_X86_SIMD)
+  __builtin_cpu_init();
+  if (__builtin_cpu_supports("avx512f") and __builtin_cpu_supports("avx512dq")) {
+    return ISA::AVX512;
+  }
+  if (__builtin_cpu_supports("avx2") and __builtin_cpu_supports("fma")) {
+    return ISA::AVX2;
+  }
+#endif
+  return ISA::Generic;
+}
+
+auto initial_isa() -> ISA {
+  auto supported = CpuFeatures::supported_isa();
+  auto env = std::getenv("CBRAINX_ISA");
+  if (env == nullptr) {
+    return supported;
+  }
+  // An unknown or unsupported request from the environment silently falls back to the supported ISA.
+  auto requested = std::string_view{env};
+  for (auto isa : {ISA::Generic, ISA::AVX2, ISA::AVX512}) {
+    if (requested == CpuFeatures::to_string(isa) and isa <= supported) {
+      return isa;
+    }
+  }
+  return supported;
+}
+
+auto active() -> std::atomic<ISA> & {
+  static auto isa = std::atomic<ISA>{initial_isa()};
+  return isa;
+}
+
+}
+
+// /////////////////////////////////////////////
+// Query Functions
+// /////////////////////////////////////////////
+
+auto CpuFeatures::supported_isa() -> ISA {
+  static const auto isa = detect_isa();
+  return isa;
+}
+
+auto CpuFeatures::active_isa() -> ISA { return active().load(std::memory_order_relaxed); }
+
+auto CpuFeatures::is_supported(ISA isa) -> bool { return isa <= supported_isa(); }
+
+// /////////////////////////////////////////////
+// Modifiers
+// /////////////////////////////////////////////
+
+auto CpuFeatures::set_active_isa(ISA isa) -> void {
+  if (not is_supported(isa)) {
+    throw ValueError{"cbx::CpuFeatures::set_active_isa: isa = {} is not supported [supported = {}]",
+                     to_string(isa), to_string(supported_isa())};
+  }
+  active().store(isa, std::memory_order_relaxed);
+}
+
+// /////////////////////////////////////////////
+// Informative
+// /////////////////////////////////////////////
+
+auto CpuFeatures::to_string(ISA isa) -> std::string {
+  switch (isa) {
+    case ISA::Generic: {
+      return "generic";
+    }
+    case ISA::AVX2: {
+      return "avx2";
+    }
+    case ISA::AVX512: {
+      return "avx512";
+    }
+    default: {
+      return {};
+    }
+  }
+}
+
+}
@@ -17,12 +17,51 @@
 
 #include "cbrainx/denseLayer.hh"
 
+#include <algorithm>
 #include <limits>
+#include <vector>
 
 #include <fmt/core.h>
 
+#include "cbrainx/exceptions.hh"
+#include "cbrainx/gemm.hh"
+#include "cbrainx/smallMatmul.hh"
+#include "cbrainx/threadPool.hh"
+#include "cbrainx/tune.hh"
+#include "cbrainx/vmath.hh"
+
 namespace cbx {
 
+// /////////////////////////////////////////////
+// Helpers
+// /////////////////////////////////////////////
+
+auto DenseLayer::_m_check_input_shape(const Shape &shape) const -> void {
+  auto inputs = weights_.shape().front();
+  if (shape.rank() < container::MATRIX_RANK or shape.total() != shape.front() * inputs) {
+    throw ShapeError{"cbx::DenseLayer::_m_check_input_shape: input = {} is not compatible with weights = {}",
+                     shape.to_string(), weights_.shape().to_string()};
+  }
+}
+
+auto DenseLayer::_m_allocate_gradients() const -> void {
+  if (weight_gradients_.total() != weights_.total()) {
+    weight_gradients_ = weights_.zeros_like();
+  }
+  if (bias_gradients_.total() != biases_.total()) {
+    bias_gradients_ = biases_.zeros_like();
+  }
+}
+
+auto DenseLayer::_m_shard_columns(size_type shard) const -> std::pair<size_type, size_type> {
+  // Shards are made of whole cache lines of columns, so that no two of them write to the same line of a row.
+  auto neurons = this->neurons();
+  auto lines = (neurons + DENSE_SHARD_ALIGNMENT - 1) / DENSE_SHARD_ALIGNMENT;
+  auto first = std::min(shard * lines / shards_ * DENSE_SHARD_ALIGNMENT, neurons);
+  auto last = std::min((shard + 1) * lines / shards_ * DENSE_SHARD_ALIGNMENT, neurons);
+  return {first, last - first};
+}
+
 // /////////////////////////////////////////////
 // Constructors (and Destructors)
 // /////////////////////////////////////////////
@@ -30,10 +69,26 @@ namespace cbx {
 DenseLayer::DenseLayer(size_type inputs, size_type neurons) : AbstractLayer{"DNSL"} {
   weights_ = container::random({inputs, neurons}, {}, -1, 1);
   biases_ = container{{neurons}, std::numeric_limits<value_type>::epsilon()};
+  weight_gradients_ = weights_.zeros_like();
+  bias_gradients_ = biases_.zeros_like();
+}
+
+DenseLayer::DenseLayer(size_type inputs, container weights, container biases)
+    : AbstractLayer{"DNSL"}, weights_{std::move(weights)}, biases_{std::move(biases)} {
+  if (weights_.rank() != container::MATRIX_RANK or weights_.shape().front() != inputs or
+      biases_.rank() != container::VECTOR_RANK or biases_.total() != weights_.shape().back()) {
+    throw ShapeError{
+        "cbx::DenseLayer::DenseLayer: weights = {} and biases = {} do not form a layer of input_size = {}",
+        weights_.shape().to_string(), biases_.shape().to_string(), inputs};
+  }
 }
 
 DenseLayer::DenseLayer(DenseLayer &&other) noexcept
-    : weights_{std::move(other.weights_)}, biases_{std::move(other.biases_)} {}
+    : weights_{std::move(other.weights_)},
+      biases_{std::move(other.biases_)},
+      weight_gradients_{std::move(other.weight_gradients_)},
+      bias_gradients_{std::move(other.bias_gradients_)},
+      shards_{other.shards_} {}
 
 // /////////////////////////////////////////////
 // Assignment Operators
@@ -42,6 +97,56 @@ DenseLayer::DenseLayer(DenseLayer &&other) noexcept
 auto DenseLayer::operator=(DenseLayer &&other) noexcept -> DenseLayer & {
   weights_ = std::move(other.weights_);
   biases_ = std::move(other.biases_);
+  weight_gradients_ = std::move(other.weight_gradients_);
+  bias_gradients_ = std::move(other.bias_gradients_);
+  shards_ = other.shards_;
+  return *this;
+}
+
+// /////////////////////////////////////////////
+// Accessors and Mutators
+// /////////////////////////////////////////////
+
+auto DenseLayer::weights() const -> const container & { return weights_; }
+
+auto DenseLayer::biases() const -> const container & { return biases_; }
+
+auto DenseLayer::weight_gradients() const -> const container & {
+  _m_allocate_gradients();
+  return weight_gradients_;
+}
+
+auto DenseLayer::bias_gradients() const -> const container & {
+  _m_allocate_gradients();
+  return bias_gradients_;
+}
+
+auto DenseLayer::shards() const -> size_type { return shards_; }
+
+auto DenseLayer::set_shards(size_type shards) -> DenseLayer & {
+  if (shards == 0) {
+    throw ValueError{"cbx::DenseLayer::set_shards: shards must be positive"};
+  }
+  auto [inputs, neurons] = weights_.shape().unwrap<2>();
+  auto lines = (neurons + DENSE_SHARD_ALIGNMENT - 1) / DENSE_SHARD_ALIGNMENT;
+  shards_ = std::clamp(shards, size_type{1}, std::max(lines, size_type{1}));
+  if (shards_ == 1) {
+    return *this;
+  }
+
+  // The copy is made by the same loop as the forward pass, so that each worker first touches the columns that
+  // it will multiply.
+  auto placed = container{weights_.shape(), container::container::allocator_type{}};
+  ThreadPool::global().parallel_for(0, shards_, 1, [&](size_type first, size_type last) {
+    for (auto shard = first; shard < last; ++shard) {
+      auto [column, width] = _m_shard_columns(shard);
+      for (size_type row = {}; row < inputs; ++row) {
+        auto source = weights_.data() + row * neurons + column;
+        std::copy(source, source + width, placed.data() + row * neurons + column);
+      }
+    }
+  });
+  weights_ = std::move(placed);
   return *this;
 }
 
@@ -63,6 +168,19 @@ auto DenseLayer::property() const -> std::string {
   return fmt::format("Shape: W={}, B={}", weights_.shape().to_string(), biases_.shape().to_string());
 }
 
+// /////////////////////////////////////////////
+// Utility
+// /////////////////////////////////////////////
+
+auto DenseLayer::clone() const -> std::shared_ptr<AbstractLayer> {
+  auto layer = std::make_shared<DenseLayer>(*this);
+  if (shards_ > 1) {
+    // The copied weights are placed anew, as the copy has been touched by the calling thread alone.
+    layer->set_shards(shards_);
+  }
+  return layer;
+}
+
 // /////////////////////////////////////////////
 // Core Functionality
 // /////////////////////////////////////////////
@@ -79,9 +197,103 @@ auto DenseLayer::forward_pass(const container &input) const -> const AbstractLay
   // and, the symbol `⊙` denotes dot product (typically matrix multiplication).
 
   // Applying forward pass and caching the input and output layers.
+  _m_check_input_shape(input.shape());
   input_ = input;
-  output_ = input.matmul(weights_) + biases_;
+  output_ = container::matrix(input.shape().front(), neurons());
+  infer(input_, output_);
   return *this;
 }
 
+auto DenseLayer::infer(TensorView<const value_type> input, TensorView<value_type> output) const -> void {
+  _m_check_input_shape(input.shape());
+  auto [inputs, neurons] = weights_.shape().unwrap<2>();
+  auto samples = input.shape().front();
+
+  if (shards_ > 1) {
+    // The products below are nested in a parallel loop and thus run serially, so when there are fewer shards
+    // than threads, each shard is split further into blocks of rows.
+    auto &pool = ThreadPool::global();
+    auto groups = std::min(samples, (pool.concurrency() + shards_ - 1) / shards_);
+    pool.parallel_for(0, shards_ * groups, 1, [&](size_type first, size_type last) {
+      for (auto task = first; task < last; ++task) {
+        auto shard = task / groups, group = task % groups;
+        auto [column, width] = _m_shard_columns(shard);
+        auto row = group * samples / groups;
+        auto rows = (group + 1) * samples / groups - row;
+        auto x = input.data() + row * inputs;
+        auto w = weights_.data() + column;
+        auto y = output.data() + row * neurons + column;
+        for (size_type i = {}; i < rows; ++i) {
+          std::fill(y + i * neurons, y + i * neurons + width, value_type{});
+        }
+        if (rows == 1) {
+          vmath::gemv({x, inputs}, w, neurons, {y, width});
+        } else {
+          gemm(x, inputs, w, neurons, y, neurons, rows, width, inputs, tune::lookup(rows, width, inputs));
+        }
+        for (size_type i = {}; i < rows; ++i) {
+          std::transform(biases_.begin() + column, biases_.begin() + column + width, y + i * neurons,
+                         y + i * neurons, [](auto bias, auto value) { return value + bias; });
+        }
+      }
+    });
+    return;
+  }
+
+  std::fill(output.begin(), output.end(), value_type{});
+  if (samples == 1) {
+    // A single sample only needs a matrix-vector product, which streams the weights once instead of packing
+    // them for a matrix multiplication.
+    gemv(input.data(), weights_.data(), output.data(), inputs, neurons);
+  } else if (not small_matmul(input.data(), weights_.data(), output.data(), samples, neurons, inputs)) {
+    gemm(input.data(), weights_.data(), output.data(), samples, neurons, inputs,
+         tune::lookup(samples, neurons, inputs));
+  }
+  for (size_type i = {}; i < samples; ++i) {
+    std::transform(biases_.begin(), biases_.end(), output.data() + i * neurons, output.data() + i * neurons,
+                   [](auto bias, auto x) { return x + bias; });
+  }
+}
+
+auto DenseLayer::backward_pass(const container &output_gradient) const -> const AbstractLayer & {
+  // Formulae:
+  //  ∂Î  = ∂Ô ⊙ Ŵᵀ
+  //  ∂Ŵ += Îᵀ ⊙ ∂Ô
+  //  ∂Ƀ += ⅀ [rows] ∂Ô
+  //
+  // where:
+  //  ∂Ô - Gradient w.r.t. the output (Matrix)  : Shape => (m, o)
+  //  ∂Î - Gradient w.r.t. the input (Matrix)   : Shape => (m, n)
+  //  ∂Ŵ - Gradient w.r.t. the weights (Matrix) : Shape => (n, o)
+  //  ∂Ƀ - Gradient w.r.t. the biases (Vector)  : Shape => (o)
+  _m_check_output_gradient(output_gradient);
+  auto [inputs, neurons] = weights_.shape().unwrap<2>();
+  auto samples = input_.total() / inputs;
+  _m_allocate_gradients();
+
+  gemm(input_.data(), output_gradient.data(), weight_gradients_.data(), inputs, neurons, samples,
+       tune::lookup(inputs, neurons, samples), MatrixOp::Transpose, MatrixOp::None);
+
+  // Summing the rows is a product with a row vector of ones, which `gemv` streams in a single pass.
+  auto ones = std::vector<value_type>(samples, 1);
+  gemv(ones.data(), output_gradient.data(), bias_gradients_.data(), samples, neurons);
+
+  input_gradient_ = input_.zeros_like();
+  gemm(output_gradient.data(), weights_.data(), input_gradient_.data(), samples, inputs, neurons,
+       tune::lookup(samples, inputs, neurons), MatrixOp::None, MatrixOp::Transpose);
+  return *this;
+}
+
+auto DenseLayer::trainable_parameters() -> std::vector<TrainableParameter> {
+  _m_allocate_gradients();
+  return {{{weights_.data(), weights_.total()}, {weight_gradients_.data(), weight_gradients_.total()}},
+          {{biases_.data(), biases_.total()}, {bias_gradients_.data(), bias_gradients_.total()}}};
+}
+
+auto DenseLayer::zero_gradients() const -> void {
+  _m_allocate_gradients();
+  std::fill(weight_gradients_.begin(), weight_gradients_.end(), value_type{});
+  std::fill(bias_gradients_.begin(), bias_gradients_.end(), value_type{});
+}
+
 }
@@ -25,10 +25,14 @@ auto IncompatibleColorModelError::what() const noexcept -> str { return msg_.c_s
 
 auto IndexOutOfBoundsError::what() const noexcept -> str { return msg_.c_str(); }
 
+auto ModelIOError::what() const noexcept -> str { return msg_.c_str(); }
+
 auto RankError::what() const noexcept -> str { return msg_.c_str(); }
 
 auto ShapeError::what() const noexcept -> str { return msg_.c_str(); }
 
+auto SocketError::what() const noexcept -> str { return msg_.c_str(); }
+
 auto UnrecognizedColorModelError::what() const noexcept -> str { return msg_.c_str(); }
 
 auto ValueError::what() const noexcept -> str { return msg_.c_str(); }
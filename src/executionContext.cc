@@ -0,0 +1,43 @@
+// Copyright 2021 CBrainX
+// Project URL: https://github.com/mansoormemon/cbrainx
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Copyright (c) 2021 Mansoor Ahmed Memon <mansoorahmed.one@gmail.com>
+#include "cbrainx/executionContext.hh"
+
+namespace cbx {
+
+// /////////////////////////////////////////////
+// Query Functions
+// /////////////////////////////////////////////
+
+auto ExecutionContext::capacity() const noexcept -> size_type { return workspace_.size(); }
+
+// /////////////////////////////////////////////
+// Core Functionality
+// /////////////////////////////////////////////
+
+auto ExecutionContext::workspace(size_type size) -> std::span<value_type> {
+  if (workspace_.size() < size) {
+    workspace_.resize(size);
+  }
+  return {workspace_.data(), size};
+}
+
+auto ExecutionContext::release() -> void {
+  workspace_.clear();
+  workspace_.shrink_to_fit();
+}
+
+}
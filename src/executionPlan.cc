@@ -0,0 +1,357 @@
+// Copyright 2021 CBrainX
+// Project URL: https://github.com/mansoormemon/cbrainx
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Copyright (c) 2021 Mansoor Ahmed Memon <mansoorahmed.one@gmail.com>
+#include "cbrainx/executionPlan.hh"
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <iterator>
+#include <numeric>
+#include <span>
+
+#include <fmt/format.h>
+
+#include "cbrainx/activationLayer.hh"
+#include "cbrainx/batchNormLayer.hh"
+#include "cbrainx/denseLayer.hh"
+#include "cbrainx/exceptions.hh"
+#include "cbrainx/smallMatmul.hh"
+#include "cbrainx/softmax.hh"
+#include "cbrainx/tensorView.hh"
+#include "cbrainx/tune.hh"
+
+namespace cbx {
+
+// /////////////////////////////////////////////
+// Implementation Detail
+// /////////////////////////////////////////////
+
+namespace {
+
+auto kernel_name(ExecutionPlan::Kernel kernel) -> str {
+  switch (kernel) {
+    case ExecutionPlan::Kernel::DenseGemv: {
+      return "DenseGemv";
+    }
+    case ExecutionPlan::Kernel::DenseSmall: {
+      return "DenseSmall";
+    }
+    case ExecutionPlan::Kernel::DenseGemm: {
+      return "DenseGemm";
+    }
+    case ExecutionPlan::Kernel::Activation: {
+      return "Activation";
+    }
+    case ExecutionPlan::Kernel::Softmax: {
+      return "Softmax";
+    }
+    case ExecutionPlan::Kernel::Layer: {
+      return "Layer";
+    }
+  }
+  return "";
+}
+
+/// \brief The number of elements that a step processes at a time, small enough to stay in the L1 cache
+/// between the kernel and the epilogue.
+constexpr usize CHUNK_SIZE = 4096;
+
+/// \brief Returns the number of rows of the given width that make up a chunk.
+auto chunk_rows(usize width) -> usize { return std::max(CHUNK_SIZE / std::max(width, usize{1}), usize{1}); }
+
+/// \brief Adds the biases to every row of a block of a row-major matrix with `ld` elements per row.
+auto add_biases(f32 *y, const f32 *biases, usize rows, usize cols, usize ld) -> void {
+  for (usize i = {}; i < rows; ++i) {
+    auto row = y + i * ld;
+    std::transform(biases, biases + cols, row, row, [](auto bias, auto x) { return x + bias; });
+  }
+}
+
+}
+
+// /////////////////////////////////////////////
+// Helpers
+// /////////////////////////////////////////////
+
+auto ExecutionPlan::_s_finish(const Step &step, value_type *y, size_type rows, size_type col, size_type cols)
+    -> void {
+  auto width = step.outputs;
+  // A block of whole rows is contiguous and is processed a chunk at a time; any other block, a row at a time.
+  auto whole = col == 0 and cols == width;
+  auto step_rows = whole ? chunk_rows(width) : size_type{1};
+  for (size_type i = {}; i < rows; i += step_rows) {
+    auto count = std::min(step_rows, rows - i);
+    auto block = y + i * width + col;
+    if (step.biases != nullptr) {
+      add_biases(block, step.biases + col, count, cols, width);
+    }
+    auto values = std::span{block, count * cols};
+    for (const auto &function : step.epilogue) {
+      function.apply(values, values);
+    }
+    if (step.softmax and whole) {
+      Softmax::apply(values, values, width);
+    }
+  }
+}
+
+// /////////////////////////////////////////////
+// Constructors and Destructors
+// /////////////////////////////////////////////
+
+ExecutionPlan::ExecutionPlan(const Shape &input_shape, const layers_type &layers, size_type batch_size,
+                             bool fuse)
+    : batch_size_{batch_size}, input_size_{input_shape.total()} {
+  if (batch_size == 0) {
+    throw ValueError{"cbx::ExecutionPlan::ExecutionPlan: batch_size must be positive"};
+  }
+  if (layers.empty()) {
+    throw ValueError{"cbx::ExecutionPlan::ExecutionPlan: there must be at least one layer"};
+  }
+
+  // Batch normalizations are folded into copies of the dense layers or convolutions in front of them.
+  auto resolved = layers_type{};
+  for (const auto &layer : layers) {
+    if (fuse and layer->type() == LayerType::BatchNorm and not resolved.empty()) {
+      if (auto folded = static_cast<const BatchNormLayer &>(*layer).fold(*resolved.back())) {
+        resolved.back() = std::move(folded);
+        memory_passes_saved_ += 2;
+        continue;
+      }
+    }
+    resolved.push_back(layer);
+  }
+
+  auto inputs = input_size_;
+  for (const auto &layer : resolved) {
+    layers_.push_back(layer);
+    auto type = layer->type();
+    if (fuse and not steps_.empty()) {
+      auto &last = steps_.back();
+      auto is_linear = type == LayerType::Activation and
+                       static_cast<const ActivationLayer &>(*layer).function().type() == Activation::Linear;
+      auto is_foldable = last.kernel != Kernel::Layer and not last.softmax;
+      if (is_linear or (is_foldable and type == LayerType::Activation)) {
+        if (not is_linear) {
+          last.epilogue.push_back(static_cast<const ActivationLayer &>(*layer).function());
+        }
+        memory_passes_saved_ += 2;
+        continue;
+      }
+      if (is_foldable and type == LayerType::Softmax) {
+        last.softmax = true;
+        memory_passes_saved_ += 2;
+        continue;
+      }
+    }
+
+    auto step = Step{};
+    step.inputs = inputs;
+    step.outputs = layer->neurons();
+    switch (type) {
+      case LayerType::Dense: {
+        const auto &dense = static_cast<const DenseLayer &>(*layer);
+        step.weights = dense.weights().data();
+        step.biases = dense.biases().data();
+        if (dense.shards() > 1) {
+          // A sharded layer spreads its columns over the workers itself.
+          step.kernel = Kernel::Layer;
+          step.layer = layer.get();
+        } else if (batch_size == 1) {
+          step.kernel = Kernel::DenseGemv;
+        } else if (is_small_matmul(batch_size, step.outputs, step.inputs)) {
+          step.kernel = Kernel::DenseSmall;
+        } else {
+          step.kernel = Kernel::DenseGemm;
+          step.config = tune::lookup(batch_size, step.outputs, step.inputs);
+        }
+        break;
+      }
+      case LayerType::Activation: {
+        step.kernel = Kernel::Activation;
+        step.activation = static_cast<const ActivationLayer &>(*layer).function();
+        break;
+      }
+      case LayerType::Softmax: {
+        step.kernel = Kernel::Softmax;
+        break;
+      }
+      default: {
+        step.kernel = Kernel::Layer;
+        step.layer = layer.get();
+        break;
+      }
+    }
+    steps_.push_back(step);
+    inputs = step.outputs;
+  }
+  output_size_ = inputs;
+
+  // The hidden steps alternate between the two halves of the workspace; the last one writes the output.
+  auto widest = std::accumulate(steps_.begin(), std::prev(steps_.end()), size_type{},
+                                [](auto acc, const auto &step) { return std::max(acc, step.outputs); });
+  auto half = batch_size * widest;
+  workspace_size_ = 2 * half;
+  auto source = Operand{Buffer::Input, 0};
+  for (size_type i = {}; i < steps_.size(); ++i) {
+    steps_[i].source = source;
+    steps_[i].target =
+        i + 1 == steps_.size() ? Operand{Buffer::Output, 0} : Operand{Buffer::Workspace, (i % 2) * half};
+    source = steps_[i].target;
+  }
+}
+
+// /////////////////////////////////////////////
+// Query Functions
+// /////////////////////////////////////////////
+
+auto ExecutionPlan::batch_size() const noexcept -> size_type { return batch_size_; }
+
+auto ExecutionPlan::input_size() const noexcept -> size_type { return input_size_; }
+
+auto ExecutionPlan::output_size() const noexcept -> size_type { return output_size_; }
+
+auto ExecutionPlan::workspace_size() const noexcept -> size_type { return workspace_size_; }
+
+auto ExecutionPlan::memory_passes_saved() const noexcept -> size_type { return memory_passes_saved_; }
+
+auto ExecutionPlan::kernels() const -> std::vector<Kernel> {
+  auto kernels = std::vector<Kernel>{};
+  kernels.reserve(steps_.size());
+  for (const auto &step : steps_) {
+    kernels.push_back(step.kernel);
+  }
+  return kernels;
+}
+
+// /////////////////////////////////////////////
+// Informative
+// /////////////////////////////////////////////
+
+auto ExecutionPlan::to_string() const -> std::string {
+  auto buffer_name = [](Buffer buffer) -> str {
+    return buffer == Buffer::Input ? "input" : buffer == Buffer::Output ? "output" : "workspace";
+  };
+  auto description = fmt::format("ExecutionPlan [batch_size = {}, workspace = {}, memory passes saved = {}]\n",
+                                 batch_size_, workspace_size_, memory_passes_saved_);
+  for (size_type i = {}; i < steps_.size(); ++i) {
+    const auto &step = steps_[i];
+    auto name = std::string{kernel_name(step.kernel)};
+    if (step.kernel == Kernel::Activation) {
+      name += fmt::format("({})", step.activation.type_name());
+    } else if (step.kernel == Kernel::Layer) {
+      name += fmt::format("({})", step.layer->type_name());
+    }
+    for (const auto &function : step.epilogue) {
+      name += fmt::format("+{}", function.type_name());
+    }
+    if (step.softmax) {
+      name += "+Softmax";
+    }
+    description += fmt::format("{:>3}: {:<10} {} -> {}  {}[{}] -> {}[{}]", i, name, step.inputs, step.outputs,
+                               buffer_name(step.source.buffer), step.source.offset,
+                               buffer_name(step.target.buffer), step.target.offset);
+    if (step.kernel == Kernel::DenseGemm) {
+      description += fmt::format("  ({})", step.config.to_string());
+    }
+    description += "\n";
+  }
+  return description;
+}
+
+// /////////////////////////////////////////////
+// Core Functionality
+// /////////////////////////////////////////////
+
+auto ExecutionPlan::run(const value_type *input, value_type *output, ExecutionContext &context) const -> void {
+  auto workspace = context.workspace(workspace_size_).data();
+  auto sources = std::array<const value_type *, 3>{input, workspace, output};
+  auto targets = std::array<value_type *, 3>{nullptr, workspace, output};
+
+  auto rows = batch_size_;
+  for (const auto &step : steps_) {
+    auto x = sources[usize(step.source.buffer)] + step.source.offset;
+    auto y = targets[usize(step.target.buffer)] + step.target.offset;
+    auto y_total = rows * step.outputs;
+    switch (step.kernel) {
+      case Kernel::DenseGemv: {
+        std::fill(y, y + y_total, value_type{});
+        gemv(x, step.weights, y, step.inputs, step.outputs);
+        _s_finish(step, y, rows, 0, step.outputs);
+        break;
+      }
+      case Kernel::DenseSmall: {
+        small_matmul(x, step.weights, y, rows, step.outputs, step.inputs);
+        _s_finish(step, y, rows, 0, step.outputs);
+        break;
+      }
+      case Kernel::DenseGemm: {
+        // Blocks narrower than a row cannot be normalized by the epilogue; their softmax takes a pass of its
+        // own.
+        auto is_split = std::atomic<bool>{};
+        std::fill(y, y + y_total, value_type{});
+        gemm(x, step.weights, y, rows, step.outputs, step.inputs, step.config,
+             [&step, &is_split, y](usize row, usize col, usize count, usize cols) {
+               _s_finish(step, y + row * step.outputs, count, col, cols);
+               if (cols != step.outputs) {
+                 is_split.store(true, std::memory_order_relaxed);
+               }
+             });
+        if (step.softmax and is_split.load(std::memory_order_relaxed)) {
+          Softmax::apply({y, y_total}, {y, y_total}, step.outputs);
+        }
+        break;
+      }
+      case Kernel::Activation:
+      case Kernel::Softmax: {
+        auto chunk = chunk_rows(step.outputs);
+        for (size_type i = {}; i < rows; i += chunk) {
+          auto count = std::min(chunk, rows - i);
+          auto x_chunk = std::span{x + i * step.inputs, count * step.inputs};
+          auto y_chunk = std::span{y + i * step.outputs, count * step.outputs};
+          if (step.kernel == Kernel::Activation) {
+            step.activation.apply(x_chunk, y_chunk);
+          } else {
+            Softmax::apply(x_chunk, y_chunk, step.outputs);
+          }
+          _s_finish(step, y_chunk.data(), count, 0, step.outputs);
+        }
+        break;
+      }
+      case Kernel::Layer: {
+        step.layer->infer(TensorView<const value_type>{x, {rows, step.inputs}},
+                          TensorView<value_type>{y, {rows, step.outputs}});
+        break;
+      }
+    }
+  }
+}
+
+auto ExecutionPlan::run(const tensor_type &input, ExecutionContext &context) const -> tensor_type {
+  if (steps_.empty()) {
+    throw ShapeError{"cbx::ExecutionPlan::run: the plan is empty"};
+  }
+  if (input.rank() == 0 or input.shape().front() != batch_size_ or input.total() != batch_size_ * input_size_) {
+    throw ShapeError{"cbx::ExecutionPlan::run: input = {} does not match [batch_size = {}, input_size = {}]",
+                     input.shape().to_string(), batch_size_, input_size_};
+  }
+  auto output = tensor_type::matrix(batch_size_, output_size_);
+  run(input.data(), output.data(), context);
+  return output;
+}
+
+}
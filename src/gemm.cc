@@ -0,0 +1,219 @@
+// Copyright 2021 CBrainX
+// Project URL: https://github.com/mansoormemon/cbrainx
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Copyright (c) 2021 Mansoor Ahmed Memon <mansoorahmed.one@gmail.com>
+#include "cbrainx/gemm.hh"
+
+#include <algorithm>
+#include <tuple>
+
+#include <fmt/format.h>
+
+#include "cbrainx/exceptions.hh"
+#include "cbrainx/threadPool.hh"
+#include "cbrainx/vmath.hh"
+#include "vmathKernels.hh"
+
+namespace cbx {
+
+// /////////////////////////////////////////////
+// Implementation Detail
+// /////////////////////////////////////////////
+
+namespace {
+
+using kernel_type = vmath::_detail::KernelTable::microkernel_type;
+
+/// \brief Returns the register tile of a configuration, resolving the preferred tile of the active instruction
+/// set, along with its microkernel.
+auto find_microkernel(const GemmConfig &config) -> std::tuple<usize, usize, kernel_type> {
+  const auto &table = vmath::_detail::active_kernels();
+  const auto &tiles = vmath::_detail::GEMM_TILES;
+  if (config.mr == 0 and config.nr == 0) {
+    auto [mr, nr] = tiles[table.preferred_tile];
+    return {mr, nr, table.microkernels[table.preferred_tile]};
+  }
+  for (usize i = {}; i < tiles.size(); ++i) {
+    if (tiles[i] == std::pair{config.mr, config.nr}) {
+      return {config.mr, config.nr, table.microkernels[i]};
+    }
+  }
+  throw ValueError{"cbx::gemm: no microkernel of shape mr = {}, nr = {} is available", config.mr, config.nr};
+}
+
+/// \brief The distances between consecutive rows and columns of an operand, which express transposition.
+struct Strides {
+  usize row;
+  usize col;
+};
+
+/// \brief Returns the strides of a row-major matrix with `ld` elements per stored row.
+auto strides_of(MatrixOp op, usize ld) -> Strides {
+  return op == MatrixOp::Transpose ? Strides{1, ld} : Strides{ld, 1};
+}
+
+/// \brief Packs a `rows × depth` block of A into slivers of `mr` rows, each stored depth-major.
+auto pack_a(const f32 *a, Strides sa, usize rows, usize depth, usize mr, f32 *packed) -> void {
+  for (usize i0 = {}; i0 < rows; i0 += mr) {
+    auto height = std::min(mr, rows - i0);
+    for (usize p = {}; p < depth; ++p) {
+      for (usize i = {}; i < mr; ++i) {
+        *packed++ = i < height ? a[(i0 + i) * sa.row + p * sa.col] : f32{};
+      }
+    }
+  }
+}
+
+/// \brief Packs slivers `[first, last)` of `nr` columns of a `depth × cols` panel of B, each stored
+/// depth-major.
+auto pack_b(const f32 *b, Strides sb, usize depth, usize cols, usize nr, usize first, usize last, f32 *packed)
+    -> void {
+  for (auto sliver = first; sliver < last; ++sliver) {
+    auto j0 = sliver * nr;
+    auto width = std::min(nr, cols - j0);
+    auto dst = packed + sliver * depth * nr;
+    for (usize p = {}; p < depth; ++p) {
+      for (usize j = {}; j < nr; ++j) {
+        *dst++ = j < width ? b[p * sb.row + (j0 + j) * sb.col] : f32{};
+      }
+    }
+  }
+}
+
+auto round_up(usize value, usize multiple) -> usize { return (value + multiple - 1) / multiple * multiple; }
+
+/// \brief Columns per block of a parallel `gemv`; a multiple of the cache line keeps the blocks from sharing
+/// lines of the accumulator.
+constexpr usize GEMV_COLUMN_BLOCK = 64;
+
+}
+
+// /////////////////////////////////////////////
+// GemmConfig
+// /////////////////////////////////////////////
+
+auto GemmConfig::to_string() const -> std::string {
+  return fmt::format("mc={} kc={} nc={} mr={} nr={} threads={}", mc, kc, nc, mr, nr, threads);
+}
+
+// /////////////////////////////////////////////
+// Core Functionality
+// /////////////////////////////////////////////
+
+auto gemm_microkernels() -> std::vector<std::pair<usize, usize>> {
+  return {vmath::_detail::GEMM_TILES.begin(), vmath::_detail::GEMM_TILES.end()};
+}
+
+auto gemm(const f32 *a, const f32 *b, f32 *c, usize m, usize n, usize k, const GemmConfig &config,
+          MatrixOp op_a, MatrixOp op_b) -> void {
+  gemm(a, b, c, m, n, k, config, GemmEpilogue{}, op_a, op_b);
+}
+
+auto gemm(const f32 *a, const f32 *b, f32 *c, usize m, usize n, usize k, const GemmConfig &config,
+          const GemmEpilogue &epilogue, MatrixOp op_a, MatrixOp op_b) -> void {
+  // A transposed operand is stored with its dimensions swapped, i.e., `k × m` for A and `n × k` for B.
+  auto lda = op_a == MatrixOp::Transpose ? m : k;
+  auto ldb = op_b == MatrixOp::Transpose ? k : n;
+  gemm(a, lda, b, ldb, c, n, m, n, k, config, epilogue, op_a, op_b);
+}
+
+auto gemm(const f32 *a, usize lda, const f32 *b, usize ldb, f32 *c, usize ldc, usize m, usize n, usize k,
+          const GemmConfig &config, const GemmEpilogue &epilogue, MatrixOp op_a, MatrixOp op_b) -> void {
+  if (config.mc == 0 or config.kc == 0 or config.nc == 0) {
+    throw ValueError{"cbx::gemm: block sizes must be positive [{}]", config.to_string()};
+  }
+  auto [mr, nr, kernel] = find_microkernel(config);
+  // An empty product leaves C untouched; without depth, C is final as it is and only the epilogue remains.
+  if (m == 0 or n == 0) {
+    return;
+  }
+  if (k == 0) {
+    if (epilogue) {
+      epilogue(0, 0, m, n);
+    }
+    return;
+  }
+  // Blocks are whole multiples of the register tile so that only the edges of the matrices need padding.
+  auto mc = round_up(config.mc, mr);
+  auto nc = round_up(config.nc, nr);
+  auto kc = config.kc;
+  auto sa = strides_of(op_a, lda);
+  auto sb = strides_of(op_b, ldb);
+
+  auto &pool = ThreadPool::global();
+  auto threads = config.threads == 0 ? pool.concurrency() : std::min(config.threads, pool.concurrency());
+
+  auto packed_b = std::vector<f32>(std::min(kc, k) * round_up(std::min(nc, n), nr));
+  for (usize jc = {}; jc < n; jc += nc) {
+    auto cols = std::min(nc, n - jc);
+    auto slivers = (cols + nr - 1) / nr;
+    for (usize pc = {}; pc < k; pc += kc) {
+      auto depth = std::min(kc, k - pc);
+      auto b_panel = b + pc * sb.row + jc * sb.col;
+      pool.parallel_for(0, slivers, (slivers + threads - 1) / threads, [&](usize first, usize last) {
+        pack_b(b_panel, sb, depth, cols, nr, first, last, packed_b.data());
+      });
+
+      // Blocks of rows are split further into groups of slivers when there are fewer of them than threads,
+      // e.g., for short and wide products, so that every thread gets a part of the panel.
+      auto blocks = (m + mc - 1) / mc;
+      auto groups = std::min(slivers, (threads + blocks - 1) / blocks);
+      auto tasks = blocks * groups;
+      pool.parallel_for(0, tasks, (tasks + threads - 1) / threads, [&](usize first, usize last) {
+        auto packed_a = std::vector<f32>(mc * depth);
+        auto packed = blocks;
+        for (auto task = first; task < last; ++task) {
+          auto block = task / groups, group = task % groups;
+          auto ic = block * mc;
+          auto rows = std::min(mc, m - ic);
+          if (block != packed) {
+            pack_a(a + ic * sa.row + pc * sa.col, sa, rows, depth, mr, packed_a.data());
+            packed = block;
+          }
+          auto jr_first = group * slivers / groups * nr;
+          auto jr_last = std::min((group + 1) * slivers / groups * nr, cols);
+          for (auto jr = jr_first; jr < jr_last; jr += nr) {
+            auto bp = packed_b.data() + (jr / nr) * depth * nr;
+            for (usize ir = {}; ir < rows; ir += mr) {
+              auto ap = packed_a.data() + (ir / mr) * depth * mr;
+              kernel(depth, ap, bp, c + (ic + ir) * ldc + jc + jr, ldc, std::min(mr, rows - ir),
+                     std::min(nr, cols - jr));
+            }
+          }
+          if (epilogue and pc + depth == k) {
+            epilogue(ic, jc + jr_first, rows, jr_last - jr_first);
+          }
+        }
+      });
+    }
+  }
+}
+
+auto gemv(const f32 *x, const f32 *w, f32 *y, usize k, usize n, usize threads) -> void {
+  auto &pool = ThreadPool::global();
+  threads = threads == 0 ? pool.concurrency() : std::min(threads, pool.concurrency());
+  if (threads == 1 or k * n < GEMV_PARALLEL_VOLUME) {
+    vmath::gemv({x, k}, w, n, {y, n});
+    return;
+  }
+  auto blocks = (n + GEMV_COLUMN_BLOCK - 1) / GEMV_COLUMN_BLOCK;
+  pool.parallel_for(0, blocks, (blocks + threads - 1) / threads, [&](usize first, usize last) {
+    auto j = first * GEMV_COLUMN_BLOCK;
+    auto cols = std::min(last * GEMV_COLUMN_BLOCK, n) - j;
+    vmath::gemv({x, k}, w + j, n, {y + j, cols});
+  });
+}
+
+}
@@ -88,7 +88,7 @@ auto ImgProc::_s_has_channel_check(Image::Meta meta, Image::Channel channel) ->
 // /////////////////////////////////////////////
 
 template <>
-auto ImgProc::invert(Tensor<u8> &img) noexcept -> Tensor<u8> & {
+auto ImgProc::invert(Tensor<u8> &img) -> Tensor<u8> & {
   const auto MAX_VALUE = _detail::limits<u8>::max();
   const auto CHANNEL_SIZE = MAX_VALUE + 1;
 
@@ -109,14 +109,14 @@ auto ImgProc::invert(Tensor<u8> &img) noexcept -> Tensor<u8> & {
 }
 
 template <>
-auto ImgProc::invert(Tensor<f32> &img) noexcept -> Tensor<f32> & {
+auto ImgProc::invert(Tensor<f32> &img) -> Tensor<f32> & {
   return img |= [](auto value) {
     return _detail::limits<f32>::max() - value;
   };
 }
 
 template <>
-auto ImgProc::binarize(Tensor<u8> &img) noexcept -> Tensor<u8> & {
+auto ImgProc::binarize(Tensor<u8> &img) -> Tensor<u8> & {
   // Algorithm: Otsu's Method
   // Otsu's thresholding method involves iterating through all the possible thresholds and calculating a
   // measure of spread for the pixel intensities in the foreground and background. The aim is to find a
@@ -205,7 +205,7 @@ auto ImgProc::binarize(Tensor<u8> &img) noexcept -> Tensor<u8> & {
 }
 
 template <>
-auto ImgProc::binarize(Tensor<f32> &img) noexcept -> Tensor<f32> & {
+auto ImgProc::binarize(Tensor<f32> &img) -> Tensor<f32> & {
   const auto MAX_VALUE = _detail::limits<f32>::max(), MIN_VALUE = _detail::limits<f32>::min();
   const auto PIVOT = MAX_VALUE / 2;
   return img |= [MAX_VALUE, MIN_VALUE, PIVOT](auto value) {
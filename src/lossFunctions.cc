@@ -17,7 +17,11 @@
 
 #include "cbrainx/lossFunctions.hh"
 
+#include <numeric>
+#include <vector>
+
 #include "cbrainx/exceptions.hh"
+#include "cbrainx/vmath.hh"
 
 namespace cbx {
 
@@ -93,6 +97,10 @@ auto LossFuncWrapper::derivative(const tensor_type &y_true, const tensor_type &y
   return func_->derivative(y_true, y_pred);
 }
 
+auto LossFuncWrapper::gradient(const tensor_type &y_true, const tensor_type &y_pred) const -> tensor_type {
+  return func_->gradient(y_true, y_pred);
+}
+
 // /////////////////////////////////////////////
 // Interface
 // /////////////////////////////////////////////
@@ -163,6 +171,22 @@ auto MeanSquaredError::derivative(const tensor_type &y_true, const tensor_type &
   return gradient / y_true.total();
 }
 
+auto MeanSquaredError::gradient(const tensor_type &y_true, const tensor_type &y_pred) const -> tensor_type {
+  // This function implements the subsequent operation.
+  //
+  // Gradient: ẟĹ / ẟÝὶ = 2 . (Ýὶ - Yὶ) / n
+
+  _s_check_rank_range(y_true.rank(), tensor_type::SCALAR_RANK, tensor_type::MATRIX_RANK);
+  _s_check_shape_equality(y_true.shape(), y_pred.shape());
+
+  auto scale = value_type{2} / y_true.total();
+  auto gradient = y_pred;
+  for (usize i = {}; i < gradient.total(); ++i) {
+    gradient[i] = scale * (y_pred[i] - y_true[i]);
+  }
+  return gradient;
+}
+
 // /////////////////////////////////////////////
 
 auto BinaryCrossEntropy::type() const -> Loss { return Loss::BinaryCrossEntropy; }
@@ -191,16 +215,22 @@ auto BinaryCrossEntropy::operator()(const tensor_type &y_true, const tensor_type
 
   const auto EPSILON = std::numeric_limits<value_type>::epsilon();
 
-  auto y_true_begin = y_true.begin(), y_true_end = y_true.end();
-  auto y_pred_begin = y_pred.begin();
+  auto total = y_true.total();
+
+  // Gather the clamped probabilities and their complements so that all logarithms are evaluated in one go.
+  auto logs = std::vector<value_type>(2 * total);
+  for (usize i = {}; i < total; ++i) {
+    auto pred = std::clamp(y_pred[i], EPSILON, 1 - EPSILON);
+    logs[i] = pred, logs[total + i] = 1 - pred;
+  }
+  vmath::log(logs);
 
   value_type total_logarithmic_loss = {};
-  while (y_true_begin != y_true_end) {
-    auto truth = *y_true_begin, pred = std::clamp(*y_pred_begin, EPSILON, 1 - EPSILON);
-    total_logarithmic_loss -= truth * std::log(pred) + (1 - truth) * std::log(1 - pred);
-    ++y_true_begin, ++y_pred_begin;
+  for (usize i = {}; i < total; ++i) {
+    auto truth = y_true[i];
+    total_logarithmic_loss -= truth * logs[i] + (1 - truth) * logs[total + i];
   }
-  return total_logarithmic_loss / y_true.total();
+  return total_logarithmic_loss / total;
 }
 
 auto BinaryCrossEntropy::derivative(const tensor_type &y_true, const tensor_type &y_pred) const -> value_type {
@@ -235,6 +265,25 @@ auto BinaryCrossEntropy::derivative(const tensor_type &y_true, const tensor_type
   return gradient / y_true.total();
 }
 
+auto BinaryCrossEntropy::gradient(const tensor_type &y_true, const tensor_type &y_pred) const -> tensor_type {
+  // This function implements the subsequent operation.
+  //
+  // Gradient: ẟĹ / ẟÝὶ = -1 / n . [Yὶ / Ýὶ - (1 - Yὶ) / (1 - Ýὶ)]
+
+  _s_check_rank_range(y_true.rank(), tensor_type::SCALAR_RANK, tensor_type::MATRIX_RANK);
+  _s_check_shape_equality(y_true.shape(), y_pred.shape());
+
+  const auto EPSILON = std::numeric_limits<value_type>::epsilon();
+
+  auto scale = value_type{1} / y_true.total();
+  auto gradient = y_pred;
+  for (usize i = {}; i < gradient.total(); ++i) {
+    auto truth = y_true[i], pred = std::clamp(y_pred[i], EPSILON, 1 - EPSILON);
+    gradient[i] = -scale * (truth / pred - (1 - truth) / (1 - pred));
+  }
+  return gradient;
+}
+
 // /////////////////////////////////////////////
 
 auto CategoricalCrossEntropy::type() const -> Loss { return Loss::CategoricalCrossEntropy; }
@@ -267,14 +316,17 @@ auto CategoricalCrossEntropy::operator()(const tensor_type &y_true, const tensor
 
   auto [samples] = y_true.is_matrix() ? y_true.shape().unwrap<1>() : Shape::SCALAR_SIZE;
 
-  value_type total_logarithmic_loss = {};
+  // Gather the probabilities of the positive classes so that their logarithms are evaluated in one go.
+  auto logs = std::vector<value_type>{};
+  logs.reserve(samples);
   for (usize i = {}; i < y_true.total(); ++i) {
-    auto truth = y_true[i], pred = std::clamp(y_pred[i], EPSILON, 1 - EPSILON);
-    if (truth == EYE) {
-      total_logarithmic_loss -= std::log(pred);
+    if (y_true[i] == EYE) {
+      logs.push_back(std::clamp(y_pred[i], EPSILON, 1 - EPSILON));
     }
   }
+  vmath::log(logs);
 
+  auto total_logarithmic_loss = -std::accumulate(logs.begin(), logs.end(), value_type{});
   return total_logarithmic_loss / samples;
 }
 
@@ -313,8 +365,44 @@ auto CategoricalCrossEntropy::derivative(const tensor_type &y_true, const tensor
   return gradient / samples;
 }
 
+auto CategoricalCrossEntropy::gradient(const tensor_type &y_true, const tensor_type &y_pred) const
+    -> tensor_type {
+  // This function implements the subsequent operation.
+  //
+  // Gradient: ẟĹ / ẟÝὶ = -Yὶ / (m . Ýὶ)
+  //
+  // where m is the number of samples, i.e., only the positive classes receive a gradient.
+
+  _s_check_rank_range(y_true.rank(), tensor_type::VECTOR_RANK, tensor_type::MATRIX_RANK);
+  _s_check_shape_equality(y_pred.shape(), y_true.shape());
+
+  const auto EPSILON = std::numeric_limits<value_type>::epsilon();
+
+  auto samples = y_true.is_matrix() ? y_true.shape().at(0) : Shape::SCALAR_SIZE;
+
+  auto gradient = y_pred;
+  for (usize i = {}; i < gradient.total(); ++i) {
+    auto truth = y_true[i], pred = std::clamp(y_pred[i], EPSILON, 1 - EPSILON);
+    gradient[i] = -truth / (pred * samples);
+  }
+  return gradient;
+}
+
 // /////////////////////////////////////////////
 
+auto SparseCrossEntropy::_s_positive_probabilities(const tensor_type &y_true, const tensor_type &y_pred)
+    -> tensor_type {
+  const auto EPSILON = std::numeric_limits<value_type>::epsilon();
+
+  // Append a unit axis to the observations so that they index the class axis of the predictions.
+  auto class_axis = y_pred.rank() - 1;
+  auto indices = y_true;
+  indices.reshape(y_pred.rank());
+  auto probabilities = y_pred.gather(class_axis, indices);
+  probabilities.transform([EPSILON](auto pred) { return std::clamp(pred, EPSILON, 1 - EPSILON); });
+  return probabilities;
+}
+
 auto SparseCrossEntropy::type() const -> Loss { return Loss::SparseCrossEntropy; }
 
 auto SparseCrossEntropy::to_string() const -> std::string { return "Sparse Cross Entropy"; }
@@ -342,16 +430,11 @@ auto SparseCrossEntropy::operator()(const tensor_type &y_true, const tensor_type
   _s_check_rank_range(y_pred.rank(), tensor_type::VECTOR_RANK, tensor_type::MATRIX_RANK);
   _s_check_shape_equality(y_true.shape(), y_pred.shape().slice(0, y_pred.rank() - 1));
 
-  const auto EPSILON = std::numeric_limits<value_type>::epsilon();
+  // Gather the probabilities of the positive classes so that their logarithms are evaluated in one go.
+  auto logs = _s_positive_probabilities(y_true, y_pred);
+  vmath::log(logs);
 
-  auto samples = y_pred.is_matrix() ? y_pred.shape().at(1) : Shape::SCALAR_SIZE;
-  value_type total_logarithmic_loss = {};
-  for (usize i = {}; i < y_true.total(); ++i) {
-    auto truth = y_true[i];
-    usize j = i * samples + truth;
-    auto pred = std::clamp(y_pred[j], EPSILON, 1 - EPSILON);
-    total_logarithmic_loss -= std::log(pred);
-  }
+  auto total_logarithmic_loss = -std::accumulate(logs.begin(), logs.end(), value_type{});
   return total_logarithmic_loss / y_true.total();
 }
 
@@ -376,17 +459,32 @@ auto SparseCrossEntropy::derivative(const tensor_type &y_true, const tensor_type
   _s_check_rank_range(y_pred.rank(), tensor_type::VECTOR_RANK, tensor_type::MATRIX_RANK);
   _s_check_shape_equality(y_true.shape(), y_pred.shape().slice(0, y_pred.rank() - 1));
 
-  const auto EPSILON = std::numeric_limits<value_type>::epsilon();
-
-  auto samples = y_pred.is_matrix() ? y_pred.shape().at(1) : Shape::SCALAR_SIZE;
   value_type gradient = {};
-  for (usize i = {}; i < y_true.total(); ++i) {
-    auto truth = y_true[i];
-    usize j = i * samples + truth;
-    auto pred = std::clamp(y_pred[j], EPSILON, 1 - EPSILON);
+  for (auto pred : _s_positive_probabilities(y_true, y_pred)) {
     gradient -= 1 / pred;
   }
   return gradient / y_true.total();
 }
 
+auto SparseCrossEntropy::gradient(const tensor_type &y_true, const tensor_type &y_pred) const -> tensor_type {
+  // This function implements the subsequent operation.
+  //
+  // Gradient: ẟĹ / ẟÝὶ = -1 / (m . Ý०) if ὶ = ὶ०, and 0 otherwise
+  //
+  // where m is the number of samples.
+
+  _s_check_rank_range(y_pred.rank(), tensor_type::VECTOR_RANK, tensor_type::MATRIX_RANK);
+  _s_check_shape_equality(y_true.shape(), y_pred.shape().slice(0, y_pred.rank() - 1));
+
+  auto classes = y_pred.shape().back();
+  auto samples = y_true.total();
+  auto probabilities = _s_positive_probabilities(y_true, y_pred);
+
+  auto gradient = y_pred.zeros_like();
+  for (usize i = {}; i < samples; ++i) {
+    gradient[i * classes + usize(y_true[i])] = -1 / (probabilities[i] * samples);
+  }
+  return gradient;
+}
+
 }
@@ -17,13 +17,157 @@
 
 #include "cbrainx/neuralNet.hh"
 
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <bit>
+#include <chrono>
+#include <fstream>
+#include <iterator>
+#include <new>
+#include <numeric>
+#include <optional>
+#include <sstream>
+#include <string_view>
 #include <utility>
 
 #include <fmt/color.h>
 #include <fmt/core.h>
 
+#if defined(__unix__)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#include "cbrainx/activationLayer.hh"
+#include "cbrainx/batchNormLayer.hh"
+#include "cbrainx/conv2DLayer.hh"
+#include "cbrainx/denseLayer.hh"
+#include "cbrainx/exceptions.hh"
+#include "cbrainx/numa.hh"
+#include "cbrainx/pooling.hh"
+#include "cbrainx/softmax.hh"
+#include "cbrainx/threadPool.hh"
+
 namespace cbx {
 
+// /////////////////////////////////////////////
+// Implementation Detail
+// /////////////////////////////////////////////
+
+namespace {
+
+/// \brief The minimum number of parameters per block when reducing or broadcasting replicas.
+constexpr usize REPLICA_CHUNK_SIZE = 1 << 14;
+
+/// \brief The first word of a model file.
+constexpr str MODEL_MAGIC = "cbrainx-model";
+
+/// \brief The version of the model file format.
+constexpr usize MODEL_VERSION = 1;
+
+/// \brief The line that terminates the header of a model file.
+constexpr std::string_view MODEL_HEADER_END = "\nend\n";
+
+/// \brief Returns the byte order of the machine as written to model files.
+auto native_byte_order() -> std::string {
+  return std::endian::native == std::endian::little ? "little" : "big";
+}
+
+/// \brief Rounds a size in bytes up to the alignment of model files.
+auto align_model(usize bytes) -> usize {
+  return (bytes + MODEL_ALIGNMENT - 1) / MODEL_ALIGNMENT * MODEL_ALIGNMENT;
+}
+
+/// \brief Returns the activation function of the given name.
+auto parse_activation(const std::string &name) -> std::optional<Activation> {
+  for (auto i = i32{}; i <= i32(Activation::TanH); ++i) {
+    if (ActFuncWrapper{Activation(i)}.type_name() == name) {
+      return Activation(i);
+    }
+  }
+  return std::nullopt;
+}
+
+/// \brief The contents of a file in memory, kept alive by a shared owner.
+struct FileContents {
+  std::shared_ptr<const void> owner;
+  std::byte *data;
+  usize size;
+};
+
+/// \brief Maps a file privately into memory where supported, otherwise reads it into an aligned buffer.
+auto read_file(const std::string &path) -> FileContents {
+#if defined(__unix__)
+  auto fd = ::open(path.c_str(), O_RDONLY);
+  struct stat info = {};
+  if (fd < 0 or ::fstat(fd, &info) != 0 or info.st_size == 0) {
+    if (fd >= 0) {
+      ::close(fd);
+    }
+    throw ModelIOError{"cbx::NeuralNet::load: could not read model [path = {}]", path};
+  }
+  auto size = usize(info.st_size);
+  // A private writable mapping lets the parameters be trained in place without ever writing to the file.
+  auto address = ::mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+  ::close(fd);
+  if (address == MAP_FAILED) {
+    throw ModelIOError{"cbx::NeuralNet::load: could not map model [path = {}]", path};
+  }
+  auto owner =
+      std::shared_ptr<const void>{address, [size](const void *p) { ::munmap(const_cast<void *>(p), size); }};
+  return {std::move(owner), static_cast<std::byte *>(address), size};
+#else
+  auto file = std::ifstream{path, std::ios::binary | std::ios::ate};
+  if (not file) {
+    throw ModelIOError{"cbx::NeuralNet::load: could not read model [path = {}]", path};
+  }
+  auto size = usize(file.tellg());
+  auto data = static_cast<std::byte *>(::operator new(size, std::align_val_t{MODEL_ALIGNMENT}));
+  auto owner = std::shared_ptr<const void>{
+      data, [](const void *p) { ::operator delete(const_cast<void *>(p), std::align_val_t{MODEL_ALIGNMENT}); }};
+  file.seekg(0);
+  if (not file.read(reinterpret_cast<char *>(data), std::streamsize(size))) {
+    throw ModelIOError{"cbx::NeuralNet::load: could not read model [path = {}]", path};
+  }
+  return {std::move(owner), data, size};
+#endif
+}
+
+/// \brief Prepends the samples axis to the shape of one sample.
+auto with_samples(usize samples, const Shape &shape) -> Shape {
+  auto axes = std::vector<usize>{samples};
+  axes.insert(axes.end(), shape.begin(), shape.end());
+  return Shape{axes.begin(), axes.end()};
+}
+
+/// \brief Copies the samples [first, last) along the first axis of a tensor.
+auto slice_samples(const Tensor<f32> &tensor, usize first, usize last) -> Tensor<f32> {
+  auto shape = tensor.shape();
+  auto stride = tensor.total() / shape.front();
+  shape.set_axis(0, last - first);
+  return Tensor<f32>{shape, tensor.begin() + first * stride};
+}
+
+/// \brief Visits the range [first, last) of the parameters laid out end to end.
+///
+/// \details
+/// The callback receives the index of a parameter, the offset within it, and the length of the segment.
+template <typename F>
+auto for_each_segment(const std::vector<usize> &offsets, usize first, usize last, F &&visit) -> void {
+  auto index = usize(std::upper_bound(offsets.begin(), offsets.end(), first) - offsets.begin()) - 1;
+  while (first < last) {
+    auto end = std::min(last, offsets[index + 1]);
+    visit(index, first - offsets[index], end - first);
+    first = end;
+    ++index;
+  }
+}
+
+}
+
 // /////////////////////////////////////////////
 // Helpers
 // /////////////////////////////////////////////
@@ -37,7 +181,7 @@ auto NeuralNet::_s_validate_input_shape(const Shape &shape) -> void {
   }
 }
 
-auto NeuralNet::_m_match_input_shape(const Shape &shape) -> void {
+auto NeuralNet::_m_match_input_shape(const Shape &shape) const -> void {
   auto sliced_shape = shape.slice(1);
   if (input_shape_ != sliced_shape) {
     throw ShapeError{"cbx::NeuralNet::_m_match_input_shape: shapes mismatch [expected = {}, received = {}]",
@@ -45,6 +189,66 @@ auto NeuralNet::_m_match_input_shape(const Shape &shape) -> void {
   }
 }
 
+auto NeuralNet::_m_check_training_set(const tensor_type &x, const tensor_type &y, size_type batch_size)
+    -> void {
+  _m_match_input_shape(x.shape());
+  if (x.shape().front() == 0) {
+    throw ShapeError{"cbx::NeuralNet::_m_check_training_set: x = {} must hold at least one sample",
+                     x.shape().to_string()};
+  }
+  if (y.rank() == 0 or y.shape().front() != x.shape().front()) {
+    throw ShapeError{"cbx::NeuralNet::_m_check_training_set: y = {} must hold as many samples as x = {}",
+                     y.shape().to_string(), x.shape().to_string()};
+  }
+  if (batch_size == 0) {
+    throw ValueError{"cbx::NeuralNet::_m_check_training_set: batch_size must be positive"};
+  }
+}
+
+auto NeuralNet::_m_apply_shard_policy(AbstractLayer &layer) const -> void {
+  if (layer.type() != LayerType::Dense) {
+    return;
+  }
+  auto shards = size_type{1};
+  if (shard_threshold_ != 0 and layer.parameters() >= shard_threshold_) {
+    auto widest = std::max(layer.neurons() / DENSE_SHARD_MIN_NEURONS, size_type{1});
+    shards = std::min(ThreadPool::global().concurrency(), widest);
+  }
+  auto &dense = static_cast<DenseLayer &>(layer);
+  if (dense.shards() != shards) {
+    dense.set_shards(shards);
+  }
+}
+
+auto NeuralNet::_m_merge_running_statistics(const std::vector<NeuralNet *> &replicas,
+                                             const std::vector<f32> &weights) -> void {
+  auto index = size_type{};
+  for (const auto &layer : layers_) {
+    if (layer->type() == LayerType::BatchNorm) {
+      auto &target = static_cast<BatchNormLayer &>(*layer);
+      auto layer_of = [index](NeuralNet *replica) -> BatchNormLayer & {
+        return static_cast<BatchNormLayer &>(**std::next(replica->layers_.begin(), isize(index)));
+      };
+      auto mean = target.running_mean().zeros_like(), variance = target.running_variance().zeros_like();
+      for (size_type r = {}; r < replicas.size(); ++r) {
+        if (weights[r] != 0) {
+          const auto &source = layer_of(replicas[r]);
+          for (size_type j = {}; j < mean.total(); ++j) {
+            mean[j] += weights[r] * source.running_mean()[j];
+            variance[j] += weights[r] * source.running_variance()[j];
+          }
+        }
+      }
+      // The network may be one of the replicas, so the averages are only written once they are complete.
+      target.set_running_statistics(mean, variance);
+      for (auto *replica : replicas) {
+        layer_of(replica).set_running_statistics(mean, variance);
+      }
+    }
+    ++index;
+  }
+}
+
 // /////////////////////////////////////////////
 // Constructors (and Destructors)
 // /////////////////////////////////////////////
@@ -55,7 +259,10 @@ NeuralNet::NeuralNet(const Shape &input_shape) {
 }
 
 NeuralNet::NeuralNet(NeuralNet &&other) noexcept
-    : input_shape_{std::move(other.input_shape_)}, layers_{std::move(other.layers_)} {}
+    : input_shape_{std::move(other.input_shape_)},
+      layers_{std::move(other.layers_)},
+      context_{std::move(other.context_)},
+      shard_threshold_{other.shard_threshold_} {}
 
 // /////////////////////////////////////////////
 // Assignment Operators
@@ -64,6 +271,8 @@ NeuralNet::NeuralNet(NeuralNet &&other) noexcept
 auto NeuralNet::operator=(NeuralNet &&other) noexcept -> NeuralNet & {
   input_shape_ = std::move(other.input_shape_);
   layers_ = std::move(other.layers_);
+  context_ = std::move(other.context_);
+  shard_threshold_ = other.shard_threshold_;
   return *this;
 }
 
@@ -107,6 +316,20 @@ auto NeuralNet::rend() const noexcept -> const_reverse_iterator { return layers_
 
 auto NeuralNet::rend() noexcept -> reverse_iterator { return layers_.rend(); }
 
+// /////////////////////////////////////////////
+// Accessors and Mutators
+// /////////////////////////////////////////////
+
+auto NeuralNet::shard_threshold() const -> size_type { return shard_threshold_; }
+
+auto NeuralNet::set_shard_threshold(size_type parameters) -> NeuralNet & {
+  shard_threshold_ = parameters;
+  for (const auto &layer : layers_) {
+    _m_apply_shard_policy(*layer);
+  }
+  return *this;
+}
+
 // /////////////////////////////////////////////
 // Query Functions
 // /////////////////////////////////////////////
@@ -119,6 +342,16 @@ auto NeuralNet::total_parameters() const -> size_type {
   });
 }
 
+auto NeuralNet::input_shape() const -> const Shape & { return input_shape_; }
+
+auto NeuralNet::output_shape() const -> Shape {
+  auto shape = input_shape_;
+  for (const auto &layer : layers_) {
+    shape = layer->output_shape(shape);
+  }
+  return shape;
+}
+
 // /////////////////////////////////////////////
 // Informative
 // /////////////////////////////////////////////
@@ -175,15 +408,136 @@ auto NeuralNet::show_summary() const -> void {
   print_separator(Equal);
   print_row({"INPL0 (Input)", input_shape_.to_string(), "-"});
   print_separator(Plus);
+  auto shape = input_shape_;
   for (const auto &layer : layers_) {
-    print_row({fmt::format("{} ({})", layer->to_string(), layer->type_name()),
-               Shape{layer->neurons()}.to_string(), layer->property()});
+    shape = layer->output_shape(shape);
+    print_row({fmt::format("{} ({})", layer->to_string(), layer->type_name()), shape.to_string(),
+               layer->property()});
     print_separator(Minus);
   }
   print_attributes(attributes);
   print_separator(Equal);
 }
 
+// /////////////////////////////////////////////
+// Utility
+// /////////////////////////////////////////////
+
+auto NeuralNet::clone() const -> NeuralNet {
+  auto net = NeuralNet{input_shape_};
+  net.shard_threshold_ = shard_threshold_;
+  for (const auto &layer : layers_) {
+    net.layers_.push_back(layer->clone());
+  }
+  return net;
+}
+
+auto NeuralNet::fold() const -> NeuralNet {
+  auto net = NeuralNet{input_shape_};
+  net.shard_threshold_ = shard_threshold_;
+  for (const auto &layer : layers_) {
+    if (layer->type() == LayerType::BatchNorm and not net.layers_.empty()) {
+      if (auto folded = static_cast<const BatchNormLayer &>(*layer).fold(*net.layers_.back())) {
+        net.layers_.back() = std::move(folded);
+        continue;
+      }
+    }
+    net.layers_.push_back(layer);
+  }
+  return net;
+}
+
+auto NeuralNet::save(const std::string &path) const -> void {
+  // The blob is laid out first so that the header can record the offset of every tensor.
+  auto tensors = std::vector<const tensor_type *>{};
+  auto blob_size = usize{};
+  auto place = [&tensors, &blob_size](const tensor_type &tensor) -> usize {
+    auto offset = blob_size;
+    tensors.push_back(&tensor);
+    blob_size = align_model(offset + tensor.total() * sizeof(tensor_type::value_type));
+    return offset;
+  };
+
+  auto layers = std::string{};
+  for (const auto &layer : layers_) {
+    switch (layer->type()) {
+      case LayerType::Dense: {
+        const auto &dense = static_cast<const DenseLayer &>(*layer);
+        auto [inputs, neurons] = dense.weights().shape().unwrap<2>();
+        auto weights = place(dense.weights());
+        auto biases = place(dense.biases());
+        layers += fmt::format("dense {} {} {} {}\n", inputs, neurons, weights, biases);
+        break;
+      }
+      case LayerType::Activation: {
+        const auto &activation = static_cast<const ActivationLayer &>(*layer);
+        layers += fmt::format("activation {}\n", activation.function().type_name());
+        break;
+      }
+      case LayerType::Softmax: {
+        layers += fmt::format("softmax {}\n", layer->neurons());
+        break;
+      }
+      case LayerType::Conv2D: {
+        const auto &conv = static_cast<const Conv2DLayer &>(*layer);
+        auto [kernel_height, kernel_width, channels, filters] = conv.kernel().shape().unwrap<4>();
+        const auto &params = conv.params();
+        auto kernel = place(conv.kernel());
+        auto biases = place(conv.biases());
+        layers += fmt::format("conv2d {} {} {} {} {} {} {} {} {} {} {} {}\n", kernel_height, kernel_width,
+                              channels, filters, params.stride_h, params.stride_w, params.padding_h,
+                              params.padding_w, params.dilation_h, params.dilation_w, kernel, biases);
+        break;
+      }
+      case LayerType::MaxPool2D:
+      case LayerType::AvgPool2D: {
+        auto keyword = layer->type() == LayerType::MaxPool2D ? "maxpool2d" : "avgpool2d";
+        const auto &params = static_cast<const Pool2DLayer &>(*layer).params();
+        layers += fmt::format("{} {} {} {} {} {} {}\n", keyword, params.window_h, params.window_w,
+                              params.stride_h, params.stride_w, params.padding_h, params.padding_w);
+        break;
+      }
+      case LayerType::GlobalAvgPool: {
+        layers += "globalavgpool\n";
+        break;
+      }
+      case LayerType::BatchNorm: {
+        const auto &norm = static_cast<const BatchNormLayer &>(*layer);
+        auto gamma = place(norm.gamma());
+        auto beta = place(norm.beta());
+        auto mean = place(norm.running_mean());
+        auto variance = place(norm.running_variance());
+        layers += fmt::format("batchnorm {} {} {} {} {} {} {}\n", norm.gamma().total(), norm.momentum(),
+                              norm.epsilon(), gamma, beta, mean, variance);
+        break;
+      }
+      default: {
+        throw ValueError{"cbx::NeuralNet::save: layers of type {} cannot be saved", layer->type_name()};
+      }
+    }
+  }
+
+  auto header = fmt::format("{} {} {}\ninput", MODEL_MAGIC, MODEL_VERSION, native_byte_order());
+  for (auto axis : input_shape_) {
+    header += fmt::format(" {}", axis);
+  }
+  header += fmt::format("\nblob {}\n{}{}", blob_size, layers, MODEL_HEADER_END.substr(1));
+
+  auto file = std::ofstream{path, std::ios::binary | std::ios::trunc};
+  auto padding = std::vector<char>(MODEL_ALIGNMENT);
+  auto write = [&file, &padding](const void *data, usize bytes) {
+    file.write(static_cast<const char *>(data), std::streamsize(bytes));
+    file.write(padding.data(), std::streamsize(align_model(bytes) - bytes));
+  };
+  write(header.data(), header.size());
+  for (const auto *tensor : tensors) {
+    write(tensor->data(), tensor->total() * sizeof(tensor_type::value_type));
+  }
+  if (not file.flush()) {
+    throw ModelIOError{"cbx::NeuralNet::save: could not write model [path = {}]", path};
+  }
+}
+
 // /////////////////////////////////////////////
 // Modifiers
 // /////////////////////////////////////////////
@@ -203,4 +557,433 @@ auto NeuralNet::forward_pass(tensor_type input) -> tensor_type {
   return input;
 }
 
+auto NeuralNet::infer(const tensor_type &input) -> tensor_type { return infer(input, context_); }
+
+auto NeuralNet::infer(const tensor_type &input, ExecutionContext &context) const -> tensor_type {
+  _m_match_input_shape(input.shape());
+  if (layers_.empty()) {
+    return input;
+  }
+
+  auto samples = input.shape().front();
+  auto widest = std::accumulate(layers_.begin(), std::prev(layers_.end()), size_type{},
+                                [](auto acc, const auto &layer) { return std::max(acc, layer->neurons()); });
+  auto half = samples * widest;
+  auto workspace = context.workspace(2 * half);
+
+  // Every layer sees its input and output with their per-sample shapes, e.g., as images.
+  auto shapes = std::vector<Shape>{};
+  for (auto shape = input_shape_; const auto &layer : layers_) {
+    shape = layer->output_shape(shape);
+    shapes.push_back(with_samples(samples, shape));
+  }
+
+  auto output = tensor_type{shapes.back()};
+  auto source = TensorView<const f32>{input};
+  auto buffer = size_type{};
+  for (auto layer = layers_.begin(); layer != layers_.end(); ++layer) {
+    const auto &shape = shapes[usize(std::distance(layers_.begin(), layer))];
+    auto target = std::next(layer) == layers_.end() ? TensorView<f32>{output}
+                                                    : TensorView<f32>{workspace.data() + buffer * half, shape};
+    (*layer)->infer(source, target);
+    source = target;
+    buffer ^= 1;
+  }
+  return output;
+}
+
+auto NeuralNet::compile(size_type batch_size, bool fuse) const -> ExecutionPlan {
+  return ExecutionPlan{input_shape_, layers_, batch_size, fuse};
+}
+
+auto NeuralNet::predict(tensor_type input, size_type k) -> std::pair<tensor_type, Tensor<size_type>> {
+  auto output = infer(input);
+  return output.topk(k, output.rank() - 1);
+}
+
+auto NeuralNet::backward_pass(tensor_type output_gradient) -> tensor_type {
+  for (auto layer = layers_.rbegin(); layer != layers_.rend(); ++layer) {
+    // The input gradient of one layer becomes the output gradient of the previous one.
+    output_gradient = (*layer)->backward_pass(output_gradient).input_gradient();
+  }
+  return output_gradient;
+}
+
+auto NeuralNet::zero_gradients() -> void {
+  for (const auto &layer : layers_) {
+    layer->zero_gradients();
+  }
+}
+
+auto NeuralNet::trainable_parameters() -> std::vector<TrainableParameter> {
+  auto parameters = std::vector<TrainableParameter>{};
+  for (const auto &layer : layers_) {
+    auto layer_parameters = layer->trainable_parameters();
+    parameters.insert(parameters.end(), layer_parameters.begin(), layer_parameters.end());
+  }
+  return parameters;
+}
+
+auto NeuralNet::fit(const tensor_type &x, const tensor_type &y, const LossFuncWrapper &loss,
+                    Optimizer &optimizer, size_type batch_size, size_type epochs) -> std::vector<EpochReport> {
+  _m_check_training_set(x, y, batch_size);
+  auto samples = x.shape().front();
+  auto &pool = ThreadPool::global();
+  auto replica_count = std::min({pool.concurrency(), batch_size, samples});
+
+  // The network itself is the first replica; the others are deep copies whose parameters mirror it.
+  auto copies = std::vector<NeuralNet>{};
+  copies.reserve(replica_count - 1);
+  auto replicas = std::vector<NeuralNet *>{this};
+  for (size_type r = 1; r < replica_count; ++r) {
+    replicas.push_back(&copies.emplace_back(clone()));
+  }
+  auto parameters = std::vector<std::vector<TrainableParameter>>{};
+  for (auto *replica : replicas) {
+    parameters.push_back(replica->trainable_parameters());
+  }
+  auto offsets = std::vector<size_type>{0};
+  for (const auto &parameter : parameters.front()) {
+    offsets.push_back(offsets.back() + parameter.values.size());
+  }
+  auto total = offsets.back();
+
+  auto reports = std::vector<EpochReport>{};
+  reports.reserve(epochs);
+  auto losses = std::vector<f64>(replica_count);
+  auto shares = std::vector<f32>(replica_count);
+  for (size_type epoch = 1; epoch <= epochs; ++epoch) {
+    auto start = std::chrono::steady_clock::now();
+    auto epoch_loss = f64{};
+    for (size_type begin = {}; begin < samples; begin += batch_size) {
+      auto batch = std::min(batch_size, samples - begin);
+      auto active = std::min(replica_count, batch);
+      auto micro_begin = [begin, batch, active](size_type r) { return begin + r * batch / active; };
+
+      // Each replica is processed by exactly one thread.
+      pool.parallel_for(0, active, 1, [&](size_type first, size_type last) {
+        for (size_type r = first; r < last; ++r) {
+          auto micro_first = micro_begin(r), micro_last = micro_begin(r + 1);
+          auto share = f32(micro_last - micro_first) / f32(batch);
+          auto x_micro = slice_samples(x, micro_first, micro_last);
+          auto y_micro = slice_samples(y, micro_first, micro_last);
+
+          auto &replica = *replicas[r];
+          replica.zero_gradients();
+          auto y_pred = replica.forward_pass(std::move(x_micro));
+          losses[r] = f64(loss(y_micro, y_pred)) * f64(micro_last - micro_first);
+          auto gradient = loss.gradient(y_micro, y_pred);
+          gradient *= share;
+          (void)replica.backward_pass(std::move(gradient));
+        }
+      });
+      for (size_type r = {}; r < active; ++r) {
+        epoch_loss += losses[r];
+      }
+
+      // Running statistics are not parameters; those of the micro-batches are combined by their shares.
+      for (size_type r = {}; r < replica_count; ++r) {
+        shares[r] = r < active ? f32(micro_begin(r + 1) - micro_begin(r)) / f32(batch) : f32{};
+      }
+      _m_merge_running_statistics(replicas, shares);
+
+      // Each block reduces its slice of the parameters through all levels of the tree, so the levels need no
+      // barrier between them.
+      if (active > 1) {
+        pool.parallel_for(0, total, REPLICA_CHUNK_SIZE, [&](size_type first, size_type last) {
+          for_each_segment(offsets, first, last, [&](size_type index, size_type local, size_type count) {
+            for (size_type stride = 1; stride < active; stride *= 2) {
+              for (size_type r = {}; r + stride < active; r += 2 * stride) {
+                auto *sum = parameters[r][index].gradients.data() + local;
+                const auto *addend = parameters[r + stride][index].gradients.data() + local;
+                for (size_type i = {}; i < count; ++i) {
+                  sum[i] += addend[i];
+                }
+              }
+            }
+          });
+        });
+      }
+
+      optimizer.step(parameters.front());
+
+      if (replica_count > 1) {
+        pool.parallel_for(0, total, REPLICA_CHUNK_SIZE, [&](size_type first, size_type last) {
+          for_each_segment(offsets, first, last, [&](size_type index, size_type local, size_type count) {
+            const auto *source = parameters.front()[index].values.data() + local;
+            for (size_type r = 1; r < replica_count; ++r) {
+              std::copy_n(source, count, parameters[r][index].values.data() + local);
+            }
+          });
+        });
+      }
+    }
+    auto seconds = std::chrono::duration<f64>(std::chrono::steady_clock::now() - start).count();
+    auto updates = (samples + batch_size - 1) / batch_size;
+    reports.push_back({epoch, f32(epoch_loss / f64(samples)), samples, replica_count, seconds, updates});
+  }
+  return reports;
+}
+
+auto NeuralNet::fit_async(const tensor_type &x, const tensor_type &y, const LossFuncWrapper &loss,
+                          f32 learning_rate, size_type batch_size, size_type epochs)
+    -> std::vector<EpochReport> {
+  _m_check_training_set(x, y, batch_size);
+  if (not(learning_rate > 0)) {
+    throw ValueError{"cbx::NeuralNet::fit_async: learning_rate = {} must be positive", learning_rate};
+  }
+  auto samples = x.shape().front();
+  auto batches = (samples + batch_size - 1) / batch_size;
+
+  auto &pool = ThreadPool::global();
+  auto worker_count = std::min(pool.concurrency(), batches);
+
+  // The parameters of the network are the shared state; each worker computes gradients on a private replica.
+  auto replicas = std::vector<NeuralNet>{};
+  replicas.reserve(worker_count);
+  for (size_type w = {}; w < worker_count; ++w) {
+    replicas.push_back(clone());
+  }
+  auto shared = trainable_parameters();
+  auto replica_pointers = std::vector<NeuralNet *>{};
+  for (auto &replica : replicas) {
+    replica_pointers.push_back(&replica);
+  }
+  auto replica_weights = std::vector<f32>(worker_count, 1 / f32(worker_count));
+
+  struct WorkerStats {
+    f64 loss = {};
+    f64 staleness = {};
+    size_type max_staleness = {};
+    size_type updates = {};
+  };
+
+  auto reports = std::vector<EpochReport>{};
+  reports.reserve(epochs);
+  auto stats = std::vector<WorkerStats>(worker_count);
+  for (size_type epoch = 1; epoch <= epochs; ++epoch) {
+    auto start = std::chrono::steady_clock::now();
+    auto next_batch = std::atomic<size_type>{};
+    auto version = std::atomic<size_type>{};
+    std::fill(stats.begin(), stats.end(), WorkerStats{});
+
+    pool.parallel_for(0, worker_count, 1, [&](size_type first, size_type last) {
+      for (size_type w = first; w < last; ++w) {
+        auto &replica = replicas[w];
+        auto local = replica.trainable_parameters();
+        auto &stat = stats[w];
+        for (auto batch = next_batch.fetch_add(1); batch < batches; batch = next_batch.fetch_add(1)) {
+          auto begin = batch * batch_size, end = std::min(begin + batch_size, samples);
+
+          auto snapshot = version.load(std::memory_order_relaxed);
+          for (size_type p = {}; p < shared.size(); ++p) {
+            auto source = shared[p].values, target = local[p].values;
+            for (size_type i = {}; i < source.size(); ++i) {
+              target[i] = std::atomic_ref{source[i]}.load(std::memory_order_relaxed);
+            }
+          }
+
+          auto x_batch = slice_samples(x, begin, end);
+          auto y_batch = slice_samples(y, begin, end);
+          replica.zero_gradients();
+          auto y_pred = replica.forward_pass(std::move(x_batch));
+          stat.loss += f64(loss(y_batch, y_pred)) * f64(end - begin);
+          (void)replica.backward_pass(loss.gradient(y_batch, y_pred));
+
+          // A racing update of the same element may be lost; the algorithm tolerates that by design.
+          for (size_type p = {}; p < shared.size(); ++p) {
+            auto target = shared[p].values;
+            auto gradients = local[p].gradients;
+            for (size_type i = {}; i < target.size(); ++i) {
+              if (gradients[i] != 0) {
+                auto value = std::atomic_ref{target[i]};
+                value.store(value.load(std::memory_order_relaxed) - learning_rate * gradients[i],
+                            std::memory_order_relaxed);
+              }
+            }
+          }
+
+          auto staleness = version.fetch_add(1, std::memory_order_relaxed) - snapshot;
+          stat.staleness += f64(staleness);
+          stat.max_staleness = std::max(stat.max_staleness, staleness);
+          ++stat.updates;
+        }
+      }
+    });
+
+    _m_merge_running_statistics(replica_pointers, replica_weights);
+
+    auto report = EpochReport{epoch, {}, samples, worker_count};
+    auto epoch_loss = f64{}, total_staleness = f64{};
+    for (const auto &stat : stats) {
+      epoch_loss += stat.loss;
+      total_staleness += stat.staleness;
+      report.updates += stat.updates;
+      report.max_staleness = std::max(report.max_staleness, stat.max_staleness);
+    }
+    report.loss = f32(epoch_loss / f64(samples));
+    report.mean_staleness = total_staleness / f64(report.updates);
+    report.seconds = std::chrono::duration<f64>(std::chrono::steady_clock::now() - start).count();
+    reports.push_back(report);
+  }
+  return reports;
+}
+
+// /////////////////////////////////////////////////////////////
+// Static Functions
+// /////////////////////////////////////////////////////////////
+
+auto NeuralNet::load(const std::string &path) -> NeuralNet {
+  auto file = read_file(path);
+  auto invalid = [&path](const std::string &reason) {
+    return ModelIOError{"cbx::NeuralNet::load: invalid model [path = {}]: {}", path, reason};
+  };
+
+  auto text = std::string_view{reinterpret_cast<const char *>(file.data), file.size};
+  auto header_end = text.find(MODEL_HEADER_END);
+  if (header_end == std::string_view::npos) {
+    throw invalid("the header is not terminated");
+  }
+  auto header = std::istringstream{std::string{text.substr(0, header_end + 1)}};
+  auto blob_offset = align_model(header_end + MODEL_HEADER_END.size());
+  auto line = std::string{};
+  auto next_line = [&header, &line]() -> std::istringstream {
+    return std::istringstream{std::getline(header, line) ? line : std::string{}};
+  };
+
+  auto magic = std::string{}, byte_order = std::string{};
+  auto version = usize{};
+  if (not(next_line() >> magic >> version >> byte_order) or magic != MODEL_MAGIC) {
+    throw invalid("the signature is missing");
+  }
+  if (version != MODEL_VERSION or byte_order != native_byte_order()) {
+    throw invalid(fmt::format("version {} with {} byte order is not supported", version, byte_order));
+  }
+
+  auto axes = std::vector<usize>{};
+  auto words = next_line();
+  auto keyword = std::string{};
+  words >> keyword;
+  for (auto axis = usize{}; words >> axis;) {
+    axes.push_back(axis);
+  }
+  auto blob_size = usize{};
+  if (keyword != "input" or axes.empty() or not(next_line() >> keyword >> blob_size) or keyword != "blob") {
+    throw invalid("the input shape or the size of the blob is missing");
+  }
+  // Sizes are compared rather than pointers, since a forged size could make their sum wrap around.
+  if (blob_offset > file.size or blob_size > file.size - blob_offset) {
+    throw invalid(fmt::format("the blob of {} bytes is truncated", blob_size));
+  }
+  auto blob = file.data + blob_offset;
+
+  auto net = NeuralNet{Shape{axes}};
+  // Sharding would copy the weights out of the mapping, so it is left to the caller to opt into.
+  net.shard_threshold_ = 0;
+  // A tensor adopts its part of the blob through an allocator bound to it, which also keeps the file alive.
+  auto adopt = [&](usize offset, const Shape &shape) -> tensor_type {
+    auto elements = shape.total();
+    if (offset % MODEL_ALIGNMENT != 0 or offset > blob_size or
+        elements > (blob_size - offset) / sizeof(tensor_type::value_type)) {
+      throw invalid(fmt::format("a tensor at offset {} lies outside the blob", offset));
+    }
+    auto data = reinterpret_cast<tensor_type::value_type *>(blob + offset);
+    return tensor_type{shape, FirstTouchAllocator<tensor_type::value_type>{file.owner, data, elements}};
+  };
+  while (true) {
+    auto fields = next_line();
+    if (not(fields >> keyword)) {
+      break;
+    }
+    auto shape = net.output_shape();
+    auto inputs = shape.total();
+    if (keyword == "dense") {
+      auto layer_inputs = usize{}, neurons = usize{}, weights = usize{}, biases = usize{};
+      if (not(fields >> layer_inputs >> neurons >> weights >> biases) or layer_inputs != inputs) {
+        throw invalid(fmt::format("'{}' does not describe a dense layer of {} inputs", line, inputs));
+      }
+      net.layers_.push_back(std::make_shared<DenseLayer>(inputs, adopt(weights, {inputs, neurons}),
+                                                         adopt(biases, {neurons})));
+      net.layers_.back()->set_id(i32(net.layers_.size()));
+    } else if (keyword == "activation") {
+      auto name = std::string{};
+      auto activation = fields >> name ? parse_activation(name) : std::nullopt;
+      if (not activation) {
+        throw invalid(fmt::format("'{}' does not name an activation function", line));
+      }
+      net.add<ActivationLayer>(*activation);
+    } else if (keyword == "softmax") {
+      auto neurons = usize{};
+      if (not(fields >> neurons) or neurons != inputs) {
+        throw invalid(fmt::format("'{}' does not describe a softmax of {} inputs", line, inputs));
+      }
+      net.add<Softmax>();
+    } else if (keyword == "conv2d") {
+      auto dims = std::array<usize, 4>{};
+      auto params = Conv2DParams{};
+      auto kernel = usize{}, biases = usize{};
+      fields >> dims[0] >> dims[1] >> dims[2] >> dims[3];
+      fields >> params.stride_h >> params.stride_w >> params.padding_h >> params.padding_w;
+      auto is_parsed = static_cast<bool>(fields >> params.dilation_h >> params.dilation_w >> kernel >> biases);
+      if (not is_parsed) {
+        throw invalid(fmt::format("'{}' does not describe a convolution", line));
+      }
+      auto kernel_shape = Shape{dims.begin(), dims.end()};
+      try {
+        net.layers_.push_back(std::make_shared<Conv2DLayer>(shape, adopt(kernel, kernel_shape),
+                                                            adopt(biases, {dims[3]}), params));
+      } catch (const ModelIOError &) {
+        throw;
+      } catch (const std::exception &error) {
+        throw invalid(fmt::format("'{}' does not describe a convolution of {}: {}", line, shape.to_string(),
+                                  error.what()));
+      }
+      net.layers_.back()->set_id(i32(net.layers_.size()));
+    } else if (keyword == "maxpool2d" or keyword == "avgpool2d" or keyword == "globalavgpool") {
+      auto params = Pool2DParams{};
+      if (keyword != "globalavgpool") {
+        fields >> params.window_h >> params.window_w >> params.stride_h >> params.stride_w;
+        if (not(fields >> params.padding_h >> params.padding_w)) {
+          throw invalid(fmt::format("'{}' does not describe a pooling", line));
+        }
+      }
+      try {
+        if (keyword == "maxpool2d") {
+          net.add<MaxPool2D>(params);
+        } else if (keyword == "avgpool2d") {
+          net.add<AvgPool2D>(params);
+        } else {
+          net.add<GlobalAvgPool>();
+        }
+      } catch (const std::exception &error) {
+        throw invalid(fmt::format("'{}' does not describe a pooling of {}: {}", line, shape.to_string(),
+                                  error.what()));
+      }
+    } else if (keyword == "batchnorm") {
+      auto features = usize{}, gamma = usize{}, beta = usize{}, mean = usize{}, variance = usize{};
+      auto momentum = f32{}, epsilon = f32{};
+      fields >> features >> momentum >> epsilon;
+      auto is_parsed = static_cast<bool>(fields >> gamma >> beta >> mean >> variance);
+      if (not is_parsed or shape.back() != features) {
+        throw invalid(
+            fmt::format("'{}' does not describe a batch normalization of {}", line, shape.to_string()));
+      }
+      try {
+        net.layers_.push_back(std::make_shared<BatchNormLayer>(shape, adopt(gamma, {features}),
+                                                               adopt(beta, {features}), adopt(mean, {features}),
+                                                               adopt(variance, {features}), momentum, epsilon));
+      } catch (const ModelIOError &) {
+        throw;
+      } catch (const std::exception &error) {
+        throw invalid(fmt::format("'{}' does not describe a batch normalization of {}: {}", line,
+                                  shape.to_string(), error.what()));
+      }
+      net.layers_.back()->set_id(i32(net.layers_.size()));
+    } else {
+      throw invalid(fmt::format("'{}' does not describe a layer", line));
+    }
+  }
+  return net;
+}
+
 }
@@ -0,0 +1,225 @@
+// Copyright 2021 CBrainX
+// Project URL: https://github.com/mansoormemon/cbrainx
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Copyright (c) 2021 Mansoor Ahmed Memon <mansoorahmed.one@gmail.com>
+#include "cbrainx/numa.hh"
+
+#include <algorithm>
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include <thread>
+
+#include <fmt/format.h>
+
+#include "cbrainx/exceptions.hh"
+
+#if defined(__linux__)
+#include <sched.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+namespace cbx {
+
+// /////////////////////////////////////////////
+// Implementation Detail
+// /////////////////////////////////////////////
+
+namespace {
+
+/// \brief Memory policy and flag of `mbind(2)`, spelled out to avoid a dependency on libnuma.
+constexpr int MPOL_INTERLEAVE_POLICY = 3;
+constexpr unsigned MPOL_MF_MOVE_FLAG = 1U << 1;
+
+/// \brief Parses a CPU list such as `0-3,8-11`.
+auto parse_cpu_list(const std::string &list) -> std::vector<usize> {
+  auto cpus = std::vector<usize>{};
+  auto stream = std::istringstream{list};
+  auto range = std::string{};
+  while (std::getline(stream, range, ',')) {
+    if (range.find_first_not_of(" \n") == std::string::npos) {
+      continue;
+    }
+    auto dash = range.find('-');
+    auto first = std::stoul(range.substr(0, dash));
+    auto last = dash == std::string::npos ? first : std::stoul(range.substr(dash + 1));
+    for (auto cpu = first; cpu <= last; ++cpu) {
+      cpus.push_back(cpu);
+    }
+  }
+  return cpus;
+}
+
+auto single_node() -> NumaTopology {
+  auto node = NumaTopology::Node{};
+  node.cpus.resize(std::max(std::thread::hardware_concurrency(), 1U));
+  for (usize cpu = {}; cpu < node.cpus.size(); ++cpu) {
+    node.cpus[cpu] = cpu;
+  }
+  return NumaTopology{{node}};
+}
+
+}
+
+// /////////////////////////////////////////////
+// Constructors and Destructors
+// /////////////////////////////////////////////
+
+NumaTopology::NumaTopology(std::vector<Node> nodes) : nodes_{std::move(nodes)} {
+  if (nodes_.empty()) {
+    throw ValueError{"cbx::NumaTopology::NumaTopology: nodes must not be empty"};
+  }
+  for (const auto &node : nodes_) {
+    if (node.cpus.empty()) {
+      throw ValueError{"cbx::NumaTopology::NumaTopology: node = {} has no CPU", node.id};
+    }
+  }
+  std::ranges::sort(nodes_, {}, &Node::id);
+}
+
+// /////////////////////////////////////////////
+// Accessors and Mutators
+// /////////////////////////////////////////////
+
+auto NumaTopology::nodes() const noexcept -> const std::vector<Node> & { return nodes_; }
+
+// /////////////////////////////////////////////
+// Query Functions
+// /////////////////////////////////////////////
+
+auto NumaTopology::node_count() const noexcept -> size_type { return nodes_.size(); }
+
+auto NumaTopology::cpu_count() const noexcept -> size_type {
+  size_type count = {};
+  for (const auto &node : nodes_) {
+    count += node.cpus.size();
+  }
+  return count;
+}
+
+auto NumaTopology::cpus() const -> std::vector<size_type> {
+  auto cpus = std::vector<size_type>{};
+  cpus.reserve(cpu_count());
+  for (const auto &node : nodes_) {
+    cpus.insert(cpus.end(), node.cpus.begin(), node.cpus.end());
+  }
+  return cpus;
+}
+
+auto NumaTopology::node_of_cpu(size_type cpu) const -> size_type {
+  for (const auto &node : nodes_) {
+    if (std::ranges::find(node.cpus, cpu) != node.cpus.end()) {
+      return node.id;
+    }
+  }
+  throw ValueError{"cbx::NumaTopology::node_of_cpu: cpu = {} does not belong to any node", cpu};
+}
+
+// /////////////////////////////////////////////
+// Informative
+// /////////////////////////////////////////////
+
+auto NumaTopology::to_string() const -> std::string {
+  auto summary = std::string{};
+  for (const auto &node : nodes_) {
+    summary += fmt::format("node{}: {{ {} }}\n", node.id, fmt::join(node.cpus, ", "));
+  }
+  return summary;
+}
+
+// /////////////////////////////////////////////////////////////
+// Static Functions
+// /////////////////////////////////////////////////////////////
+
+auto NumaTopology::discover(const std::string &root) -> NumaTopology {
+  namespace fs = std::filesystem;
+
+  auto nodes = std::vector<Node>{};
+  auto error = std::error_code{};
+  for (const auto &entry : fs::directory_iterator{root, error}) {
+    auto name = entry.path().filename().string();
+    if (not name.starts_with("node") or name.size() == 4 or
+        name.find_first_not_of("0123456789", 4) != std::string::npos) {
+      continue;
+    }
+    auto file = std::ifstream{entry.path() / "cpulist"};
+    auto list = std::string{};
+    if (not std::getline(file, list)) {
+      continue;
+    }
+    try {
+      auto node = Node{std::stoul(name.substr(4)), parse_cpu_list(list)};
+      // Memory-only nodes, e.g., those of CXL expanders, have no CPU to run a worker on.
+      if (not node.cpus.empty()) {
+        nodes.push_back(std::move(node));
+      }
+    } catch (const std::exception &) {
+      // A malformed entry is skipped.
+    }
+  }
+  return nodes.empty() ? single_node() : NumaTopology{std::move(nodes)};
+}
+
+auto NumaTopology::system() -> const NumaTopology & {
+  static const auto topology = discover();
+  return topology;
+}
+
+auto NumaTopology::pin_current_thread([[maybe_unused]] size_type cpu) noexcept -> bool {
+#if defined(__linux__)
+  if (cpu >= CPU_SETSIZE) {
+    return false;
+  }
+  auto set = cpu_set_t{};
+  CPU_ZERO(&set);
+  CPU_SET(cpu, &set);
+  return sched_setaffinity(0, sizeof(set), &set) == 0;
+#else
+  return false;
+#endif
+}
+
+auto NumaTopology::interleave([[maybe_unused]] void *address, [[maybe_unused]] size_type bytes) noexcept
+    -> bool {
+#if defined(__linux__) && defined(SYS_mbind)
+  const auto &topology = system();
+  if (topology.node_count() < 2) {
+    return false;
+  }
+
+  auto page = static_cast<usize>(sysconf(_SC_PAGESIZE));
+  auto first = (reinterpret_cast<usize>(address) + page - 1) / page * page;
+  auto last = (reinterpret_cast<usize>(address) + bytes) / page * page;
+  if (first >= last) {
+    return false;
+  }
+
+  constexpr auto BITS_PER_WORD = sizeof(unsigned long) * 8;
+  auto max_node = topology.nodes().back().id;
+  auto mask = std::vector<unsigned long>(max_node / BITS_PER_WORD + 1);
+  for (const auto &node : topology.nodes()) {
+    mask[node.id / BITS_PER_WORD] |= 1UL << (node.id % BITS_PER_WORD);
+  }
+  // The kernel expects the number of bits plus one.
+  auto mask_bits = mask.size() * BITS_PER_WORD + 1;
+  return syscall(SYS_mbind, first, last - first, MPOL_INTERLEAVE_POLICY, mask.data(), mask_bits,
+                 MPOL_MF_MOVE_FLAG) == 0;
+#else
+  return false;
+#endif
+}
+
+}
@@ -0,0 +1,249 @@
+// Copyright 2021 CBrainX
+// Project URL: https://github.com/mansoormemon/cbrainx
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Copyright (c) 2021 Mansoor Ahmed Memon <mansoorahmed.one@gmail.com>
+
+#include "cbrainx/optimizers.hh"
+
+#include <algorithm>
+#include <cmath>
+
+#include <fmt/format.h>
+
+#include "cbrainx/exceptions.hh"
+#include "cbrainx/threadPool.hh"
+#include "vmathKernels.hh"
+
+namespace cbx {
+
+// /////////////////////////////////////////////
+// Helpers
+// /////////////////////////////////////////////
+
+auto Optimizer::_s_check_decay(str caller, str name, value_type value) -> void {
+  if (not(value >= 0 and value < 1)) {
+    throw ValueError{"cbx::{}: {} = {} must be in the range [0, 1)", caller, name, value};
+  }
+}
+
+auto Optimizer::_s_check_non_negative(str caller, str name, value_type value) -> void {
+  if (not(value >= 0)) {
+    throw ValueError{"cbx::{}: {} = {} must not be negative", caller, name, value};
+  }
+}
+
+auto Optimizer::_m_prepare(std::span<const TrainableParameter> parameters) -> void {
+  auto offsets = std::vector<size_type>{0};
+  offsets.reserve(parameters.size() + 1);
+  for (const auto &parameter : parameters) {
+    if (parameter.values.size() != parameter.gradients.size()) {
+      throw ShapeError{"cbx::Optimizer::step: values [size = {}] and gradients [size = {}] must be of the same "
+                       "size",
+                       parameter.values.size(), parameter.gradients.size()};
+    }
+    offsets.push_back(offsets.back() + parameter.values.size());
+  }
+  if (offsets == offsets_) {
+    return;
+  }
+
+  // The state is zeroed with the same partition that the updates use, so every chunk is first touched by the
+  // thread that streams it.
+  offsets_ = std::move(offsets);
+  steps_ = {};
+  auto total = offsets_.back();
+  state_ = container(_m_slots() * total);
+  ThreadPool::global().parallel_for(0, total, CHUNK_SIZE, [this, total](size_type first, size_type last) {
+    for (size_type slot = {}; slot < _m_slots(); ++slot) {
+      std::fill(state_.data() + slot * total + first, state_.data() + slot * total + last, value_type{});
+    }
+  });
+}
+
+// /////////////////////////////////////////////
+// Constructors and Destructors
+// /////////////////////////////////////////////
+
+Optimizer::Optimizer(value_type learning_rate) { set_learning_rate(learning_rate); }
+
+// /////////////////////////////////////////////
+// Accessors and Mutators
+// /////////////////////////////////////////////
+
+auto Optimizer::learning_rate() const -> value_type { return learning_rate_; }
+
+auto Optimizer::set_learning_rate(value_type learning_rate) -> Optimizer & {
+  if (not(learning_rate > 0)) {
+    throw ValueError{"cbx::Optimizer::set_learning_rate: learning_rate = {} must be positive", learning_rate};
+  }
+  learning_rate_ = learning_rate;
+  return *this;
+}
+
+auto Optimizer::steps() const -> size_type { return steps_; }
+
+auto Optimizer::state_size() const -> size_type { return state_.size(); }
+
+// /////////////////////////////////////////////
+// Core Functionality
+// /////////////////////////////////////////////
+
+auto Optimizer::step(std::span<const TrainableParameter> parameters) -> void {
+  _m_prepare(parameters);
+  auto step = ++steps_;
+  auto total = offsets_.back();
+  auto slots = _m_slots();
+
+  // The parameters are treated as one flat range; a chunk may span the end of one parameter and the beginning
+  // of the next.
+  ThreadPool::global().parallel_for(0, total, CHUNK_SIZE, [&](size_type first, size_type last) {
+    auto index = size_type(std::upper_bound(offsets_.begin(), offsets_.end(), first) - offsets_.begin()) - 1;
+    while (first < last) {
+      auto end = std::min(last, offsets_[index + 1]);
+      const auto &parameter = parameters[index];
+      auto local = first - offsets_[index];
+      auto state = [&](size_type slot) -> value_type * {
+        return slot < slots ? state_.data() + slot * total + first : nullptr;
+      };
+      _m_update(parameter.values.data() + local, parameter.gradients.data() + local, state(0), state(1),
+                end - first, step);
+      first = end;
+      ++index;
+    }
+  });
+}
+
+auto Optimizer::reset() -> void {
+  offsets_ = {};
+  state_ = {};
+  steps_ = {};
+}
+
+// /////////////////////////////////////////////
+// SGD
+// /////////////////////////////////////////////
+
+SGD::SGD(value_type learning_rate, value_type momentum, value_type weight_decay)
+    : Optimizer{learning_rate}, momentum_{momentum}, weight_decay_{weight_decay} {
+  _s_check_decay("SGD::SGD", "momentum", momentum);
+  _s_check_non_negative("SGD::SGD", "weight_decay", weight_decay);
+}
+
+auto SGD::_m_slots() const -> size_type { return momentum_ > 0 ? 1 : 0; }
+
+auto SGD::_m_update(value_type *values, const value_type *gradients, value_type *first, value_type *,
+                    size_type n, size_type) const -> void {
+  auto params = vmath::_detail::UpdateParams{};
+  params.learning_rate = learning_rate();
+  params.beta1 = momentum_;
+  params.weight_decay = weight_decay_;
+  const auto &kernels = vmath::_detail::active_kernels();
+  auto kernel = momentum_ > 0 ? kernels.momentum : kernels.sgd;
+  kernel(values, gradients, first, nullptr, n, params);
+}
+
+auto SGD::to_string() const -> std::string {
+  return fmt::format("SGD (learning_rate={}, momentum={}, weight_decay={})", learning_rate(), momentum_,
+                     weight_decay_);
+}
+
+// /////////////////////////////////////////////
+// Adam
+// /////////////////////////////////////////////
+
+Adam::Adam(value_type learning_rate, value_type beta1, value_type beta2, value_type epsilon,
+           value_type weight_decay, bool decoupled)
+    : Optimizer{learning_rate},
+      beta1_{beta1},
+      beta2_{beta2},
+      epsilon_{epsilon},
+      weight_decay_{weight_decay},
+      decoupled_{decoupled} {
+  _s_check_decay("Adam::Adam", "beta1", beta1);
+  _s_check_decay("Adam::Adam", "beta2", beta2);
+  _s_check_non_negative("Adam::Adam", "epsilon", epsilon);
+  _s_check_non_negative("Adam::Adam", "weight_decay", weight_decay);
+}
+
+Adam::Adam(value_type learning_rate, value_type beta1, value_type beta2, value_type epsilon,
+           value_type weight_decay)
+    : Adam{learning_rate, beta1, beta2, epsilon, weight_decay, false} {}
+
+auto Adam::_m_slots() const -> size_type { return 2; }
+
+auto Adam::_m_update(value_type *values, const value_type *gradients, value_type *first, value_type *second,
+                     size_type n, size_type step) const -> void {
+  auto params = vmath::_detail::UpdateParams{};
+  params.learning_rate = learning_rate();
+  params.beta1 = beta1_;
+  params.beta2 = beta2_;
+  params.epsilon = epsilon_;
+  if (decoupled_) {
+    params.shrink = 1 - learning_rate() * weight_decay_;
+  } else {
+    params.weight_decay = weight_decay_;
+  }
+  auto t = value_type(step);
+  params.correction1 = 1 / (1 - std::pow(beta1_, t));
+  params.correction2 = 1 / (1 - std::pow(beta2_, t));
+  vmath::_detail::active_kernels().adam(values, gradients, first, second, n, params);
+}
+
+auto Adam::_m_hyperparameters() const -> std::string {
+  return fmt::format("learning_rate={}, beta1={}, beta2={}, epsilon={}, weight_decay={}", learning_rate(),
+                     beta1_, beta2_, epsilon_, weight_decay_);
+}
+
+auto Adam::to_string() const -> std::string { return fmt::format("Adam ({})", _m_hyperparameters()); }
+
+// /////////////////////////////////////////////
+// AdamW
+// /////////////////////////////////////////////
+
+AdamW::AdamW(value_type learning_rate, value_type beta1, value_type beta2, value_type epsilon,
+             value_type weight_decay)
+    : Adam{learning_rate, beta1, beta2, epsilon, weight_decay, true} {}
+
+auto AdamW::to_string() const -> std::string { return fmt::format("AdamW ({})", _m_hyperparameters()); }
+
+// /////////////////////////////////////////////
+// RMSProp
+// /////////////////////////////////////////////
+
+RMSProp::RMSProp(value_type learning_rate, value_type rho, value_type epsilon, value_type weight_decay)
+    : Optimizer{learning_rate}, rho_{rho}, epsilon_{epsilon}, weight_decay_{weight_decay} {
+  _s_check_decay("RMSProp::RMSProp", "rho", rho);
+  _s_check_non_negative("RMSProp::RMSProp", "epsilon", epsilon);
+  _s_check_non_negative("RMSProp::RMSProp", "weight_decay", weight_decay);
+}
+
+auto RMSProp::_m_slots() const -> size_type { return 1; }
+
+auto RMSProp::_m_update(value_type *values, const value_type *gradients, value_type *first, value_type *,
+                        size_type n, size_type) const -> void {
+  auto params = vmath::_detail::UpdateParams{};
+  params.learning_rate = learning_rate();
+  params.beta2 = rho_;
+  params.epsilon = epsilon_;
+  params.weight_decay = weight_decay_;
+  vmath::_detail::active_kernels().rmsprop(values, gradients, first, nullptr, n, params);
+}
+
+auto RMSProp::to_string() const -> std::string {
+  return fmt::format("RMSProp (learning_rate={}, rho={}, epsilon={}, weight_decay={})", learning_rate(), rho_,
+                     epsilon_, weight_decay_);
+}
+
+}
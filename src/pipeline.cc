@@ -0,0 +1,314 @@
+// Copyright 2021 CBrainX
+// Project URL: https://github.com/mansoormemon/cbrainx
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Copyright (c) 2021 Mansoor Ahmed Memon <mansoorahmed.one@gmail.com>
+#include "cbrainx/pipeline.hh"
+
+#include <algorithm>
+#include <chrono>
+#include <limits>
+#include <numeric>
+#include <utility>
+
+#include <fmt/format.h>
+
+#include "cbrainx/exceptions.hh"
+#include "cbrainx/executionContext.hh"
+#include "cbrainx/numa.hh"
+#include "cbrainx/threadPool.hh"
+
+namespace cbx {
+
+// /////////////////////////////////////////////
+// Implementation Detail
+// /////////////////////////////////////////////
+
+namespace {
+
+/// \brief The number of failed polls after which a waiting thread starts yielding the CPU.
+constexpr usize SPIN_LIMIT = 1 << 10;
+
+/// \brief The number of failed polls after which a waiting thread starts sleeping.
+constexpr usize YIELD_LIMIT = 1 << 14;
+
+/// \brief The time that an idle thread sleeps between polls.
+constexpr auto IDLE_SLEEP = std::chrono::microseconds{50};
+
+/// \brief Polls a ring buffer until it yields a slot.
+///
+/// \details
+/// A stage that has just handed a batch over usually gets the next one within microseconds, so waiting starts
+/// with spinning and only backs off to yielding, and eventually sleeping, once the stream has gone quiet.
+template <typename F>
+auto wait_for(F poll) -> decltype(poll()) {
+  for (auto polls = usize{};; ++polls) {
+    if (auto slot = poll(); slot != nullptr) {
+      return slot;
+    }
+    if (polls >= YIELD_LIMIT) {
+      std::this_thread::sleep_for(IDLE_SLEEP);
+    } else if (polls >= SPIN_LIMIT) {
+      std::this_thread::yield();
+    }
+  }
+}
+
+/// \brief Splits costs into at most `parts` contiguous groups such that the largest sum of a group is minimal.
+/// \return The index of the first element of each group.
+auto balance(const std::vector<f64> &costs, usize parts) -> std::vector<usize> {
+  auto n = costs.size();
+  parts = std::clamp(parts, usize{1}, n);
+  auto prefix = std::vector<f64>(n + 1);
+  std::partial_sum(costs.begin(), costs.end(), prefix.begin() + 1);
+
+  // `best[k][i]` is the smallest bottleneck of the first `i` elements cut into `k + 1` groups, and `cut[k][i]`
+  // is where the last of those groups begins.
+  constexpr auto infinity = std::numeric_limits<f64>::infinity();
+  auto best = std::vector<std::vector<f64>>(parts, std::vector<f64>(n + 1, infinity));
+  auto cut = std::vector<std::vector<usize>>(parts, std::vector<usize>(n + 1));
+  for (usize i = 1; i <= n; ++i) {
+    best[0][i] = prefix[i];
+  }
+  for (usize k = 1; k < parts; ++k) {
+    for (usize i = k + 1; i <= n; ++i) {
+      for (usize j = k; j < i; ++j) {
+        auto bottleneck = std::max(best[k - 1][j], prefix[i] - prefix[j]);
+        if (bottleneck < best[k][i]) {
+          best[k][i] = bottleneck;
+          cut[k][i] = j;
+        }
+      }
+    }
+  }
+
+  auto starts = std::vector<usize>(parts);
+  for (auto k = parts - 1, i = n; k > 0; --k) {
+    i = cut[k][i];
+    starts[k] = i;
+  }
+  return starts;
+}
+
+}
+
+// /////////////////////////////////////////////
+// Helpers
+// /////////////////////////////////////////////
+
+auto Pipeline::_m_run_stage(size_type index) -> void {
+  // A stage owns its core; parallel loops within it would only compete with the other stages.
+  ThreadPool::serialize_current_thread();
+  if (config_.pinned) {
+    // Stage `index` runs on CPU `index + 1`; the first CPU is left to the threads that push and pop.
+    auto cpus = NumaTopology::system().cpus();
+    NumaTopology::pin_current_thread(cpus[(index + 1) % cpus.size()]);
+  }
+
+  auto &source = *rings_[index];
+  auto &target = *rings_[index + 1];
+  const auto &plan = stages_[index].plan;
+  auto context = ExecutionContext{};
+  while (true) {
+    auto input = wait_for([&source] { return source.front(); });
+    auto output = wait_for([&target] { return target.acquire(); });
+    auto samples = input->samples;
+    if (samples != 0) {
+      plan.run(input->data.data(), output->data.data(), context);
+    }
+    output->samples = samples;
+    target.publish();
+    source.release();
+    if (samples == 0) {
+      return;
+    }
+  }
+}
+
+// /////////////////////////////////////////////
+// Constructors and Destructors
+// /////////////////////////////////////////////
+
+Pipeline::Pipeline(const NeuralNet &net, const PipelineConfig &config) : config_{config} {
+  if (net.size() == 0) {
+    throw ValueError{"cbx::Pipeline::Pipeline: the network must have at least one layer"};
+  }
+  if (config_.batch_size == 0 or config_.depth == 0) {
+    throw ValueError{"cbx::Pipeline::Pipeline: batch_size = {} and depth = {} must be positive",
+                     config_.batch_size, config_.depth};
+  }
+  input_size_ = net.compile(1).input_size();
+
+  // A unit is a layer together with the element-wise layers that follow it, which fusion folds into it.
+  auto units = std::vector<ExecutionPlan::layers_type>{};
+  for (const auto &layer : net) {
+    auto type = layer->type();
+    auto is_elementwise =
+        type == LayerType::Activation or type == LayerType::Softmax or type == LayerType::BatchNorm;
+    if (units.empty() or not is_elementwise) {
+      units.emplace_back();
+    }
+    units.back().push_back(layer);
+  }
+
+  // The units are timed on a thread that runs its loops serially, just like a stage.
+  auto costs = std::vector<f64>(units.size());
+  std::thread{[&] {
+    ThreadPool::serialize_current_thread();
+    auto context = ExecutionContext{};
+    auto inputs = input_size_;
+    for (size_type u = {}; u < units.size(); ++u) {
+      auto plan = ExecutionPlan{Shape{inputs}, units[u], config_.batch_size};
+      auto input = std::vector<value_type>(config_.batch_size * inputs, 0.5F);
+      auto output = std::vector<value_type>(config_.batch_size * plan.output_size());
+      plan.run(input.data(), output.data(), context);
+      auto runs = std::max(config_.calibration_runs, size_type{1});
+      auto start = std::chrono::steady_clock::now();
+      for (size_type r = {}; r < runs; ++r) {
+        plan.run(input.data(), output.data(), context);
+      }
+      costs[u] = std::chrono::duration<f64>(std::chrono::steady_clock::now() - start).count() / f64(runs);
+      inputs = plan.output_size();
+    }
+  }}.join();
+
+  auto stages = config_.stages;
+  if (stages == 0) {
+    stages = std::max(NumaTopology::system().cpu_count(), size_type{2}) - 1;
+  }
+  auto starts = balance(costs, stages);
+  starts.push_back(units.size());
+
+  auto inputs = input_size_;
+  rings_.push_back(std::make_unique<SpscRing<Batch>>(
+      config_.depth, Batch{std::vector<value_type>(config_.batch_size * inputs), 0}));
+  for (size_type s = {}; s + 1 < starts.size(); ++s) {
+    auto layers = ExecutionPlan::layers_type{};
+    auto stage = Stage{};
+    for (auto u = starts[s]; u < starts[s + 1]; ++u) {
+      layers.insert(layers.end(), units[u].begin(), units[u].end());
+      stage.cost += costs[u];
+    }
+    stage.first_layer = layers.front()->id();
+    stage.last_layer = layers.back()->id();
+    stage.plan = ExecutionPlan{Shape{inputs}, layers, config_.batch_size};
+    inputs = stage.plan.output_size();
+    stages_.push_back(std::move(stage));
+    rings_.push_back(std::make_unique<SpscRing<Batch>>(
+        config_.depth, Batch{std::vector<value_type>(config_.batch_size * inputs), 0}));
+  }
+  output_size_ = inputs;
+
+  for (size_type s = {}; s < stages_.size(); ++s) {
+    threads_.emplace_back(&Pipeline::_m_run_stage, this, s);
+  }
+}
+
+Pipeline::~Pipeline() {
+  close();
+  while (pop()) {
+    // The remaining outputs are discarded, so that no stage is left waiting for room.
+  }
+  for (auto &thread : threads_) {
+    thread.join();
+  }
+}
+
+// /////////////////////////////////////////////
+// Query Functions
+// /////////////////////////////////////////////
+
+auto Pipeline::batch_size() const noexcept -> size_type { return config_.batch_size; }
+
+auto Pipeline::depth() const noexcept -> size_type { return config_.depth; }
+
+auto Pipeline::input_size() const noexcept -> size_type { return input_size_; }
+
+auto Pipeline::output_size() const noexcept -> size_type { return output_size_; }
+
+auto Pipeline::stages() const noexcept -> size_type { return stages_.size(); }
+
+auto Pipeline::stage_costs() const -> std::vector<f64> {
+  auto costs = std::vector<f64>{};
+  costs.reserve(stages_.size());
+  for (const auto &stage : stages_) {
+    costs.push_back(stage.cost);
+  }
+  return costs;
+}
+
+// /////////////////////////////////////////////
+// Informative
+// /////////////////////////////////////////////
+
+auto Pipeline::to_string() const -> std::string {
+  auto description = fmt::format("Pipeline [batch_size = {}, depth = {}, stages = {}]\n", config_.batch_size,
+                                 config_.depth, stages_.size());
+  for (size_type s = {}; s < stages_.size(); ++s) {
+    const auto &stage = stages_[s];
+    description += fmt::format("  {}: layers {}-{} ({} -> {}), {:.3f} us per batch\n", s, stage.first_layer,
+                               stage.last_layer, stage.plan.input_size(), stage.plan.output_size(),
+                               stage.cost * 1e6);
+  }
+  return description;
+}
+
+// /////////////////////////////////////////////
+// Core Functionality
+// /////////////////////////////////////////////
+
+auto Pipeline::push(const tensor_type &input) -> void {
+  if (closed_) {
+    throw ValueError{"cbx::Pipeline::push: the stream has been closed"};
+  }
+  auto samples = input.rank() == 0 ? size_type{} : input.shape().front();
+  if (samples == 0 or samples > config_.batch_size or input.total() != samples * input_size_) {
+    throw ShapeError{"cbx::Pipeline::push: input = {} does not fit [batch_size = {}, input_size = {}]",
+                     input.shape().to_string(), config_.batch_size, input_size_};
+  }
+  auto &ring = *rings_.front();
+  auto slot = wait_for([&ring] { return ring.acquire(); });
+  std::copy_n(input.data(), input.total(), slot->data.data());
+  slot->samples = samples;
+  ring.publish();
+}
+
+auto Pipeline::pop() -> std::optional<tensor_type> {
+  if (drained_) {
+    return std::nullopt;
+  }
+  auto &ring = *rings_.back();
+  auto slot = wait_for([&ring] { return ring.front(); });
+  if (slot->samples == 0) {
+    ring.release();
+    drained_ = true;
+    return std::nullopt;
+  }
+  auto output = tensor_type{Shape{slot->samples, output_size_}, slot->data.data()};
+  ring.release();
+  return output;
+}
+
+auto Pipeline::close() -> void {
+  if (closed_) {
+    return;
+  }
+  auto &ring = *rings_.front();
+  auto slot = wait_for([&ring] { return ring.acquire(); });
+  slot->samples = 0;
+  ring.publish();
+  closed_ = true;
+}
+
+}
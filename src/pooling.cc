@@ -0,0 +1,426 @@
+// Copyright 2021 CBrainX
+// Project URL: https://github.com/mansoormemon/cbrainx
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Copyright (c) 2021 Mansoor Ahmed Memon <mansoorahmed.one@gmail.com>
+#include "cbrainx/pooling.hh"
+
+#include <algorithm>
+#include <limits>
+#include <span>
+#include <utility>
+
+#include <fmt/format.h>
+
+#include "cbrainx/exceptions.hh"
+#include "cbrainx/threadPool.hh"
+#include "cbrainx/vmath.hh"
+
+namespace cbx {
+
+// /////////////////////////////////////////////
+// Implementation Detail
+// /////////////////////////////////////////////
+
+namespace {
+
+/// \brief The number of window taps (per channel) from which a block of output rows is worth a thread.
+constexpr usize POOL_MIN_WORK = 16384;
+
+/// \brief Returns the output extent along one spatial axis, or zero if the window does not fit.
+auto output_extent(usize extent, usize window, usize stride, usize padding) -> usize {
+  auto padded = extent + 2 * padding;
+  return padded < window ? 0 : (padded - window) / stride + 1;
+}
+
+/// \brief A half-open range [first, second).
+using Range = std::pair<usize, usize>;
+
+/// \brief Returns the range of the taps of a window that lie inside the input along one axis.
+auto valid_taps(usize index, usize extent, usize window, usize stride, usize padding) -> Range {
+  auto start = index * stride;
+  auto first = start < padding ? padding - start : 0;
+  auto last = std::min(window, extent + padding - start);
+  return {first, last};
+}
+
+/// \brief The geometry shared by the kernels below, for a batch of shape `in` pooled to shape `out`.
+struct Geometry {
+  usize height, width, channels, out_height, out_width;
+  Pool2DParams params;
+
+  Geometry(const Shape &in, const Shape &out, const Pool2DParams &params)
+      : height{in[1]}, width{in[2]}, channels{in[3]}, out_height{out[1]}, out_width{out[2]}, params{params} {}
+
+  /// \brief Returns the valid taps of the window of output pixel (y, x) along the height and the width.
+  [[nodiscard]] auto taps(usize y, usize x) const -> std::pair<Range, Range> {
+    return {valid_taps(y, height, params.window_h, params.stride_h, params.padding_h),
+            valid_taps(x, width, params.window_w, params.stride_w, params.padding_w)};
+  }
+
+  /// \brief Returns the offset of the pixel of image `n` that is covered by tap (i, j) of output pixel (y, x).
+  [[nodiscard]] auto pixel(usize n, usize y, usize x, usize i, usize j) const -> usize {
+    auto row = y * params.stride_h + i - params.padding_h;
+    auto column = x * params.stride_w + j - params.padding_w;
+    return ((n * height + row) * width + column) * channels;
+  }
+
+  /// \brief Returns a grain that gives every thread at least `POOL_MIN_WORK` taps of output rows.
+  [[nodiscard]] auto row_grain() const -> usize {
+    auto row_work = out_width * channels * params.window_h * params.window_w;
+    return std::max(POOL_MIN_WORK / std::max(row_work, usize{1}), usize{1});
+  }
+};
+
+/// \brief Max-pools the output rows [first, last) of a batch, where row `r` is row `r % out_height` of image
+/// `r / out_height`, optionally recording the positions of the maxima.
+auto max_pool_rows(const f32 *input, f32 *output, f32 *indices, const Geometry &g, usize first, usize last)
+    -> void {
+  auto c = g.channels;
+  for (auto r = first; r < last; ++r) {
+    auto n = r / g.out_height, y = r % g.out_height;
+    for (usize x = {}; x < g.out_width; ++x) {
+      auto offset = (r * g.out_width + x) * c;
+      auto maxima = std::span{output + offset, c};
+      auto [rows, columns] = g.taps(y, x);
+      // The first valid tap seeds the maxima, so that padding never wins.
+      auto is_seeded = false;
+      for (auto i = rows.first; i < rows.second; ++i) {
+        for (auto j = columns.first; j < columns.second; ++j) {
+          auto values = std::span<const f32>{input + g.pixel(n, y, x, i, j), c};
+          auto position = f32(i * g.params.window_w + j);
+          if (not is_seeded) {
+            std::copy(values.begin(), values.end(), maxima.begin());
+            if (indices != nullptr) {
+              std::fill_n(indices + offset, c, position);
+            }
+            is_seeded = true;
+          } else if (indices != nullptr) {
+            vmath::maximum(values, maxima, {indices + offset, c}, position);
+          } else {
+            vmath::maximum(values, maxima);
+          }
+        }
+      }
+    }
+  }
+}
+
+/// \brief Average-pools the output rows [first, last) of a batch, like `max_pool_rows`.
+auto avg_pool_rows(const f32 *input, f32 *output, const Geometry &g, usize first, usize last) -> void {
+  auto c = g.channels;
+  for (auto r = first; r < last; ++r) {
+    auto n = r / g.out_height, y = r % g.out_height;
+    for (usize x = {}; x < g.out_width; ++x) {
+      auto averages = std::span{output + (r * g.out_width + x) * c, c};
+      auto [rows, columns] = g.taps(y, x);
+      auto weight = 1.0F / f32((rows.second - rows.first) * (columns.second - columns.first));
+      std::fill(averages.begin(), averages.end(), 0.0F);
+      for (auto i = rows.first; i < rows.second; ++i) {
+        for (auto j = columns.first; j < columns.second; ++j) {
+          vmath::axpy(weight, {input + g.pixel(n, y, x, i, j), c}, averages);
+        }
+      }
+    }
+  }
+}
+
+/// \brief Adds the gradient of every output pixel of the images [first, last) to the input pixel that attained
+/// its maximum.
+auto max_unpool_images(const f32 *output_gradient, const f32 *indices, f32 *input_gradient, const Geometry &g,
+                       usize first, usize last) -> void {
+  auto c = g.channels;
+  for (auto n = first; n < last; ++n) {
+    for (usize y = {}; y < g.out_height; ++y) {
+      for (usize x = {}; x < g.out_width; ++x) {
+        auto offset = ((n * g.out_height + y) * g.out_width + x) * c;
+        for (usize k = {}; k < c; ++k) {
+          auto position = usize(indices[offset + k]);
+          auto i = position / g.params.window_w, j = position % g.params.window_w;
+          input_gradient[g.pixel(n, y, x, i, j) + k] += output_gradient[offset + k];
+        }
+      }
+    }
+  }
+}
+
+/// \brief Spreads the gradient of every output pixel of the images [first, last) evenly over its window.
+auto avg_unpool_images(const f32 *output_gradient, f32 *input_gradient, const Geometry &g, usize first,
+                       usize last) -> void {
+  auto c = g.channels;
+  for (auto n = first; n < last; ++n) {
+    for (usize y = {}; y < g.out_height; ++y) {
+      for (usize x = {}; x < g.out_width; ++x) {
+        auto offset = ((n * g.out_height + y) * g.out_width + x) * c;
+        auto gradient = std::span<const f32>{output_gradient + offset, c};
+        auto [rows, columns] = g.taps(y, x);
+        auto weight = 1.0F / f32((rows.second - rows.first) * (columns.second - columns.first));
+        for (auto i = rows.first; i < rows.second; ++i) {
+          for (auto j = columns.first; j < columns.second; ++j) {
+            vmath::axpy(weight, gradient, {input_gradient + g.pixel(n, y, x, i, j), c});
+          }
+        }
+      }
+    }
+  }
+}
+
+}
+
+// /////////////////////////////////////////////
+// Core Functionality
+// /////////////////////////////////////////////
+
+auto pool2d_output_shape(const Shape &input, const Pool2DParams &params) -> Shape {
+  constexpr usize POOL2D_RANK = 4;
+  if (input.rank() != POOL2D_RANK) {
+    throw RankError{"cbx::pool2d_output_shape: input = {} must be of rank {}", input.to_string(), POOL2D_RANK};
+  }
+  if (params.window_h == 0 or params.window_w == 0 or params.stride_h == 0 or params.stride_w == 0) {
+    throw ValueError{"cbx::pool2d_output_shape: window [{}, {}] and strides [{}, {}] must be positive",
+                     params.window_h, params.window_w, params.stride_h, params.stride_w};
+  }
+  if (params.padding_h >= params.window_h or params.padding_w >= params.window_w) {
+    throw ValueError{"cbx::pool2d_output_shape: padding [{}, {}] must be smaller than the window [{}, {}]",
+                     params.padding_h, params.padding_w, params.window_h, params.window_w};
+  }
+  auto out_height = output_extent(input[1], params.window_h, params.stride_h, params.padding_h);
+  auto out_width = output_extent(input[2], params.window_w, params.stride_w, params.padding_w);
+  if (out_height == 0 or out_width == 0) {
+    throw ValueError{"cbx::pool2d_output_shape: window [{}, {}] does not fit in input = {} with padding "
+                     "[{}, {}]",
+                     params.window_h, params.window_w, input.to_string(), params.padding_h, params.padding_w};
+  }
+  return {input[0], out_height, out_width, input[3]};
+}
+
+// /////////////////////////////////////////////
+// Helpers
+// /////////////////////////////////////////////
+
+auto Pool2DLayer::_m_count_samples(const Shape &shape) const -> size_type {
+  if (shape.rank() < container::MATRIX_RANK or shape.total() != shape.front() * input_shape_.total()) {
+    throw ShapeError{"cbx::Pool2DLayer::_m_count_samples: input = {} does not hold images of shape {}",
+                     shape.to_string(), input_shape_.to_string()};
+  }
+  return shape.front();
+}
+
+auto Pool2DLayer::_m_images(size_type samples) const -> Shape {
+  auto [height, width, channels] = input_shape_.unwrap<3>();
+  return {samples, height, width, channels};
+}
+
+auto Pool2DLayer::_m_maps(size_type samples) const -> Shape {
+  return pool2d_output_shape(_m_images(samples), params_);
+}
+
+auto Pool2DLayer::_m_outputs(size_type samples) const -> Shape {
+  auto shape = output_shape_;
+  shape.resize(shape.rank() + 1, true).set_axis(0, samples);
+  return shape;
+}
+
+// /////////////////////////////////////////////
+// Constructors (and Destructors)
+// /////////////////////////////////////////////
+
+Pool2DLayer::Pool2DLayer(std::string_view name, const Shape &input_shape, const Pool2DParams &params)
+    : AbstractLayer{name}, input_shape_{input_shape}, params_{params} {
+  if (input_shape_.rank() == container::MATRIX_RANK) {
+    input_shape_ = Shape{input_shape_[0], input_shape_[1], 1};
+  }
+  if (input_shape_.rank() != 3) {
+    throw RankError{"cbx::Pool2DLayer::Pool2DLayer: input_shape = {} is not the shape of an image",
+                    input_shape_.to_string()};
+  }
+  output_shape_ = _m_maps(1).slice(1);
+}
+
+MaxPool2D::MaxPool2D(const Shape &input_shape, size_type window, size_type stride, size_type padding)
+    : MaxPool2D{input_shape, Pool2DParams::square(window, stride == 0 ? window : stride, padding)} {}
+
+MaxPool2D::MaxPool2D(const Shape &input_shape, const Pool2DParams &params)
+    : Pool2DLayer{"MXPL", input_shape, params} {}
+
+AvgPool2D::AvgPool2D(std::string_view name, const Shape &input_shape, const Pool2DParams &params)
+    : Pool2DLayer{name, input_shape, params} {}
+
+AvgPool2D::AvgPool2D(const Shape &input_shape, size_type window, size_type stride, size_type padding)
+    : AvgPool2D{input_shape, Pool2DParams::square(window, stride == 0 ? window : stride, padding)} {}
+
+AvgPool2D::AvgPool2D(const Shape &input_shape, const Pool2DParams &params)
+    : AvgPool2D{"AVPL", input_shape, params} {}
+
+GlobalAvgPool::GlobalAvgPool(const Shape &input_shape)
+    : AvgPool2D{"GAPL", input_shape,
+                input_shape.rank() < container::MATRIX_RANK
+                    ? Pool2DParams{}
+                    : Pool2DParams{input_shape[0], input_shape[1], 1, 1, 0, 0}} {
+  output_shape_ = Shape{input_shape_.back()};
+}
+
+// /////////////////////////////////////////////
+// Accessors and Mutators
+// /////////////////////////////////////////////
+
+auto Pool2DLayer::params() const -> const Pool2DParams & { return params_; }
+
+auto Pool2DLayer::input_shape() const -> const Shape & { return input_shape_; }
+
+auto MaxPool2D::records_indices() const -> bool { return records_indices_; }
+
+auto MaxPool2D::set_records_indices(bool records_indices) -> MaxPool2D & {
+  records_indices_ = records_indices;
+  return *this;
+}
+
+auto MaxPool2D::indices() const -> const container & { return indices_; }
+
+// /////////////////////////////////////////////
+// Query Functions
+// /////////////////////////////////////////////
+
+auto Pool2DLayer::neurons() const -> size_type { return output_shape_.total(); }
+
+auto Pool2DLayer::parameters() const -> size_type { return {}; }
+
+auto Pool2DLayer::output_shape([[maybe_unused]] const Shape &input_shape) const -> Shape {
+  return output_shape_;
+}
+
+auto MaxPool2D::type() const -> LayerType { return LayerType::MaxPool2D; }
+
+auto AvgPool2D::type() const -> LayerType { return LayerType::AvgPool2D; }
+
+auto GlobalAvgPool::type() const -> LayerType { return LayerType::GlobalAvgPool; }
+
+// /////////////////////////////////////////////
+// Informative
+// /////////////////////////////////////////////
+
+auto Pool2DLayer::property() const -> std::string {
+  return fmt::format("Window: [{}, {}], S=[{}, {}], P=[{}, {}]", params_.window_h, params_.window_w,
+                     params_.stride_h, params_.stride_w, params_.padding_h, params_.padding_w);
+}
+
+auto GlobalAvgPool::property() const -> std::string {
+  return fmt::format("Window: [{}, {}]", params_.window_h, params_.window_w);
+}
+
+// /////////////////////////////////////////////
+// Utility
+// /////////////////////////////////////////////
+
+auto MaxPool2D::clone() const -> std::shared_ptr<AbstractLayer> { return std::make_shared<MaxPool2D>(*this); }
+
+auto AvgPool2D::clone() const -> std::shared_ptr<AbstractLayer> { return std::make_shared<AvgPool2D>(*this); }
+
+auto GlobalAvgPool::clone() const -> std::shared_ptr<AbstractLayer> {
+  return std::make_shared<GlobalAvgPool>(*this);
+}
+
+// /////////////////////////////////////////////
+// Core Functionality
+// /////////////////////////////////////////////
+
+auto Pool2DLayer::forward_pass(const container &input) const -> const AbstractLayer & {
+  // Applying forward pass and caching the input and output layers.
+  auto samples = _m_count_samples(input.shape());
+  input_ = input;
+  output_ = container{_m_outputs(samples)};
+  infer(input_, output_);
+  return *this;
+}
+
+auto MaxPool2D::forward_pass(const container &input) const -> const AbstractLayer & {
+  if (not records_indices_) {
+    indices_ = {};
+    return Pool2DLayer::forward_pass(input);
+  }
+  auto samples = _m_count_samples(input.shape());
+  auto images = _m_images(samples);
+  auto maps = _m_maps(samples);
+  input_ = input;
+  output_ = container{_m_outputs(samples)};
+  indices_ = container{maps};
+  auto g = Geometry{images, maps, params_};
+  ThreadPool::global().parallel_for(0, samples * g.out_height, g.row_grain(), [&](auto first, auto last) {
+    max_pool_rows(input_.data(), output_.data(), indices_.data(), g, first, last);
+  });
+  return *this;
+}
+
+auto MaxPool2D::infer(TensorView<const value_type> input, TensorView<value_type> output) const -> void {
+  // Formula: Ô[y, x] = max [(i, j) ∈ window(y, x)] Î[i, j]
+  auto samples = _m_count_samples(input.shape());
+  auto images = _m_images(samples);
+  auto maps = output.reshaped(_m_maps(samples));
+  auto g = Geometry{images, maps.shape(), params_};
+  ThreadPool::global().parallel_for(0, samples * g.out_height, g.row_grain(), [&](auto first, auto last) {
+    max_pool_rows(input.data(), maps.data(), nullptr, g, first, last);
+  });
+}
+
+auto MaxPool2D::backward_pass(const container &output_gradient) const -> const AbstractLayer & {
+  // Formula: ∂Î[i, j] = ⅀ [(y, x) | argmax(window(y, x)) = (i, j)] ∂Ô[y, x]
+  _m_check_output_gradient(output_gradient);
+  auto samples = input_.shape().front();
+  auto images = _m_images(samples);
+  auto g = Geometry{images, _m_maps(samples), params_};
+  auto &pool = ThreadPool::global();
+  // The recorded positions are used in place; only when they are missing are the windows searched again.
+  auto is_recorded = indices_.total() == output_.total();
+  auto searched = container{};
+  if (not is_recorded) {
+    auto maxima = container{_m_maps(samples)};
+    searched = container{_m_maps(samples)};
+    pool.parallel_for(0, samples * g.out_height, g.row_grain(), [&](auto first, auto last) {
+      max_pool_rows(input_.data(), maxima.data(), searched.data(), g, first, last);
+    });
+  }
+  const auto &indices = is_recorded ? indices_ : searched;
+  // Overlapping windows may share input pixels, so each thread owns whole images of the gradient.
+  input_gradient_ = input_.zeros_like();
+  pool.parallel_for(0, samples, 1, [&](auto first, auto last) {
+    max_unpool_images(output_gradient.data(), indices.data(), input_gradient_.data(), g, first, last);
+  });
+  return *this;
+}
+
+auto AvgPool2D::infer(TensorView<const value_type> input, TensorView<value_type> output) const -> void {
+  // Formula: Ô[y, x] = ⅀ [(i, j) ∈ window(y, x)] Î[i, j] / |window(y, x)|
+  auto samples = _m_count_samples(input.shape());
+  auto images = _m_images(samples);
+  auto maps = output.reshaped(_m_maps(samples));
+  auto g = Geometry{images, maps.shape(), params_};
+  ThreadPool::global().parallel_for(0, samples * g.out_height, g.row_grain(), [&](auto first, auto last) {
+    avg_pool_rows(input.data(), maps.data(), g, first, last);
+  });
+}
+
+auto AvgPool2D::backward_pass(const container &output_gradient) const -> const AbstractLayer & {
+  // Formula: ∂Î[i, j] = ⅀ [(y, x) | (i, j) ∈ window(y, x)] ∂Ô[y, x] / |window(y, x)|
+  _m_check_output_gradient(output_gradient);
+  auto samples = input_.shape().front();
+  auto g = Geometry{_m_images(samples), _m_maps(samples), params_};
+  // Overlapping windows may share input pixels, so each thread owns whole images of the gradient.
+  input_gradient_ = input_.zeros_like();
+  ThreadPool::global().parallel_for(0, samples, 1, [&](auto first, auto last) {
+    avg_unpool_images(output_gradient.data(), input_gradient_.data(), g, first, last);
+  });
+  return *this;
+}
+
+}
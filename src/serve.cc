@@ -0,0 +1,476 @@
+// Copyright 2021 CBrainX
+// Project URL: https://github.com/mansoormemon/cbrainx
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Copyright (c) 2021 Mansoor Ahmed Memon <mansoorahmed.one@gmail.com>
+#include "cbrainx/serve.hh"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <utility>
+
+#include <fmt/format.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include "cbrainx/exceptions.hh"
+
+namespace cbx::serve {
+
+// /////////////////////////////////////////////
+// Implementation Detail
+// /////////////////////////////////////////////
+
+namespace {
+
+/// \brief Reads exactly `size` bytes, returning false if the connection is closed or fails first.
+auto read_all(int fd, void *data, usize size) -> bool {
+  auto bytes = static_cast<char *>(data);
+  while (size > 0) {
+    auto count = ::recv(fd, bytes, size, 0);
+    if (count < 0 and errno == EINTR) {
+      continue;
+    }
+    if (count <= 0) {
+      return false;
+    }
+    bytes += count;
+    size -= usize(count);
+  }
+  return true;
+}
+
+/// \brief Writes exactly `size` bytes, returning false if the connection is closed or fails first.
+auto write_all(int fd, const void *data, usize size) -> bool {
+  auto bytes = static_cast<const char *>(data);
+  while (size > 0) {
+    // A peer that has gone away must not raise SIGPIPE in the server.
+    auto count = ::send(fd, bytes, size, MSG_NOSIGNAL);
+    if (count < 0 and errno == EINTR) {
+      continue;
+    }
+    if (count <= 0) {
+      return false;
+    }
+    bytes += count;
+    size -= usize(count);
+  }
+  return true;
+}
+
+/// \brief Returns the address of a Unix domain socket, or throws if the path does not fit.
+auto make_address(const std::string &path, str caller) -> sockaddr_un {
+  auto address = sockaddr_un{};
+  address.sun_family = AF_UNIX;
+  if (path.empty() or path.size() >= sizeof(address.sun_path)) {
+    throw ValueError{"{}: socket path = '{}' must be non-empty and shorter than {} characters", caller, path,
+                     sizeof(address.sun_path)};
+  }
+  std::copy(path.begin(), path.end(), address.sun_path);
+  return address;
+}
+
+/// \brief Returns the value at the given fraction of a sorted sequence.
+auto percentile(const std::vector<f64> &sorted, f64 fraction) -> f64 {
+  if (sorted.empty()) {
+    return {};
+  }
+  auto index = usize(fraction * f64(sorted.size() - 1) + 0.5);
+  return sorted[std::min(index, sorted.size() - 1)];
+}
+
+}
+
+// /////////////////////////////////////////////
+// Statistics
+// /////////////////////////////////////////////
+
+auto Statistics::throughput() const noexcept -> f64 { return seconds > 0 ? f64(samples) / seconds : 0.0; }
+
+auto Statistics::mean_batch_size() const noexcept -> f64 {
+  return batches > 0 ? f64(samples) / f64(batches) : 0.0;
+}
+
+auto Statistics::to_string() const -> std::string {
+  auto description = fmt::format("requests = {}, samples = {}, batches = {}, seconds = {:.3f}\n"
+                                 "throughput = {:.1f} samples/s, mean batch size = {:.2f}\n"
+                                 "latency [us]: p50 = {:.1f}, p90 = {:.1f}, p99 = {:.1f}, max = {:.1f}\n"
+                                 "batch sizes:",
+                                 requests, samples, batches, seconds, throughput(), mean_batch_size(),
+                                 latency_p50, latency_p90, latency_p99, latency_max);
+  for (usize size = {}; size < batch_sizes.size(); ++size) {
+    if (batch_sizes[size] != 0) {
+      description += fmt::format(" {}:{}", size, batch_sizes[size]);
+    }
+  }
+  return description + "\n";
+}
+
+// /////////////////////////////////////////////
+// Helpers
+// /////////////////////////////////////////////
+
+auto Server::_m_accept() -> void {
+  while (true) {
+    auto fd = ::accept(listen_fd_, nullptr, nullptr);
+    if (fd < 0) {
+      if (errno == EINTR or errno == ECONNABORTED) {
+        continue;
+      }
+      // The listening socket has been shut down by `stop`.
+      return;
+    }
+    auto lock = std::scoped_lock{connections_mutex_};
+    // Threads of closed connections are reaped as new ones arrive.
+    for (auto it = connections_.begin(); it != connections_.end();) {
+      if (it->finished) {
+        it->thread.join();
+        it = connections_.erase(it);
+      } else {
+        ++it;
+      }
+    }
+    if (auto stop_lock = std::scoped_lock{mutex_}; stop_) {
+      ::close(fd);
+      return;
+    }
+    auto &connection = connections_.emplace_back();
+    connection.fd = fd;
+    connection.thread = std::thread{&Server::_m_serve, this, std::ref(connection)};
+  }
+}
+
+auto Server::_m_serve(Connection &connection) -> void {
+  auto fd = connection.fd;
+  u32 sizes[] = {u32(input_size_), u32(output_size_)};
+  if (write_all(fd, sizes, sizeof(sizes))) {
+    while (true) {
+      auto samples = u32{};
+      if (not read_all(fd, &samples, sizeof(samples)) or samples == 0 or samples > MAX_REQUEST_SAMPLES) {
+        break;
+      }
+      auto request = Request{};
+      request.samples = samples;
+      request.input.resize(samples * input_size_);
+      if (not read_all(fd, request.input.data(), request.input.size() * sizeof(value_type))) {
+        break;
+      }
+      auto done = request.done.get_future();
+      request.arrival = clock::now();
+      {
+        auto lock = std::scoped_lock{mutex_};
+        if (stop_) {
+          break;
+        }
+        queue_.push_back(&request);
+        queued_samples_ += request.samples;
+      }
+      cv_.notify_all();
+
+      auto answered = u32(samples);
+      try {
+        done.get();
+      } catch (const std::exception &) {
+        answered = 0;
+      }
+      auto ok = write_all(fd, &answered, sizeof(answered));
+      if (ok and answered != 0) {
+        ok = write_all(fd, request.output.data(), request.output.size() * sizeof(value_type));
+      }
+      if (not ok) {
+        break;
+      }
+    }
+  }
+  auto lock = std::scoped_lock{connections_mutex_};
+  ::close(fd);
+  connection.fd = -1;
+  connection.finished = true;
+}
+
+auto Server::_m_batch() -> void {
+  auto input = std::vector<value_type>{};
+  auto output = std::vector<value_type>{};
+  auto batch = std::vector<Request *>{};
+  while (true) {
+    auto samples = size_type{};
+    {
+      auto lock = std::unique_lock{mutex_};
+      cv_.wait(lock, [this] { return stop_ or not queue_.empty(); });
+      if (queue_.empty()) {
+        return;
+      }
+      // The batch closes when it is full or when its oldest request has waited long enough.
+      auto deadline = queue_.front()->arrival + config_.max_wait;
+      cv_.wait_until(lock, deadline, [this] { return stop_ or queued_samples_ >= config_.max_batch_size; });
+      // Requests are never split; one larger than a batch runs alone.
+      batch.clear();
+      while (not queue_.empty() and
+             (batch.empty() or samples + queue_.front()->samples <= config_.max_batch_size)) {
+        batch.push_back(queue_.front());
+        samples += queue_.front()->samples;
+        queued_samples_ -= queue_.front()->samples;
+        queue_.pop_front();
+      }
+    }
+    _m_run(batch, samples, input, output);
+  }
+}
+
+auto Server::_m_run(const std::vector<Request *> &batch, size_type samples, std::vector<value_type> &input,
+                    std::vector<value_type> &output) -> void {
+  try {
+    // Gather the requests into the rows of one input matrix.
+    input.resize(samples * input_size_);
+    output.resize(samples * output_size_);
+    auto row = input.begin();
+    for (auto *request : batch) {
+      row = std::copy(request->input.begin(), request->input.end(), row);
+    }
+
+    auto plan = plans_.find(samples);
+    if (plan == plans_.end()) {
+      plan = plans_.emplace(samples, net_.compile(samples)).first;
+    }
+    plan->second.run(input.data(), output.data(), context_);
+  } catch (...) {
+    for (auto *request : batch) {
+      request->done.set_exception(std::current_exception());
+    }
+    return;
+  }
+
+  // Scatter the rows of the output matrix back to the requests.
+  auto now = clock::now();
+  auto lock = std::scoped_lock{statistics_mutex_};
+  auto row = output.begin();
+  for (auto *request : batch) {
+    auto end = row + isize(request->samples * output_size_);
+    request->output.assign(row, end);
+    row = end;
+    auto latency = std::chrono::duration<f64, std::micro>(now - request->arrival).count();
+    latencies_[latencies_recorded_++ % LATENCY_WINDOW] = latency;
+    request->done.set_value();
+  }
+  statistics_.requests += batch.size();
+  statistics_.samples += samples;
+  statistics_.batches += 1;
+  if (statistics_.batch_sizes.size() <= samples) {
+    statistics_.batch_sizes.resize(samples + 1);
+  }
+  statistics_.batch_sizes[samples] += 1;
+}
+
+// /////////////////////////////////////////////
+// Constructors and Destructors
+// /////////////////////////////////////////////
+
+Server::Server(NeuralNet net, ServerConfig config) : net_{net.fold()}, config_{std::move(config)} {
+  if (net_.size() == 0) {
+    throw ValueError{"cbx::serve::Server::Server: the network has no layers"};
+  }
+  if (config_.max_batch_size == 0) {
+    throw ValueError{"cbx::serve::Server::Server: max_batch_size must be positive"};
+  }
+  make_address(config_.socket_path, "cbx::serve::Server::Server");
+  // The network was folded up front, so the plans of all batch sizes share the folded layers. The plan for
+  // single samples also tells the sizes of a sample.
+  const auto &plan = plans_.emplace(1, net_.compile(1)).first->second;
+  input_size_ = plan.input_size();
+  output_size_ = plan.output_size();
+  statistics_.batch_sizes.resize(config_.max_batch_size + 1);
+}
+
+Server::~Server() { stop(); }
+
+// /////////////////////////////////////////////
+// Accessors and Mutators
+// /////////////////////////////////////////////
+
+auto Server::config() const noexcept -> const ServerConfig & { return config_; }
+
+// /////////////////////////////////////////////
+// Query Functions
+// /////////////////////////////////////////////
+
+auto Server::input_size() const noexcept -> size_type { return input_size_; }
+
+auto Server::output_size() const noexcept -> size_type { return output_size_; }
+
+auto Server::is_running() const noexcept -> bool { return listen_fd_ >= 0; }
+
+auto Server::statistics() const -> Statistics {
+  auto lock = std::scoped_lock{statistics_mutex_};
+  auto statistics = statistics_;
+  if (is_running()) {
+    statistics.seconds = std::chrono::duration<f64>(clock::now() - started_).count();
+  }
+  auto recorded = std::min(latencies_recorded_, LATENCY_WINDOW);
+  auto sorted = std::vector<f64>(latencies_.begin(), latencies_.begin() + isize(recorded));
+  std::sort(sorted.begin(), sorted.end());
+  statistics.latency_p50 = percentile(sorted, 0.50);
+  statistics.latency_p90 = percentile(sorted, 0.90);
+  statistics.latency_p99 = percentile(sorted, 0.99);
+  statistics.latency_max = sorted.empty() ? 0.0 : sorted.back();
+  return statistics;
+}
+
+// /////////////////////////////////////////////
+// Core Functionality
+// /////////////////////////////////////////////
+
+auto Server::start() -> void {
+  if (is_running()) {
+    throw SocketError{"cbx::serve::Server::start: the server is already running"};
+  }
+  auto address = make_address(config_.socket_path, "cbx::serve::Server::start");
+  auto fd = ::socket(AF_UNIX, SOCK_STREAM, 0);
+  if (fd < 0) {
+    throw SocketError{"cbx::serve::Server::start: could not create a socket [{}]", std::strerror(errno)};
+  }
+  ::unlink(config_.socket_path.c_str());
+  if (::bind(fd, reinterpret_cast<const sockaddr *>(&address), sizeof(address)) != 0 or
+      ::listen(fd, SOMAXCONN) != 0) {
+    auto error = errno;
+    ::close(fd);
+    throw SocketError{"cbx::serve::Server::start: could not listen on '{}' [{}]", config_.socket_path,
+                      std::strerror(error)};
+  }
+
+  {
+    auto lock = std::scoped_lock{statistics_mutex_};
+    statistics_ = Statistics{};
+    statistics_.batch_sizes.resize(config_.max_batch_size + 1);
+    latencies_.assign(LATENCY_WINDOW, 0.0);
+    latencies_recorded_ = 0;
+    started_ = clock::now();
+  }
+  stop_ = false;
+  listen_fd_ = fd;
+  batcher_ = std::thread{&Server::_m_batch, this};
+  acceptor_ = std::thread{&Server::_m_accept, this};
+}
+
+auto Server::stop() -> void {
+  if (not is_running()) {
+    return;
+  }
+  {
+    auto lock = std::scoped_lock{mutex_};
+    stop_ = true;
+  }
+  cv_.notify_all();
+
+  // Shutting the sockets down wakes up the threads blocked on them.
+  ::shutdown(listen_fd_, SHUT_RDWR);
+  acceptor_.join();
+  // The batching thread drains the queue before returning, so no connection waits for a result forever.
+  batcher_.join();
+  {
+    auto lock = std::scoped_lock{connections_mutex_};
+    for (auto &connection : connections_) {
+      if (connection.fd >= 0) {
+        ::shutdown(connection.fd, SHUT_RDWR);
+      }
+    }
+  }
+  for (auto &connection : connections_) {
+    connection.thread.join();
+  }
+  connections_.clear();
+
+  {
+    auto lock = std::scoped_lock{statistics_mutex_};
+    statistics_.seconds = std::chrono::duration<f64>(clock::now() - started_).count();
+  }
+  ::close(listen_fd_);
+  listen_fd_ = -1;
+  ::unlink(config_.socket_path.c_str());
+}
+
+// /////////////////////////////////////////////
+// Client
+// /////////////////////////////////////////////
+
+Client::Client(const std::string &socket_path) {
+  auto address = make_address(socket_path, "cbx::serve::Client::Client");
+  fd_ = ::socket(AF_UNIX, SOCK_STREAM, 0);
+  if (fd_ < 0) {
+    throw SocketError{"cbx::serve::Client::Client: could not create a socket [{}]", std::strerror(errno)};
+  }
+  u32 sizes[2] = {};
+  if (::connect(fd_, reinterpret_cast<const sockaddr *>(&address), sizeof(address)) != 0) {
+    auto error = errno;
+    ::close(fd_);
+    throw SocketError{"cbx::serve::Client::Client: could not connect to '{}' [{}]", socket_path,
+                      std::strerror(error)};
+  }
+  if (not read_all(fd_, sizes, sizeof(sizes))) {
+    ::close(fd_);
+    throw SocketError{"cbx::serve::Client::Client: the server at '{}' closed the connection", socket_path};
+  }
+  input_size_ = sizes[0];
+  output_size_ = sizes[1];
+}
+
+Client::Client(Client &&other) noexcept
+    : fd_{std::exchange(other.fd_, -1)}, input_size_{other.input_size_}, output_size_{other.output_size_} {}
+
+Client::~Client() {
+  if (fd_ >= 0) {
+    ::close(fd_);
+  }
+}
+
+auto Client::operator=(Client &&other) noexcept -> Client & {
+  if (this != &other) {
+    if (fd_ >= 0) {
+      ::close(fd_);
+    }
+    fd_ = std::exchange(other.fd_, -1);
+    input_size_ = other.input_size_;
+    output_size_ = other.output_size_;
+  }
+  return *this;
+}
+
+auto Client::input_size() const noexcept -> size_type { return input_size_; }
+
+auto Client::output_size() const noexcept -> size_type { return output_size_; }
+
+auto Client::infer(const tensor_type &input) -> tensor_type {
+  auto samples = input_size_ == 0 ? size_type{} : input.total() / input_size_;
+  if (samples == 0 or samples * input_size_ != input.total() or samples > Server::MAX_REQUEST_SAMPLES) {
+    throw ShapeError{"cbx::serve::Client::infer: input = {} must hold between 1 and {} samples of {} values",
+                     input.shape().to_string(), Server::MAX_REQUEST_SAMPLES, input_size_};
+  }
+  auto header = u32(samples);
+  if (fd_ < 0 or not write_all(fd_, &header, sizeof(header)) or
+      not write_all(fd_, input.data(), input.total() * sizeof(value_type)) or
+      not read_all(fd_, &header, sizeof(header))) {
+    throw SocketError{"cbx::serve::Client::infer: the connection to the server is broken"};
+  }
+  if (header != samples) {
+    throw SocketError{"cbx::serve::Client::infer: the server failed the request"};
+  }
+  auto output = tensor_type::matrix(samples, output_size_);
+  if (not read_all(fd_, output.data(), output.total() * sizeof(value_type))) {
+    throw SocketError{"cbx::serve::Client::infer: the connection to the server is broken"};
+  }
+  return output;
+}
+
+}
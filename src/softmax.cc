@@ -19,8 +19,11 @@
 
 #include <algorithm>
 #include <numeric>
+#include <span>
 #include <utility>
 
+#include "cbrainx/vmath.hh"
+
 namespace cbx {
 
 // /////////////////////////////////////////////
@@ -48,12 +51,20 @@ auto Softmax::neurons() const -> size_type { return neurons_; }
 
 auto Softmax::parameters() const -> size_type { return {}; }
 
+auto Softmax::output_shape(const Shape &input_shape) const -> Shape { return input_shape; }
+
 auto Softmax::property() const -> std::string { return "-"; }
 
 auto Softmax::type() const -> LayerType { return LayerType::Softmax; }
 
 // /////////////////////////////////////////////
-// Informative
+// Utility
+// /////////////////////////////////////////////
+
+auto Softmax::clone() const -> std::shared_ptr<AbstractLayer> { return std::make_shared<Softmax>(*this); }
+
+// /////////////////////////////////////////////
+// Core Functionality
 // /////////////////////////////////////////////
 
 auto Softmax::forward_pass(const container &input) const -> const AbstractLayer & {
@@ -74,23 +85,54 @@ auto Softmax::forward_pass(const container &input) const -> const AbstractLayer
   // Applying forward pass and caching the input and output layers.
   input_ = input;
   output_ = input.zeros_like();
-  auto total = input.total();
+  infer(input_, output_);
+  return *this;
+}
+
+auto Softmax::apply(std::span<const value_type> x, std::span<value_type> y, size_type classes) -> void {
+  auto total = x.size();
   // Iterate along the y-axis.
-  for (size_type i = {}; i < total; i += neurons_) {
+  for (size_type i = {}; i < total; i += classes) {
     // Determine the boundaries of each sample.
-    auto in_begin = input.begin() + i;
-    auto in_end = in_begin + neurons_;
-    auto out_begin = output_.begin() + i;
-    // Accumulate inputs along the x-axis.
+    auto in_begin = x.begin() + i;
+    auto in_end = in_begin + classes;
+    auto out_begin = y.begin() + i;
+    auto out_end = out_begin + classes;
+    // Shift the inputs by their maximum so that the exponentials cannot overflow; the distribution is invariant
+    // under the shift.
+    auto max = *std::max_element(in_begin, in_end);
+    std::transform(in_begin, in_end, out_begin, [max](auto z) { return z - max; });
+    auto sample = y.subspan(i, classes);
+    vmath::exp(sample);
+    // Accumulate exponentials along the x-axis.
     // Formula: ⅀ [ʝ = 1, ƙ] ęᶽ
-    auto acc = std::accumulate(in_begin, in_end, 0.0F, [](auto acc, auto x) {
-      return acc + std::exp(x);
-    });
+    auto acc = std::accumulate(out_begin, out_end, 0.0F);
     // Calculate probability distributions.
     // Formula: ęᶼ / ⅀ [ʝ = 1, ƙ] ęᶽ
-    std::transform(in_begin, in_end, out_begin, [acc](auto x) {
-      return std::exp(x) / acc;
-    });
+    std::transform(out_begin, out_end, out_begin, [acc](auto e) { return e / acc; });
+  }
+}
+
+auto Softmax::infer(TensorView<const value_type> input, TensorView<value_type> output) const -> void {
+  apply({input.data(), input.total()}, {output.data(), output.total()}, neurons_);
+}
+
+auto Softmax::backward_pass(const container &output_gradient) const -> const AbstractLayer & {
+  // The Jacobian of the softmax function is ∂Ōὶ / ∂Ƶʝ = Ōὶ (δὶʝ - Ōʝ), so the product with the gradient
+  // collapses to a dot product per sample.
+  //
+  // Formula: ∂Ƶὶ = Ōὶ (∂Ōὶ - ⅀ [ʝ = 1, ƙ] ∂Ōʝ Ōʝ)
+  _m_check_output_gradient(output_gradient);
+  input_gradient_ = container{output_.shape()};
+  auto total = output_.total();
+  for (size_type i = {}; i < total; i += neurons_) {
+    auto y = output_.data() + i;
+    auto dy = output_gradient.data() + i;
+    auto dz = input_gradient_.data() + i;
+    auto dot = std::inner_product(dy, dy + neurons_, y, 0.0F);
+    for (size_type j = {}; j < neurons_; ++j) {
+      dz[j] = y[j] * (dy[j] - dot);
+    }
   }
   return *this;
 }
@@ -0,0 +1,203 @@
+// Copyright 2021 CBrainX
+// Project URL: https://github.com/mansoormemon/cbrainx
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Copyright (c) 2021 Mansoor Ahmed Memon <mansoorahmed.one@gmail.com>
+
+#include "cbrainx/threadPool.hh"
+
+#include <algorithm>
+#include <cstdlib>
+#include <exception>
+#include <string>
+#include <string_view>
+#include <utility>
+
+#include "cbrainx/numa.hh"
+
+namespace cbx {
+
+// /////////////////////////////////////////////
+// Implementation Detail
+// /////////////////////////////////////////////
+
+namespace {
+
+/// \brief Marks the worker threads of all pools, and a calling thread while it processes its own block.
+thread_local bool is_worker_thread = false;
+
+auto default_concurrency() -> usize {
+  if (auto env = std::getenv("CBRAINX_NUM_THREADS"); env != nullptr) {
+    try {
+      auto requested = std::stoul(env);
+      if (requested > 0) {
+        return requested;
+      }
+    } catch (const std::exception &) {
+      // An invalid value silently falls back to the hardware concurrency.
+    }
+  }
+  return std::max(std::thread::hardware_concurrency(), 1U);
+}
+
+auto default_pinning() -> bool {
+  auto env = std::getenv("CBRAINX_PIN_THREADS");
+  return env != nullptr and std::string_view{env} != "" and std::string_view{env} != "0";
+}
+
+}
+
+// /////////////////////////////////////////////
+// Helpers
+// /////////////////////////////////////////////
+
+auto ThreadPool::_m_work(size_type index) -> void {
+  is_worker_thread = true;
+  if (pinned_) {
+    // Worker `index` runs block `index + 1`; the first CPU is left to the calling thread, which runs block 0.
+    auto cpus = NumaTopology::system().cpus();
+    NumaTopology::pin_current_thread(cpus[(index + 1) % cpus.size()]);
+  }
+  auto &queue = queues_[index];
+  while (true) {
+    auto task = task_type{};
+    {
+      auto lock = std::unique_lock{mutex_};
+      cv_.wait(lock, [this, &queue] { return stop_ or not queue.empty(); });
+      if (queue.empty()) {
+        return;
+      }
+      task = std::move(queue.front());
+      queue.pop_front();
+    }
+    task();
+  }
+}
+
+auto ThreadPool::_m_submit(size_type index, task_type task) -> void {
+  {
+    auto lock = std::scoped_lock{mutex_};
+    queues_[index].push_back(std::move(task));
+  }
+  cv_.notify_all();
+}
+
+// /////////////////////////////////////////////
+// Constructors and Destructors
+// /////////////////////////////////////////////
+
+ThreadPool::ThreadPool(size_type workers, bool pinned) : queues_(workers), pinned_{pinned} {
+  workers_.reserve(workers);
+  for (size_type i = {}; i < workers; ++i) {
+    workers_.emplace_back(&ThreadPool::_m_work, this, i);
+  }
+}
+
+ThreadPool::~ThreadPool() {
+  {
+    auto lock = std::scoped_lock{mutex_};
+    stop_ = true;
+  }
+  cv_.notify_all();
+  for (auto &worker : workers_) {
+    worker.join();
+  }
+}
+
+// /////////////////////////////////////////////
+// Query Functions
+// /////////////////////////////////////////////
+
+auto ThreadPool::concurrency() const noexcept -> size_type { return workers_.size() + 1; }
+
+auto ThreadPool::is_worker() noexcept -> bool { return is_worker_thread; }
+
+auto ThreadPool::serialize_current_thread() noexcept -> void { is_worker_thread = true; }
+
+auto ThreadPool::is_pinned() const noexcept -> bool { return pinned_; }
+
+// /////////////////////////////////////////////
+// Core Functionality
+// /////////////////////////////////////////////
+
+auto ThreadPool::parallel_for(size_type begin, size_type end, size_type grain, const body_type &body) -> void {
+  if (begin >= end) {
+    return;
+  }
+  auto iterations = end - begin;
+  grain = std::max(grain, size_type{1});
+  auto blocks = std::min(concurrency(), (iterations + grain - 1) / grain);
+  // Nested loops and loops that are too small to be worth splitting are executed in place.
+  if (blocks <= 1 or is_worker()) {
+    body(begin, end);
+    return;
+  }
+
+  auto block_begin = [begin, iterations, blocks](size_type block) -> size_type {
+    return begin + block * iterations / blocks;
+  };
+
+  // The completion state lives on this stack frame; workers signal while holding the lock so that none of them
+  // touches it after this function has observed the final count.
+  auto mutex = std::mutex{};
+  auto cv = std::condition_variable{};
+  auto pending = blocks - 1;
+  auto error = std::exception_ptr{};
+  auto run_block = [&body, &block_begin](size_type block) -> std::exception_ptr {
+    try {
+      body(block_begin(block), block_begin(block + 1));
+    } catch (...) {
+      return std::current_exception();
+    }
+    return {};
+  };
+
+  for (size_type block = 1; block < blocks; ++block) {
+    _m_submit(block - 1, [&, block] {
+      auto block_error = run_block(block);
+      auto lock = std::scoped_lock{mutex};
+      if (block_error and not error) {
+        error = block_error;
+      }
+      --pending;
+      cv.notify_all();
+    });
+  }
+
+  // The calling thread acts as a worker for the duration of its block, so that loops nested in the body run
+  // serially on every block alike instead of queueing behind the busy workers.
+  auto was_worker = std::exchange(is_worker_thread, true);
+  auto block_error = run_block(0);
+  is_worker_thread = was_worker;
+  auto lock = std::unique_lock{mutex};
+  if (block_error and not error) {
+    error = block_error;
+  }
+  cv.wait(lock, [&pending] { return pending == 0; });
+
+  if (error) {
+    std::rethrow_exception(error);
+  }
+}
+
+// /////////////////////////////////////////////////////////////
+// Static Functions
+// /////////////////////////////////////////////////////////////
+
+auto ThreadPool::global() -> ThreadPool & {
+  static auto pool = ThreadPool{default_concurrency() - 1, default_pinning()};
+  return pool;
+}
+
+}
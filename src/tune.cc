@@ -0,0 +1,397 @@
+// Copyright 2021 CBrainX
+// Project URL: https://github.com/mansoormemon/cbrainx
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Copyright (c) 2021 Mansoor Ahmed Memon <mansoorahmed.one@gmail.com>
+#include "cbrainx/tune.hh"
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cctype>
+#include <chrono>
+#include <cstdlib>
+#include <deque>
+#include <filesystem>
+#include <fstream>
+#include <limits>
+#include <mutex>
+#include <optional>
+#include <random>
+#include <set>
+#include <sstream>
+#include <string_view>
+#include <vector>
+
+#include <fmt/format.h>
+
+#include "cbrainx/cpuFeatures.hh"
+#include "cbrainx/stopwatch.hh"
+#include "cbrainx/threadPool.hh"
+
+namespace cbx::tune {
+
+// /////////////////////////////////////////////
+// Implementation Detail
+// /////////////////////////////////////////////
+
+namespace {
+
+/// \brief Names of the size buckets of a dimension.
+constexpr auto BUCKET_NAMES = std::array{"xs", "s", "m", "l"};
+
+/// \brief Inclusive upper bounds of the size buckets, except for the last one, which is unbounded.
+constexpr auto BUCKET_LIMITS = std::array<usize, 3>{16, 128, 1024};
+
+/// \brief The size of a dimension that is benchmarked for each bucket.
+constexpr auto BUCKET_REPRESENTATIVES = std::array<usize, 4>{16, 96, 384, 1024};
+
+constexpr usize BUCKETS = BUCKET_NAMES.size();
+constexpr usize CLASSES = BUCKETS * BUCKETS * BUCKETS;
+
+/// \brief Minimum duration of a timed run, so that tiny problems are not dominated by timer resolution.
+constexpr auto MIN_RUN_NS = i64{2'000'000};
+
+constexpr usize TIMED_RUNS = 3;
+
+auto initial_auto_tuning() -> bool {
+  auto env = std::getenv("CBRAINX_AUTOTUNE");
+  return env != nullptr and std::string_view{env} == "1";
+}
+
+struct State {
+  std::mutex mutex = {};
+
+  /// \brief The distinct configurations ever published; they are never freed, so that a lookup racing with an
+  /// update still reads a valid configuration.
+  std::deque<GemmConfig> published = {};
+
+  /// \brief The configuration of each class, if known; they are read without holding the lock.
+  std::array<std::atomic<const GemmConfig *>, CLASSES> entries = {};
+
+  std::atomic<bool> loaded = {};
+  std::atomic<bool> auto_tuning = initial_auto_tuning();
+};
+
+auto state() -> State & {
+  static auto instance = State{};
+  return instance;
+}
+
+auto bucket(usize dimension) -> usize {
+  return std::ranges::distance(BUCKET_LIMITS.begin(), std::ranges::lower_bound(BUCKET_LIMITS, dimension));
+}
+
+auto class_id(usize m, usize n, usize k) -> usize {
+  return (bucket(m) * BUCKETS + bucket(n)) * BUCKETS + bucket(k);
+}
+
+auto class_name(usize id) -> std::string {
+  return fmt::format("{}-{}-{}", BUCKET_NAMES[id / (BUCKETS * BUCKETS)], BUCKET_NAMES[id / BUCKETS % BUCKETS],
+                     BUCKET_NAMES[id % BUCKETS]);
+}
+
+auto class_of_name(const std::string &name) -> std::optional<usize> {
+  for (usize id = {}; id < CLASSES; ++id) {
+    if (class_name(id) == name) {
+      return id;
+    }
+  }
+  return std::nullopt;
+}
+
+auto is_valid(const GemmConfig &config) -> bool {
+  auto kernels = gemm_microkernels();
+  return config.mc > 0 and config.kc > 0 and config.nc > 0 and
+         std::ranges::find(kernels, std::pair{config.mr, config.nr}) != kernels.end();
+}
+
+/// \brief Sets the configuration of a class; the caller must hold the lock.
+auto publish_locked(State &s, usize id, const GemmConfig &config) -> void {
+  auto entry = std::ranges::find(s.published, config);
+  const auto *stored = entry != s.published.end() ? &*entry : &s.published.emplace_back(config);
+  s.entries[id].store(stored, std::memory_order_release);
+}
+
+/// \brief Forgets the configurations of all classes; the caller must hold the lock.
+auto reset_locked(State &s) -> void {
+  for (auto &entry : s.entries) {
+    entry.store(nullptr, std::memory_order_release);
+  }
+}
+
+/// \brief Reads the entries of this machine; the caller must hold the lock.
+auto load_locked(State &s, const std::string &path) -> usize {
+  reset_locked(s);
+  auto file = std::ifstream{path};
+  auto machine = machine_key();
+  auto line = std::string{};
+  usize count = {};
+  while (std::getline(file, line)) {
+    if (line.empty() or line.front() == '#') {
+      continue;
+    }
+    auto stream = std::istringstream{line};
+    auto key = std::string{}, name = std::string{};
+    auto config = GemmConfig{};
+    if (not(stream >> key >> name >> config.mc >> config.kc >> config.nc >> config.mr >> config.nr >>
+            config.threads) or
+        key != machine) {
+      continue;
+    }
+    if (auto id = class_of_name(name); id and is_valid(config)) {
+      publish_locked(s, *id, config);
+      ++count;
+    }
+  }
+  s.loaded.store(true, std::memory_order_release);
+  return count;
+}
+
+/// \brief Returns the average duration of a product in nanoseconds.
+auto measure(const GemmConfig &config, const std::vector<f32> &a, const std::vector<f32> &b,
+             std::vector<f32> &c, usize m, usize n, usize k) -> f64 {
+  auto stopwatch = Stopwatch{};
+  stopwatch.start();
+  gemm(a.data(), b.data(), c.data(), m, n, k, config);
+  auto once = std::max(stopwatch.get_duration<std::chrono::nanoseconds>(), i64{1});
+  auto iterations = std::clamp(MIN_RUN_NS / once, i64{1}, i64{10'000});
+
+  auto best = std::numeric_limits<f64>::max();
+  for (usize run = {}; run < TIMED_RUNS; ++run) {
+    stopwatch.start();
+    for (i64 i = {}; i < iterations; ++i) {
+      gemm(a.data(), b.data(), c.data(), m, n, k, config);
+    }
+    best = std::min(best, f64(stopwatch.get_duration<std::chrono::nanoseconds>()) / f64(iterations));
+  }
+  return best;
+}
+
+auto round_up(usize value, usize multiple) -> usize { return (value + multiple - 1) / multiple * multiple; }
+
+}
+
+// /////////////////////////////////////////////
+// Query Functions
+// /////////////////////////////////////////////
+
+auto machine_key() -> std::string {
+  auto model = std::string{"unknown-cpu"};
+  auto cpuinfo = std::ifstream{"/proc/cpuinfo"};
+  for (auto line = std::string{}; std::getline(cpuinfo, line);) {
+    if (line.starts_with("model name")) {
+      if (auto colon = line.find(':'); colon != std::string::npos) {
+        model = line.substr(line.find_first_not_of(" \t", colon + 1));
+      }
+      break;
+    }
+  }
+  std::ranges::replace_if(model, [](auto ch) { return std::isspace(static_cast<unsigned char>(ch)); }, '_');
+  return fmt::format("{}/{}/t{}", model, CpuFeatures::to_string(CpuFeatures::active_isa()),
+                     ThreadPool::global().concurrency());
+}
+
+auto shape_class(usize m, usize n, usize k) -> std::string { return class_name(class_id(m, n, k)); }
+
+auto cache_path() -> std::string {
+  if (auto path = std::getenv("CBRAINX_TUNE_CACHE"); path != nullptr) {
+    return path;
+  }
+  if (auto xdg = std::getenv("XDG_CACHE_HOME"); xdg != nullptr and *xdg != '\0') {
+    return fmt::format("{}/cbrainx/gemm.tune", xdg);
+  }
+  if (auto home = std::getenv("HOME"); home != nullptr and *home != '\0') {
+    return fmt::format("{}/.cache/cbrainx/gemm.tune", home);
+  }
+  return {};
+}
+
+auto lookup(usize m, usize n, usize k) -> GemmConfig {
+  auto &s = state();
+  // Only the first lookup reads the cache file under the lock; hits merely load a pointer, so layers may look
+  // up their configuration on every call.
+  if (not s.loaded.load(std::memory_order_acquire)) {
+    auto lock = std::scoped_lock{s.mutex};
+    if (not s.loaded) {
+      load_locked(s, cache_path());
+    }
+  }
+  if (const auto *entry = s.entries[class_id(m, n, k)].load(std::memory_order_acquire)) {
+    return *entry;
+  }
+  if (not s.auto_tuning) {
+    return {};
+  }
+  auto config = tune(m, n, k);
+  if (auto path = cache_path(); not path.empty()) {
+    save(path);
+  }
+  return config;
+}
+
+// /////////////////////////////////////////////
+// Core Functionality
+// /////////////////////////////////////////////
+
+auto tune(usize m, usize n, usize k, const std::function<void(const std::string &)> &log) -> GemmConfig {
+  auto id = class_id(m, n, k);
+  auto rm = BUCKET_REPRESENTATIVES[bucket(m)];
+  auto rn = BUCKET_REPRESENTATIVES[bucket(n)];
+  auto rk = BUCKET_REPRESENTATIVES[bucket(k)];
+
+  auto engine = std::mt19937{1U};
+  auto distribution = std::uniform_real_distribution<f32>{-1, 1};
+  auto a = std::vector<f32>(rm * rk), b = std::vector<f32>(rk * rn), c = std::vector<f32>(rm * rn);
+  std::ranges::generate(a, [&] { return distribution(engine); });
+  std::ranges::generate(b, [&] { return distribution(engine); });
+
+  auto flops = 2.0 * f64(rm) * f64(rn) * f64(rk);
+  auto best = GemmConfig{};
+  auto best_ns = std::numeric_limits<f64>::max();
+  auto tried = std::set<std::string>{};
+  auto consider = [&](GemmConfig candidate) {
+    // Blocks larger than the problem behave like blocks of the size of the problem.
+    candidate.mc = std::min(candidate.mc, round_up(rm, candidate.mr));
+    candidate.nc = std::min(candidate.nc, round_up(rn, candidate.nr));
+    candidate.kc = std::min(candidate.kc, rk);
+    if (not tried.insert(candidate.to_string()).second) {
+      return;
+    }
+    auto ns = measure(candidate, a, b, c, rm, rn, rk);
+    if (log) {
+      log(fmt::format("{} [{}x{}x{}] {}: {:.2f} GFLOP/s", class_name(id), rm, rn, rk, candidate.to_string(),
+                      flops / ns));
+    }
+    if (ns < best_ns) {
+      best_ns = ns;
+      best = candidate;
+    }
+  };
+
+  // A coordinate search, one group of parameters at a time, keeps the number of candidates manageable.
+  for (auto [mr, nr] : gemm_microkernels()) {
+    auto candidate = best;
+    candidate.mr = mr;
+    candidate.nr = nr;
+    consider(candidate);
+  }
+  for (usize mc : {48, 96, 192, 384}) {
+    for (usize kc : {128, 256, 512}) {
+      auto candidate = best;
+      candidate.mc = mc;
+      candidate.kc = kc;
+      consider(candidate);
+    }
+  }
+  for (usize nc : {512, 2048, 8192}) {
+    auto candidate = best;
+    candidate.nc = nc;
+    consider(candidate);
+  }
+  auto concurrency = ThreadPool::global().concurrency();
+  for (auto threads : {usize{1}, concurrency / 4, concurrency / 2, concurrency}) {
+    if (threads > 0) {
+      auto candidate = best;
+      candidate.threads = threads;
+      consider(candidate);
+    }
+  }
+
+  auto &s = state();
+  auto lock = std::scoped_lock{s.mutex};
+  publish_locked(s, id, best);
+  s.loaded.store(true, std::memory_order_release);
+  return best;
+}
+
+auto tune_all(const std::function<void(const std::string &)> &log) -> void {
+  for (usize id = {}; id < CLASSES; ++id) {
+    tune(BUCKET_REPRESENTATIVES[id / (BUCKETS * BUCKETS)], BUCKET_REPRESENTATIVES[id / BUCKETS % BUCKETS],
+         BUCKET_REPRESENTATIVES[id % BUCKETS], log);
+  }
+}
+
+// /////////////////////////////////////////////
+// Persistence
+// /////////////////////////////////////////////
+
+auto load(const std::string &path) -> usize {
+  auto &s = state();
+  auto lock = std::scoped_lock{s.mutex};
+  return load_locked(s, path);
+}
+
+auto save(const std::string &path) -> bool {
+  namespace fs = std::filesystem;
+
+  auto machine = machine_key();
+  // Entries of other machines are carried over verbatim.
+  auto lines = std::vector<std::string>{};
+  {
+    auto file = std::ifstream{path};
+    for (auto line = std::string{}; std::getline(file, line);) {
+      if (not line.empty() and line.front() != '#' and not line.starts_with(machine + ' ')) {
+        lines.push_back(line);
+      }
+    }
+  }
+  {
+    auto &s = state();
+    auto lock = std::scoped_lock{s.mutex};
+    for (usize id = {}; id < CLASSES; ++id) {
+      if (const auto *entry = s.entries[id].load()) {
+        lines.push_back(fmt::format("{} {} {} {} {} {} {} {}", machine, class_name(id), entry->mc, entry->kc,
+                                    entry->nc, entry->mr, entry->nr, entry->threads));
+      }
+    }
+  }
+
+  auto error = std::error_code{};
+  auto target = fs::path{path};
+  if (target.has_parent_path()) {
+    fs::create_directories(target.parent_path(), error);
+  }
+  // Write to a temporary file first so that concurrent readers never observe a partial table.
+  auto temporary = fs::path{path + ".tmp"};
+  {
+    auto file = std::ofstream{temporary, std::ios::trunc};
+    file << "# cbrainx gemm tuning cache\n# <machine> <class> <mc> <kc> <nc> <mr> <nr> <threads>\n";
+    for (const auto &line : lines) {
+      file << line << '\n';
+    }
+    if (not file.flush()) {
+      return false;
+    }
+  }
+  fs::rename(temporary, target, error);
+  return not error;
+}
+
+auto clear() -> void {
+  auto &s = state();
+  auto lock = std::scoped_lock{s.mutex};
+  reset_locked(s);
+  s.loaded.store(true, std::memory_order_release);
+}
+
+// /////////////////////////////////////////////
+// Modifiers
+// /////////////////////////////////////////////
+
+auto set_auto_tuning(bool enabled) -> void { state().auto_tuning = enabled; }
+
+auto is_auto_tuning() -> bool { return state().auto_tuning; }
+
+}
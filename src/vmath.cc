@@ -0,0 +1,210 @@
+// Copyright 2021 CBrainX
+// Project URL: https://github.com/mansoormemon/cbrainx
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Copyright (c) 2021 Mansoor Ahmed Memon <mansoorahmed.one@gmail.com>
+
+#include "cbrainx/vmath.hh"
+
+#include <bit>
+#include <cmath>
+
+#include "cbrainx/cpuFeatures.hh"
+#include "cbrainx/exceptions.hh"
+#include "vmathKernels.hh"
+
+namespace cbx::vmath {
+
+// /////////////////////////////////////////////
+// Implementation Detail
+// /////////////////////////////////////////////
+
+namespace _detail {
+
+namespace {
+
+/// \brief Scalar traits for the portable kernels.
+struct Generic {
+  using vec = f32;
+  using mask = bool;
+
+  static constexpr usize width = 1;
+
+  static constexpr usize registers = 16;
+
+  static auto load(const f32 *ptr) -> vec { return *ptr; }
+
+  static auto store(f32 *ptr, vec a) -> void { *ptr = a; }
+
+  static auto set1(f32 value) -> vec { return value; }
+
+  static auto add(vec a, vec b) -> vec { return a + b; }
+
+  static auto sub(vec a, vec b) -> vec { return a - b; }
+
+  static auto mul(vec a, vec b) -> vec { return a * b; }
+
+  static auto div(vec a, vec b) -> vec { return a / b; }
+
+  static auto fma(vec a, vec b, vec c) -> vec {
+#ifdef FP_FAST_FMAF
+    return std::fma(a, b, c);
+#else
+    return a * b + c;
+#endif
+  }
+
+  static auto min(vec a, vec b) -> vec { return b < a ? b : a; }
+
+  static auto max(vec a, vec b) -> vec { return a < b ? b : a; }
+
+  static auto abs(vec a) -> vec { return std::fabs(a); }
+
+  static auto sqrt(vec a) -> vec { return std::sqrt(a); }
+
+  static auto copysign(vec magnitude, vec sign) -> vec { return std::copysign(magnitude, sign); }
+
+  static auto round(vec a) -> vec {
+    // Adding and subtracting 1.5 ⋅ 2²³ rounds to the nearest integer without a library call; the kernels only
+    // round values far below 2²², for which the trick is exact.
+    constexpr auto MAGIC = 12582912.0F;
+    return (a + MAGIC) - MAGIC;
+  }
+
+  static auto lt(vec a, vec b) -> mask { return a < b; }
+
+  static auto gt(vec a, vec b) -> mask { return a > b; }
+
+  static auto ge(vec a, vec b) -> mask { return a >= b; }
+
+  static auto is_nan(vec a) -> mask { return a != a; }
+
+  static auto select(mask m, vec a, vec b) -> vec { return m ? a : b; }
+
+  static auto ldexp2(vec x, vec n) -> vec {
+    auto ni = i32(n);
+    auto n1 = ni >> 1;
+    auto n2 = ni - n1;
+    return x * std::bit_cast<f32>((n1 + 127) << 23) * std::bit_cast<f32>((n2 + 127) << 23);
+  }
+
+  static auto frexp(vec x, vec &e) -> vec {
+    auto bits = std::bit_cast<u32>(x);
+    e = f32(i32(bits >> 23) - 126);
+    return std::bit_cast<f32>((bits & 0x007FFFFFU) | 0x3F000000U);
+  }
+};
+
+}
+
+auto generic_kernels() -> const KernelTable & {
+  static constexpr auto table = make_kernel_table<Generic>();
+  return table;
+}
+
+}
+
+auto _detail::active_kernels() -> const KernelTable & {
+#if defined(CBRAINX_X86_SIMD)
+  switch (CpuFeatures::active_isa()) {
+    case ISA::AVX512: {
+      return avx512_kernels();
+    }
+    case ISA::AVX2: {
+      return avx2_kernels();
+    }
+    default: {
+      break;
+    }
+  }
+#endif
+  return generic_kernels();
+}
+
+namespace {
+
+auto kernels() -> const _detail::KernelTable & { return _detail::active_kernels(); }
+
+auto check_sizes(str caller, std::span<const f32> x, std::span<f32> y) -> void {
+  if (x.size() != y.size()) {
+    throw ShapeError{"cbx::vmath::{}: x [size = {}] and y [size = {}] must be of the same size", caller,
+                     x.size(), y.size()};
+  }
+}
+
+}
+
+// /////////////////////////////////////////////
+// Core Functionality
+// /////////////////////////////////////////////
+
+auto exp(std::span<const f32> x, std::span<f32> y) -> void {
+  check_sizes("exp", x, y);
+  kernels().exp(x.data(), y.data(), x.size());
+}
+
+auto log(std::span<const f32> x, std::span<f32> y) -> void {
+  check_sizes("log", x, y);
+  kernels().log(x.data(), y.data(), x.size());
+}
+
+auto tanh(std::span<const f32> x, std::span<f32> y) -> void {
+  check_sizes("tanh", x, y);
+  kernels().tanh(x.data(), y.data(), x.size());
+}
+
+auto sigmoid(std::span<const f32> x, std::span<f32> y) -> void {
+  check_sizes("sigmoid", x, y);
+  kernels().sigmoid(x.data(), y.data(), x.size());
+}
+
+auto erf(std::span<const f32> x, std::span<f32> y) -> void {
+  check_sizes("erf", x, y);
+  kernels().erf(x.data(), y.data(), x.size());
+}
+
+auto exp(std::span<f32> x) -> void { kernels().exp(x.data(), x.data(), x.size()); }
+
+auto log(std::span<f32> x) -> void { kernels().log(x.data(), x.data(), x.size()); }
+
+auto tanh(std::span<f32> x) -> void { kernels().tanh(x.data(), x.data(), x.size()); }
+
+auto sigmoid(std::span<f32> x) -> void { kernels().sigmoid(x.data(), x.data(), x.size()); }
+
+auto erf(std::span<f32> x) -> void { kernels().erf(x.data(), x.data(), x.size()); }
+
+auto gemv(std::span<const f32> x, const f32 *w, usize ldw, std::span<f32> y) -> void {
+  if (ldw < y.size()) {
+    throw ValueError{"cbx::vmath::gemv: ldw = {} must not be less than y.size() = {}", ldw, y.size()};
+  }
+  kernels().gemv(x.data(), w, ldw, y.data(), x.size(), y.size());
+}
+
+auto axpy(f32 a, std::span<const f32> x, std::span<f32> y) -> void {
+  check_sizes("axpy", x, y);
+  kernels().axpy(a, x.data(), y.data(), x.size());
+}
+
+auto maximum(std::span<const f32> x, std::span<f32> y) -> void {
+  check_sizes("maximum", x, y);
+  kernels().maximum(x.data(), y.data(), nullptr, {}, x.size());
+}
+
+auto maximum(std::span<const f32> x, std::span<f32> y, std::span<f32> index, f32 position) -> void {
+  check_sizes("maximum", x, y);
+  check_sizes("maximum", x, index);
+  kernels().maximum(x.data(), y.data(), index.data(), position, x.size());
+}
+
+}
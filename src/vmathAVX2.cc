@@ -0,0 +1,103 @@
+// Copyright 2021 CBrainX
+// Project URL: https://github.com/mansoormemon/cbrainx
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Copyright (c) 2021 Mansoor Ahmed Memon <mansoorahmed.one@gmail.com>
+
+// This translation unit must be compiled with AVX2 and FMA enabled (see `src/CMakeLists.txt`).
+
+#include <immintrin.h>
+
+#include "vmathKernels.hh"
+
+namespace cbx::vmath::_detail {
+
+namespace {
+
+/// \brief SIMD traits for 256-bit AVX2 registers.
+struct AVX2 {
+  using vec = __m256;
+  using mask = __m256;
+
+  static constexpr usize width = 8;
+
+  static constexpr usize registers = 16;
+
+  static auto load(const f32 *ptr) -> vec { return _mm256_loadu_ps(ptr); }
+
+  static auto store(f32 *ptr, vec a) -> void { _mm256_storeu_ps(ptr, a); }
+
+  static auto set1(f32 value) -> vec { return _mm256_set1_ps(value); }
+
+  static auto add(vec a, vec b) -> vec { return _mm256_add_ps(a, b); }
+
+  static auto sub(vec a, vec b) -> vec { return _mm256_sub_ps(a, b); }
+
+  static auto mul(vec a, vec b) -> vec { return _mm256_mul_ps(a, b); }
+
+  static auto div(vec a, vec b) -> vec { return _mm256_div_ps(a, b); }
+
+  static auto fma(vec a, vec b, vec c) -> vec { return _mm256_fmadd_ps(a, b, c); }
+
+  static auto min(vec a, vec b) -> vec { return _mm256_min_ps(a, b); }
+
+  static auto max(vec a, vec b) -> vec { return _mm256_max_ps(a, b); }
+
+  static auto abs(vec a) -> vec { return _mm256_andnot_ps(_mm256_set1_ps(-0.0F), a); }
+
+  static auto sqrt(vec a) -> vec { return _mm256_sqrt_ps(a); }
+
+  static auto copysign(vec magnitude, vec sign) -> vec {
+    auto sign_mask = _mm256_set1_ps(-0.0F);
+    return _mm256_or_ps(_mm256_andnot_ps(sign_mask, magnitude), _mm256_and_ps(sign_mask, sign));
+  }
+
+  static auto round(vec a) -> vec { return _mm256_round_ps(a, _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC); }
+
+  static auto lt(vec a, vec b) -> mask { return _mm256_cmp_ps(a, b, _CMP_LT_OQ); }
+
+  static auto gt(vec a, vec b) -> mask { return _mm256_cmp_ps(a, b, _CMP_GT_OQ); }
+
+  static auto ge(vec a, vec b) -> mask { return _mm256_cmp_ps(a, b, _CMP_GE_OQ); }
+
+  static auto is_nan(vec a) -> mask { return _mm256_cmp_ps(a, a, _CMP_UNORD_Q); }
+
+  static auto select(mask m, vec a, vec b) -> vec { return _mm256_blendv_ps(b, a, m); }
+
+  static auto ldexp2(vec x, vec n) -> vec {
+    auto ni = _mm256_cvtps_epi32(n);
+    auto n1 = _mm256_srai_epi32(ni, 1);
+    auto n2 = _mm256_sub_epi32(ni, n1);
+    auto bias = _mm256_set1_epi32(127);
+    auto p1 = _mm256_castsi256_ps(_mm256_slli_epi32(_mm256_add_epi32(n1, bias), 23));
+    auto p2 = _mm256_castsi256_ps(_mm256_slli_epi32(_mm256_add_epi32(n2, bias), 23));
+    return _mm256_mul_ps(_mm256_mul_ps(x, p1), p2);
+  }
+
+  static auto frexp(vec x, vec &e) -> vec {
+    auto bits = _mm256_castps_si256(x);
+    e = _mm256_cvtepi32_ps(_mm256_sub_epi32(_mm256_srli_epi32(bits, 23), _mm256_set1_epi32(126)));
+    auto mantissa = _mm256_and_si256(bits, _mm256_set1_epi32(0x007FFFFF));
+    return _mm256_castsi256_ps(_mm256_or_si256(mantissa, _mm256_set1_epi32(0x3F000000)));
+  }
+};
+
+}
+
+auto avx2_kernels() -> const KernelTable & {
+  static constexpr auto table = make_kernel_table<AVX2>();
+  return table;
+}
+
+}
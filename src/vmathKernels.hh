@@ -0,0 +1,646 @@
+// Copyright 2021 CBrainX
+// Project URL: https://github.com/mansoormemon/cbrainx
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Copyright (c) 2021 Mansoor Ahmed Memon <mansoorahmed.one@gmail.com>
+
+// This is a private header shared by the translation units implementing `cbx::vmath`. Each translation unit is
+// compiled for a different instruction set and instantiates the kernels below with its own SIMD traits. The
+// kernels are defined in an anonymous namespace on purpose, so that every instantiation is local to the
+// translation unit that was compiled with the matching compiler flags.
+//
+// A SIMD trait `V` must provide the following members.
+//
+//  vec, mask, width                      - Register types and the number of lanes.
+//  registers                             - The number of architectural vector registers.
+//  load, store, set1                     - Unaligned memory access and broadcasting.
+//  add, sub, mul, div, fma, min, max     - Arithmetic, where fma(a, b, c) = a * b + c.
+//  abs, copysign, round                  - Sign manipulation and rounding to the nearest integer.
+//  sqrt                                  - Correctly rounded square root.
+//  lt, gt, ge, is_nan, select            - Comparisons and blending, where select(m, a, b) = m ? a : b.
+//  ldexp2(x, n)                          - x * 2ⁿ for integral n in [-252, 254].
+//  frexp(x, e)                           - The mantissa in [0.5, 1) and the exponent (as a float) of x > 0.
+
+#ifndef CBRAINX__VMATH_KERNELS_HH_
+#define CBRAINX__VMATH_KERNELS_HH_
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <limits>
+#include <utility>
+
+#include "cbrainx/typeAliases.hh"
+
+namespace cbx::vmath::_detail {
+
+/// \brief Hyperparameters of the fused parameter updates; each kernel reads only the fields it needs.
+struct UpdateParams {
+  f32 learning_rate = {};
+
+  /// \brief Decay of the first moment (momentum).
+  f32 beta1 = {};
+
+  /// \brief Decay of the second moment.
+  f32 beta2 = {};
+
+  f32 epsilon = {};
+
+  /// \brief Coefficient of the L2 penalty, which is added to the gradient.
+  f32 weight_decay = {};
+
+  /// \brief Multiplier applied to the parameters before the update, i.e., 1 - lr ⋅ λ for decoupled decay.
+  f32 shrink = 1;
+
+  /// \brief Reciprocals of the bias corrections 1 - β₁ᵗ and 1 - β₂ᵗ.
+  f32 correction1 = 1;
+  f32 correction2 = 1;
+};
+
+/// \brief The register tiles (`mr`, `nr`) of the GEMM microkernels, in the order of their table entries.
+inline constexpr auto GEMM_TILES = std::array<std::pair<usize, usize>, 5>{
+    {{4, 8}, {4, 16}, {6, 16}, {8, 8}, {8, 16}}};
+
+/// \brief A table of kernels compiled for a specific instruction set.
+struct KernelTable {
+  using kernel_type = void (*)(const f32 *, f32 *, usize);
+
+  kernel_type exp = {};
+  kernel_type log = {};
+  kernel_type tanh = {};
+  kernel_type sigmoid = {};
+  kernel_type erf = {};
+
+  using gemv_type = void (*)(const f32 *, const f32 *, usize, f32 *, usize, usize);
+
+  gemv_type gemv = {};
+
+  using axpy_type = void (*)(f32, const f32 *, f32 *, usize);
+
+  axpy_type axpy = {};
+
+  /// \brief A running maximum over `n` elements that optionally records the position at which it was attained.
+  using maximum_type = void (*)(const f32 *, f32 *, f32 *, f32, usize);
+
+  maximum_type maximum = {};
+
+  /// \brief A fused parameter update over `n` elements, given the parameters, their gradients and up to two
+  /// state buffers of the optimizer.
+  using update_type = void (*)(f32 *, const f32 *, f32 *, f32 *, usize, const UpdateParams &);
+
+  update_type sgd = {};
+  update_type momentum = {};
+  update_type adam = {};
+  update_type rmsprop = {};
+
+  /// \brief A register-blocked GEMM microkernel over packed slivers (see `cbx::gemm`), given the depth, the
+  /// slivers of A and B, the tile of C with its row stride and the numbers of valid rows and columns.
+  using microkernel_type = void (*)(usize, const f32 *, const f32 *, f32 *, usize, usize, usize);
+
+  std::array<microkernel_type, GEMM_TILES.size()> microkernels = {};
+
+  /// \brief The index of the largest tile of `GEMM_TILES` whose accumulators fit in registers.
+  usize preferred_tile = {};
+};
+
+auto generic_kernels() -> const KernelTable &;
+
+auto avx2_kernels() -> const KernelTable &;
+
+auto avx512_kernels() -> const KernelTable &;
+
+/// \brief Returns the kernels for the instruction set selected by `CpuFeatures`.
+auto active_kernels() -> const KernelTable &;
+
+namespace {
+
+// /////////////////////////////////////////////
+// Constants
+// /////////////////////////////////////////////
+
+// Range reduction for `exp` (Cody-Waite splitting of ln(2)).
+constexpr f32 EXP_HI = 88.7228394F;    // ln(FLT_MAX)
+constexpr f32 EXP_LO = -87.3365479F;   // ln(FLT_MIN)
+constexpr f32 LOG2E = 1.44269504F;
+constexpr f32 LN2_HI = 0.693359375F;
+constexpr f32 LN2_LO = -2.12194440e-4F;
+
+// Minimax polynomial for eʳ on [-ln(2) / 2, ln(2) / 2] (Cephes).
+constexpr f32 EXP_P0 = 1.9875691500e-4F;
+constexpr f32 EXP_P1 = 1.3981999507e-3F;
+constexpr f32 EXP_P2 = 8.3334519073e-3F;
+constexpr f32 EXP_P3 = 4.1665795894e-2F;
+constexpr f32 EXP_P4 = 1.6666665459e-1F;
+constexpr f32 EXP_P5 = 5.0000001201e-1F;
+
+// Minimax polynomial for ln(1 + m) on [√½ - 1, √2 - 1] (Cephes).
+constexpr f32 SQRT_HALF = 0.707106781F;
+constexpr f32 LOG_P0 = 7.0376836292e-2F;
+constexpr f32 LOG_P1 = -1.1514610310e-1F;
+constexpr f32 LOG_P2 = 1.1676998740e-1F;
+constexpr f32 LOG_P3 = -1.2420140846e-1F;
+constexpr f32 LOG_P4 = 1.4249322787e-1F;
+constexpr f32 LOG_P5 = -1.6668057665e-1F;
+constexpr f32 LOG_P6 = 2.0000714765e-1F;
+constexpr f32 LOG_P7 = -2.4999993993e-1F;
+constexpr f32 LOG_P8 = 3.3333331174e-1F;
+
+// Minimax polynomial for tanh(x) on |x| < 0.625 (Cephes).
+constexpr f32 TANH_THRESHOLD = 0.625F;
+constexpr f32 TANH_P0 = -5.70498872745e-3F;
+constexpr f32 TANH_P1 = 2.06390887954e-2F;
+constexpr f32 TANH_P2 = -5.37397155531e-2F;
+constexpr f32 TANH_P3 = 1.33314422036e-1F;
+constexpr f32 TANH_P4 = -3.33332819422e-1F;
+
+// Least-squares fits (relative error) for erf(x) = x + x ⋅ P(x²) on |x| < 1 and for erfc(x) = e⁻ˣ² ⋅ Q(1 / x)
+// on 1 ≤ |x| < 3.92. Beyond 3.92, erfc(x) is less than half an ULP of 1.
+constexpr f32 ERF_THRESHOLD = 1.0F;
+constexpr f32 ERF_SATURATION = 3.92F;
+constexpr f32 ERF_P0 = 7.84725926e-05F;
+constexpr f32 ERF_P1 = -8.00818903e-04F;
+constexpr f32 ERF_P2 = 5.18809911e-03F;
+constexpr f32 ERF_P3 = -2.68536918e-02F;
+constexpr f32 ERF_P4 = 1.12835824e-01F;
+constexpr f32 ERF_P5 = -3.76126260e-01F;
+constexpr f32 ERF_P6 = 1.28379166e-01F;
+constexpr f32 ERF_Q0 = 7.27258779e-03F;
+constexpr f32 ERF_Q1 = -6.12749127e-02F;
+constexpr f32 ERF_Q2 = 2.31399851e-01F;
+constexpr f32 ERF_Q3 = -5.11515982e-01F;
+constexpr f32 ERF_Q4 = 7.11873921e-01F;
+constexpr f32 ERF_Q5 = -5.79286498e-01F;
+constexpr f32 ERF_Q6 = 7.50778644e-02F;
+constexpr f32 ERF_Q7 = 5.53344574e-01F;
+constexpr f32 ERF_Q8 = 6.92170184e-04F;
+
+constexpr f32 INF = std::numeric_limits<f32>::infinity();
+constexpr f32 QNAN = std::numeric_limits<f32>::quiet_NaN();
+constexpr f32 DENORM_BOUND = std::numeric_limits<f32>::min();
+constexpr f32 DENORM_SCALE = 33554432.0F;    // 2²⁵
+
+// /////////////////////////////////////////////
+// Kernels
+// /////////////////////////////////////////////
+
+template <typename V>
+inline auto exp_v(typename V::vec x) -> typename V::vec {
+  // Algorithm: eˣ = 2ⁿ ⋅ eʳ, where n = round(x / ln(2)) and r = x - n ⋅ ln(2) ∈ [-ln(2) / 2, ln(2) / 2].
+  auto xc = V::min(V::max(x, V::set1(EXP_LO)), V::set1(EXP_HI));
+  auto n = V::round(V::mul(xc, V::set1(LOG2E)));
+  auto r = V::fma(n, V::set1(-LN2_HI), xc);
+  r = V::fma(n, V::set1(-LN2_LO), r);
+
+  auto p = V::set1(EXP_P0);
+  p = V::fma(p, r, V::set1(EXP_P1));
+  p = V::fma(p, r, V::set1(EXP_P2));
+  p = V::fma(p, r, V::set1(EXP_P3));
+  p = V::fma(p, r, V::set1(EXP_P4));
+  p = V::fma(p, r, V::set1(EXP_P5));
+  auto y = V::add(V::fma(p, V::mul(r, r), r), V::set1(1.0F));
+  y = V::ldexp2(y, n);
+
+  y = V::select(V::gt(x, V::set1(EXP_HI)), V::set1(INF), y);
+  y = V::select(V::lt(x, V::set1(EXP_LO)), V::set1(0.0F), y);
+  return V::select(V::is_nan(x), x, y);
+}
+
+template <typename V>
+inline auto log_v(typename V::vec x) -> typename V::vec {
+  // Algorithm: ln(x) = ln(m) + e ⋅ ln(2), where x = m ⋅ 2ᵉ and m ∈ [√½, √2).
+  auto is_denormal = V::lt(x, V::set1(DENORM_BOUND));
+  auto xs = V::select(is_denormal, V::mul(x, V::set1(DENORM_SCALE)), x);
+  auto e = typename V::vec{};
+  auto m = V::frexp(xs, e);
+  e = V::select(is_denormal, V::sub(e, V::set1(25.0F)), e);
+
+  auto is_small = V::lt(m, V::set1(SQRT_HALF));
+  e = V::select(is_small, V::sub(e, V::set1(1.0F)), e);
+  m = V::sub(V::select(is_small, V::add(m, m), m), V::set1(1.0F));
+
+  auto z = V::mul(m, m);
+  auto p = V::set1(LOG_P0);
+  p = V::fma(p, m, V::set1(LOG_P1));
+  p = V::fma(p, m, V::set1(LOG_P2));
+  p = V::fma(p, m, V::set1(LOG_P3));
+  p = V::fma(p, m, V::set1(LOG_P4));
+  p = V::fma(p, m, V::set1(LOG_P5));
+  p = V::fma(p, m, V::set1(LOG_P6));
+  p = V::fma(p, m, V::set1(LOG_P7));
+  p = V::fma(p, m, V::set1(LOG_P8));
+  auto y = V::mul(V::mul(p, m), z);
+  y = V::fma(e, V::set1(LN2_LO), y);
+  y = V::fma(z, V::set1(-0.5F), y);
+  y = V::fma(e, V::set1(LN2_HI), V::add(m, y));
+
+  y = V::select(V::ge(x, V::set1(INF)), V::set1(INF), y);
+  y = V::select(V::lt(x, V::set1(0.0F)), V::set1(QNAN), y);
+  y = V::select(V::is_nan(x), x, y);
+  // Comparisons are false for NaNs, so zero is checked last without disturbing the propagation.
+  return V::select(V::ge(V::set1(0.0F), V::abs(x)), V::set1(-INF), y);
+}
+
+template <typename V>
+inline auto tanh_v(typename V::vec x) -> typename V::vec {
+  // Algorithm:
+  //  |x| < 0.625  => tanh(x) = x + x³ ⋅ P(x²)
+  //  |x| ≥ 0.625  => tanh(x) = sign(x) ⋅ (1 - 2 / (e²ˣ + 1))
+  auto a = V::abs(x);
+
+  auto z = V::mul(x, x);
+  auto p = V::set1(TANH_P0);
+  p = V::fma(p, z, V::set1(TANH_P1));
+  p = V::fma(p, z, V::set1(TANH_P2));
+  p = V::fma(p, z, V::set1(TANH_P3));
+  p = V::fma(p, z, V::set1(TANH_P4));
+  auto small = V::fma(V::mul(p, z), x, x);
+
+  auto e = exp_v<V>(V::add(a, a));
+  auto large = V::sub(V::set1(1.0F), V::div(V::set1(2.0F), V::add(e, V::set1(1.0F))));
+
+  // The sign is restored at the end so that signed zeros are preserved as well.
+  return V::copysign(V::select(V::lt(a, V::set1(TANH_THRESHOLD)), small, large), x);
+}
+
+template <typename V>
+inline auto sigmoid_v(typename V::vec x) -> typename V::vec {
+  // Formula: σ(x) = 1 / (1 + e⁻ˣ)
+  //
+  // The exponential is evaluated at -|x| so that it never overflows, and negative inputs use the equivalent
+  // form eˣ / (1 + eˣ), which needs a single division in either case.
+  auto e = exp_v<V>(V::sub(V::set1(0.0F), V::abs(x)));
+  auto numerator = V::select(V::lt(x, V::set1(0.0F)), e, V::set1(1.0F));
+  return V::div(numerator, V::add(V::set1(1.0F), e));
+}
+
+template <typename V>
+inline auto erf_v(typename V::vec x) -> typename V::vec {
+  // Algorithm:
+  //  |x| < 1         => erf(x) = x + x ⋅ P(x²)
+  //  1 ≤ |x| < 3.92  => erf(x) = sign(x) ⋅ (1 - e⁻ˣ² ⋅ Q(1 / |x|))
+  //  |x| ≥ 3.92      => erf(x) = sign(x)
+  auto a = V::abs(x);
+
+  auto t = V::mul(x, x);
+  auto p = V::set1(ERF_P0);
+  p = V::fma(p, t, V::set1(ERF_P1));
+  p = V::fma(p, t, V::set1(ERF_P2));
+  p = V::fma(p, t, V::set1(ERF_P3));
+  p = V::fma(p, t, V::set1(ERF_P4));
+  p = V::fma(p, t, V::set1(ERF_P5));
+  p = V::fma(p, t, V::set1(ERF_P6));
+  auto small = V::fma(x, p, x);
+
+  auto u = V::div(V::set1(1.0F), a);
+  auto q = V::set1(ERF_Q0);
+  q = V::fma(q, u, V::set1(ERF_Q1));
+  q = V::fma(q, u, V::set1(ERF_Q2));
+  q = V::fma(q, u, V::set1(ERF_Q3));
+  q = V::fma(q, u, V::set1(ERF_Q4));
+  q = V::fma(q, u, V::set1(ERF_Q5));
+  q = V::fma(q, u, V::set1(ERF_Q6));
+  q = V::fma(q, u, V::set1(ERF_Q7));
+  q = V::fma(q, u, V::set1(ERF_Q8));
+  // The rounding error of x² is recovered with an FMA and applied as a first-order correction to e⁻ˣ².
+  auto hi = V::mul(a, a);
+  auto lo = V::fma(a, a, V::sub(V::set1(0.0F), hi));
+  auto e = exp_v<V>(V::sub(V::set1(0.0F), hi));
+  e = V::fma(V::sub(V::set1(0.0F), lo), e, e);
+  auto large = V::fma(V::sub(V::set1(0.0F), e), q, V::set1(1.0F));
+  large = V::select(V::ge(a, V::set1(ERF_SATURATION)), V::set1(1.0F), large);
+  large = V::copysign(large, x);
+
+  return V::select(V::lt(a, V::set1(ERF_THRESHOLD)), small, large);
+}
+
+// /////////////////////////////////////////////
+// Drivers
+// /////////////////////////////////////////////
+
+template <typename V, auto F>
+auto run(const f32 *x, f32 *y, usize n) -> void {
+  usize i = {};
+  for (; i + V::width <= n; i += V::width) {
+    V::store(y + i, F(V::load(x + i)));
+  }
+  // The remainder is staged through a zero-padded buffer to avoid reading past the end of the input.
+  if (i < n) {
+    alignas(64) f32 buffer[V::width] = {};
+    std::copy(x + i, x + n, buffer);
+    V::store(buffer, F(V::load(buffer)));
+    std::copy(buffer, buffer + (n - i), y + i);
+  }
+}
+
+/// \brief Accumulates `y += xᵀ × W` for a row-major `k × n` matrix `W` with a row stride of `ldw`.
+///
+/// \details
+/// The matrix is streamed once, four rows at a time, so that every pass over `y` retires four multiply-adds per
+/// element and the loads of `W` form four sequential streams.
+template <typename V>
+auto gemv(const f32 *x, const f32 *w, usize ldw, f32 *y, usize k, usize n) -> void {
+  usize p = {};
+  for (; p + 4 <= k; p += 4) {
+    auto w0 = w + p * ldw, w1 = w0 + ldw, w2 = w1 + ldw, w3 = w2 + ldw;
+    auto x0 = V::set1(x[p]), x1 = V::set1(x[p + 1]), x2 = V::set1(x[p + 2]), x3 = V::set1(x[p + 3]);
+    usize j = {};
+    for (; j + V::width <= n; j += V::width) {
+      auto acc = V::fma(x0, V::load(w0 + j), V::load(y + j));
+      acc = V::fma(x1, V::load(w1 + j), acc);
+      acc = V::fma(x2, V::load(w2 + j), acc);
+      acc = V::fma(x3, V::load(w3 + j), acc);
+      V::store(y + j, acc);
+    }
+    for (; j < n; ++j) {
+      y[j] += x[p] * w0[j] + x[p + 1] * w1[j] + x[p + 2] * w2[j] + x[p + 3] * w3[j];
+    }
+  }
+  for (; p < k; ++p) {
+    auto row = w + p * ldw;
+    auto xp = V::set1(x[p]);
+    usize j = {};
+    for (; j + V::width <= n; j += V::width) {
+      V::store(y + j, V::fma(xp, V::load(row + j), V::load(y + j)));
+    }
+    for (; j < n; ++j) {
+      y[j] += x[p] * row[j];
+    }
+  }
+}
+
+// /////////////////////////////////////////////
+// Accumulation
+// /////////////////////////////////////////////
+
+// Formula: y = y + a ⋅ x
+template <typename V>
+auto axpy(f32 a, const f32 *x, f32 *y, usize n) -> void {
+  auto a_v = V::set1(a);
+  usize i = {};
+  for (; i + V::width <= n; i += V::width) {
+    V::store(y + i, V::fma(a_v, V::load(x + i), V::load(y + i)));
+  }
+  for (; i < n; ++i) {
+    y[i] += a * x[i];
+  }
+}
+
+// Formula: y = max(y, x), and index = position wherever x > y
+template <typename V>
+auto maximum(const f32 *x, f32 *y, f32 *index, f32 position, usize n) -> void {
+  usize i = {};
+  if (index == nullptr) {
+    for (; i + V::width <= n; i += V::width) {
+      V::store(y + i, V::max(V::load(y + i), V::load(x + i)));
+    }
+    for (; i < n; ++i) {
+      y[i] = std::max(y[i], x[i]);
+    }
+    return;
+  }
+  auto position_v = V::set1(position);
+  for (; i + V::width <= n; i += V::width) {
+    auto x_v = V::load(x + i);
+    auto y_v = V::load(y + i);
+    // Ties keep the earlier position.
+    auto greater = V::gt(x_v, y_v);
+    V::store(y + i, V::select(greater, x_v, y_v));
+    V::store(index + i, V::select(greater, position_v, V::load(index + i)));
+  }
+  for (; i < n; ++i) {
+    if (x[i] > y[i]) {
+      y[i] = x[i];
+      index[i] = position;
+    }
+  }
+}
+
+// /////////////////////////////////////////////
+// Parameter Updates
+// /////////////////////////////////////////////
+
+/// \brief The hyperparameters broadcast to registers once per call.
+template <typename V>
+struct UpdateConstants {
+  typename V::vec learning_rate, beta1, one_minus_beta1, beta2, one_minus_beta2, epsilon, weight_decay, shrink,
+      correction1, correction2;
+
+  explicit UpdateConstants(const UpdateParams &h)
+      : learning_rate{V::set1(h.learning_rate)},
+        beta1{V::set1(h.beta1)},
+        one_minus_beta1{V::set1(1 - h.beta1)},
+        beta2{V::set1(h.beta2)},
+        one_minus_beta2{V::set1(1 - h.beta2)},
+        epsilon{V::set1(h.epsilon)},
+        weight_decay{V::set1(h.weight_decay)},
+        shrink{V::set1(h.shrink)},
+        correction1{V::set1(h.correction1)},
+        correction2{V::set1(h.correction2)} {}
+};
+
+// Formula: θ = θ - η ⋅ (g + λθ)
+template <typename V>
+auto sgd_v(typename V::vec &p, typename V::vec g, typename V::vec *, const UpdateConstants<V> &c) -> void {
+  g = V::fma(c.weight_decay, p, g);
+  p = V::sub(p, V::mul(c.learning_rate, g));
+}
+
+// Formula: v = μv + (g + λθ), θ = θ - η ⋅ v
+template <typename V>
+auto momentum_v(typename V::vec &p, typename V::vec g, typename V::vec *s, const UpdateConstants<V> &c)
+    -> void {
+  g = V::fma(c.weight_decay, p, g);
+  s[0] = V::fma(c.beta1, s[0], g);
+  p = V::sub(p, V::mul(c.learning_rate, s[0]));
+}
+
+// Formula: m = β₁m + (1 - β₁)g, v = β₂v + (1 - β₂)g², θ = sθ - η ⋅ m̂ / (√v̂ + ε)
+template <typename V>
+auto adam_v(typename V::vec &p, typename V::vec g, typename V::vec *s, const UpdateConstants<V> &c) -> void {
+  g = V::fma(c.weight_decay, p, g);
+  s[0] = V::fma(c.beta1, s[0], V::mul(c.one_minus_beta1, g));
+  s[1] = V::fma(c.beta2, s[1], V::mul(c.one_minus_beta2, V::mul(g, g)));
+  auto m_hat = V::mul(s[0], c.correction1);
+  auto v_hat = V::mul(s[1], c.correction2);
+  auto step = V::div(m_hat, V::add(V::sqrt(v_hat), c.epsilon));
+  p = V::sub(V::mul(c.shrink, p), V::mul(c.learning_rate, step));
+}
+
+// Formula: v = βv + (1 - β)g², θ = θ - η ⋅ g / (√v + ε)
+template <typename V>
+auto rmsprop_v(typename V::vec &p, typename V::vec g, typename V::vec *s, const UpdateConstants<V> &c) -> void {
+  g = V::fma(c.weight_decay, p, g);
+  s[0] = V::fma(c.beta2, s[0], V::mul(c.one_minus_beta2, V::mul(g, g)));
+  p = V::sub(p, V::mul(c.learning_rate, V::div(g, V::add(V::sqrt(s[0]), c.epsilon))));
+}
+
+/// \brief Streams the parameters, gradients and `SLOTS` state buffers once, updating them in place.
+template <typename V, usize SLOTS, auto F>
+auto update(f32 *p, const f32 *g, f32 *s1, f32 *s2, usize n, const UpdateParams &h) -> void {
+  auto c = UpdateConstants<V>{h};
+  f32 *state[] = {s1, s2};
+  typename V::vec s[2] = {};
+  usize i = {};
+  for (; i + V::width <= n; i += V::width) {
+    auto p_v = V::load(p + i);
+    for (usize k = {}; k < SLOTS; ++k) {
+      s[k] = V::load(state[k] + i);
+    }
+    F(p_v, V::load(g + i), s, c);
+    V::store(p + i, p_v);
+    for (usize k = {}; k < SLOTS; ++k) {
+      V::store(state[k] + i, s[k]);
+    }
+  }
+  // The remainder is staged through zero-padded buffers, like in `run`.
+  if (i < n) {
+    auto rest = n - i;
+    alignas(64) f32 buffers[2 + SLOTS][V::width] = {};
+    std::copy(p + i, p + n, buffers[0]);
+    std::copy(g + i, g + n, buffers[1]);
+    for (usize k = {}; k < SLOTS; ++k) {
+      std::copy(state[k] + i, state[k] + n, buffers[2 + k]);
+      s[k] = V::load(buffers[2 + k]);
+    }
+    auto p_v = V::load(buffers[0]);
+    F(p_v, V::load(buffers[1]), s, c);
+    V::store(buffers[0], p_v);
+    std::copy(buffers[0], buffers[0] + rest, p + i);
+    for (usize k = {}; k < SLOTS; ++k) {
+      V::store(buffers[2 + k], s[k]);
+      std::copy(buffers[2 + k], buffers[2 + k] + rest, state[k] + i);
+    }
+  }
+}
+
+// /////////////////////////////////////////////
+// Matrix Multiplication
+// /////////////////////////////////////////////
+
+/// \brief Multiplies an `MR × kc` packed sliver of A with a `kc × NR` packed sliver of B into a tile of C.
+///
+/// \details
+/// The tile is held in `MR × NR / width` vector registers for the whole depth; every step loads one row of the
+/// B sliver and broadcasts each element of the A column against it. Partial tiles at the edges of C are staged
+/// through a zero-padded buffer, so that only the top-left `rows × cols` part of the tile is read and written.
+///
+/// Tiles narrower than a register fall back to scalar code. Either way every element accumulates its terms in
+/// ascending order of depth with the multiply-add of the instruction set, so the result does not depend on the
+/// tile.
+template <typename V, usize MR, usize NR>
+auto microkernel(usize kc, const f32 *ap, const f32 *bp, f32 *c, usize ldc, usize rows, usize cols) -> void {
+  if constexpr (NR % V::width != 0) {
+    f32 acc[MR][NR] = {};
+    for (usize i = {}; i < rows; ++i) {
+      std::copy(c + i * ldc, c + i * ldc + cols, acc[i]);
+    }
+    for (usize p = {}; p < kc; ++p) {
+      for (usize i = {}; i < MR; ++i) {
+        for (usize j = {}; j < NR; ++j) {
+          acc[i][j] = std::fma(ap[p * MR + i], bp[p * NR + j], acc[i][j]);
+        }
+      }
+    }
+    for (usize i = {}; i < rows; ++i) {
+      std::copy(acc[i], acc[i] + cols, c + i * ldc);
+    }
+  } else {
+    constexpr auto LANES = NR / V::width;
+    auto full = rows == MR and cols == NR;
+    alignas(64) f32 staged[MR][NR] = {};
+    if (not full) {
+      for (usize i = {}; i < rows; ++i) {
+        std::copy(c + i * ldc, c + i * ldc + cols, staged[i]);
+      }
+    }
+    auto tile = full ? c : &staged[0][0];
+    auto ld = full ? ldc : NR;
+
+    typename V::vec acc[MR][LANES];
+    for (usize i = {}; i < MR; ++i) {
+      for (usize l = {}; l < LANES; ++l) {
+        acc[i][l] = V::load(tile + i * ld + l * V::width);
+      }
+    }
+    for (usize p = {}; p < kc; ++p) {
+      typename V::vec b[LANES];
+      for (usize l = {}; l < LANES; ++l) {
+        b[l] = V::load(bp + p * NR + l * V::width);
+      }
+      for (usize i = {}; i < MR; ++i) {
+        auto a = V::set1(ap[p * MR + i]);
+        for (usize l = {}; l < LANES; ++l) {
+          acc[i][l] = V::fma(a, b[l], acc[i][l]);
+        }
+      }
+    }
+    for (usize i = {}; i < MR; ++i) {
+      for (usize l = {}; l < LANES; ++l) {
+        V::store(tile + i * ld + l * V::width, acc[i][l]);
+      }
+    }
+    if (not full) {
+      for (usize i = {}; i < rows; ++i) {
+        std::copy(staged[i], staged[i] + cols, c + i * ldc);
+      }
+    }
+  }
+}
+
+/// \brief Returns the microkernels of all tiles in `GEMM_TILES`.
+template <typename V, usize... I>
+constexpr auto make_microkernels(std::index_sequence<I...>)
+    -> std::array<KernelTable::microkernel_type, sizeof...(I)> {
+  return {microkernel<V, GEMM_TILES[I].first, GEMM_TILES[I].second>...};
+}
+
+/// \brief Returns the index of the largest tile whose accumulators, one row of the B sliver and a broadcast
+/// element of A fit in the vector registers, or of the first tile if none fits.
+template <typename V>
+constexpr auto preferred_tile() -> usize {
+  usize preferred = {}, area = {};
+  for (usize i = {}; i < GEMM_TILES.size(); ++i) {
+    auto [mr, nr] = GEMM_TILES[i];
+    auto lanes = nr / V::width;
+    if (nr % V::width == 0 and mr * lanes + lanes + 1 <= V::registers and mr * nr > area) {
+      preferred = i;
+      area = mr * nr;
+    }
+  }
+  return preferred;
+}
+
+template <typename V>
+constexpr auto make_kernel_table() -> KernelTable {
+  return {run<V, exp_v<V>>,
+          run<V, log_v<V>>,
+          run<V, tanh_v<V>>,
+          run<V, sigmoid_v<V>>,
+          run<V, erf_v<V>>,
+          gemv<V>,
+          axpy<V>,
+          maximum<V>,
+          update<V, 0, sgd_v<V>>,
+          update<V, 1, momentum_v<V>>,
+          update<V, 2, adam_v<V>>,
+          update<V, 1, rmsprop_v<V>>,
+          make_microkernels<V>(std::make_index_sequence<GEMM_TILES.size()>{}),
+          preferred_tile<V>()};
+}
+
+}
+
+}
+
+#endif
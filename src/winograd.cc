@@ -0,0 +1,301 @@
+// Copyright 2021 CBrainX
+// Project URL: https://github.com/mansoormemon/cbrainx
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Copyright (c) 2021 Mansoor Ahmed Memon <mansoorahmed.one@gmail.com>
+#include "winograd.hh"
+
+#include <algorithm>
+#include <array>
+#include <cstring>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include "cbrainx/gemm.hh"
+#include "cbrainx/threadPool.hh"
+#include "cbrainx/tune.hh"
+
+namespace cbx::_detail {
+
+// /////////////////////////////////////////////
+// Implementation Detail
+// /////////////////////////////////////////////
+
+namespace {
+
+/// \brief Number of elements of the transformed input of a chunk of tiles, sized to stay within the L2 cache.
+constexpr usize CHUNK_ELEMENTS = 1 << 16;
+
+/// \brief Number of transformed filters kept around.
+constexpr usize FILTER_CACHE_SIZE = 8;
+
+constexpr usize R = 3;
+
+/// \brief Transformation matrices of F(m x m, 3 x 3) with tiles of `T = m + 2` pixels, after Lavin and Gray.
+template <usize M>
+struct Transform;
+
+template <>
+struct Transform<2> {
+  static constexpr usize T = 4;
+  static constexpr f32 BT[T][T] = {{1, 0, -1, 0}, {0, 1, 1, 0}, {0, -1, 1, 0}, {0, 1, 0, -1}};
+  static constexpr f32 G[T][R] = {{1, 0, 0}, {0.5F, 0.5F, 0.5F}, {0.5F, -0.5F, 0.5F}, {0, 0, 1}};
+  static constexpr f32 AT[2][T] = {{1, 1, 1, 0}, {0, 1, -1, -1}};
+};
+
+template <>
+struct Transform<4> {
+  static constexpr usize T = 6;
+  static constexpr f32 BT[T][T] = {{4, 0, -5, 0, 1, 0},  {0, -4, -4, 1, 1, 0}, {0, 4, -4, -1, 1, 0},
+                                   {0, -2, -1, 2, 1, 0}, {0, 2, -1, -2, 1, 0}, {0, 4, 0, -5, 0, 1}};
+  static constexpr f32 G[T][R] = {{1.0F / 4, 0, 0},
+                                  {-1.0F / 6, -1.0F / 6, -1.0F / 6},
+                                  {-1.0F / 6, 1.0F / 6, -1.0F / 6},
+                                  {1.0F / 24, 1.0F / 12, 1.0F / 6},
+                                  {1.0F / 24, -1.0F / 12, 1.0F / 6},
+                                  {0, 0, 1}};
+  static constexpr f32 AT[4][T] = {
+      {1, 1, 1, 1, 1, 0}, {0, 1, -1, 2, -2, 0}, {0, 1, 1, 4, 4, 0}, {0, 1, -1, 8, -8, 1}};
+};
+
+/// \brief Computes `X Y Zᵀ` for small dense matrices.
+template <usize P, usize Q, usize S, usize U>
+auto sandwich(const f32 (&x)[P][Q], const f32 (&y)[Q][S], const f32 (&z)[U][S], f32 (&out)[P][U]) -> void {
+  f32 xy[P][S] = {};
+  for (usize i = {}; i < P; ++i) {
+    for (usize k = {}; k < Q; ++k) {
+      for (usize j = {}; j < S; ++j) {
+        xy[i][j] += x[i][k] * y[k][j];
+      }
+    }
+  }
+  for (usize i = {}; i < P; ++i) {
+    for (usize j = {}; j < U; ++j) {
+      f32 sum = {};
+      for (usize k = {}; k < S; ++k) {
+        sum += xy[i][k] * z[j][k];
+      }
+      out[i][j] = sum;
+    }
+  }
+}
+
+/// \brief Transforms the filters into `T × T` matrices of shape (channels, filters), i.e., `U = G g Gᵀ`.
+template <usize M>
+auto transform_filters(const Tensor<f32> &kernel) -> std::vector<f32> {
+  using W = Transform<M>;
+  constexpr auto T = W::T;
+  auto channels = kernel.shape()[2], filters = kernel.shape()[3];
+  auto transformed = std::vector<f32>(T * T * channels * filters);
+  auto plane = channels * filters;
+  ThreadPool::global().parallel_for(0, plane, 1024, [&](usize first, usize last) {
+    for (auto cf = first; cf < last; ++cf) {
+      f32 g[R][R];
+      for (usize i = {}; i < R; ++i) {
+        for (usize j = {}; j < R; ++j) {
+          g[i][j] = kernel[(i * R + j) * plane + cf];
+        }
+      }
+      f32 u[T][T];
+      sandwich(W::G, g, W::G, u);
+      for (usize i = {}; i < T; ++i) {
+        for (usize j = {}; j < T; ++j) {
+          transformed[(i * T + j) * plane + cf] = u[i][j];
+        }
+      }
+    }
+  });
+  return transformed;
+}
+
+/// \brief A small cache of transformed filters.
+///
+/// \details
+/// Entries are keyed by the address, the shape and a checksum of the contents of the kernel, so that weights
+/// updated in place are never served stale. Computing the checksum is far cheaper than the transformation.
+class FilterCache {
+ public:
+  using value_type = std::shared_ptr<const std::vector<f32>>;
+
+ private:
+  struct Entry {
+    const f32 *address;
+    Shape shape;
+    u64 checksum;
+    usize m;
+    value_type filters;
+  };
+
+  std::mutex mutex_ = {};
+  std::list<Entry> entries_ = {};
+
+  static auto _s_checksum(const Tensor<f32> &kernel) -> u64 {
+    // FNV-1a over the bit patterns of the weights.
+    auto hash = u64{14695981039346656037ULL};
+    for (auto weight : kernel) {
+      u32 bits;
+      std::memcpy(&bits, &weight, sizeof(bits));
+      hash = (hash ^ bits) * 1099511628211ULL;
+    }
+    return hash;
+  }
+
+ public:
+  template <usize M>
+  auto get(const Tensor<f32> &kernel) -> value_type {
+    auto checksum = _s_checksum(kernel);
+    {
+      auto lock = std::scoped_lock{mutex_};
+      for (auto it = entries_.begin(); it != entries_.end(); ++it) {
+        if (it->address == kernel.data() and it->shape == kernel.shape() and it->checksum == checksum and
+            it->m == M) {
+          // Move the hit to the front so that the least recently used entry is evicted first.
+          entries_.splice(entries_.begin(), entries_, it);
+          return it->filters;
+        }
+      }
+    }
+    auto filters = std::make_shared<const std::vector<f32>>(transform_filters<M>(kernel));
+    auto lock = std::scoped_lock{mutex_};
+    entries_.push_front({kernel.data(), kernel.shape(), checksum, M, filters});
+    if (entries_.size() > FILTER_CACHE_SIZE) {
+      entries_.pop_back();
+    }
+    return filters;
+  }
+
+  static auto global() -> FilterCache & {
+    static auto cache = FilterCache{};
+    return cache;
+  }
+};
+
+template <usize M>
+auto convolve(TensorView<const f32> input, const Tensor<f32> &kernel, const Conv2DParams &params,
+              TensorView<f32> result, const GemmEpilogue &epilogue) -> void {
+  using W = Transform<M>;
+  constexpr auto T = W::T;
+
+  auto [batch, height, width, channels] = input.shape().template unwrap<4>();
+  auto out_height = result.shape()[1], out_width = result.shape()[2], filters = result.shape()[3];
+  auto tiles_h = (out_height + M - 1) / M, tiles_w = (out_width + M - 1) / M;
+  auto tiles = batch * tiles_h * tiles_w;
+
+  auto u = FilterCache::global().get<M>(kernel);
+
+  // Tiles are processed in chunks; each chunk transforms its input, runs one multiplication per position of
+  // the tile, i.e., (tiles, channels) x (channels, filters), and transforms the products back.
+  auto chunk = std::max(CHUNK_ELEMENTS / (T * T * channels), usize{1});
+  auto chunks = (tiles + chunk - 1) / chunk;
+  auto config = tune::lookup(std::min(chunk, tiles), filters, channels);
+  if (chunks > 1) {
+    config.threads = 1;
+  }
+
+  ThreadPool::global().parallel_for(0, chunks, 1, [&](usize first_chunk, usize last_chunk) {
+    auto capacity = std::min(chunk, tiles);
+    auto v = std::vector<f32>(T * T * capacity * channels);
+    auto products = std::vector<f32>(T * T * capacity * filters);
+    for (auto c = first_chunk; c < last_chunk; ++c) {
+      auto first = c * chunk;
+      auto count = std::min(chunk, tiles - first);
+
+      // Input transform: V = Bᵀ d B for every tile and channel.
+      for (usize p = {}; p < count; ++p) {
+        auto tile = first + p;
+        auto n = tile / (tiles_h * tiles_w);
+        auto row = tile / tiles_w % tiles_h * M;
+        auto col = tile % tiles_w * M;
+        auto image = input.data() + n * height * width * channels;
+        for (usize ch = {}; ch < channels; ++ch) {
+          f32 d[T][T];
+          for (usize i = {}; i < T; ++i) {
+            // Coordinates are shifted by the padding so that they stay unsigned.
+            auto ih = row + i;
+            for (usize j = {}; j < T; ++j) {
+              auto iw = col + j;
+              auto inside = ih >= params.padding_h and ih - params.padding_h < height and
+                            iw >= params.padding_w and iw - params.padding_w < width;
+              d[i][j] = inside
+                            ? image[((ih - params.padding_h) * width + (iw - params.padding_w)) * channels + ch]
+                            : f32{};
+            }
+          }
+          f32 transformed[T][T];
+          sandwich(W::BT, d, W::BT, transformed);
+          for (usize i = {}; i < T; ++i) {
+            for (usize j = {}; j < T; ++j) {
+              v[((i * T + j) * count + p) * channels + ch] = transformed[i][j];
+            }
+          }
+        }
+      }
+
+      // Element-wise stage, batched into one multiplication per position of the tile.
+      std::fill_n(products.begin(), T * T * count * filters, f32{});
+      for (usize position = {}; position < T * T; ++position) {
+        gemm(v.data() + position * count * channels, u->data() + position * channels * filters,
+             products.data() + position * count * filters, count, filters, channels, config);
+      }
+
+      // Output transform: Y = Aᵀ M A, cropped at the bottom and right edges.
+      for (usize p = {}; p < count; ++p) {
+        auto tile = first + p;
+        auto n = tile / (tiles_h * tiles_w);
+        auto row = tile / tiles_w % tiles_h * M;
+        auto col = tile % tiles_w * M;
+        for (usize f = {}; f < filters; ++f) {
+          f32 m[T][T];
+          for (usize i = {}; i < T; ++i) {
+            for (usize j = {}; j < T; ++j) {
+              m[i][j] = products[((i * T + j) * count + p) * filters + f];
+            }
+          }
+          f32 y[M][M];
+          sandwich(W::AT, m, W::AT, y);
+          for (usize i = {}; i < M and row + i < out_height; ++i) {
+            for (usize j = {}; j < M and col + j < out_width; ++j) {
+              result[((n * out_height + row + i) * out_width + col + j) * filters + f] = y[i][j];
+            }
+          }
+        }
+        if (epilogue) {
+          auto cols = std::min(M, out_width - col);
+          for (usize i = {}; i < M and row + i < out_height; ++i) {
+            epilogue((n * out_height + row + i) * out_width + col, 0, cols, filters);
+          }
+        }
+      }
+    }
+  });
+}
+
+}
+
+// /////////////////////////////////////////////
+// Core Functionality
+// /////////////////////////////////////////////
+
+auto winograd_conv2d(TensorView<const f32> input, const Tensor<f32> &kernel, const Conv2DParams &params,
+                     usize m, TensorView<f32> result, const GemmEpilogue &epilogue) -> void {
+  if (m == 2) {
+    convolve<2>(input, kernel, params, result, epilogue);
+  } else {
+    convolve<4>(input, kernel, params, result, epilogue);
+  }
+}
+
+}
@@ -0,0 +1,43 @@
+// Copyright 2021 CBrainX
+// Project URL: https://github.com/mansoormemon/cbrainx
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Copyright (c) 2021 Mansoor Ahmed Memon <mansoorahmed.one@gmail.com>
+// This is a private header declaring the Winograd kernels used by `conv2d`.
+
+#ifndef CBRAINX__WINOGRAD_HH_
+#define CBRAINX__WINOGRAD_HH_
+
+#include "cbrainx/convolution.hh"
+#include "cbrainx/gemm.hh"
+#include "cbrainx/tensor.hh"
+#include "cbrainx/tensorView.hh"
+#include "cbrainx/typeAliases.hh"
+
+namespace cbx::_detail {
+
+/// \brief Computes a 3x3, unit-stride, undilated convolution with the Winograd algorithm F(m x m, 3 x 3).
+/// \param[in] input The input of shape (batch, height, width, channels).
+/// \param[in] kernel The filters of shape (3, 3, channels, filters).
+/// \param[in] params The geometry of the convolution; only the padding is taken into account.
+/// \param[in] m The size of the output tiles, either 2 or 4.
+/// \param[out] result The result of shape (batch, output height, output width, filters).
+/// \param[in] epilogue The callback invoked on each row of an output tile once it is final, if any (see
+/// `conv2d`).
+auto winograd_conv2d(TensorView<const f32> input, const Tensor<f32> &kernel, const Conv2DParams &params,
+                     usize m, TensorView<f32> result, const GemmEpilogue &epilogue) -> void;
+
+}
+
+#endif
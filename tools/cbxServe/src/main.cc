@@ -0,0 +1,177 @@
+// Copyright 2021 CBrainX
+// Project URL: https://github.com/mansoormemon/cbrainx
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Copyright (c) 2021 Mansoor Ahmed Memon <mansoorahmed.one@gmail.com>
+// Goal: Serve a network over a Unix domain socket with dynamic batching.
+//
+// Usage:
+//   cbxServe --socket PATH [--model PATH | [--input N] [--dense N]...] [--max-batch N] [--max-wait-us N]
+//            [--report SECONDS] [--bench CLIENTS REQUESTS]
+//
+// The network is loaded from `--model` if given. Otherwise, it maps `--input` values through the given dense
+// layers, with ReLU in between and a softmax at the end, and is initialized randomly. The server runs until
+// interrupted and prints its statistics periodically.
+// With `--bench`, the server is instead exercised by local clients sending single-sample requests, each answer
+// is checked against local inference, and the statistics are printed once all clients are done.
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <csignal>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <cbrainx/cbrainx.hh>
+#include <fmt/format.h>
+
+auto print_usage() -> void {
+  std::cerr << "usage: cbxServe --socket PATH [--model PATH | [--input N] [--dense N]...] [--max-batch N] "
+               "[--max-wait-us N] [--report SECONDS] [--bench CLIENTS REQUESTS]"
+            << std::endl;
+}
+
+auto bench(cbx::serve::Server &server, cbx::NeuralNet &net, cbx::usize clients, cbx::usize requests) -> int {
+  auto mismatches = std::atomic<cbx::usize>{};
+  auto failures = std::atomic<cbx::usize>{};
+  auto threads = std::vector<std::thread>{};
+  for (cbx::usize c = {}; c < clients; ++c) {
+    threads.emplace_back([&, c] {
+      try {
+        auto client = cbx::serve::Client{server.config().socket_path};
+        auto context = cbx::ExecutionContext{};
+        for (cbx::usize r = {}; r < requests; ++r) {
+          auto input = cbx::Tensor<cbx::f32>::random({1, client.input_size()}, c * requests + r, -1, 1);
+          auto output = client.infer(input);
+          auto expected = net.infer(input, context);
+          // Batched and single-sample inference may round differently.
+          for (cbx::usize i = {}; i < output.total(); ++i) {
+            if (std::fabs(output[i] - expected[i]) > 1e-5F) {
+              ++mismatches;
+              break;
+            }
+          }
+        }
+      } catch (const std::exception &error) {
+        std::cerr << "cbxServe: client " << c << ": " << error.what() << std::endl;
+        ++failures;
+      }
+    });
+  }
+  for (auto &thread : threads) {
+    thread.join();
+  }
+  server.stop();
+  fmt::print("{}mismatches = {}, failed clients = {}\n", server.statistics().to_string(), mismatches.load(),
+             failures.load());
+  return mismatches == 0 and failures == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+auto main(int argc, char *argv[]) -> int {
+  auto config = cbx::serve::ServerConfig{};
+  auto model = std::string{};
+  auto input = cbx::usize{784};
+  auto layers = std::vector<cbx::usize>{};
+  auto report = cbx::usize{10};
+  auto clients = cbx::usize{}, requests = cbx::usize{};
+
+  try {
+    for (int i = 1; i < argc; ++i) {
+      auto arg = std::string{argv[i]};
+      if (arg == "--socket" and i + 1 < argc) {
+        config.socket_path = argv[++i];
+      } else if (arg == "--model" and i + 1 < argc) {
+        model = argv[++i];
+      } else if (arg == "--input" and i + 1 < argc) {
+        input = std::stoul(argv[++i]);
+      } else if (arg == "--dense" and i + 1 < argc) {
+        layers.push_back(std::stoul(argv[++i]));
+      } else if (arg == "--max-batch" and i + 1 < argc) {
+        config.max_batch_size = std::stoul(argv[++i]);
+      } else if (arg == "--max-wait-us" and i + 1 < argc) {
+        config.max_wait = std::chrono::microseconds{std::stol(argv[++i])};
+      } else if (arg == "--report" and i + 1 < argc) {
+        report = std::max(std::stoul(argv[++i]), 1UL);
+      } else if (arg == "--bench" and i + 2 < argc) {
+        clients = std::stoul(argv[i + 1]);
+        requests = std::stoul(argv[i + 2]);
+        i += 2;
+      } else {
+        print_usage();
+        return EXIT_FAILURE;
+      }
+    }
+  } catch (const std::exception &) {
+    print_usage();
+    return EXIT_FAILURE;
+  }
+
+  if (config.socket_path.empty()) {
+    print_usage();
+    return EXIT_FAILURE;
+  }
+  if (layers.empty()) {
+    layers = {128, 10};
+  }
+
+  auto net = cbx::NeuralNet{{input}};
+  if (not model.empty()) {
+    try {
+      net = cbx::NeuralNet::load(model);
+    } catch (const std::exception &error) {
+      std::cerr << "cbxServe: " << error.what() << std::endl;
+      return EXIT_FAILURE;
+    }
+  } else {
+    for (cbx::usize i = {}; i < layers.size(); ++i) {
+      net.add<cbx::DenseLayer>(layers[i]);
+      if (i + 1 < layers.size()) {
+        net.add<cbx::ActivationLayer>(cbx::Activation::ReLU);
+      }
+    }
+    net.add<cbx::Softmax>();
+  }
+
+  // The signals are blocked before any thread is started, so that only `sigtimedwait` below receives them.
+  auto signals = sigset_t{};
+  sigemptyset(&signals);
+  sigaddset(&signals, SIGINT);
+  sigaddset(&signals, SIGTERM);
+  pthread_sigmask(SIG_BLOCK, &signals, nullptr);
+
+  try {
+    auto server = cbx::serve::Server{net, config};
+    server.start();
+    fmt::print("serving {} -> {} on {} [max batch size = {}, max wait = {}us]\n", server.input_size(),
+               server.output_size(), config.socket_path, config.max_batch_size, config.max_wait.count());
+    if (clients > 0) {
+      return bench(server, net, clients, requests);
+    }
+
+    auto timeout = timespec{static_cast<time_t>(report), 0};
+    while (sigtimedwait(&signals, nullptr, &timeout) < 0) {
+      fmt::print("{}\n", server.statistics().to_string());
+    }
+    server.stop();
+    fmt::print("{}", server.statistics().to_string());
+  } catch (const std::exception &error) {
+    std::cerr << "cbxServe: " << error.what() << std::endl;
+    return EXIT_FAILURE;
+  }
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,106 @@
+// Copyright 2021 CBrainX
+// Project URL: https://github.com/mansoormemon/cbrainx
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Copyright (c) 2021 Mansoor Ahmed Memon <mansoorahmed.one@gmail.com>
+// Goal: Tune the matrix multiplication kernel for this machine and persist the results.
+//
+// Usage:
+//   cbxTune [--cache PATH] [--shape M N K]... [--show] [--quiet]
+//
+// Without `--shape`, every class of matrix multiplication is tuned. With `--show`, the cached entries of this
+// machine are printed and nothing is tuned.
+
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <tuple>
+#include <vector>
+
+#include <cbrainx/cbrainx.hh>
+#include <fmt/format.h>
+
+auto print_usage() -> void {
+  std::cerr << "usage: cbxTune [--cache PATH] [--shape M N K]... [--show] [--quiet]" << std::endl;
+}
+
+auto main(int argc, char *argv[]) -> int {
+  auto path = cbx::tune::cache_path();
+  auto shapes = std::vector<std::tuple<cbx::usize, cbx::usize, cbx::usize>>{};
+  auto show = false, quiet = false;
+
+  try {
+    for (int i = 1; i < argc; ++i) {
+      auto arg = std::string{argv[i]};
+      if (arg == "--cache" and i + 1 < argc) {
+        path = argv[++i];
+      } else if (arg == "--shape" and i + 3 < argc) {
+        auto m = std::stoul(argv[i + 1]), n = std::stoul(argv[i + 2]), k = std::stoul(argv[i + 3]);
+        shapes.emplace_back(m, n, k);
+        i += 3;
+      } else if (arg == "--show") {
+        show = true;
+      } else if (arg == "--quiet") {
+        quiet = true;
+      } else {
+        print_usage();
+        return EXIT_FAILURE;
+      }
+    }
+  } catch (const std::exception &) {
+    print_usage();
+    return EXIT_FAILURE;
+  }
+
+  if (path.empty()) {
+    std::cerr << "cbxTune: no cache location; pass --cache PATH" << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  fmt::print("machine: {}\ncache: {}\n", cbx::tune::machine_key(), path);
+  auto loaded = cbx::tune::load(path);
+
+  if (show) {
+    fmt::print("{} entries\n", loaded);
+    for (cbx::usize m : {8, 64, 512, 2048}) {
+      for (cbx::usize n : {8, 64, 512, 2048}) {
+        for (cbx::usize k : {8, 64, 512, 2048}) {
+          fmt::print("{:>8}: {}\n", cbx::tune::shape_class(m, n, k), cbx::tune::lookup(m, n, k).to_string());
+        }
+      }
+    }
+    return EXIT_SUCCESS;
+  }
+
+  auto log = [quiet](const std::string &line) {
+    if (not quiet) {
+      std::cout << line << std::endl;
+    }
+  };
+  if (shapes.empty()) {
+    cbx::tune::tune_all(log);
+  } else {
+    for (auto [m, n, k] : shapes) {
+      auto config = cbx::tune::tune(m, n, k, log);
+      fmt::print("{}: {}\n", cbx::tune::shape_class(m, n, k), config.to_string());
+    }
+  }
+
+  if (not cbx::tune::save(path)) {
+    std::cerr << "cbxTune: failed to write " << path << std::endl;
+    return EXIT_FAILURE;
+  }
+  fmt::print("saved to {}\n", path);
+  return EXIT_SUCCESS;
+}